@@ -0,0 +1,80 @@
+#include <sstream>
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+namespace {
+
+const char *kRules =
+    "(defrule hit (k0 ?x) (test (> ?x 10)) => (assert (hit ?x)))\n"
+    "(deffunction get-result () 1)";
+
+// The load-facts text path ClipsCreateFacts replaced: every feature is
+// printed into one string that is parsed back by EnvLoadFactsFromString.
+void PrintPrimitive(const json &obj, std::ostream &os) {
+    if (obj.is_number_integer()) {
+        os << obj.get<int64_t>();
+    } else if (obj.is_number_float()) {
+        os << obj.get<double>();
+    } else if (obj.is_string()) {
+        os << obj.dump();
+    } else if (obj.is_boolean()) {
+        os << (obj.get<bool>() ? "TRUE" : "FALSE");
+    }
+}
+
+void LoadFactsText(void *clips, const json &features) {
+    std::stringstream facts;
+    for (auto iter = features.begin(); iter != features.end(); ++iter) {
+        facts << "(" << iter.key();
+        if (iter.value().is_array()) {
+            for (auto &value : iter.value()) {
+                facts << " ";
+                PrintPrimitive(value, facts);
+            }
+        } else {
+            facts << " ";
+            PrintPrimitive(iter.value(), facts);
+        }
+        facts << ")\n";
+    }
+    EnvLoadFactsFromString(clips, facts.str().c_str(), -1);
+}
+
+json MakeFeatures(int keys) {
+    json features = json::object();
+    for (int i = 0; i < keys; ++i) {
+        std::string key = "k" + std::to_string(i);
+        switch (i % 4) {
+            case 0: features[key] = i; break;
+            case 1: features[key] = i + 0.5; break;
+            case 2: features[key] = "s" + std::to_string(i); break;
+            default: features[key] = json::array({i, "v", 1.5}); break;
+        }
+    }
+    return features;
+}
+
+}  // anonymous namespace
+
+// Reset + assert of a request's features, text path against the C API.
+int main() {
+    auto clips = CreateClips(kRules);
+    for (int keys : {50, 300}) {
+        json features = MakeFeatures(keys);
+        int iters = 200000 / keys;
+        double text = BenchNanos(iters, [&](int) {
+            EnvReset(clips.get());
+            LoadFactsText(clips.get(), features);
+        });
+        double api = BenchNanos(iters, [&](int) {
+            EnvReset(clips.get());
+            ClipsCreateFacts(clips.get(), features);
+        });
+        BenchReport(std::to_string(keys) + " keys, load-facts text", text);
+        BenchReport(std::to_string(keys) + " keys, ClipsCreateFacts", api);
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+// Average time of @param iters calls of @param fn, in nanoseconds.
+template <typename Fn>
+double BenchNanos(int iters, Fn &&fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iters; ++i) {
+        fn(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iters;
+}
+
+inline void BenchReport(const std::string &name, double nanos) {
+    std::cout << name << ": " << static_cast<int64_t>(nanos) << " ns"
+              << std::endl;
+}
@@ -0,0 +1,51 @@
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-factory.h"
+
+namespace {
+
+std::string Rules(int rules) {
+    std::ostringstream os;
+    os << "(deftemplate hit_result (slot model) (slot score))\n";
+    for (int i = 0; i < rules; ++i) {
+        os << "(defrule M" << i << " (list.score ?score) (list.city \"c" << i
+           << "\" ?c) (test (>= ?score " << i << ")) (not (list.black ?c))"
+           << " => (assert (hit_result (model \"M" << i << "\") (score " << i
+           << "))))\n";
+    }
+    os << "(deffunction get-result ()"
+       << " (nth 1 (find-fact ((?fact hit_result)) TRUE)))";
+    return os.str();
+}
+
+// Average time to create and destroy an environment of @param factory,
+// after a first one built whatever the factory shares between them.
+double CreateNanos(ClipsFactory &factory, int iters) {
+    factory.Destroy(factory.Create());
+    return BenchNanos(iters, [&](int) { factory.Destroy(factory.Create()); });
+}
+
+}  // anonymous namespace
+
+// Environment creation: parsing the rules against loading the binary image
+// of a prototype, and sharing the prototype's frozen network.
+int main() {
+    for (int rules : {10, 1000, 10000}) {
+        std::string text = Rules(rules);
+        int iters = rules >= 10000 ? 3 : rules >= 1000 ? 20 : 200;
+        std::string prefix = std::to_string(rules) + " rules, ";
+
+        ClipsFactory parsed(text);
+        BenchReport(prefix + "parsed", CreateNanos(parsed, iters));
+
+        ClipsFactory cloned(text, false, true);
+        BenchReport(prefix + "cloned", CreateNanos(cloned, iters));
+
+        ClipsFactory shared(text, false, true);
+        shared.set_shared_network(true);
+        BenchReport(prefix + "shared network", CreateNanos(shared, iters));
+    }
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+const int kAccounts = 50;
+
+// Rules joining a profile with a transaction through arithmetic and
+// comparisons.
+void BuildRules(void *clips, int rules) {
+    for (int i = 0; i < rules; ++i) {
+        std::string k = std::to_string(15 + i % 7);
+        std::string h = std::to_string(i % 24);
+        std::string rule =
+            "(defrule r" + std::to_string(i) +
+            " (profile (acct ?a) (avg ?avg) (home ?h) (limit ?l))"
+            " (txn (acct ?a) (amount ?amt) (country ?c) (hour ?hr))";
+        switch (i % 3) {
+            case 0:
+                rule += " (test (and (> ?amt (* ?avg " + k +
+                        ")) (neq ?c ?h)))";
+                break;
+            case 1:
+                rule += " (test (or (> (+ ?amt " + k + ") ?l) (and (>= ?hr " +
+                        h + ") (< ?amt (- ?avg ?l)))))";
+                break;
+            case 2:
+                rule += " (test (and (<> ?hr " + h +
+                        ") (not (eq ?c ?h)) (> (* ?amt 0.05) (+ ?avg " + k +
+                        "))))";
+                break;
+        }
+        rule += " =>)";
+        EnvBuild(clips, rule.c_str());
+    }
+}
+
+}  // anonymous namespace
+
+// Matching transactions against join tests walked by EvaluateExpression and
+// compiled by EnvCompileJoinExpressions.
+int main() {
+    const int kTransactions = 20000;
+    for (int rules : {200, 400}) {
+        for (bool compile : {false, true}) {
+            auto clips = CreateClips(
+                "(deftemplate profile (slot acct) (slot avg) (slot home)"
+                " (slot limit))\n"
+                "(deftemplate txn (slot acct) (slot amount) (slot country)"
+                " (slot hour))");
+            BuildRules(clips.get(), rules);
+            if (compile) EnvCompileJoinExpressions(clips.get());
+            EnvReset(clips.get());
+            for (int a = 0; a < kAccounts; ++a) {
+                std::string fact =
+                    "(profile (acct a" + std::to_string(a) + ") (avg " +
+                    std::to_string(50 + a) + ") (home c" +
+                    std::to_string(a % 5) + ") (limit " +
+                    std::to_string(1000 + a * 10) + "))";
+                EnvAssertString(clips.get(), fact.c_str());
+            }
+            long fired = 0;
+            double match = BenchNanos(kTransactions, [&](int i) {
+                std::string fact =
+                    "(txn (acct a" + std::to_string(i % kAccounts) +
+                    ") (amount " + std::to_string(i * 37 % 1200) +
+                    (i % 2 ? ".5" : "") + ") (country c" +
+                    std::to_string(i % 7) + ") (hour " +
+                    std::to_string(i % 24) + "))";
+                EnvAssertString(clips.get(), fact.c_str());
+                if (i % 1000 == 999) fired += EnvRun(clips.get(), -1);
+            });
+            std::string name = std::to_string(rules) + " rules, " +
+                               (compile ? "compiled" : "tree walker");
+            BenchReport(name + ", transaction asserted and matched", match);
+            std::cout << name << ", rules fired: " << fired << std::endl;
+        }
+    }
+}
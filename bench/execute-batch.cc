@@ -0,0 +1,76 @@
+#include <string>
+#include <vector>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+namespace {
+
+std::string Rules(int rules) {
+    std::string text = "(deftemplate hit (slot rule) (slot score))\n";
+    for (int i = 0; i < rules; ++i) {
+        std::string index = std::to_string(i);
+        text += "(defrule r" + index + " (list.score ?s&:(> ?s " +
+                std::to_string(i % 50) + ")) (list.city \"c" +
+                std::to_string(i % 13) + "\")" +
+                " => (assert (hit (rule r" + index + ") (score ?s))))\n";
+    }
+    text += "(deffunction get-result ()"
+            " (length$ (find-all-facts ((?f hit)) TRUE)))";
+    return text;
+}
+
+std::vector<json> Requests(int requests, int keys) {
+    std::vector<json> items;
+    for (int i = 0; i < requests; ++i) {
+        json features = {{"list.score", i % 60},
+                         {"list.city", "c" + std::to_string(i % 13)}};
+        for (int k = 0; k < keys; ++k) {
+            features["k" + std::to_string(k)] = i + k;
+        }
+        items.push_back(features);
+    }
+    return items;
+}
+
+}  // anonymous namespace
+
+// The same requests run by one ClipsExecuteBatch and by a loop of
+// ClipsModuleExecute calls, per request. Both are run in turns and the best
+// round of each is kept, which evens out the noise of the machine.
+int main() {
+    const int kRequests = 1000;
+    for (int rules : {10, 200}) {
+        for (int keys : {2, 50}) {
+            auto clips = CreateClips(Rules(rules));
+            std::vector<json> items = Requests(kRequests, keys);
+            std::string name = std::to_string(rules) + " rules, " +
+                               std::to_string(keys) + " keys";
+
+            double loop = 0;
+            double batch = 0;
+            for (int round = 0; round < 10; ++round) {
+                double nanos = BenchNanos(1, [&](int) {
+                    int halt = 0;
+                    for (const json &features : items) {
+                        ClipsModuleExecute(clips.get(), features, -1,
+                                           "get-result", halt);
+                    }
+                });
+                if (round == 0 || nanos < loop) loop = nanos;
+                nanos = BenchNanos(1, [&](int) {
+                    std::vector<int> halts;
+                    ClipsExecuteBatch(clips.get(), items, -1, "get-result",
+                                      halts);
+                });
+                if (round == 0 || nanos < batch) batch = nanos;
+            }
+            BenchReport(name + ", ClipsModuleExecute loop, per request",
+                        loop / kRequests);
+            BenchReport(name + ", ClipsExecuteBatch, per request",
+                        batch / kRequests);
+        }
+    }
+}
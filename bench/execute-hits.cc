@@ -0,0 +1,56 @@
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+namespace {
+
+// Rules of decreasing salience, each asserting a hit when its threshold is
+// below the score.
+std::string Rules(int rules) {
+    std::string text = "(deftemplate hit (slot rule) (slot score))\n";
+    for (int i = 0; i < rules; ++i) {
+        std::string index = std::to_string(i);
+        text += "(defrule r" + index + " (declare (salience " +
+                std::to_string(rules - i) + ")) (list.score ?s&:(> ?s " +
+                std::to_string(i % 50) + ")) (list.city ?c)" +
+                " => (assert (hit (rule r" + index + ") (score ?s))))\n";
+    }
+    text += "(deffunction get-result ()"
+            " (find-all-facts ((?f hit)) TRUE))";
+    return text;
+}
+
+}  // anonymous namespace
+
+// Requests run to completion with ClipsModuleExecute, and stopped after the
+// first hits with ClipsExecuteHits, with eager and lazy matching.
+int main() {
+    const int kRules = 1000;
+    const int kIters = 200;
+    json features = {{"list.score", 30}, {"list.city", "c1"}};
+    for (bool lazy : {false, true}) {
+        auto clips = CreateClips(Rules(kRules));
+        EnvSetLazyMatching(clips.get(), lazy);
+        std::string name = std::to_string(kRules) + " rules, " +
+                           (lazy ? "lazy" : "eager");
+        int halt = 0;
+
+        double nanos = BenchNanos(kIters, [&](int) {
+            ClipsModuleExecute(clips.get(), features, -1, "get-result", halt);
+        });
+        BenchReport(name + ", all hits", nanos);
+
+        for (size_t max_hits : {1, 10}) {
+            nanos = BenchNanos(kIters, [&](int) {
+                ClipsExecuteHits(clips.get(), features, -1, "hit", max_hits,
+                                 halt);
+            });
+            BenchReport(name + ", first " + std::to_string(max_hits) +
+                            " hits",
+                        nanos);
+        }
+    }
+}
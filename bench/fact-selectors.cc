@@ -0,0 +1,75 @@
+#include <iostream>
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+std::string Symbol(const char *prefix, int i) {
+    return prefix + std::to_string(i);
+}
+
+// One quarter each of disjunctions, negated constants, test CE equalities
+// and test CE inequalities on the same fields.
+void BuildRules(void *clips, int rules) {
+    for (int i = 0; i < rules; ++i) {
+        std::string m = Symbol("m", i % 500);
+        std::string m2 = Symbol("m", (i * 7 + 3) % 500);
+        std::string m3 = Symbol("m", (i * 13 + 5) % 500);
+        std::string c = Symbol("c", i / 4 % 200);
+        std::string rule = "(defrule r" + std::to_string(i) + " ";
+        switch (i % 4) {
+            case 0:
+                rule += "(txn (mcc " + m + "|" + m2 + "|" + m3 +
+                        ") (country " + c + "))";
+                break;
+            case 1:
+                rule += "(txn (mcc ?m&~" + m + "&~" + m2 + ") (country " + c +
+                        ") (channel web))";
+                break;
+            case 2:
+                rule += "(txn (mcc ?m) (country ?c) (amount ?a))"
+                        " (test (and (eq ?m " + m + ") (eq ?c " + c +
+                        ") (> ?a 10)))";
+                break;
+            case 3:
+                rule += "(txn (mcc " + m + ") (channel ?ch))"
+                        " (test (neq ?ch pos atm))";
+                break;
+        }
+        rule += " =>)";
+        EnvBuild(clips, rule.c_str());
+    }
+}
+
+}  // anonymous namespace
+
+// Building rules the fact selectors dispatch on, and matching facts through
+// them.
+int main() {
+    const char *channels[] = {"web", "pos", "atm", "app"};
+    const int kFacts = 20000;
+    for (int rules : {1000, 10000}) {
+        auto clips = CreateClips(
+            "(deftemplate txn (slot mcc) (slot country) (slot channel)"
+            " (slot amount))");
+        double build = BenchNanos(1, [&](int) {
+            BuildRules(clips.get(), rules);
+        });
+        EnvReset(clips.get());
+        long fired = 0;
+        double match = BenchNanos(kFacts, [&](int i) {
+            std::string fact = "(txn (mcc " + Symbol("m", i * 7919 % 500) +
+                               ") (country " + Symbol("c", i * 31 % 200) +
+                               ") (channel " + channels[i % 4] +
+                               ") (amount " + std::to_string(i) + "))";
+            EnvAssertString(clips.get(), fact.c_str());
+            if (i % 1000 == 999) fired += EnvRun(clips.get(), -1);
+        });
+        std::string name = std::to_string(rules) + " rules";
+        BenchReport(name + ", build", build);
+        BenchReport(name + ", fact asserted and matched", match);
+        std::cout << name << ", rules fired: " << fired << std::endl;
+    }
+}
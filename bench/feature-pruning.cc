@@ -0,0 +1,54 @@
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-factory.h"
+
+using nlohmann::json;
+
+namespace {
+
+// Rules matching the first @param used keys of a request, the other keys
+// are only in the payload.
+std::string Rules(int used) {
+    std::string rules = "(deftemplate hit (slot v))\n";
+    for (int i = 0; i < used; ++i) {
+        std::string key = "k" + std::to_string(i);
+        rules += "(defrule r" + std::to_string(i) + " (" + key +
+                 " ?x&:(> ?x 10)) => (assert (hit (v ?x))))\n";
+    }
+    rules += "(deffunction get-result ()"
+             " (length$ (find-all-facts ((?f hit)) TRUE)))";
+    return rules;
+}
+
+json MakeFeatures(int keys) {
+    json features = json::object();
+    for (int i = 0; i < keys; ++i) {
+        features["k" + std::to_string(i)] = i;
+    }
+    return features;
+}
+
+}  // anonymous namespace
+
+// Requests of 300 keys to rule sets matching some of them, with and without
+// pruning the keys no rule or query can see.
+int main() {
+    const int kKeys = 300;
+    json features = MakeFeatures(kKeys);
+    for (int used : {10, 100, 300}) {
+        for (bool prune : {false, true}) {
+            ClipsFactory factory(Rules(used), prune, true);
+            void *clips = factory.Create();
+            int halt = 0;
+            double nanos = BenchNanos(2000, [&](int) {
+                ClipsModuleExecute(clips, features, -1, "get-result", halt);
+            });
+            factory.Destroy(clips);
+            BenchReport(std::to_string(used) + " of " +
+                            std::to_string(kKeys) + " keys used, " +
+                            (prune ? "pruned" : "not pruned") + ", request",
+                        nanos);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+// Rules of decreasing salience joining transactions with accounts, and a
+// rule of high salience halting the run on a blocked account.
+void BuildRules(void *clips, int rules) {
+    EnvBuild(clips,
+             "(defrule blocked (declare (salience 1000))"
+             " (acct (id ?a) (status blocked)) (txn (acct ?a)) => (halt))");
+    for (int i = 0; i < rules; ++i) {
+        std::string index = std::to_string(i);
+        std::string rule =
+            "(defrule r" + index + " (declare (salience " +
+            std::to_string(500 - i % 1000) +
+            ")) (txn (acct ?a) (amount ?m&:(> ?m " + std::to_string(i % 97) +
+            "))) (acct (id ?a) (limit ?l&:(< ?l (+ ?m " + index +
+            ")))) => (assert (score r" + index + " ?a)))";
+        EnvBuild(clips, rule.c_str());
+    }
+}
+
+long Request(void *clips, bool block) {
+    EnvReset(clips);
+    for (int a = 0; a < 10; ++a) {
+        std::string fact = "(acct (id a" + std::to_string(a) + ") (limit " +
+                           std::to_string(a * 10) + ") (status " +
+                           (block && a == 3 ? "blocked" : "ok") + "))";
+        EnvAssertString(clips, fact.c_str());
+    }
+    for (int i = 0; i < 200; ++i) {
+        std::string fact = "(txn (id " + std::to_string(i) + ") (acct a" +
+                           std::to_string(i % 10) + ") (amount " +
+                           std::to_string(i * 37 % 100) + "))";
+        EnvAssertString(clips, fact.c_str());
+    }
+    return EnvRun(clips, -1);
+}
+
+}  // anonymous namespace
+
+// Requests with eager and lazy matching (EnvSetLazyMatching), running to
+// completion or halted by the rule of highest salience.
+int main() {
+    const int kRules = 2000;
+    for (bool lazy : {false, true}) {
+        auto clips = CreateClips(
+            "(deftemplate txn (slot id) (slot acct) (slot amount))\n"
+            "(deftemplate acct (slot id) (slot limit) (slot status))");
+        EnvSetLazyMatching(clips.get(), lazy);
+        BuildRules(clips.get(), kRules);
+        for (bool block : {false, true}) {
+            long fired = 0;
+            double nanos = BenchNanos(3, [&](int) {
+                fired = Request(clips.get(), block);
+            });
+            std::string name = std::to_string(kRules) + " rules, " +
+                               (lazy ? "lazy" : "eager") +
+                               (block ? ", halted" : ", not halted");
+            BenchReport(name + ", request", nanos);
+            std::cout << name << ", rules fired: " << fired << std::endl;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#include <iostream>
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+const char *kRules = "(defrule R (a ?x ?) (b ?x ?) =>)";
+
+void Assert(void *clips, const std::string &fact) {
+    EnvAssertString(clips, fact.c_str());
+}
+
+// Pairs of facts joined on their first field, in the same order each
+// request so that the memories fill up to the same level.
+void Request(void *clips, int pairs, int request) {
+    for (int i = 0; i < pairs; ++i) {
+        std::string value = std::to_string(i) + " " + std::to_string(request);
+        Assert(clips, "(a " + value + ")");
+        Assert(clips, "(b " + value + ")");
+    }
+    EnvRun(clips, -1);
+}
+
+long JoinCompares(void *clips) {
+    DATA_OBJECT activity;
+    EnvEval(clips, "(join-activity R terse)", &activity);
+    return ValueToLong(GetMFValue(GetValue(activity), 1));
+}
+
+}  // anonymous namespace
+
+// An equality join filled by each request: the first request grows the
+// hashed memories, the next ones find them sized by the previous peak.
+// Also the memory of the environment before any request.
+int main() {
+    auto empty = CreateClips(kRules);
+    std::cout << "one rule environment, memory: " << EnvMemUsed(empty.get())
+              << " bytes" << std::endl;
+
+    const int kRequests = 20;
+    for (int pairs : {200, 2000, 20000}) {
+        auto clips = CreateClips(kRules);
+        std::string name = std::to_string(pairs) + " pairs";
+        // The resets emptying the memories are not timed.
+        EnvReset(clips.get());
+        double first = BenchNanos(1, [&](int) {
+            Request(clips.get(), pairs, 0);
+        });
+        double next = 0;
+        for (int i = 1; i <= kRequests; ++i) {
+            EnvReset(clips.get());
+            next += BenchNanos(1, [&](int) {
+                Request(clips.get(), pairs, i);
+            });
+        }
+        BenchReport(name + ", first request", first);
+        BenchReport(name + ", next requests", next / kRequests);
+        std::cout << name << ", join compares per request: "
+                  << JoinCompares(clips.get()) / (kRequests + 1) << std::endl;
+    }
+}
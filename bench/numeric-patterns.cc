@@ -0,0 +1,69 @@
+#include <iostream>
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+// Rules comparing a slot to a constant and two slots of the same fact. With
+// @param primitives the comparisons take two arguments and are generated as
+// FACT_PN_NUMBER1/2 primitives, otherwise they get a third argument that
+// doesn't change their value and stay function calls.
+std::string Rules(int rules, bool primitives) {
+    std::string text = "(deftemplate m (slot a) (slot b) (slot c))\n";
+    for (int i = 0; i < rules; ++i) {
+        std::string bound = std::to_string(i);
+        std::string low = primitives ? "" : " -1000000";
+        std::string high = primitives ? "" : " 1000000";
+        std::string other = primitives ? "" : " " + bound;
+        text += "(defrule r" + std::to_string(i) +
+                " (m (a ?a&:(<> ?a " + bound + other + "))" +
+                " (b ?b&:(< ?a ?b" + high + "))" +
+                " (c ?c&:(>= ?c ?b" + low + "))) => )\n";
+    }
+    return text;
+}
+
+long Request(void *clips, int facts) {
+    EnvReset(clips);
+    for (int i = 0; i < facts; ++i) {
+        std::string fact = "(m (a " + std::to_string(i % 1000) + ") (b " +
+                           std::to_string(i * 7 % 1000) + ") (c " +
+                           std::to_string(i * 13 % 1000) + ".5))";
+        EnvAssertString(clips, fact.c_str());
+    }
+    return EnvRun(clips, -1);
+}
+
+}  // anonymous namespace
+
+// Facts matched against numeric comparisons run by the pattern network
+// primitives and by function calls. Both are run in turns and the best of
+// five rounds is kept.
+int main() {
+    const int kRules = 600;
+    const int kFacts = 20000;
+    auto calls = CreateClips(Rules(kRules, false));
+    auto primitives = CreateClips(Rules(kRules, true));
+    double calls_nanos = 0;
+    double primitives_nanos = 0;
+    long calls_fired = 0;
+    long primitives_fired = 0;
+    for (int round = 0; round < 5; ++round) {
+        double nanos = BenchNanos(1, [&](int) {
+            calls_fired = Request(calls.get(), kFacts);
+        });
+        if (round == 0 || nanos < calls_nanos) calls_nanos = nanos;
+        nanos = BenchNanos(1, [&](int) {
+            primitives_fired = Request(primitives.get(), kFacts);
+        });
+        if (round == 0 || nanos < primitives_nanos) primitives_nanos = nanos;
+    }
+    std::string name = std::to_string(kRules) + " rules, " +
+                       std::to_string(kFacts) + " facts, ";
+    BenchReport(name + "function calls, request", calls_nanos);
+    BenchReport(name + "primitives, request", primitives_nanos);
+    std::cout << name << "rules fired: " << calls_fired << " and "
+              << primitives_fired << std::endl;
+}
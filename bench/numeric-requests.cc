@@ -0,0 +1,69 @@
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+namespace {
+
+const int kRelations = 40;
+
+std::string Rules(int rules) {
+    std::ostringstream os;
+    os << "(deftemplate hit (slot model) (slot score))\n";
+    for (int i = 0; i < rules; ++i) {
+        int relation = i % kRelations;
+        os << "(defrule R" << i << " (list.i" << relation << " ?a&:(> ?a "
+           << i * 5000 << ")) (list.d" << relation << " ?x&:(< ?x "
+           << 0.005 * i << ")) => (assert (hit (model R" << i
+           << ") (score (+ ?a (* ?x 10))))))\n";
+    }
+    os << "(deffunction get-result () (bind ?s 0)"
+       << " (do-for-all-facts ((?f hit)) TRUE"
+       << " (bind ?s (+ ?s (fact-slot-value ?f score)))) ?s)\n";
+    return os.str();
+}
+
+// Fresh integers, floats and float multifields in every request, so the
+// numbers of one request are rarely seen again.
+std::vector<json> Requests(int count) {
+    std::mt19937_64 rng(42);
+    std::vector<json> requests;
+    for (int r = 0; r < count; ++r) {
+        json features;
+        for (int k = 0; k < kRelations; ++k) {
+            std::string relation = std::to_string(k);
+            features["list.i" + relation] =
+                static_cast<long long>(rng() % 1000000) + 1000000LL * r;
+            features["list.d" + relation] = (rng() % 1000000) / 1e6;
+            json values = json::array();
+            for (int m = 0; m < 4; ++m) {
+                values.push_back((rng() % 1000000) / 7.0);
+            }
+            features["list.m" + relation] = values;
+        }
+        requests.push_back(features);
+    }
+    return requests;
+}
+
+}  // anonymous namespace
+
+// Requests of numeric features. Build with -DIMMEDIATE_NUMBERS=0 to compare
+// against numbers interned in the atom tables.
+int main() {
+    auto requests = Requests(20000);
+    for (int rules : {20, 200}) {
+        auto clips = CreateClips(Rules(rules));
+        int halt = 0;
+        double nanos = BenchNanos(requests.size(), [&](int i) {
+            ClipsModuleExecute(clips.get(), requests[i], 100000, "get-result",
+                               halt);
+        });
+        BenchReport(std::to_string(rules) + " rules, request", nanos);
+    }
+}
@@ -0,0 +1,59 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench-utils.h"
+#include "lib/resource-pool.hpp"
+
+namespace {
+
+// Resources that cost nothing, so only the pool itself is measured.
+struct CounterFactory {
+    int *Create() { return new int(0); }
+    void Destroy(int *resource) { delete resource; }
+};
+
+using CounterPool = ResourcePool<int, CounterFactory>;
+
+// Average time of one RunWithResource when @param threads threads keep
+// taking and returning resources of the same pool.
+double PoolNanos(PoolMode mode, unsigned int threads, int iters) {
+    CounterPool pool(threads, new CounterFactory(), mode);
+    pool.set_need_clear(false);
+    std::atomic<bool> start(false);
+    std::vector<std::thread> workers;
+    std::vector<double> nanos(threads);
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            while (!start.load()) {
+                std::this_thread::yield();
+            }
+            nanos[t] = BenchNanos(iters, [&](int) {
+                pool.RunWithResource<int>(
+                    [](int *resource) -> int { return ++*resource; });
+            });
+        });
+    }
+    start = true;
+    double total = 0;
+    for (unsigned int t = 0; t < threads; ++t) {
+        workers[t].join();
+        total += nanos[t];
+    }
+    return total / threads;
+}
+
+}  // anonymous namespace
+
+// Pool overhead under contention, locked list against sharded slots.
+int main() {
+    const int kIters = 200000;
+    for (unsigned int threads : {1u, 2u, 4u, 8u, 16u}) {
+        std::string prefix = std::to_string(threads) + " threads, ";
+        BenchReport(prefix + "locked list",
+                    PoolNanos(POOL_LOCKED_LIST, threads, kIters));
+        BenchReport(prefix + "sharded",
+                    PoolNanos(POOL_SHARDED, threads, kIters));
+    }
+}
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+// The first rule folds a pattern predicate, the second a test CE into an
+// inequality join. Few of the pairs of facts match either.
+const char *kRules =
+    "(defrule R1 (limit ?l) (reading ?r&:(> ?r ?l)) =>)\n"
+    "(defrule R2 (order ?id ?amount) (cap ?c ?limit)"
+    " (test (>= ?amount ?limit)) =>)";
+
+void Assert(void *clips, const std::string &fact) {
+    EnvAssertString(clips, fact.c_str());
+}
+
+long Request(void *clips, int facts) {
+    EnvReset(clips);
+    for (int i = 0; i < facts; ++i) {
+        int reading = i * 7919 % (10 * facts);
+        if (i % 97 == 0) reading += 10 * facts + 50;
+        Assert(clips, "(limit " + std::to_string(10 * facts + i) + ")");
+        Assert(clips, "(reading " + std::to_string(reading) + ")");
+        Assert(clips, "(order o" + std::to_string(i) + " " +
+                          std::to_string(i * 31 % 1000) + ".5)");
+        Assert(clips, "(cap c" + std::to_string(i) + " " +
+                          std::to_string(990 + i) + ")");
+    }
+    // Retract some facts of each side of the joins.
+    DATA_OBJECT result;
+    EnvEval(clips,
+            "(do-for-all-facts ((?f limit)) (= (mod (fact-index ?f) 3) 0)"
+            " (retract ?f))",
+            &result);
+    EnvEval(clips,
+            "(do-for-all-facts ((?f reading order))"
+            " (= (mod (fact-index ?f) 5) 0) (retract ?f))",
+            &result);
+    return EnvRun(clips, -1);
+}
+
+long JoinCompares(void *clips, const char *rule) {
+    DATA_OBJECT activity;
+    EnvEval(clips, ("(join-activity " + std::string(rule) + " terse)").c_str(),
+            &activity);
+    return ValueToLong(GetMFValue(GetValue(activity), 1));
+}
+
+}  // anonymous namespace
+
+// Requests asserting growing numbers of facts into the range indexed joins.
+int main() {
+    const int kRequests = 3;
+    for (int facts : {200, 2000, 10000}) {
+        auto clips = CreateClips(kRules);
+        long fired = 0;
+        double nanos = BenchNanos(kRequests, [&](int) {
+            fired = Request(clips.get(), facts);
+        });
+        std::string name = std::to_string(facts) + " facts per relation";
+        BenchReport(name + ", request", nanos);
+        long compares =
+            JoinCompares(clips.get(), "R1") + JoinCompares(clips.get(), "R2");
+        compares /= kRequests;
+        std::cout << name << ", rules fired: " << fired
+                  << ", join compares per request: " << compares << std::endl;
+    }
+}
@@ -0,0 +1,76 @@
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+// Rules joining transactions with accounts, and rules whose not CE is
+// blocked by the transactions, so that retracting them one by one unblocks
+// the accounts.
+std::string Rules(int rules) {
+    std::string text =
+        "(deftemplate txn (slot id) (slot acct) (slot amount))\n"
+        "(deftemplate acct (slot id) (slot limit))\n";
+    for (int i = 0; i < rules; ++i) {
+        std::string index = std::to_string(i);
+        std::string bound = std::to_string(i % 100);
+        text += "(defrule over" + index + " (txn (acct ?a) (amount ?m&:(> ?m " +
+                bound + "))) (acct (id ?a) (limit ?l&:(< ?l ?m))) => )\n";
+        text += "(defrule idle" + index + " (acct (id ?a))" +
+                " (not (txn (acct ?a) (amount ?m&:(> ?m " + bound +
+                ")))) => )\n";
+    }
+    return text;
+}
+
+// The transactions are asserted first, the reset retracts them first.
+void Request(void *clips, int facts) {
+    for (int i = 0; i < facts; ++i) {
+        std::string fact = "(txn (id " + std::to_string(i) + ") (acct a" +
+                           std::to_string(i % 10) + ") (amount " +
+                           std::to_string(i * 37 % 100) + "))";
+        EnvAssertString(clips, fact.c_str());
+    }
+    for (int a = 0; a < 10; ++a) {
+        std::string fact = "(acct (id a" + std::to_string(a) + ") (limit " +
+                           std::to_string(a * 5) + "))";
+        EnvAssertString(clips, fact.c_str());
+    }
+}
+
+// The retraction of each fact through the join network, in the order of
+// the fact-list, which is what reset did before the memories were flushed
+// in bulk.
+void RetractEach(void *clips) {
+    void *fact;
+    while ((fact = EnvGetNextFact(clips, nullptr)) != nullptr) {
+        EnvRetract(clips, fact);
+    }
+    EnvReset(clips);
+}
+
+}  // anonymous namespace
+
+// A reset after a request, with the beta memories flushed in bulk
+// (FlushJoinNetwork), against the same facts retracted one by one.
+int main() {
+    for (int rules : {10, 100, 1000}) {
+        const int kFacts = 100;
+        int iters = 20000 / rules;
+        auto clips = CreateClips(Rules(rules));
+        EnvReset(clips.get());
+        double retract = 0;
+        double flush = 0;
+        for (int i = 0; i < iters; ++i) {
+            Request(clips.get(), kFacts);
+            retract += BenchNanos(1, [&](int) { RetractEach(clips.get()); });
+            Request(clips.get(), kFacts);
+            flush += BenchNanos(1, [&](int) { EnvReset(clips.get()); });
+        }
+        std::string name = std::to_string(rules * 2) + " rules, " +
+                           std::to_string(kFacts) + " facts";
+        BenchReport(name + ", retract each fact", retract / iters);
+        BenchReport(name + ", reset flushing the joins", flush / iters);
+    }
+}
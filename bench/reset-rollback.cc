@@ -0,0 +1,66 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+namespace {
+
+std::string Rules(int rules) {
+    std::ostringstream os;
+    os << "(deftemplate hit (slot model) (slot score))\n";
+    os << "(deffacts black";
+    for (int i = 0; i < 200; ++i) os << " (black " << i << ")";
+    os << ")\n";
+    for (int i = 0; i < rules; ++i) {
+        os << "(defrule R" << i << " (a.x ?x) (a.y ?y) (test (> ?x " << i
+           << ")) (black ?y) => (assert (hit (model R" << i
+           << ") (score ?x))))\n";
+    }
+    os << "(deffunction get-result ()"
+       << " (length$ (find-all-facts ((?f hit)) TRUE)))\n";
+    return os.str();
+}
+
+}  // anonymous namespace
+
+// Requests starting with EnvReset against requests starting with a rollback
+// to the checkpoint taken after the first reset (ClipsResetOrRollback).
+int main() {
+    for (int rules : {10, 100, 1000}) {
+        auto clips = CreateClips(Rules(rules));
+        std::vector<json> requests;
+        for (int i = 0; i < 1000; ++i) {
+            requests.push_back({{"a.x", i % (rules + 5)}, {"a.y", i % 300}});
+        }
+
+        std::string prefix = std::to_string(rules) + " rules, ";
+        for (bool rollback : {false, true}) {
+            int halt = 0;
+            double request = BenchNanos(requests.size(), [&](int i) {
+                ClipsModuleExecute(clips.get(), requests[i], 100000,
+                                   "get-result", halt, rollback);
+            });
+
+            // The reset or rollback alone, after each request.
+            double restore = 0;
+            for (auto &features : requests) {
+                ClipsModuleExecute(clips.get(), features, 100000, "get-result",
+                                   halt, rollback);
+                restore += BenchNanos(1, [&](int) {
+                    if (rollback) {
+                        ClipsResetOrRollback(clips.get());
+                    } else {
+                        EnvReset(clips.get());
+                    }
+                });
+            }
+            std::string mode = rollback ? "rollback" : "reset";
+            BenchReport(prefix + mode + ", request", request);
+            BenchReport(prefix + mode + " alone", restore / requests.size());
+        }
+    }
+}
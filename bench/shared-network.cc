@@ -0,0 +1,54 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-factory.h"
+
+namespace {
+
+std::string Rules(int rules) {
+    std::ostringstream os;
+    os << "(deftemplate hit_result (slot model) (slot score))\n";
+    for (int i = 0; i < rules; ++i) {
+        os << "(defrule M" << i << " (list.score ?score) (list.city \"c" << i
+           << "\" ?c) (test (>= ?score " << i << ")) (not (list.black ?c))"
+           << " => (assert (hit_result (model \"M" << i << "\") (score " << i
+           << "))))\n";
+    }
+    os << "(deffunction get-result ()"
+       << " (nth 1 (find-fact ((?fact hit_result)) TRUE)))";
+    return os.str();
+}
+
+void Report(const std::string &name, ClipsFactory &factory, int iters) {
+    // The first environment builds what the factory shares.
+    void *clips = factory.Create();
+    long used = EnvMemUsed(clips);
+    double nanos = BenchNanos(iters, [&](int) {
+        factory.Destroy(factory.Create());
+    });
+    factory.Destroy(clips);
+    BenchReport(name + ", create and destroy", nanos);
+    std::cout << name << ", memory per environment: " << used / 1024
+              << " KB" << std::endl;
+}
+
+}  // anonymous namespace
+
+// Memory and creation time of environments loading their own copy of the
+// binary image, and of environments sharing one frozen network.
+int main() {
+    for (int rules : {100, 1000, 10000}) {
+        std::string text = Rules(rules);
+        int iters = rules >= 10000 ? 5 : rules >= 1000 ? 50 : 500;
+        std::string prefix = std::to_string(rules) + " rules, ";
+
+        ClipsFactory cloned(text, false, true);
+        Report(prefix + "cloned", cloned, iters);
+
+        ClipsFactory shared(text, false, true);
+        shared.set_shared_network(true);
+        Report(prefix + "shared network", shared, iters);
+    }
+}
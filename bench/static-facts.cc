@@ -0,0 +1,58 @@
+#include <chrono>
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+// A blacklist of @param facts deffacts facts joined with the request facts,
+// and a rule firing on a few of the static facts.
+std::string Rules(int facts) {
+    std::string rules = "(deffacts blacklist";
+    for (int i = 0; i < facts; ++i) {
+        rules += " (black " + std::to_string(i) + ")";
+    }
+    rules += ")\n"
+             "(defrule hit (req ?x) (black ?x) => (assert (hit ?x)))\n"
+             "(defrule low (black ?x&:(< ?x 10)) => (assert (low ?x)))";
+    return rules;
+}
+
+// Returns the time the reset took, in nanoseconds.
+double Request(void *clips, int request) {
+    auto start = std::chrono::steady_clock::now();
+    EnvReset(clips);
+    std::chrono::duration<double, std::nano> reset =
+        std::chrono::steady_clock::now() - start;
+    for (int i = 0; i < 10; ++i) {
+        std::string fact = "(req " + std::to_string(request * 10 + i) + ")";
+        EnvAssertString(clips, fact.c_str());
+    }
+    EnvRun(clips, -1);
+    return reset.count();
+}
+
+}  // anonymous namespace
+
+// Requests of 10 facts after full resets and after resets keeping the
+// deffacts facts static (EnvSetStaticFacts), for growing deffacts.
+int main() {
+    for (int facts : {100, 1000, 10000}) {
+        for (bool keep : {false, true}) {
+            auto clips = CreateClips(Rules(facts));
+            EnvSetStaticFacts(clips.get(), keep);
+            // The first reset is a full one in both modes.
+            Request(clips.get(), 0);
+            int iters = 200000 / facts;
+            double reset = 0;
+            double nanos = BenchNanos(iters, [&](int i) {
+                reset += Request(clips.get(), i);
+            });
+            std::string name = std::to_string(facts) + " deffacts facts, " +
+                               (keep ? "static facts" : "full reset");
+            BenchReport(name + ", request", nanos);
+            BenchReport(name + ", reset", reset / iters);
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+namespace {
+
+const int kAttributes = 60;
+
+std::string Rules(int rules) {
+    std::ostringstream os;
+    os << "(deftemplate hit (slot model) (slot tag))\n";
+    for (int i = 0; i < rules; ++i) {
+        os << "(defrule R" << i << " (customer.profile.attribute_"
+           << i % kAttributes << " \"value_" << i % 7
+           << "\") (customer.profile.attribute_" << (i + 1) % kAttributes
+           << " ?t) => (assert (hit (model R" << i << ") (tag (str-cat ?t \"-R"
+           << i << "\")))))\n";
+    }
+    os << "(deffunction get-result () (bind ?s 0)"
+       << " (do-for-all-facts ((?f hit)) TRUE"
+       << " (bind ?s (+ ?s (str-length (fact-slot-value ?f tag))))) ?s)\n";
+    return os.str();
+}
+
+// Long relation names sharing their prefix, with mostly fresh string values.
+std::vector<json> Requests(int count) {
+    std::mt19937_64 rng(42);
+    std::vector<json> requests;
+    for (int r = 0; r < count; ++r) {
+        json features;
+        for (int k = 0; k < kAttributes; ++k) {
+            std::string attribute = std::to_string(k);
+            unsigned long long value =
+                rng() % 7 == 0 ? rng() % 7 : 100000 + rng() % 1000000;
+            features["customer.profile.attribute_" + attribute] =
+                "value_" + std::to_string(value);
+            features["customer.session.token_" + attribute] =
+                "session-token-" + std::to_string(rng());
+        }
+        requests.push_back(features);
+    }
+    return requests;
+}
+
+}  // anonymous namespace
+
+// Interning the same long symbols again (EnvAddSymbol), and requests of
+// string features.
+int main() {
+    auto atoms = CreateClips("");
+    for (int keys : {100, 2000}) {
+        std::vector<std::string> names;
+        for (int i = 0; i < keys; ++i) {
+            names.push_back("customer.profile.attribute_" +
+                            std::to_string(i * 7919 % 1000003));
+            IncrementSymbolCount(
+                EnvAddSymbol(atoms.get(), names.back().c_str()));
+        }
+        double nanos = BenchNanos(5000000, [&](int i) {
+            EnvAddSymbol(atoms.get(), names[i % keys].c_str());
+        });
+        BenchReport(std::to_string(keys) + " symbols, lookup", nanos);
+    }
+
+    auto requests = Requests(10000);
+    for (int rules : {20, 200}) {
+        auto clips = CreateClips(Rules(rules));
+        int halt = 0;
+        double nanos = BenchNanos(requests.size(), [&](int i) {
+            ClipsModuleExecute(clips.get(), requests[i], 100000, "get-result",
+                               halt);
+        });
+        BenchReport(std::to_string(rules) + " rules, request", nanos);
+    }
+}
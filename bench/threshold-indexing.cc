@@ -0,0 +1,55 @@
+#include <iostream>
+#include <string>
+
+#include "bench-utils.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+// Half the rules test the score against a lower bound, half against an
+// upper one.
+void BuildRules(void *clips, int rules) {
+    for (int i = 0; i < rules; ++i) {
+        std::string rule =
+            "(defrule r" + std::to_string(i) + " (list (score ?s)) ";
+        if (i % 2 == 0) {
+            rule += "(test (>= ?s " + std::to_string(1000000 - i) + "))";
+        } else {
+            rule += "(test (< ?s " + std::to_string(i) + ".5))";
+        }
+        rule += " =>)";
+        EnvBuild(clips, rule.c_str());
+    }
+}
+
+}  // anonymous namespace
+
+// Matching facts against many threshold tests of one field, evaluated one
+// by one and indexed in the fact selectors (EnvSetThresholdIndexing).
+int main() {
+    const int kFacts = 20000;
+    for (int rules : {1000, 10000}) {
+        for (bool indexing : {false, true}) {
+            auto clips =
+                CreateClips("(deftemplate list (slot id) (slot score))");
+            EnvSetThresholdIndexing(clips.get(), indexing);
+            double build = BenchNanos(1, [&](int) {
+                BuildRules(clips.get(), rules);
+            });
+            EnvReset(clips.get());
+            long fired = 0;
+            double match = BenchNanos(kFacts, [&](int i) {
+                std::string fact = "(list (id " + std::to_string(i) +
+                                   ") (score " +
+                                   std::to_string(i * 7919L % 1000000) + "))";
+                EnvAssertString(clips.get(), fact.c_str());
+                if (i % 1000 == 999) fired += EnvRun(clips.get(), -1);
+            });
+            std::string name = std::to_string(rules) + " rules, " +
+                               (indexing ? "indexed" : "unindexed");
+            BenchReport(name + ", build", build);
+            BenchReport(name + ", fact asserted and matched", match);
+            std::cout << name << ", rules fired: " << fired << std::endl;
+        }
+    }
+}
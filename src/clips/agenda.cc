@@ -86,6 +86,7 @@
    static struct salienceGroup   *ReuseOrCreateSalienceGroup(void *,struct defruleModule *,int);
    static struct salienceGroup   *FindSalienceGroup(struct defruleModule *,int);
    static void                    RemoveActivationFromGroup(void *,struct activation *,struct defruleModule *);
+   static void                    UnparkActivation(void *,struct activation *);
    
 /*************************************************/
 /* InitializeAgenda: Initializes the activations */
@@ -165,6 +166,7 @@ globle void AddActivation(
    newActivation->salience = EvaluateSalience(theEnv,theRule);
 
    newActivation->randomID = genrand();
+   newActivation->parked = FALSE;
    newActivation->prev = NULL;
    newActivation->next = NULL;
 
@@ -194,7 +196,7 @@ globle void AddActivation(
     /* Place the activation on the agenda. */
     /*=====================================*/
 
-    theModuleItem = (struct defruleModule *) theRule->header.whichModule;
+    theModuleItem = RuleModuleItem(theEnv,theRule->header.whichModule);
     
     theGroup = ReuseOrCreateSalienceGroup(theEnv,theModuleItem,newActivation->salience);
     
@@ -280,7 +282,7 @@ globle void ClearRuleFromAgenda(
    /* in which the rule is contained.            */
    /*============================================*/
 
-   agendaPtr = ((struct defruleModule *) theRule->header.whichModule)->agenda;
+   agendaPtr = RuleModuleItem(theEnv,theRule->header.whichModule)->agenda;
 
    /*==============================================*/
    /* Loop through every activation on the agenda. */
@@ -309,6 +311,29 @@ globle void ClearRuleFromAgenda(
 
       agendaPtr = agendaNext;
      }
+
+   /*==================================================*/
+   /* Fired activations of the rule kept for the next  */
+   /* reset are removed as well (see ParkActivation).  */
+   /*==================================================*/
+
+   for (agendaPtr = AgendaData(theEnv)->ParkedActivations;
+        agendaPtr != NULL;
+        agendaPtr = agendaNext)
+     {
+      agendaNext = agendaPtr->next;
+
+      for (tempRule = theRule;
+           tempRule != NULL;
+           tempRule = tempRule->disjunct)
+        {
+         if (agendaPtr->theRule == tempRule)
+           {
+            RemoveActivation(theEnv,agendaPtr,TRUE,TRUE);
+            break;
+           }
+        }
+     }
   }
 
 /****************************************************************/
@@ -325,7 +350,7 @@ globle void *EnvGetNextActivation(
    
    if (actPtr == NULL)
      {
-      theModuleItem = (struct defruleModule *) GetModuleItem(theEnv,NULL,DefruleData(theEnv)->DefruleModuleIndex);
+      theModuleItem = GetDefruleModuleItem(theEnv,NULL);
       if (theModuleItem == NULL) return(NULL);
       return((void *) theModuleItem->agenda);
      }
@@ -458,7 +483,7 @@ globle intBool MoveActivationToTop(
    /* in which the activation is stored. */
    /*====================================*/
 
-   theModuleItem = (struct defruleModule *) theActivation->theRule->header.whichModule;
+   theModuleItem = RuleModuleItem(theEnv,theActivation->theRule->header.whichModule);
 
    /*============================================*/
    /* If the activation is already at the top of */
@@ -532,7 +557,7 @@ globle intBool DetachActivation(
    /* in which the activation is stored. */
    /*====================================*/
 
-   theModuleItem = (struct defruleModule *) theActivation->theRule->header.whichModule;
+   theModuleItem = RuleModuleItem(theEnv,theActivation->theRule->header.whichModule);
 
    RemoveActivationFromGroup(theEnv,theActivation,theModuleItem);
 
@@ -627,7 +652,28 @@ globle void RemoveActivation(
    /* in which the activation is stored. */
    /*====================================*/
 
-   theModuleItem = (struct defruleModule *) theActivation->theRule->header.whichModule;
+   theModuleItem = RuleModuleItem(theEnv,theActivation->theRule->header.whichModule);
+
+   /*===============================================*/
+   /* A parked activation is only on the list of    */
+   /* parked activations, and is no longer counted. */
+   /*===============================================*/
+
+   if (theActivation->parked)
+     {
+      if (theActivation->prev == NULL)
+        { AgendaData(theEnv)->ParkedActivations = theActivation->next; }
+      else
+        { theActivation->prev->next = theActivation->next; }
+      if (theActivation->next != NULL)
+        { theActivation->next->prev = theActivation->prev; }
+
+      if ((updateLinks == TRUE) && (theActivation->basis != NULL))
+        { theActivation->basis->marker = NULL; }
+
+      rtn_struct(theEnv,activation,theActivation);
+      return;
+     }
 
    /*=================================*/
    /* Update the agenda if necessary. */
@@ -751,6 +797,83 @@ static void RemoveActivationFromGroup(
      }
   }
 
+/*******************************************************************/
+/* ParkActivation: Keeps a fired activation whose partial match    */
+/*   consists only of static facts (and whose partial match is not */
+/*   being deleted) instead of returning it to free memory. A      */
+/*   reset that keeps the static facts puts it back on the agenda  */
+/*   with its original timetag, just as a full reset would have    */
+/*   recreated it. The partial match points to it again so that it */
+/*   is removed with the partial match.                            */
+/*******************************************************************/
+globle void ParkActivation(
+  void *theEnv,
+  struct activation *theActivation)
+  {
+   theActivation->parked = TRUE;
+   theActivation->prev = NULL;
+   theActivation->next = AgendaData(theEnv)->ParkedActivations;
+   if (theActivation->next != NULL)
+     { theActivation->next->prev = theActivation; }
+   AgendaData(theEnv)->ParkedActivations = theActivation;
+
+   theActivation->basis->marker = (void *) theActivation;
+   AgendaData(theEnv)->NumberOfActivations--;
+  }
+
+/***************************************************************/
+/* RestoreParkedActivations: Puts every parked activation back */
+/*   on the agenda of its module.                              */
+/***************************************************************/
+globle void RestoreParkedActivations(
+  void *theEnv)
+  {
+   while (AgendaData(theEnv)->ParkedActivations != NULL)
+     { UnparkActivation(theEnv,AgendaData(theEnv)->ParkedActivations); }
+  }
+
+/*************************************************************/
+/* DiscardParkedActivations: Returns every parked activation */
+/*   to free memory.                                         */
+/*************************************************************/
+globle void DiscardParkedActivations(
+  void *theEnv)
+  {
+   while (AgendaData(theEnv)->ParkedActivations != NULL)
+     { RemoveActivation(theEnv,AgendaData(theEnv)->ParkedActivations,TRUE,TRUE); }
+  }
+
+/**********************************************************/
+/* UnparkActivation: Moves a parked activation back to    */
+/*   the agenda, its timetag, salience and random ID kept. */
+/**********************************************************/
+static void UnparkActivation(
+  void *theEnv,
+  struct activation *theActivation)
+  {
+   struct defruleModule *theModuleItem;
+   struct salienceGroup *theGroup;
+
+   if (theActivation->prev == NULL)
+     { AgendaData(theEnv)->ParkedActivations = theActivation->next; }
+   else
+     { theActivation->prev->next = theActivation->next; }
+   if (theActivation->next != NULL)
+     { theActivation->next->prev = theActivation->prev; }
+
+   theActivation->parked = FALSE;
+   theActivation->prev = NULL;
+   theActivation->next = NULL;
+   AgendaData(theEnv)->NumberOfActivations++;
+
+   if (theActivation->theRule->autoFocus)
+     { EnvFocus(theEnv,(void *) theActivation->theRule->header.whichModule->theModule); }
+
+   theModuleItem = RuleModuleItem(theEnv,theActivation->theRule->header.whichModule);
+   theGroup = ReuseOrCreateSalienceGroup(theEnv,theModuleItem,theActivation->salience);
+   PlaceActivation(theEnv,&(theModuleItem->agenda),theActivation,theGroup);
+  }
+
 /**************************************************************/
 /* AgendaClearFunction: Agenda clear routine for use with the */
 /*   clear command. Resets the current time tag to zero.      */
@@ -955,9 +1078,9 @@ globle intBool EnvRefresh(
       /* satisfies the LHS of the rule. */
       /*================================*/
 
-      for (b = 0; b < rulePtr->lastJoin->leftMemory->size; b++)
+      for (b = 0; b < JoinLeftMemory(theEnv,rulePtr->lastJoin)->size; b++)
         {
-         for (listOfMatches = rulePtr->lastJoin->leftMemory->beta[b];
+         for (listOfMatches = JoinLeftMemory(theEnv,rulePtr->lastJoin)->beta[b];
               listOfMatches != NULL;
               listOfMatches = listOfMatches->nextInMemory)
            {
@@ -972,6 +1095,8 @@ globle intBool EnvRefresh(
               {
                if (listOfMatches->marker == NULL)
                  { AddActivation(theEnv,rulePtr,listOfMatches); }
+               else if (((struct activation *) listOfMatches->marker)->parked)
+                 { UnparkActivation(theEnv,(struct activation *) listOfMatches->marker); }
               }
            }
         }
@@ -75,6 +75,7 @@ struct activation
    int salience;
    unsigned long long timetag;
    int randomID;
+   unsigned int parked : 1;
    struct activation *prev;
    struct activation *next;
   };
@@ -102,6 +103,7 @@ struct agendaData
    int AgendaChanged;
    intBool SalienceEvaluation;
    int Strategy;
+   struct activation *ParkedActivations;
   };
 
 #define AgendaData(theEnv) ((struct agendaData *) GetEnvironmentData(theEnv,AGENDA_DATA))
@@ -136,6 +138,9 @@ struct agendaData
    LOCALE void                    EnvAgenda(void *,const char *,void *);
    LOCALE void                    RemoveActivation(void *,void *,int,int);
    LOCALE void                    RemoveAllActivations(void *);
+   LOCALE void                    ParkActivation(void *,struct activation *);
+   LOCALE void                    RestoreParkedActivations(void *);
+   LOCALE void                    DiscardParkedActivations(void *);
    LOCALE int                     EnvGetAgendaChanged(void *);
    LOCALE void                    EnvSetAgendaChanged(void *,int);
    LOCALE unsigned long           GetNumberOfActivations(void *);
@@ -33,11 +33,13 @@
 
 #include <stdio.h>
 #define _STDIO_INCLUDED_
+#include <string.h>
 
 #include "constant.h"
 #include "symbol.h"
 #include "memalloc.h"
 #include "exprnpsr.h"
+#include "extnfunc.h"
 #include "reorder.h"
 #include "generate.h"
 #include "pattern.h"
@@ -103,6 +105,15 @@
                                                           int,int);
    static int                     TestCEAnalysis(void *,struct lhsParseNode *,struct lhsParseNode *,int,int *,struct nandFrame *);
    static void                    ReleaseNandFrames(void *,struct nandFrame *);
+   static void                    MoveTestEqualitiesToPatterns(void *,struct lhsParseNode *);
+   static int                     MoveTestEquality(void *,struct lhsParseNode *,
+                                                   struct lhsParseNode *,struct lhsParseNode *);
+   static int                     MoveTestComparison(void *,struct lhsParseNode *,
+                                                     struct lhsParseNode *,struct lhsParseNode *);
+   static struct lhsParseNode    *FindUnconstrainedBinding(struct lhsParseNode *,
+                                                           struct lhsParseNode *,
+                                                           struct symbolHashNode *,
+                                                           struct patternParser *);
 
 /******************************************************************/
 /* VariableAnalysis: Propagates variables references to other     */
@@ -120,6 +131,14 @@ globle int VariableAnalysis(
    struct nandFrame *theNandFrames = NULL, *tempNandPtr;
    int currentDepth = 1;
 
+   /*===================================================*/
+   /* Comparisons of variables to constants in test CEs */
+   /* are moved to the patterns binding the variables   */
+   /* before the variables are propagated.              */
+   /*===================================================*/
+
+   MoveTestEqualitiesToPatterns(theEnv,patternPtr);
+
    /*======================================================*/
    /* Loop through all of the CEs in the rule to determine */
    /* which variables refer to other variables and whether */
@@ -271,6 +290,319 @@ static void ReleaseNandFrames(
      }
   }
 
+/*******************************************************************/
+/* MoveTestEqualitiesToPatterns: Replaces comparisons of a variable */
+/*   to constants in a test CE, such as (eq ?c red),                */
+/*   (neq ?c red blue) and (>= ?c 200), with constraints on the     */
+/*   fact pattern field binding the variable. The constants are     */
+/*   then tested in the pattern network, where a selector node can  */
+/*   dispatch them, rather than in the join network.                */
+/*******************************************************************/
+static void MoveTestEqualitiesToPatterns(
+  void *theEnv,
+  struct lhsParseNode *theLHS)
+  {
+   struct lhsParseNode *patternPtr, *theExpression, *theTest, *lastTest, *nextTest;
+
+   for (patternPtr = theLHS;
+        patternPtr != NULL;
+        patternPtr = patternPtr->bottom)
+     {
+      /*=====================================================*/
+      /* Only a test CE attached to a pattern at the top     */
+      /* level of the rule is considered. A test CE within a */
+      /* not or exists CE can't constrain the patterns.      */
+      /*=====================================================*/
+
+      if ((patternPtr->type != PATTERN_CE) ||
+          (patternPtr->expression == NULL) ||
+          patternPtr->negated || patternPtr->exists ||
+          (patternPtr->beginNandDepth != 1) ||
+          (patternPtr->endNandDepth != 1))
+        { continue; }
+
+      theExpression = patternPtr->expression;
+
+      /*=========================================*/
+      /* Each argument of an and function call  */
+      /* is considered separately.              */
+      /*=========================================*/
+
+      if ((theExpression->type == FCALL) &&
+          (theExpression->value == ExpressionData(theEnv)->PTR_AND))
+        {
+         lastTest = NULL;
+         for (theTest = theExpression->bottom;
+              theTest != NULL;
+              theTest = nextTest)
+           {
+            nextTest = theTest->right;
+
+            if (MoveTestEquality(theEnv,theLHS,patternPtr,theTest) ||
+                MoveTestComparison(theEnv,theLHS,patternPtr,theTest))
+              {
+               if (lastTest == NULL)
+                 { theExpression->bottom = nextTest; }
+               else
+                 { lastTest->right = nextTest; }
+
+               theTest->right = NULL;
+               ReturnLHSParseNodes(theEnv,theTest);
+              }
+            else
+              { lastTest = theTest; }
+           }
+
+         if (theExpression->bottom == NULL)
+           {
+            ReturnLHSParseNodes(theEnv,theExpression);
+            patternPtr->expression = NULL;
+           }
+         else if (theExpression->bottom->right == NULL)
+           {
+            patternPtr->expression = theExpression->bottom;
+            theExpression->bottom = NULL;
+            ReturnLHSParseNodes(theEnv,theExpression);
+           }
+        }
+      else if (MoveTestEquality(theEnv,theLHS,patternPtr,theExpression) ||
+               MoveTestComparison(theEnv,theLHS,patternPtr,theExpression))
+        {
+         ReturnLHSParseNodes(theEnv,theExpression);
+         patternPtr->expression = NULL;
+        }
+     }
+  }
+
+/*******************************************************************/
+/* MoveTestEquality: Moves the constants of an eq or neq function  */
+/*   call comparing a variable to constants to the field binding   */
+/*   the variable. Returns TRUE if the constants were moved and    */
+/*   the function call is no longer needed, otherwise FALSE.       */
+/*******************************************************************/
+static int MoveTestEquality(
+  void *theEnv,
+  struct lhsParseNode *theLHS,
+  struct lhsParseNode *thePattern,
+  struct lhsParseNode *theTest)
+  {
+   struct lhsParseNode *theVariable, *theArg, *theField;
+   struct lhsParseNode *newNode, *lastNode = NULL;
+   int negated;
+
+   if ((theTest->type != FCALL) ||
+       (theTest->bottom == NULL) ||
+       (theTest->bottom->right == NULL))
+     { return(FALSE); }
+
+   if (theTest->value == ExpressionData(theEnv)->PTR_EQ)
+     {
+      if (theTest->bottom->right->right != NULL)
+        { return(FALSE); }
+      negated = FALSE;
+     }
+   else if (theTest->value == ExpressionData(theEnv)->PTR_NEQ)
+     { negated = TRUE; }
+   else
+     { return(FALSE); }
+
+   /*=====================================================*/
+   /* The variable is the first argument, or the second   */
+   /* argument of a comparison of a constant to it.       */
+   /*=====================================================*/
+
+   theVariable = theTest->bottom;
+   if ((theVariable->type != SF_VARIABLE) &&
+       (theVariable->right->right == NULL))
+     { theVariable = theVariable->right; }
+
+   if (theVariable->type != SF_VARIABLE)
+     { return(FALSE); }
+
+   for (theArg = theTest->bottom; theArg != NULL; theArg = theArg->right)
+     {
+      if (theArg == theVariable) continue;
+
+      if ((theArg->type != SYMBOL) && (theArg->type != STRING) &&
+#if OBJECT_SYSTEM
+          (theArg->type != INSTANCE_NAME) &&
+#endif
+          (theArg->type != INTEGER) && (theArg->type != FLOAT))
+        { return(FALSE); }
+     }
+
+   /*=====================================================*/
+   /* The variable must be bound by a field which has no  */
+   /* other constraints. A constant not allowed by the    */
+   /* field's constraints is left in the test CE so that  */
+   /* the rule isn't rejected as unmatchable.             */
+   /*=====================================================*/
+
+   theField = FindUnconstrainedBinding(theLHS,thePattern,(SYMBOL_HN *) theVariable->value,
+                                       FindPatternParser(theEnv,"facts"));
+   if (theField == NULL)
+     { return(FALSE); }
+
+   if (! negated)
+     {
+      theArg = (theVariable == theTest->bottom) ? theVariable->right : theTest->bottom;
+      if (ConstraintCheckValue(theEnv,theArg->type,theArg->value,theField->constraints) != NO_VIOLATION)
+        { return(FALSE); }
+     }
+
+   /*=================================================*/
+   /* Attach the constants to the field as subfields */
+   /* tied together by the & connective constraint.  */
+   /*=================================================*/
+
+   for (theArg = theTest->bottom; theArg != NULL; theArg = theArg->right)
+     {
+      if (theArg == theVariable) continue;
+
+      newNode = GetLHSParseNode(theEnv);
+      CopyLHSParseNode(theEnv,newNode,theField,FALSE);
+      newNode->type = theArg->type;
+      newNode->value = theArg->value;
+      newNode->negated = negated;
+      newNode->bindingVariable = FALSE;
+      newNode->referringNode = NULL;
+      newNode->constraints = NULL;
+      newNode->derivedConstraints = FALSE;
+      newNode->userData = NULL;
+      newNode->expression = NULL;
+      newNode->secondaryExpression = NULL;
+
+      if (lastNode == NULL)
+        { theField->bottom = newNode; }
+      else
+        { lastNode->right = newNode; }
+      lastNode = newNode;
+     }
+
+   return(TRUE);
+  }
+
+/*******************************************************************/
+/* MoveTestComparison: Moves a >, >=, < or <= function call        */
+/*   comparing a variable to a number to the field binding the     */
+/*   variable as a predicate constraint, if threshold indexing is  */
+/*   on (see EnvSetThresholdIndexing). Returns TRUE if the         */
+/*   function call was moved, otherwise FALSE.                     */
+/*******************************************************************/
+static int MoveTestComparison(
+  void *theEnv,
+  struct lhsParseNode *theLHS,
+  struct lhsParseNode *thePattern,
+  struct lhsParseNode *theTest)
+  {
+   struct lhsParseNode *theVariable, *theNumber, *theField, *newNode, *nextTest;
+   const char *name;
+
+   if ((! DefruleData(theEnv)->ThresholdIndexingFlag) ||
+       (theTest->type != FCALL) ||
+       (theTest->bottom == NULL) ||
+       (theTest->bottom->right == NULL) ||
+       (theTest->bottom->right->right != NULL))
+     { return(FALSE); }
+
+   name = ValueToString(((struct FunctionDefinition *) theTest->value)->callFunctionName);
+   if ((strcmp(name,">") != 0) && (strcmp(name,">=") != 0) &&
+       (strcmp(name,"<") != 0) && (strcmp(name,"<=") != 0))
+     { return(FALSE); }
+
+   theVariable = theTest->bottom;
+   theNumber = theVariable->right;
+   if (theVariable->type != SF_VARIABLE)
+     {
+      theVariable = theNumber;
+      theNumber = theTest->bottom;
+     }
+
+   if ((theVariable->type != SF_VARIABLE) ||
+       ((theNumber->type != INTEGER) && (theNumber->type != FLOAT)))
+     { return(FALSE); }
+
+   theField = FindUnconstrainedBinding(theLHS,thePattern,(SYMBOL_HN *) theVariable->value,
+                                       FindPatternParser(theEnv,"facts"));
+   if (theField == NULL)
+     { return(FALSE); }
+
+   /*=================================================*/
+   /* The function call becomes the expression of a  */
+   /* predicate constraint, as if the field had been */
+   /* written ?c&:(>= ?c 200).                       */
+   /*=================================================*/
+
+   newNode = GetLHSParseNode(theEnv);
+   CopyLHSParseNode(theEnv,newNode,theField,FALSE);
+   newNode->type = PREDICATE_CONSTRAINT;
+   newNode->value = NULL;
+   newNode->negated = FALSE;
+   newNode->bindingVariable = FALSE;
+   newNode->referringNode = NULL;
+   newNode->constraints = NULL;
+   newNode->derivedConstraints = FALSE;
+   newNode->userData = NULL;
+   newNode->secondaryExpression = NULL;
+
+   nextTest = theTest->right;
+   theTest->right = NULL;
+   newNode->expression = CopyLHSParseNodes(theEnv,theTest);
+   theTest->right = nextTest;
+
+   theField->bottom = newNode;
+
+   return(TRUE);
+  }
+
+/*******************************************************************/
+/* FindUnconstrainedBinding: Finds a single field variable in the  */
+/*   top level fact patterns of a rule up to and including a given */
+/*   pattern which isn't constrained by any subfields.             */
+/*******************************************************************/
+static struct lhsParseNode *FindUnconstrainedBinding(
+  struct lhsParseNode *theLHS,
+  struct lhsParseNode *lastPattern,
+  struct symbolHashNode *variableName,
+  struct patternParser *factParser)
+  {
+   struct lhsParseNode *patternPtr, *theField, *theSubfield;
+
+   if (factParser == NULL) return(NULL);
+
+   for (patternPtr = theLHS;
+        patternPtr != NULL;
+        patternPtr = patternPtr->bottom)
+     {
+      if ((patternPtr->type == PATTERN_CE) &&
+          (patternPtr->patternType == factParser) &&
+          (! patternPtr->negated) && (! patternPtr->exists) &&
+          (patternPtr->beginNandDepth == 1))
+        {
+         for (theField = patternPtr->right;
+              theField != NULL;
+              theField = theField->right)
+           {
+            theSubfield = theField->multifieldSlot ? theField->bottom : theField;
+
+            for (;
+                 theSubfield != NULL;
+                 theSubfield = theField->multifieldSlot ? theSubfield->right : NULL)
+              {
+               if ((theSubfield->type == SF_VARIABLE) &&
+                   (theSubfield->value == (void *) variableName) &&
+                   (theSubfield->bottom == NULL))
+                 { return(theSubfield); }
+              }
+           }
+        }
+
+      if (patternPtr == lastPattern) return(NULL);
+     }
+
+   return(NULL);
+  }
+
 /*******************************************************************/
 /* TestCEAnalysis: If a test CE is encountered, make sure that all */
 /*   references to variables have been previously bound. If they   */
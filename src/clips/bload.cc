@@ -54,10 +54,13 @@
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
 /***************************************/
 
+   static int                         BloadBinary(void *,const char *);
    static struct FunctionDefinition **ReadNeededFunctions(void *,long *,int *);
    static struct FunctionDefinition  *FastFindFunction(void *,const char *,struct FunctionDefinition *);
    static int                         ClearBload(void *);
    static void                        AbortBload(void *);
+   static intBool                     BinaryImageComplete(void *);
+   static void                        SkipBinarySections(void *);
    static int                         BloadOutOfMemoryFunction(void *,size_t);
    static void                        DeallocateBloadData(void *);
 
@@ -73,7 +76,7 @@ globle void InitializeBloadData(
    EnvAddClearFunction(theEnv,"bload",(void (*)(void *)) ClearBload,10000);
 
    BloadData(theEnv)->BinaryPrefixID = "\1\2\3\4CLIPS";
-   BloadData(theEnv)->BinaryVersionID = "V6.30";
+   BloadData(theEnv)->BinaryVersionID = "V6.30a";
   }
   
 /************************************************/
@@ -87,6 +90,8 @@ static void DeallocateBloadData(
    DeallocateCallList(theEnv,BloadData(theEnv)->AfterBloadFunctions);
    DeallocateCallList(theEnv,BloadData(theEnv)->ClearBloadReadyFunctions);
    DeallocateCallList(theEnv,BloadData(theEnv)->AbortBloadFunctions);
+   DeallocateCallList(theEnv,BloadData(theEnv)->FreezeBloadReadyFunctions);
+   DeallocateCallListWithArg(theEnv,BloadData(theEnv)->ShareBloadFunctions);
   }
 
 /******************************/
@@ -94,6 +99,41 @@ static void DeallocateBloadData(
 /*   for the bload command.   */
 /******************************/
 globle int EnvBload(
+  void *theEnv,
+  const char *fileName)
+  {
+   /*================*/
+   /* Open the file. */
+   /*================*/
+
+   if (GenOpenReadBinary(theEnv,"bload",fileName) == 0) return(FALSE);
+
+   return(BloadBinary(theEnv,fileName));
+  }
+
+/*************************************************/
+/* EnvBloadFromMemory: C access routine to load  */
+/*   a binary image from memory, such as one     */
+/*   written by EnvBsaveToStream or a mapped     */
+/*   file. The image is only read during the     */
+/*   call.                                       */
+/*************************************************/
+globle int EnvBloadFromMemory(
+  void *theEnv,
+  const void *image,
+  size_t size)
+  {
+   GenOpenReadBinaryImage(theEnv,image,size);
+
+   return(BloadBinary(theEnv,"[memory image]"));
+  }
+
+/*************************************************/
+/* BloadBinary: Loads the constructs of a binary */
+/*   image opened for GenReadBinary, and closes  */
+/*   it. The source name is used for messages.   */
+/*************************************************/
+static int BloadBinary(
   void *theEnv,
   const char *fileName)
   {
@@ -105,11 +145,19 @@ globle int EnvBload(
    struct BinaryItem *biPtr;
    struct callFunctionItem *bfPtr;
 
-   /*================*/
-   /* Open the file. */
-   /*================*/
+   /*=================================================*/
+   /* The constructs of a frozen binary image may be  */
+   /* shared with other environments and can't be     */
+   /* replaced.                                       */
+   /*=================================================*/
 
-   if (GenOpenReadBinary(theEnv,"bload",fileName) == 0) return(FALSE);
+   if (ConstructData(theEnv)->ConstructsFrozen)
+     {
+      GenCloseBinary(theEnv);
+      PrintErrorID(theEnv,"BLOAD",7,FALSE);
+      EnvPrintRouter(theEnv,WERROR,"The binary image is frozen. Binary load cannot continue.\n");
+      return(FALSE);
+     }
 
    /*=====================================*/
    /* Determine if this is a binary file. */
@@ -141,6 +189,23 @@ globle int EnvBload(
       GenCloseBinary(theEnv);
       return(FALSE);
      }
+
+   /*================================================*/
+   /* Make sure the whole image is there before the  */
+   /* environment is cleared. The reads past the end */
+   /* of a truncated image would return zeroes,      */
+   /* which would be loaded as constructs.           */
+   /*================================================*/
+
+   if (! BinaryImageComplete(theEnv))
+     {
+      GenCloseBinary(theEnv);
+      PrintErrorID(theEnv,"BLOAD",11,FALSE);
+      EnvPrintRouter(theEnv,WERROR,"File ");
+      EnvPrintRouter(theEnv,WERROR,fileName);
+      EnvPrintRouter(theEnv,WERROR," is truncated.\n");
+      return(FALSE);
+     }
      
    /*====================*/
    /* Clear environment. */
@@ -584,6 +649,180 @@ globle intBool Bloaded(
    return(BloadData(theEnv)->BloadActive);
   }
 
+/*******************************************************/
+/* EnvFreezeBload: Freezes the binary image of an      */
+/*   environment so that it can be shared by other     */
+/*   environments (see EnvShareBload). The atoms and   */
+/*   constructs of a frozen environment are read-only: */
+/*   it must not be run, cleared, or loaded anymore    */
+/*   and must outlive the environments sharing it.     */
+/*   Returns FALSE if the image can't be shared.       */
+/*******************************************************/
+globle intBool EnvFreezeBload(
+  void *theEnv)
+  {
+   struct callFunctionItem *bfPtr;
+   int ready, error;
+
+   if (ConstructData(theEnv)->ConstructsFrozen)
+     { return(SharingBload(theEnv) ? FALSE : TRUE); }
+
+   if (! BloadData(theEnv)->BloadActive)
+     {
+      PrintErrorID(theEnv,"BLOAD",8,FALSE);
+      EnvPrintRouter(theEnv,WERROR,"Only a binary image can be frozen.\n");
+      return(FALSE);
+     }
+
+   /*=================================================*/
+   /* Make sure the constructs of the binary image    */
+   /* can be used from several environments at once.  */
+   /*=================================================*/
+
+   error = FALSE;
+   for (bfPtr = BloadData(theEnv)->FreezeBloadReadyFunctions;
+        bfPtr != NULL;
+        bfPtr = bfPtr->next)
+     {
+      ready = (* ((int (*)(void *)) bfPtr->func))(theEnv);
+
+      if (ready == FALSE)
+        {
+         if (! error)
+           {
+            PrintErrorID(theEnv,"BLOAD",9,FALSE);
+            EnvPrintRouter(theEnv,WERROR,
+                       "Some constructs of the binary image can't be shared:\n");
+           }
+         EnvPrintRouter(theEnv,WERROR,"   ");
+         EnvPrintRouter(theEnv,WERROR,bfPtr->name);
+         EnvPrintRouter(theEnv,WERROR,"\n");
+         error = TRUE;
+        }
+     }
+
+   if (error) return(FALSE);
+
+   /*=================================================*/
+   /* Remove the ephemeral atoms before the remaining */
+   /* atoms are frozen. Their counts aren't changed   */
+   /* from here on, so they stay until the frozen     */
+   /* environment is destroyed.                       */
+   /*=================================================*/
+
+   CleanCurrentGarbageFrame(theEnv,NULL);
+   FreezeAtomTables(theEnv);
+
+   ConstructData(theEnv)->ConstructsFrozen = TRUE;
+
+   return(TRUE);
+  }
+
+/*******************************************************/
+/* EnvShareBload: Replaces the constructs of an        */
+/*   environment with the binary image of a frozen     */
+/*   environment. The network, constructs, and atoms   */
+/*   of the image are shared, while facts, agendas,    */
+/*   and the alpha and beta memories stay private to   */
+/*   the environment. The environment must have been   */
+/*   created with CreateSharedEnvironment.             */
+/*******************************************************/
+globle intBool EnvShareBload(
+  void *theEnv,
+  void *frozenEnv)
+  {
+   struct callFunctionItem *bfPtr;
+   struct callFunctionItemWithArg *sfPtr;
+
+   if ((! ConstructData(frozenEnv)->ConstructsFrozen) ||
+       SharingBload(frozenEnv) ||
+       (SymbolData(theEnv)->SharedAtomTables != SymbolData(frozenEnv)) ||
+       ConstructData(theEnv)->ConstructsFrozen)
+     {
+      PrintErrorID(theEnv,"BLOAD",10,FALSE);
+      EnvPrintRouter(theEnv,WERROR,"The binary image of the environment is not frozen or can't be shared.\n");
+      return(FALSE);
+     }
+
+   /*====================*/
+   /* Clear environment. */
+   /*====================*/
+
+   if (BloadData(theEnv)->BloadActive)
+     {
+      if (ClearBload(theEnv) == FALSE)
+        { return(FALSE); }
+     }
+
+   if (ClearReady(theEnv) == FALSE)
+     {
+      EnvPrintRouter(theEnv,WERROR,"The ");
+      EnvPrintRouter(theEnv,WERROR,APPLICATION_NAME);
+      EnvPrintRouter(theEnv,WERROR," environment could not be cleared.\n");
+      return(FALSE);
+     }
+
+   ConstructData(theEnv)->ClearInProgress = TRUE;
+   for (bfPtr = BloadData(theEnv)->BeforeBloadFunctions;
+        bfPtr != NULL;
+        bfPtr = bfPtr->next)
+     {
+      if (bfPtr->environmentAware)
+        { (*bfPtr->func)(theEnv); }
+      else
+        { (* (void (*)(void)) bfPtr->func)(); }
+     }
+   ConstructData(theEnv)->ClearInProgress = FALSE;
+
+   /*=================================================*/
+   /* Expressions compare function calls against the  */
+   /* function definitions of the frozen environment. */
+   /*=================================================*/
+
+   ExpressionData(theEnv)->PTR_AND = ExpressionData(frozenEnv)->PTR_AND;
+   ExpressionData(theEnv)->PTR_OR = ExpressionData(frozenEnv)->PTR_OR;
+   ExpressionData(theEnv)->PTR_EQ = ExpressionData(frozenEnv)->PTR_EQ;
+   ExpressionData(theEnv)->PTR_NEQ = ExpressionData(frozenEnv)->PTR_NEQ;
+   ExpressionData(theEnv)->PTR_NOT = ExpressionData(frozenEnv)->PTR_NOT;
+
+   /*===============================================*/
+   /* Attach the constructs of the frozen image and */
+   /* create the private state used to run them.    */
+   /*===============================================*/
+
+   for (sfPtr = BloadData(theEnv)->ShareBloadFunctions;
+        sfPtr != NULL;
+        sfPtr = sfPtr->next)
+     { (*sfPtr->func)(theEnv,frozenEnv); }
+
+   for (bfPtr = BloadData(theEnv)->AfterBloadFunctions;
+        bfPtr != NULL;
+        bfPtr = bfPtr->next)
+     {
+      if (bfPtr->environmentAware)
+        { (*bfPtr->func)(theEnv); }
+      else
+        { (* (void (*)(void)) bfPtr->func)(); }
+     }
+
+   BloadData(theEnv)->BloadActive = TRUE;
+   BloadData(theEnv)->SharedEnv = frozenEnv;
+   ConstructData(theEnv)->ConstructsFrozen = TRUE;
+
+   return(TRUE);
+  }
+
+/*****************************************************/
+/* SharingBload: Returns TRUE if the constructs of   */
+/*   the environment belong to the binary image of a */
+/*   frozen environment, otherwise returns FALSE.    */
+/*****************************************************/
+globle intBool SharingBload(
+  void *theEnv)
+  {
+   return(BloadData(theEnv)->SharedEnv != NULL);
+  }
+
 /*************************************/
 /* ClearBload: Clears a binary image */
 /*   from the KB environment.        */
@@ -699,6 +938,62 @@ static void AbortBload(
      }
   }
 
+/*********************************************************/
+/* BinaryImageComplete: Determines if the binary image   */
+/*   being loaded is all there, by moving past each of   */
+/*   its parts up to the end marker. The position in the */
+/*   image is restored.                                  */
+/*********************************************************/
+static intBool BinaryImageComplete(
+  void *theEnv)
+  {
+   long start, numberOfFunctions, numberOfExpressions;
+   unsigned long space;
+   intBool complete;
+
+   GenTellBinary(theEnv,&start);
+
+   GenReadBinary(theEnv,&numberOfFunctions,(unsigned long) sizeof(long int));
+   GenReadBinary(theEnv,&space,(unsigned long) sizeof(unsigned long int));
+   if (numberOfFunctions != 0)
+     { GetSeekCurBinary(theEnv,(long) space); }
+
+   SkipNeededAtomicValues(theEnv);
+
+   GenReadBinary(theEnv,&numberOfExpressions,(unsigned long) sizeof(long));
+   SkipBinarySections(theEnv);
+   GetSeekCurBinary(theEnv,numberOfExpressions * (long) sizeof(BSAVE_EXPRESSION));
+   SkipNeededConstraints(theEnv);
+   SkipBinarySections(theEnv);
+
+   complete = ! GenBinaryOverrun(theEnv);
+   GetSeekSetBinary(theEnv,start);
+
+   return(complete);
+  }
+
+/**********************************************************/
+/* SkipBinarySections: Moves past the construct sections  */
+/*   of a binary image, each one a construct header, the  */
+/*   size of its data and the data, up to the end marker  */
+/*   following them or the end of the image.              */
+/**********************************************************/
+static void SkipBinarySections(
+  void *theEnv)
+  {
+   char constructBuffer[CONSTRUCT_HEADER_SIZE];
+   unsigned long space;
+
+   for (GenReadBinary(theEnv,constructBuffer,(unsigned long) CONSTRUCT_HEADER_SIZE);
+        (! GenBinaryOverrun(theEnv)) &&
+        (strncmp(constructBuffer,BloadData(theEnv)->BinaryPrefixID,CONSTRUCT_HEADER_SIZE) != 0);
+        GenReadBinary(theEnv,constructBuffer,(unsigned long) CONSTRUCT_HEADER_SIZE))
+     {
+      GenReadBinary(theEnv,&space,(unsigned long) sizeof(unsigned long));
+      GetSeekCurBinary(theEnv,(long) space);
+     }
+  }
+
 /********************************************/
 /* AddBeforeBloadFunction: Adds a function  */
 /*   to the list of functions called before */
@@ -760,6 +1055,40 @@ globle void AddAbortBloadFunction(
    BloadData(theEnv)->AbortBloadFunctions = AddFunctionToCallList(theEnv,name,priority,func,BloadData(theEnv)->AbortBloadFunctions,TRUE);
   }
 
+/*****************************************************/
+/* AddFreezeBloadReadyFunction: Adds a function to   */
+/*   the list of functions called to determine if a  */
+/*   binary image can be frozen and shared.          */
+/*****************************************************/
+globle void AddFreezeBloadReadyFunction(
+  void *theEnv,
+  const char *name,
+  int (*func)(void *),
+  int priority)
+  {
+   BloadData(theEnv)->FreezeBloadReadyFunctions =
+      AddFunctionToCallList(theEnv,name,priority,
+                            (void (*)(void *)) func,
+                            BloadData(theEnv)->FreezeBloadReadyFunctions,TRUE);
+  }
+
+/******************************************************/
+/* AddShareBloadFunction: Adds a function to the list */
+/*   of functions called when an environment shares   */
+/*   the binary image of a frozen environment. The    */
+/*   function receives both environments.             */
+/******************************************************/
+globle void AddShareBloadFunction(
+  void *theEnv,
+  const char *name,
+  void (*func)(void *,void *),
+  int priority)
+  {
+   BloadData(theEnv)->ShareBloadFunctions =
+      AddFunctionToCallListWithArg(theEnv,name,priority,func,
+                                   BloadData(theEnv)->ShareBloadFunctions,TRUE);
+  }
+
 /*******************************************************
   NAME         : BloadOutOfMemoryFunction
   DESCRIPTION  : Memory function used by bload to
@@ -65,6 +65,9 @@ struct bloadData
    struct callFunctionItem *AfterBloadFunctions;
    struct callFunctionItem *ClearBloadReadyFunctions;
    struct callFunctionItem *AbortBloadFunctions;
+   struct callFunctionItem *FreezeBloadReadyFunctions;
+   struct callFunctionItemWithArg *ShareBloadFunctions;
+   void *SharedEnv;
   };
 
 #define BloadData(theEnv) ((struct bloadData *) GetEnvironmentData(theEnv,BLOAD_DATA))
@@ -83,12 +86,18 @@ struct bloadData
    LOCALE void                    InitializeBloadData(void *);
    LOCALE int                     BloadCommand(void *);
    LOCALE intBool                 EnvBload(void *,const char *);
+   LOCALE intBool                 EnvBloadFromMemory(void *,const void *,size_t);
    LOCALE void                    BloadandRefresh(void *,long,size_t,void (*)(void *,void *,long));
    LOCALE intBool                 Bloaded(void *);
    LOCALE void                    AddBeforeBloadFunction(void *,const char *,void (*)(void *),int);
    LOCALE void                    AddAfterBloadFunction(void *,const char *,void (*)(void *),int);
    LOCALE void                    AddClearBloadReadyFunction(void *,const char *,int (*)(void *),int);
    LOCALE void                    AddAbortBloadFunction(void *,const char *,void (*)(void *),int);
+   LOCALE void                    AddFreezeBloadReadyFunction(void *,const char *,int (*)(void *),int);
+   LOCALE void                    AddShareBloadFunction(void *,const char *,void (*)(void *,void *),int);
+   LOCALE intBool                 EnvFreezeBload(void *);
+   LOCALE intBool                 EnvShareBload(void *,void *);
+   LOCALE intBool                 SharingBload(void *);
    LOCALE void                    CannotLoadWithBloadMessage(void *,const char *);
 
 #if ALLOW_ENVIRONMENT_GLOBALS
@@ -58,6 +58,8 @@
 /***************************************/
 
 #if BLOAD_AND_BSAVE
+   static intBool                     BsaveAllowed(void *);
+   static void                        BsaveBinary(void *,FILE *);
    static void                        FindNeededItems(void *);
    static void                        InitializeFunctionNeededFlags(void *);
    static void                        WriteNeededFunctions(void *,FILE *);
@@ -128,22 +130,8 @@ globle intBool EnvBsave(
   const char *fileName)
   {
    FILE *fp;
-   struct BinaryItem *biPtr;
-   char constructBuffer[CONSTRUCT_HEADER_SIZE];
-   long saveExpressionCount;
 
-   /*===================================*/
-   /* A bsave can't occur when a binary */
-   /* image is already loaded.          */
-   /*===================================*/
-
-   if (Bloaded(theEnv))
-     {
-      PrintErrorID(theEnv,"BSAVE",1,FALSE);
-      EnvPrintRouter(theEnv,WERROR,
-          "Cannot perform a binary save while a binary load is in effect.\n");
-      return(0);
-     }
+   if (! BsaveAllowed(theEnv)) return(0);
 
    /*================*/
    /* Open the file. */
@@ -155,6 +143,64 @@ globle intBool EnvBsave(
       return(0);
      }
 
+   BsaveBinary(theEnv,fp);
+
+   /*=================*/
+   /* Close the file. */
+   /*=================*/
+
+   GenClose(theEnv,fp);
+
+   return(TRUE);
+  }
+
+/**********************************************/
+/* EnvBsaveToStream: C access routine to save */
+/*   the binary image to an open stream, such */
+/*   as one writing to memory. The stream is  */
+/*   left open.                               */
+/**********************************************/
+globle intBool EnvBsaveToStream(
+  void *theEnv,
+  FILE *fp)
+  {
+   if (! BsaveAllowed(theEnv)) return(0);
+
+   BsaveBinary(theEnv,fp);
+
+   return(TRUE);
+  }
+
+/**************************************************/
+/* BsaveAllowed: A bsave can't occur when a binary */
+/*   image is already loaded.                     */
+/**************************************************/
+static intBool BsaveAllowed(
+  void *theEnv)
+  {
+   if (Bloaded(theEnv))
+     {
+      PrintErrorID(theEnv,"BSAVE",1,FALSE);
+      EnvPrintRouter(theEnv,WERROR,
+          "Cannot perform a binary save while a binary load is in effect.\n");
+      return(FALSE);
+     }
+
+   return(TRUE);
+  }
+
+/*********************************************/
+/* BsaveBinary: Writes the binary image of   */
+/*   the constructs to an open stream.       */
+/*********************************************/
+static void BsaveBinary(
+  void *theEnv,
+  FILE *fp)
+  {
+   struct BinaryItem *biPtr;
+   char constructBuffer[CONSTRUCT_HEADER_SIZE];
+   long saveExpressionCount;
+
    /*==============================*/
    /* Remember the current module. */
    /*==============================*/
@@ -261,23 +307,11 @@ globle intBool EnvBsave(
 
    RestoreAtomicValueBuckets(theEnv);
 
-   /*=================*/
-   /* Close the file. */
-   /*=================*/
-
-   GenClose(theEnv,fp);
-
    /*=============================*/
    /* Restore the current module. */
    /*=============================*/
 
    RestoreCurrentModule(theEnv);
-
-   /*========================================*/
-   /* Return TRUE to indicate success. */
-   /*========================================*/
-
-   return(TRUE);
   }
 
 /*********************************************/
@@ -460,11 +494,11 @@ globle void MarkNeededItems(
             break;
 
          case FLOAT:
-            ((FLOAT_HN *) testPtr->value)->neededFloat = TRUE;
+            BoxedFloat(theEnv,testPtr->value)->neededFloat = TRUE;
             break;
 
          case INTEGER:
-            ((INTEGER_HN *) testPtr->value)->neededInteger = TRUE;
+            BoxedInteger(theEnv,testPtr->value)->neededInteger = TRUE;
             break;
 
          case FCALL:
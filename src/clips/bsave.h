@@ -103,6 +103,7 @@ struct bsaveData
    LOCALE int                     BsaveCommand(void *);
 #if BLOAD_AND_BSAVE
    LOCALE intBool                 EnvBsave(void *,const char *);
+   LOCALE intBool                 EnvBsaveToStream(void *,FILE *);
    LOCALE void                    MarkNeededItems(void *,struct expr *);
    LOCALE void                    SaveBloadCount(void *,long);
    LOCALE void                    RestoreBloadCount(void *,long *);
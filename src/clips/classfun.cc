@@ -116,17 +116,16 @@ static void DeassignClassID(void *,unsigned);
   INPUTS       : The class
   RETURNS      : Nothing useful
   SIDE EFFECTS : Busy count incremented
-  NOTES        : None
+  NOTES        : Classes shared by frozen
+                 environments can't be deleted,
+                 so their use counts are left alone
  ***************************************************/
 globle void IncrementDefclassBusyCount(
   void *theEnv,
   void *theDefclass)
   {
-#if MAC_XCD
-#pragma unused(theEnv)
-#endif
-
-   ((DEFCLASS *) theDefclass)->busy++;
+   if (! ConstructData(theEnv)->ConstructsFrozen)
+     ((DEFCLASS *) theDefclass)->busy++;
   }
 
 /***************************************************
@@ -138,13 +137,15 @@ globle void IncrementDefclassBusyCount(
   NOTES        : Since use counts are ignored on
                  a clear and defclasses might be
                  deleted already anyway, this is
-                 a no-op on a clear
+                 a no-op on a clear, and like
+                 the increment on frozen classes
  ***************************************************/
 globle void DecrementDefclassBusyCount(
   void *theEnv,
   void *theDefclass)
   {   
-   if (! ConstructData(theEnv)->ClearInProgress)
+   if ((! ConstructData(theEnv)->ClearInProgress) &&
+       (! ConstructData(theEnv)->ConstructsFrozen))
      ((DEFCLASS *) theDefclass)->busy--;
   }
 
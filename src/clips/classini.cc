@@ -212,10 +212,11 @@ static void DeallocateDefclassData(
    int i;
    struct defclassModule *theModuleItem;
    void *theModule;
-   int bloaded = FALSE;
+   int bloaded = FALSE, shared = FALSE;
    
 #if BLOAD || BLOAD_AND_BSAVE
    if (Bloaded(theEnv)) bloaded = TRUE;
+   if (SharingBload(theEnv)) shared = TRUE;
 #endif
 
    /*=============================*/
@@ -249,7 +250,7 @@ static void DeallocateDefclassData(
         }
      }
      
-   if (DefclassData(theEnv)->ClassTable != NULL)
+   if ((DefclassData(theEnv)->ClassTable != NULL) && (! shared))
      {
       genfree(theEnv,DefclassData(theEnv)->ClassTable,sizeof(DEFCLASS *) * CLASS_TABLE_HASH_SIZE);
      }
@@ -273,7 +274,7 @@ static void DeallocateDefclassData(
         }
      }
           
-   if (DefclassData(theEnv)->SlotNameTable != NULL)
+   if ((DefclassData(theEnv)->SlotNameTable != NULL) && (! shared))
      {
       genfree(theEnv,DefclassData(theEnv)->SlotNameTable,sizeof(SLOT_NAME *) * SLOT_NAME_TABLE_HASH_SIZE);
      }
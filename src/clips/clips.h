@@ -87,6 +87,8 @@
 #include "incrrset.h"
 #include "rulecom.h"
 #include "crstrtgy.h"
+#include "exprcode.h"
+#include "joinprof.h"
 #endif
 
 #if DEFFACTS_CONSTRUCT
@@ -104,6 +106,9 @@
 #include "factmngr.h"
 #endif
 #include "facthsh.h"
+#if DEFRULE_CONSTRUCT
+#include "lazymtch.h"
+#endif
 #endif
 
 #if DEFGLOBAL_CONSTRUCT
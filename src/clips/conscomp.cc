@@ -350,6 +350,19 @@ static int ConstructsToC(
   {
    int fileVersion;
    struct CodeGeneratorItem *cgPtr;
+   unsigned long symbolTableSize, floatTableSize, integerTableSize, bitMapTableSize;
+
+   /*================================================*/
+   /* Generating code marks the atoms and constructs */
+   /* being saved, so a frozen image is left alone.  */
+   /*================================================*/
+
+   if (ConstructData(theEnv)->ConstructsFrozen)
+     {
+      PrintErrorID(theEnv,"CONSCOMP",2,FALSE);
+      EnvPrintRouter(theEnv,WERROR,"Cannot generate code for a frozen binary image.\n");
+      return(0);
+     }
 
    /*===============================================*/
    /* Set the global MaxIndices variable indicating */
@@ -448,6 +461,13 @@ static int ConstructsToC(
    /* expressions, and constructs.     */
    /*==================================*/
 
+   symbolTableSize = GetSymbolTableSize(theEnv);
+   floatTableSize = GetFloatTableSize(theEnv);
+   integerTableSize = GetIntegerTableSize(theEnv);
+   bitMapTableSize = GetBitMapTableSize(theEnv);
+
+   SetAtomTableSizes(theEnv,SYMBOL_HASH_SIZE,FLOAT_HASH_SIZE,INTEGER_HASH_SIZE,BITMAP_HASH_SIZE);
+
    AtomicValuesToCode(theEnv,fileName,pathName,fileNameBuffer);
 
    FunctionsToCode(theEnv,fileName,pathName,fileNameBuffer);
@@ -483,6 +503,8 @@ static int ConstructsToC(
 
    RestoreAtomicValueBuckets(theEnv);
 
+   SetAtomTableSizes(theEnv,symbolTableSize,floatTableSize,integerTableSize,bitMapTableSize);
+
    /*============================*/
    /* Close the expression file. */
    /*============================*/
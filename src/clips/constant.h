@@ -167,6 +167,8 @@
 #define FACT_PN_CONSTANT2              61
 #define FACT_STORE_MULTIFIELD          62
 #define DEFTEMPLATE_PTR                63
+#define FACT_PN_NUMBER1                64
+#define FACT_PN_NUMBER2                65
 
 #define OBJ_GET_SLOT_PNVAR1            70
 #define OBJ_GET_SLOT_PNVAR2            71
@@ -267,7 +267,7 @@ globle int EnvSave(
          /* that don't import anything first and then work back from those. */
          /*=================================================================*/
          
-         if (defmodulePtr->visitedFlag)
+         if (DefmoduleVisitedFlag(theEnv,defmodulePtr))
            { /* Module has already been saved. */ }
          else if (AllImportedModulesVisited(theEnv,defmodulePtr))
            {
@@ -279,7 +279,7 @@ globle int EnvSave(
               }
               
             updated = TRUE;
-            defmodulePtr->visitedFlag = TRUE;
+            DefmoduleVisitedFlag(theEnv,defmodulePtr) = TRUE;
            }
          else
            { unvisited = TRUE; }
@@ -606,6 +606,7 @@ globle void EnvClear(
    ConstructData(theEnv)->ClearReadyInProgress = TRUE;
    if ((ConstructData(theEnv)->ClearReadyLocks > 0) ||
        (ConstructData(theEnv)->DanglingConstructs > 0) ||
+       ConstructData(theEnv)->ConstructsFrozen ||
        (ClearReady(theEnv) == FALSE))
      {
       PrintErrorID(theEnv,"CONSTRCT",1,FALSE);
@@ -113,6 +113,7 @@ struct constructData
    int ResetInProgress;
    short ClearReadyLocks;
    int DanglingConstructs;
+   intBool ConstructsFrozen;
 #if (! RUN_TIME) && (! BLOAD_ONLY)
    struct callFunctionItem *ListOfSaveFunctions;
    intBool PrintWhileLoading;
@@ -208,6 +208,20 @@ globle void ReadNeededConstraints(
                    CopyFromBsaveConstraintRecord);
   }
 
+/******************************************************/
+/* SkipNeededConstraints: Moves past the constraints  */
+/*   of the binary image currently being loaded       */
+/*   without reading them.                            */
+/******************************************************/
+globle void SkipNeededConstraints(
+  void *theEnv)
+  {
+   unsigned long int count;
+
+   GenReadBinary(theEnv,(void *) &count,sizeof(unsigned long int));
+   GetSeekCurBinary(theEnv,(long) (count * sizeof(BSAVE_CONSTRAINT_RECORD)));
+  }
+
 /*****************************************************/
 /* CopyFromBsaveConstraintRecord: Copies values to a */
 /*   constraint record from the data structure used  */
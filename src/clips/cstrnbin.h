@@ -55,6 +55,7 @@
    LOCALE void                           WriteNeededConstraints(void *,FILE *);
 #endif
    LOCALE void                           ReadNeededConstraints(void *);
+   LOCALE void                           SkipNeededConstraints(void *);
    LOCALE void                           ClearBloadedConstraints(void *);
 
 #endif /* _H_cstrnbin */
@@ -916,11 +916,14 @@ static void CheckDefinstancesBusy(
                    there are no errors)
                  Any previously existing instances
                  are deleted first.
-  NOTES        : None
+  NOTES        : Environments sharing a frozen
+                 binary image can't create
+                 instances, so nothing is done
  ***************************************************/
 static void ResetDefinstances(
   void *theEnv)
   {
+   if (ConstructData(theEnv)->ConstructsFrozen) return;
    DoForAllConstructs(theEnv,ResetDefinstancesAction,DefinstancesData(theEnv)->DefinstancesModuleIndex,TRUE,NULL);
   }
 
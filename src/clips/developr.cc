@@ -126,7 +126,7 @@ globle void PrimitiveTablesInfo(
    /*====================================*/
 
    symbolArray = GetSymbolTable(theEnv);
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < GetSymbolTableSize(theEnv); i++)
      {
       for (symbolPtr = symbolArray[i]; symbolPtr != NULL; symbolPtr = symbolPtr->next)
         { symbolCount++; }
@@ -137,7 +137,7 @@ globle void PrimitiveTablesInfo(
    /*====================================*/
 
    integerArray = GetIntegerTable(theEnv);
-   for (i = 0; i < INTEGER_HASH_SIZE; i++)
+   for (i = 0; i < GetIntegerTableSize(theEnv); i++)
      {
       for (integerPtr = integerArray[i]; integerPtr != NULL; integerPtr = integerPtr->next)
         { integerCount++; }
@@ -148,7 +148,7 @@ globle void PrimitiveTablesInfo(
    /*====================================*/
 
    floatArray = GetFloatTable(theEnv);
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0; i < GetFloatTableSize(theEnv); i++)
      {
       for (floatPtr = floatArray[i]; floatPtr != NULL; floatPtr = floatPtr->next)
         { floatCount++; }
@@ -159,7 +159,7 @@ globle void PrimitiveTablesInfo(
    /*====================================*/
 
    bitMapArray = GetBitMapTable(theEnv);
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < GetBitMapTableSize(theEnv); i++)
      {
       for (bitMapPtr = bitMapArray[i]; bitMapPtr != NULL; bitMapPtr = bitMapPtr->next)
         { bitMapCount++; }
@@ -217,7 +217,7 @@ globle void PrimitiveTablesUsage(
    /*====================================*/
 
    symbolArray = GetSymbolTable(theEnv);
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < GetSymbolTableSize(theEnv); i++)
      {
       symbolCount = 0;
       for (symbolPtr = symbolArray[i]; symbolPtr != NULL; symbolPtr = symbolPtr->next)
@@ -237,7 +237,7 @@ globle void PrimitiveTablesUsage(
    /*===================================*/
    
    floatArray = GetFloatTable(theEnv);
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0; i < GetFloatTableSize(theEnv); i++)
      {
       floatCount = 0;
       for (floatPtr = floatArray[i]; floatPtr != NULL; floatPtr = floatPtr->next)
@@ -323,14 +323,14 @@ globle intBool ValidateFactIntegrity(
          if (theSegment->theFields[i].type == INTEGER)
            {
             theInteger = (INTEGER_HN *) theSegment->theFields[i].value;
-            if (theInteger->count <= 0)
+            if ((! IsImmediateNumber(theInteger)) && (theInteger->count <= 0))
               { return FALSE; }
            }
 
          if (theSegment->theFields[i].type == FLOAT)
            {
             theFloat = (FLOAT_HN *) theSegment->theFields[i].value;
-            if (theFloat->count <= 0)
+            if ((! IsImmediateNumber(theFloat)) && (theFloat->count <= 0))
               { return FALSE; }
            }
         }
@@ -603,14 +603,14 @@ static void TraverseBetaMemories(
      { TraverseBetaMemories(theEnv,theJoin->lastLevel); }
      
    if (theJoin->depth > 2)
-     { ExamineMemory(theEnv,theJoin,theJoin->leftMemory); }
+     { ExamineMemory(theEnv,theJoin,JoinLeftMemory(theEnv,theJoin)); }
    
    if (theJoin->joinFromTheRight)
      { TraverseBetaMemories(theEnv,(struct joinNode *) theJoin->rightSideEntryStructure); }
 
    if ((theJoin->joinFromTheRight) &&
        (((struct joinNode *) (theJoin->rightSideEntryStructure))->depth > 1))
-     { ExamineMemory(theEnv,theJoin,theJoin->rightMemory); }
+     { ExamineMemory(theEnv,theJoin,JoinRightMemory(theEnv,theJoin)); }
   }
 
 /***********************************/  
@@ -59,6 +59,7 @@
 #include "cstrccom.h"
 #include "factrhs.h"
 #include "tmpltdef.h"
+#include "engine.h"
 #include "cstrcpsr.h"
 #include "dffctpsr.h"
 #include "dffctdef.h"
@@ -119,6 +120,13 @@ globle void DeffactsBasicCommands(
 static void ResetDeffacts(
   void *theEnv)
   { 
+   /*===================================================*/
+   /* The facts of the deffacts are kept by a reset     */
+   /* keeping the static facts (see EnvSetStaticFacts). */
+   /*===================================================*/
+
+   if (EngineData(theEnv)->StaticResetInProgress) return;
+
    DoForAllConstructs(theEnv,ResetDeffactsAction,DeffactsData(theEnv)->DeffactsModuleIndex,TRUE,NULL); 
   }
 
@@ -52,6 +52,7 @@
 #include "dffctpsr.h"
 #include "dffctbsc.h"
 #include "envrnmnt.h"
+#include "factmngr.h"
 
 #if BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE
 #include "bload.h"
@@ -284,6 +285,8 @@ static void ReturnDeffacts(
 
    if (theDeffacts == NULL) return;
 
+   InvalidateStaticFacts(theEnv);
+
    ExpressionDeinstall(theEnv,theDeffacts->assertList);
    ReturnPackedExpression(theEnv,theDeffacts->assertList);
 
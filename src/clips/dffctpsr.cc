@@ -43,6 +43,7 @@
 #include "router.h"
 #include "cstrcpsr.h"
 #include "factrhs.h"
+#include "factmngr.h"
 #if BLOAD || BLOAD_AND_BSAVE
 #include "bload.h"
 #endif
@@ -159,6 +160,13 @@ globle int ParseDeffacts(
 
    AddConstructToModule(&newDeffacts->header);
 
+   /*====================================================*/
+   /* The static facts no longer match the deffacts, the */
+   /* next reset needs to assert the facts again.        */
+   /*====================================================*/
+
+   InvalidateStaticFacts(theEnv);
+
 #endif /* (! RUN_TIME) && (! BLOAD_ONLY) */
 
    /*================================================================*/
@@ -122,12 +122,14 @@ globle void CallDeffunction(
    previouslyExecutingDeffunction = DeffunctionData(theEnv)->ExecutingDeffunction;
    DeffunctionData(theEnv)->ExecutingDeffunction = dptr;
    EvaluationData(theEnv)->CurrentEvaluationDepth++;
-   dptr->executing++;
+   if (! ConstructData(theEnv)->ConstructsFrozen)
+     dptr->executing++;
    PushProcParameters(theEnv,args,CountArguments(args),EnvGetDeffunctionName(theEnv,(void *) dptr),
                       "deffunction",UnboundDeffunctionErr);
    if (EvaluationData(theEnv)->EvaluationError)
      {
-      dptr->executing--;
+      if (! ConstructData(theEnv)->ConstructsFrozen)
+        dptr->executing--;
       DeffunctionData(theEnv)->ExecutingDeffunction = previouslyExecutingDeffunction;
       EvaluationData(theEnv)->CurrentEvaluationDepth--;
       
@@ -163,7 +165,8 @@ globle void CallDeffunction(
 #endif
    ProcedureFunctionData(theEnv)->ReturnFlag = FALSE;
 
-   dptr->executing--;
+   if (! ConstructData(theEnv)->ConstructsFrozen)
+     dptr->executing--;
    PopProcParameters(theEnv);
    DeffunctionData(theEnv)->ExecutingDeffunction = previouslyExecutingDeffunction;
    EvaluationData(theEnv)->CurrentEvaluationDepth--;
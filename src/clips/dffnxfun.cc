@@ -714,7 +714,8 @@ static void DecrementDeffunctionBusyCount(
       deleted - thus, it is important not to modify
       the busy flag during a clear.
       ============================================== */
-   if (! ConstructData(theEnv)->ClearInProgress)
+   if ((! ConstructData(theEnv)->ClearInProgress) &&
+       (! ConstructData(theEnv)->ConstructsFrozen))
      ((DEFFUNCTION *) value)->busy--;
   }
 
@@ -731,15 +732,13 @@ static void IncrementDeffunctionBusyCount(
   void *theEnv,
   void *value)
   {
-#if MAC_XCD
-#pragma unused(theEnv)
-#endif
 #if (! RUN_TIME) && (! BLOAD_ONLY)
    if (! ConstructData(theEnv)->ParsingConstruct)
      { ConstructData(theEnv)->DanglingConstructs++; }
 #endif
 
-   ((DEFFUNCTION *) value)->busy++;
+   if (! ConstructData(theEnv)->ConstructsFrozen)
+     ((DEFFUNCTION *) value)->busy++;
   }
 
 #if ! RUN_TIME
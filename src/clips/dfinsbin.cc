@@ -37,6 +37,7 @@
 #include "bsave.h"
 #include "envrnmnt.h"
 #include "memalloc.h"
+#include "classfun.h"
 #include "cstrcbin.h"
 #include "defins.h"
 #include "modulbin.h"
@@ -88,6 +89,7 @@ static void UpdateDefinstancesModule(void *,void *,long);
 static void UpdateDefinstances(void *,void *,long);
 static void ClearDefinstancesBload(void *);
 static void DeallocateDefinstancesBinaryData(void *);
+static int DefinstancesFreezeReady(void *);
 
 /* =========================================
    *****************************************
@@ -118,6 +120,7 @@ globle void SetupDefinstancesBload(
                              BloadStorageDefinstances,BloadDefinstances,
                              ClearDefinstancesBload);
 #endif
+   AddFreezeBloadReadyFunction(theEnv,"definstances",DefinstancesFreezeReady,0);
   }
   
 /*************************************************************/
@@ -138,6 +141,34 @@ static void DeallocateDefinstancesBinaryData(
 #endif
   }
 
+/***************************************************
+  NAME         : DefinstancesFreezeReady
+  DESCRIPTION  : Determines if a binary image can
+                 be shared by other environments
+  INPUTS       : None
+  RETURNS      : TRUE if the only definstances is
+                 initial-object, FALSE otherwise
+  SIDE EFFECTS : None
+  NOTES        : Environments sharing the image
+                 can't create instances
+ ***************************************************/
+static int DefinstancesFreezeReady(
+  void *theEnv)
+  {
+   long i;
+
+   for (i = 0L ; i < DefinstancesBinaryData(theEnv)->DefinstancesCount ; i++)
+     {
+#if DEFRULE_CONSTRUCT
+      if (DefinstancesBinaryData(theEnv)->DefinstancesArray[i].header.name ==
+          DefclassData(theEnv)->INITIAL_OBJECT_SYMBOL)
+        continue;
+#endif
+      return(FALSE);
+     }
+   return(TRUE);
+  }
+
 /***************************************************
   NAME         : BloadDefinstancesModuleRef
   DESCRIPTION  : Returns a pointer to the
@@ -51,8 +51,10 @@
 #include "constant.h"
 #include "engine.h"
 #include "envrnmnt.h"
+#include "exprcode.h"
 #include "memalloc.h"
 #include "prntutil.h"
+#include "rangeidx.h"
 #include "reteutil.h"
 #include "retract.h"
 #include "router.h"
@@ -86,6 +88,9 @@ globle void NetworkAssert(
    if (EngineData(theEnv)->IncrementalResetInProgress && (join->initialize == FALSE)) return;
 #endif
 
+   if (CountJoinActivity(theEnv))
+     { join->memoryRightActivations++; }
+
    /*==================================================*/
    /* Use a special routine if this is the first join. */
    /*==================================================*/
@@ -121,6 +126,7 @@ globle void NetworkAssertRight(
    struct partialMatch *oldLHSBinds = NULL;
    struct partialMatch *oldRHSBinds = NULL;
    struct joinNode *oldJoin = NULL;
+   struct rangeProbe theProbe;
 
    /*=========================================================*/
    /* If an incremental reset is being performed and the join */
@@ -142,7 +148,19 @@ globle void NetworkAssertRight(
    /* are stored in the left beta memory of the join.     */
    /*=====================================================*/
 
-   lhsBinds = GetLeftBetaMemory(join,rhsBinds->hashValue);
+   lhsBinds = GetLeftBetaMemory(theEnv,join,rhsBinds->hashValue);
+   if (CountJoinActivity(theEnv))
+     { join->memoryProbes++; }
+
+   /*=================================================*/
+   /* Only the partial matches which can satisfy the  */
+   /* range test of the join need to be compared.     */
+   /*=================================================*/
+
+   theProbe.entries = NULL;
+   if ((lhsBinds != NULL) && (join->leftRange != NULL) &&
+       StartRangeProbe(theEnv,join,rhsBinds,RHS,&theProbe))
+     { lhsBinds = (struct partialMatch *) theProbe.entries[0]; }
 
 #if DEVELOPER
    if (lhsBinds != NULL)
@@ -172,8 +190,9 @@ globle void NetworkAssertRight(
 
    while (lhsBinds != NULL)
      {
-      nextBind = lhsBinds->nextInMemory;
-      join->memoryCompares++;
+      nextBind = NextRangeMatch(theProbe,lhsBinds);
+      if (CountJoinActivity(theEnv))
+        { join->memoryCompares++; }
       
       /*===========================================================*/
       /* Initialize some variables pointing to the partial matches */
@@ -183,7 +202,7 @@ globle void NetworkAssertRight(
       if (lhsBinds->hashValue != rhsBinds->hashValue)
         {
 #if DEVELOPER
-         if (join->leftMemory->size == 1)
+         if (JoinLeftMemory(theEnv,join)->size == 1)
            { EngineData(theEnv)->betaHashListSkips++; }
          else
            { EngineData(theEnv)->betaHashHTSkips++; }
@@ -290,6 +309,8 @@ globle void NetworkAssertRight(
       lhsBinds = nextBind;
      }
 
+   EndRangeProbe(theEnv,&theProbe);
+
    /*=========================================*/
    /* Restore the old evaluation environment. */
    /*=========================================*/
@@ -321,6 +342,7 @@ globle void NetworkAssertLeft(
    struct partialMatch *oldLHSBinds = NULL;
    struct partialMatch *oldRHSBinds = NULL;
    struct joinNode *oldJoin = NULL;
+   struct rangeProbe theProbe;
 
    if ((operation == NETWORK_RETRACT) && PartialMatchWillBeDeleted(theEnv,lhsBinds))
      { return; }
@@ -386,10 +408,17 @@ globle void NetworkAssertLeft(
 
    entryHashValue = lhsBinds->hashValue;
    if (join->joinFromTheRight)
-     { rhsBinds = GetRightBetaMemory(join,entryHashValue); }
+     { rhsBinds = GetRightBetaMemory(theEnv,join,entryHashValue); }
    else
      { rhsBinds = GetAlphaMemory(theEnv,(struct patternNodeHeader *) join->rightSideEntryStructure,entryHashValue); }
-       
+   if (CountJoinActivity(theEnv))
+     { join->memoryProbes++; }
+
+   theProbe.entries = NULL;
+   if ((rhsBinds != NULL) && (join->leftRange != NULL) &&
+       StartRangeProbe(theEnv,join,lhsBinds,LHS,&theProbe))
+     { rhsBinds = (struct partialMatch *) theProbe.entries[0]; }
+
 #if DEVELOPER
    if (rhsBinds != NULL)
      { EngineData(theEnv)->leftToRightLoops++; }
@@ -420,11 +449,12 @@ globle void NetworkAssertLeft(
      {
       if ((operation == NETWORK_RETRACT) && PartialMatchWillBeDeleted(theEnv,rhsBinds))
         {
-         rhsBinds = rhsBinds->nextInMemory;
+         rhsBinds = NextRangeMatch(theProbe,rhsBinds);
          continue;
         }
 
-      join->memoryCompares++;
+      if (CountJoinActivity(theEnv))
+        { join->memoryCompares++; }
 
       /*===================================================*/
       /* If the join has no expression associated with it, */
@@ -502,6 +532,7 @@ globle void NetworkAssertLeft(
            { 
             AddBlockedLink(lhsBinds,rhsBinds);
             PPDrive(theEnv,lhsBinds,NULL,join,operation);
+            EndRangeProbe(theEnv,&theProbe);
             EngineData(theEnv)->GlobalLHSBinds = oldLHSBinds;
             EngineData(theEnv)->GlobalRHSBinds = oldRHSBinds;
             EngineData(theEnv)->GlobalJoin = oldJoin;
@@ -530,9 +561,11 @@ globle void NetworkAssertLeft(
       /* Move on to the next partial match. */
       /*====================================*/
 
-      rhsBinds = rhsBinds->nextInMemory;
+      rhsBinds = NextRangeMatch(theProbe,rhsBinds);
      }
 
+   EndRangeProbe(theEnv,&theProbe);
+
    /*==================================================================*/
    /* If a join with an associated not CE or join from the right was   */
    /* entered from the LHS side of the join, and the join expression   */
@@ -596,6 +629,28 @@ globle intBool EvaluateJoinExpression(
 
    if (joinExpr == NULL) return(TRUE);
 
+   /*==================================================*/
+   /* A network test compiled by                       */
+   /* EnvCompileJoinExpressions is evaluated by its    */
+   /* instructions.                                    */
+   /*==================================================*/
+
+   if ((joinPtr != NULL) &&
+       (((joinExpr == joinPtr->networkTest) && (joinPtr->networkCode != NULL)) ||
+        ((joinExpr == joinPtr->secondaryNetworkTest) && (joinPtr->secondaryNetworkCode != NULL))))
+     {
+      if (EvaluateExpressionCode(theEnv,
+                                 (joinExpr == joinPtr->networkTest) ? joinPtr->networkCode :
+                                                                      joinPtr->secondaryNetworkCode,
+                                 &theResult))
+        {
+         JoinNetErrorMessage(theEnv,joinPtr);
+         return(FALSE);
+        }
+
+      return((theResult.value != EnvFalseSymbol(theEnv)) || (theResult.type != SYMBOL));
+     }
+
    /*====================================================*/
    /* Initialize some variables which allow this routine */
    /* to avoid calling the "and" and "or" functions if   */
@@ -834,11 +889,11 @@ globle unsigned long BetaMemoryHashValue(
            break;
              
          case INTEGER:
-            hashValue += (((INTEGER_HN *) theResult.value)->bucket * multiplier);
+            hashValue += (NumberHashValue(theResult.value) * multiplier);
             break;
              
          case FLOAT:
-           hashValue += (((FLOAT_HN *) theResult.value)->bucket * multiplier);
+           hashValue += (NumberHashValue(theResult.value) * multiplier);
            break;
            
           case FACT_ADDRESS:
@@ -1064,7 +1119,7 @@ static void EmptyDrive(
 
    if (join->patternIsNegated || (join->joinFromTheRight && (! join->patternIsExists))) /* reorder to remove patternIsExists test */
      {
-      notParent = join->leftMemory->beta[0];
+      notParent = JoinLeftMemory(theEnv,join)->beta[0];
       if (notParent->marker != NULL)
         { return; }
         
@@ -1089,7 +1144,7 @@ static void EmptyDrive(
   /* TBD reorder */
    if (join->patternIsExists)
      {
-      existsParent = join->leftMemory->beta[0];
+      existsParent = JoinLeftMemory(theEnv,join)->beta[0];
       if (existsParent->marker != NULL)
         { return; }
       AddBlockedLink(existsParent,rhsBinds);
@@ -74,9 +74,11 @@
 #include "agenda.h"
 #include "argacces.h"
 #include "constant.h"
+#include "constrct.h"
 #include "envrnmnt.h"
 #include "factmngr.h"
 #include "inscom.h"
+#include "lazymtch.h"
 #include "memalloc.h"
 #include "modulutl.h"
 #include "prccode.h"
@@ -98,6 +100,8 @@
 
    static struct defmodule       *RemoveFocus(void *,struct defmodule *);
    static void                    DeallocateEngineData(void *);
+   static intBool                 StaticBasis(void *,struct partialMatch *);
+   static struct activation      *FocusActivation(void *);
 
 /*****************************************************************************/
 /* InitializeEngine: Initializes the activations and statistics watch items. */
@@ -342,7 +346,8 @@ globle long long EnvRun(
 
       EvaluationData(theEnv)->CurrentEvaluationDepth++;
       SetEvaluationError(theEnv,FALSE);
-      EngineData(theEnv)->ExecutingRule->executing = TRUE;
+      if (! ConstructData(theEnv)->ConstructsFrozen)
+        { EngineData(theEnv)->ExecutingRule->executing = TRUE; }
 
 #if PROFILING_FUNCTIONS
       StartProfile(theEnv,&profileFrame,
@@ -358,7 +363,8 @@ globle long long EnvRun(
       EndProfile(theEnv,&profileFrame);
 #endif
 
-      EngineData(theEnv)->ExecutingRule->executing = FALSE;
+      if (! ConstructData(theEnv)->ConstructsFrozen)
+        { EngineData(theEnv)->ExecutingRule->executing = FALSE; }
       SetEvaluationError(theEnv,FALSE);
       EvaluationData(theEnv)->CurrentEvaluationDepth--;
       
@@ -411,7 +417,10 @@ globle long long EnvRun(
       /*========================================*/
 
       RemoveTrackedMemory(theEnv,theTM);
-      RemoveActivation(theEnv,theActivation,FALSE,FALSE);
+      if (StaticBasis(theEnv,theBasis))
+        { ParkActivation(theEnv,theActivation); }
+      else
+        { RemoveActivation(theEnv,theActivation,FALSE,FALSE); }
 
       /*======================================*/
       /* Get rid of partial matches discarded */
@@ -684,11 +693,11 @@ globle struct activation *NextActivationToFire(
    /* a focus that has an activation on its agenda is found.    */
    /*===========================================================*/
 
-   theActivation = EngineData(theEnv)->CurrentFocus->theDefruleModule->agenda;
+   theActivation = FocusActivation(theEnv);
    while ((theActivation == NULL) && (EngineData(theEnv)->CurrentFocus != NULL))
      {
       if (EngineData(theEnv)->CurrentFocus != NULL) EnvPopFocus(theEnv);
-      if (EngineData(theEnv)->CurrentFocus != NULL) theActivation = EngineData(theEnv)->CurrentFocus->theDefruleModule->agenda;
+      if (EngineData(theEnv)->CurrentFocus != NULL) theActivation = FocusActivation(theEnv);
      }
 
    /*=========================================*/
@@ -698,6 +707,62 @@ globle struct activation *NextActivationToFire(
    return(theActivation);
   }
 
+/*************************************************************/
+/* FocusActivation: Returns the top activation on the agenda */
+/*   of the current focus, once the deferred matches which   */
+/*   could add activations ahead of it have been sent        */
+/*   through the joins (see EnvSetLazyMatching).             */
+/*************************************************************/
+static struct activation *FocusActivation(
+  void *theEnv)
+  {
+#if DEFTEMPLATE_CONSTRUCT
+   if (LazyMatchesPending(theEnv))
+     { return(EvaluateLazyMatches(theEnv)); }
+#endif
+
+   return(EngineData(theEnv)->CurrentFocus->theDefruleModule->agenda);
+  }
+
+/*****************************************************************/
+/* StaticBasis: Determines if the partial match of an activation */
+/*   which just fired only consists of static facts, and will    */
+/*   outlive the firing, so its activation can be parked for the */
+/*   next reset (see EnvSetStaticFacts).                         */
+/*****************************************************************/
+static intBool StaticBasis(
+  void *theEnv,
+  struct partialMatch *theBasis)
+  {
+   struct partialMatch *garbage;
+   struct patternEntity *theMatchingItem;
+   unsigned short i;
+
+   if (! EngineData(theEnv)->StaticBaseValid) return(FALSE);
+
+   /*=================================================*/
+   /* The actions of the rule may have removed the    */
+   /* partial match, e.g. by blocking a not CE of it. */
+   /*=================================================*/
+
+   for (garbage = EngineData(theEnv)->GarbagePartialMatches;
+        garbage != NULL;
+        garbage = garbage->nextInMemory)
+     { if (garbage == theBasis) return(FALSE); }
+
+   for (i = 0; i < theBasis->bcount; i++)
+     {
+      if (theBasis->binds[i].gm.theMatch == NULL) continue;
+      theMatchingItem = theBasis->binds[i].gm.theMatch->matchingItem;
+      if (theMatchingItem == NULL) continue;
+      if ((theMatchingItem->theInfo->isStatic == NULL) ||
+          ((*theMatchingItem->theInfo->isStatic)(theEnv,theMatchingItem) == FALSE))
+        { return(FALSE); }
+     }
+
+   return(TRUE);
+  }
+
 /***************************************************/
 /* RemoveFocus: Removes the first occurence of the */
 /*   specified module from the focus stack.        */
@@ -1061,11 +1126,10 @@ globle void EnvSetBreak(
   void *theEnv,
   void *theRule)
   {
-#if MAC_XCD
-#pragma unused(theEnv)
-#endif
    struct defrule *thePtr;
 
+   if (ConstructData(theEnv)->ConstructsFrozen) return;
+
    for (thePtr = (struct defrule *) theRule;
         thePtr != NULL;
         thePtr = thePtr->disjunct)
@@ -1080,12 +1144,11 @@ globle intBool EnvRemoveBreak(
   void *theEnv,
   void *theRule)
   {
-#if MAC_XCD
-#pragma unused(theEnv)
-#endif
    struct defrule *thePtr;
    int rv = FALSE;
 
+   if (ConstructData(theEnv)->ConstructsFrozen) return(FALSE);
+
    for (thePtr = (struct defrule *) theRule;
         thePtr != NULL;
         thePtr = thePtr->disjunct)
@@ -106,6 +106,9 @@ struct engineData
 #endif
    intBool IncrementalResetInProgress;
    intBool IncrementalResetFlag;
+   intBool StaticBaseValid;
+   intBool StaticResetInProgress;
+   intBool JoinNetworkFlushed;
    intBool JoinOperationInProgress;
    struct partialMatch *GlobalLHSBinds;
    struct partialMatch *GlobalRHSBinds;
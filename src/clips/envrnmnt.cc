@@ -54,6 +54,8 @@
 
 #include "setup.h"
 
+#include "bload.h"
+#include "constrct.h"
 #include "memalloc.h"
 #include "prntutil.h"
 #include "router.h"
@@ -78,7 +80,7 @@
    static void                    RemoveEnvironmentCleanupFunctions(struct environmentData *);
    static void                   *CreateEnvironmentDriver(struct symbolHashNode **,struct floatHashNode **,
                                                           struct integerHashNode **,struct bitMapHashNode **,
-                                                          struct externalAddressHashNode **);
+                                                          struct externalAddressHashNode **,void *);
 
 /***************************************/
 /* LOCAL INTERNAL VARIABLE DEFINITIONS */
@@ -301,9 +303,41 @@ static struct environmentData *FindEnvironment(
 /************************************************************/
 globle void *CreateEnvironment()
   {
-   return CreateEnvironmentDriver(NULL,NULL,NULL,NULL,NULL);
+   return CreateEnvironmentDriver(NULL,NULL,NULL,NULL,NULL,NULL);
   }
 
+#if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
+
+/************************************************************/
+/* CreateSharedEnvironment: Creates an environment running  */
+/*   the binary image of a frozen environment (see          */
+/*   EnvFreezeBload). The atoms and constructs of the image */
+/*   are shared rather than copied, so the new environment  */
+/*   only holds its own facts, agenda, and match memories.  */
+/*   The frozen environment must outlive it.                */
+/************************************************************/
+globle void *CreateSharedEnvironment(
+  void *frozenEnv)
+  {
+   void *theEnv;
+
+   if (! ConstructData(frozenEnv)->ConstructsFrozen)
+     { return(NULL); }
+
+   theEnv = CreateEnvironmentDriver(NULL,NULL,NULL,NULL,NULL,frozenEnv);
+   if (theEnv == NULL) return(NULL);
+
+   if (! EnvShareBload(theEnv,frozenEnv))
+     {
+      DestroyEnvironment(theEnv);
+      return(NULL);
+     }
+
+   return(theEnv);
+  }
+
+#endif
+
 /**********************************************************/
 /* CreateRuntimeEnvironment: Creates an environment data  */
 /*   structure and initializes its content to zero/null.  */
@@ -314,7 +348,7 @@ globle void *CreateRuntimeEnvironment(
   struct integerHashNode **integerTable,
   struct bitMapHashNode **bitmapTable)
   {
-   return CreateEnvironmentDriver(symbolTable,floatTable,integerTable,bitmapTable,NULL);
+   return CreateEnvironmentDriver(symbolTable,floatTable,integerTable,bitmapTable,NULL,NULL);
   }
   
 /*********************************************************/
@@ -326,7 +360,8 @@ globle void *CreateEnvironmentDriver(
   struct floatHashNode **floatTable,
   struct integerHashNode **integerTable,
   struct bitMapHashNode **bitmapTable,
-  struct externalAddressHashNode **externalAddressTable)
+  struct externalAddressHashNode **externalAddressTable,
+  void *sharedEnv)
   {
    struct environmentData *theEnvironment;
    void *theData;
@@ -386,7 +421,7 @@ globle void *CreateEnvironmentDriver(
    CurrentEnvironment = theEnvironment;
 #endif
 
-   EnvInitializeEnvironment(theEnvironment,symbolTable,floatTable,integerTable,bitmapTable,externalAddressTable);
+   EnvInitializeEnvironment(theEnvironment,symbolTable,floatTable,integerTable,bitmapTable,externalAddressTable,sharedEnv);
 
    return(theEnvironment);
   }
@@ -99,6 +99,9 @@ typedef struct environmentData * ENVIRONMENT_DATA_PTR;
    LOCALE unsigned long                  GetEnvironmentIndex(void *);
 #endif
    LOCALE void                          *CreateEnvironment(void);
+#if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
+   LOCALE void                          *CreateSharedEnvironment(void *);
+#endif
    LOCALE void                          *CreateRuntimeEnvironment(struct symbolHashNode **,struct floatHashNode **,
                                                                   struct integerHashNode **,struct bitMapHashNode **);
    LOCALE intBool                        DestroyEnvironment(void *);
@@ -138,34 +138,34 @@ typedef struct entityRecord * ENTITY_RECORD_PTR;
 #define EnvSetpDOEnd(theEnv,target,val)     ((target)->end = (long) ((val) - 1))
 
 #define DOPToString(target) (((struct symbolHashNode *) ((target)->value))->contents)
-#define DOPToDouble(target) (((struct floatHashNode *) ((target)->value))->contents)
-#define DOPToFloat(target) ((float) (((struct floatHashNode *) ((target)->value))->contents))
-#define DOPToLong(target) (((struct integerHashNode *) ((target)->value))->contents)
-#define DOPToInteger(target) ((int) (((struct integerHashNode *) ((target)->value))->contents))
+#define DOPToDouble(target) ValueToDouble((target)->value)
+#define DOPToFloat(target) ((float) ValueToDouble((target)->value))
+#define DOPToLong(target) ValueToLong((target)->value)
+#define DOPToInteger(target) ((int) ValueToLong((target)->value))
 #define DOPToPointer(target)       ((target)->value)
 #define DOPToExternalAddress(target) (((struct externalAddressHashNode *) ((target)->value))->externalAddress)
 
 #define EnvDOPToString(theEnv,target) (((struct symbolHashNode *) ((target)->value))->contents)
-#define EnvDOPToDouble(theEnv,target) (((struct floatHashNode *) ((target)->value))->contents)
-#define EnvDOPToFloat(theEnv,target) ((float) (((struct floatHashNode *) ((target)->value))->contents))
-#define EnvDOPToLong(theEnv,target) (((struct integerHashNode *) ((target)->value))->contents)
-#define EnvDOPToInteger(theEnv,target) ((int) (((struct integerHashNode *) ((target)->value))->contents))
+#define EnvDOPToDouble(theEnv,target) ValueToDouble((target)->value)
+#define EnvDOPToFloat(theEnv,target) ((float) ValueToDouble((target)->value))
+#define EnvDOPToLong(theEnv,target) ValueToLong((target)->value)
+#define EnvDOPToInteger(theEnv,target) ((int) ValueToLong((target)->value))
 #define EnvDOPToPointer(theEnv,target)       ((target)->value)
 #define EnvDOPToExternalAddress(target) (((struct externalAddressHashNode *) ((target)->value))->externalAddress)
 
 #define DOToString(target) (((struct symbolHashNode *) ((target).value))->contents)
-#define DOToDouble(target) (((struct floatHashNode *) ((target).value))->contents)
-#define DOToFloat(target) ((float) (((struct floatHashNode *) ((target).value))->contents))
-#define DOToLong(target) (((struct integerHashNode *) ((target).value))->contents)
-#define DOToInteger(target) ((int) (((struct integerHashNode *) ((target).value))->contents))
+#define DOToDouble(target) ValueToDouble((target).value)
+#define DOToFloat(target) ((float) ValueToDouble((target).value))
+#define DOToLong(target) ValueToLong((target).value)
+#define DOToInteger(target) ((int) ValueToLong((target).value))
 #define DOToPointer(target)        ((target).value)
 #define DOToExternalAddress(target) (((struct externalAddressHashNode *) ((target).value))->externalAddress)
 
 #define EnvDOToString(theEnv,target) (((struct symbolHashNode *) ((target).value))->contents)
-#define EnvDOToDouble(theEnv,target) (((struct floatHashNode *) ((target).value))->contents)
-#define EnvDOToFloat(theEnv,target) ((float) (((struct floatHashNode *) ((target).value))->contents))
-#define EnvDOToLong(theEnv,target) (((struct integerHashNode *) ((target).value))->contents)
-#define EnvDOToInteger(theEnv,target) ((int) (((struct integerHashNode *) ((target).value))->contents))
+#define EnvDOToDouble(theEnv,target) ValueToDouble((target).value)
+#define EnvDOToFloat(theEnv,target) ((float) ValueToDouble((target).value))
+#define EnvDOToLong(theEnv,target) ValueToLong((target).value)
+#define EnvDOToInteger(theEnv,target) ((int) ValueToLong((target).value))
 #define EnvDOToPointer(theEnv,target)        ((target).value)
 #define EnvDOToExternalAddress(target) (((struct externalAddressHashNode *) ((target).value))->externalAddress)
 
@@ -0,0 +1,831 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.30  08/16/14            */
+   /*                                                     */
+   /*               EXPRESSION CODE MODULE                */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Compiles expressions into a flat sequence of     */
+/*   instructions working on a small set of registers. The   */
+/*   numeric comparisons, arithmetic, eq, neq, not, and and  */
+/*   or functions are carried out by the instructions        */
+/*   themselves rather than by calls to their functions      */
+/*   evaluating their arguments one at a time. Join network  */
+/*   tests are compiled by EnvCompileJoinExpressions, other  */
+/*   expressions (RHS actions, deffunction bodies) are not.  */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#define _EXPRCODE_SOURCE_
+
+#include <stdio.h>
+#define _STDIO_INCLUDED_
+#include <string.h>
+
+#include "setup.h"
+
+#include "constant.h"
+#include "constrct.h"
+#include "envrnmnt.h"
+#include "evaluatn.h"
+#include "extnfunc.h"
+#include "memalloc.h"
+#include "multifld.h"
+#include "symbol.h"
+
+#if DEFRULE_CONSTRUCT
+#include "moduldef.h"
+#include "ruledef.h"
+#endif
+
+#include "exprcode.h"
+
+#define PENDING_JUMP 0xFFFF
+
+/*=====================================================*/
+/* The instructions of an expression being compiled.   */
+/* An expression is only worth compiling if at least   */
+/* one of its functions is carried out by instruction. */
+/*=====================================================*/
+
+struct codeBuffer
+  {
+   struct exprInstruction *instructions;
+   unsigned short length;
+   unsigned short size;
+   unsigned short specialized;
+   intBool failed;
+  };
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                    CompileNode(void *,struct expr *,struct codeBuffer *,unsigned short,int);
+   static void                    CompileJunction(void *,struct expr *,struct codeBuffer *,unsigned short,int,int);
+   static unsigned short          EmitInstruction(void *,struct codeBuffer *,unsigned short,unsigned short,
+                                                  unsigned short,unsigned short,struct expr *);
+   static unsigned short          NumericOperation(struct expr *);
+   static intBool                 NumericOperand(void *,struct expr *);
+   static intBool                 ConstantNode(struct expr *);
+   static intBool                 PrimitiveNode(void *,struct expr *);
+   static intBool                 CompareNumbers(unsigned short,DATA_OBJECT *,DATA_OBJECT *);
+#if DEFRULE_CONSTRUCT
+   static long                    CompileRuleJoins(void *,struct joinNode *);
+#endif
+
+/*****************************************************************/
+/* CompileExpression: Compiles an expression. If truthValue is   */
+/*   TRUE, the expression is evaluated as a join network test,   */
+/*   where a primitive test returns its result rather than       */
+/*   storing it. Returns NULL if the expression is too deep or   */
+/*   calls none of the functions carried out by instructions.    */
+/*****************************************************************/
+globle struct expressionCode *CompileExpression(
+  void *theEnv,
+  struct expr *theExpression,
+  int truthValue)
+  {
+   struct codeBuffer theBuffer;
+   struct expressionCode *theCode = NULL;
+
+   if (theExpression == NULL) return(NULL);
+
+   theBuffer.instructions = NULL;
+   theBuffer.length = 0;
+   theBuffer.size = 0;
+   theBuffer.specialized = 0;
+   theBuffer.failed = FALSE;
+
+   CompileNode(theEnv,theExpression,&theBuffer,0,truthValue);
+
+   if ((! theBuffer.failed) && (theBuffer.specialized != 0))
+     {
+      theCode = get_struct(theEnv,expressionCode);
+      theCode->length = theBuffer.length;
+      theCode->instructions = (struct exprInstruction *)
+                              genalloc(theEnv,sizeof(struct exprInstruction) * theBuffer.length);
+      memcpy(theCode->instructions,theBuffer.instructions,
+             sizeof(struct exprInstruction) * theBuffer.length);
+     }
+
+   if (theBuffer.instructions != NULL)
+     { genfree(theEnv,theBuffer.instructions,sizeof(struct exprInstruction) * theBuffer.size); }
+
+   return(theCode);
+  }
+
+/*****************************************************************/
+/* EvaluateExpressionCode: Evaluates a compiled expression. Like */
+/*   EvaluateExpression, returns TRUE if an error occurred, in   */
+/*   which case the result is FALSE.                             */
+/*****************************************************************/
+globle int EvaluateExpressionCode(
+  void *theEnv,
+  struct expressionCode *theCode,
+  DATA_OBJECT *returnValue)
+  {
+   DATA_OBJECT registers[EXPRESSION_CODE_REGISTERS];
+   struct exprInstruction *theInstruction, *endInstruction;
+   DATA_OBJECT *first, *second, *result;
+   struct expr *oldArgument;
+   void *falseSymbol = EnvFalseSymbol(theEnv);
+   void *trueSymbol = EnvTrueSymbol(theEnv);
+   long long theInteger;
+   double theFloat;
+   int rv;
+
+   theInstruction = theCode->instructions;
+   endInstruction = theInstruction + theCode->length;
+
+   while (theInstruction < endInstruction)
+     {
+      result = &registers[theInstruction->result];
+
+      switch (theInstruction->op)
+        {
+         case CODE_CONSTANT:
+           result->type = theInstruction->theExpression->type;
+           result->value = theInstruction->theExpression->value;
+           break;
+
+         case CODE_PRIMITIVE:
+         case CODE_PRIMITIVE_TEST:
+           oldArgument = EvaluationData(theEnv)->CurrentExpression;
+           EvaluationData(theEnv)->CurrentExpression = theInstruction->theExpression;
+           rv = (*EvaluationData(theEnv)->PrimitivesArray[theInstruction->theExpression->type]->evaluateFunction)
+                   (theEnv,theInstruction->theExpression->value,result);
+           EvaluationData(theEnv)->CurrentExpression = oldArgument;
+
+           if (theInstruction->op == CODE_PRIMITIVE_TEST)
+             {
+              result->type = SYMBOL;
+              result->value = rv ? trueSymbol : falseSymbol;
+             }
+           break;
+
+         case CODE_EVALUATE:
+           EvaluateExpression(theEnv,theInstruction->theExpression,result);
+           break;
+
+         /*=====================================================*/
+         /* The numeric functions are carried out only if their */
+         /* operands are numbers and no error occurred yet.     */
+         /* Otherwise the outermost numeric function call is    */
+         /* evaluated again to report the error the way the     */
+         /* functions do, and the evaluation goes on after it.  */
+         /*=====================================================*/
+
+         case CODE_LESS_THAN:
+         case CODE_LESS_OR_EQUAL:
+         case CODE_GREATER_THAN:
+         case CODE_GREATER_OR_EQUAL:
+         case CODE_NUMBER_EQUAL:
+         case CODE_NUMBER_NOT_EQUAL:
+           first = &registers[theInstruction->first];
+           second = &registers[theInstruction->second];
+
+           if (EvaluationData(theEnv)->EvaluationError ||
+               ((first->type != INTEGER) && (first->type != FLOAT)) ||
+               ((second->type != INTEGER) && (second->type != FLOAT)))
+             {
+              theInstruction = theCode->instructions + theInstruction->fallback;
+              EvaluateExpression(theEnv,theInstruction->theExpression,&registers[theInstruction->result]);
+              break;
+             }
+
+           rv = CompareNumbers(theInstruction->op,first,second);
+
+           result->type = SYMBOL;
+           result->value = rv ? trueSymbol : falseSymbol;
+           break;
+
+         case CODE_ADD:
+         case CODE_SUBTRACT:
+         case CODE_MULTIPLY:
+           first = &registers[theInstruction->first];
+           second = &registers[theInstruction->second];
+
+           if (EvaluationData(theEnv)->EvaluationError ||
+               ((first->type != INTEGER) && (first->type != FLOAT)) ||
+               ((second->type != INTEGER) && (second->type != FLOAT)))
+             {
+              theInstruction = theCode->instructions + theInstruction->fallback;
+              EvaluateExpression(theEnv,theInstruction->theExpression,&registers[theInstruction->result]);
+              break;
+             }
+
+           if ((first->type == INTEGER) && (second->type == INTEGER))
+             {
+              if (theInstruction->op == CODE_ADD)
+                { theInteger = ValueToLong(first->value) + ValueToLong(second->value); }
+              else if (theInstruction->op == CODE_SUBTRACT)
+                { theInteger = ValueToLong(first->value) - ValueToLong(second->value); }
+              else
+                { theInteger = ValueToLong(first->value) * ValueToLong(second->value); }
+
+              result->type = INTEGER;
+              result->value = (void *) EnvAddLong(theEnv,theInteger);
+              break;
+             }
+
+           theFloat = (first->type == INTEGER) ? (double) ValueToLong(first->value) :
+                                                 ValueToDouble(first->value);
+           if (theInstruction->op == CODE_ADD)
+             {
+              theFloat += (second->type == INTEGER) ? (double) ValueToLong(second->value) :
+                                                      ValueToDouble(second->value);
+             }
+           else if (theInstruction->op == CODE_SUBTRACT)
+             {
+              theFloat -= (second->type == INTEGER) ? (double) ValueToLong(second->value) :
+                                                      ValueToDouble(second->value);
+             }
+           else
+             {
+              theFloat *= (second->type == INTEGER) ? (double) ValueToLong(second->value) :
+                                                      ValueToDouble(second->value);
+             }
+
+           result->type = FLOAT;
+           result->value = (void *) EnvAddDouble(theEnv,theFloat);
+           break;
+
+         case CODE_EQ:
+         case CODE_NEQ:
+           first = &registers[theInstruction->first];
+           second = &registers[theInstruction->second];
+
+           if (first->type != second->type)
+             { rv = FALSE; }
+           else if (first->type == MULTIFIELD)
+             { rv = MultifieldDOsEqual(first,second); }
+           else
+             { rv = (first->value == second->value); }
+
+           if (theInstruction->op == CODE_NEQ) rv = ! rv;
+
+           result->type = SYMBOL;
+           result->value = rv ? trueSymbol : falseSymbol;
+           break;
+
+         case CODE_NOT:
+           first = &registers[theInstruction->first];
+           rv = ((first->value == falseSymbol) && (first->type == SYMBOL) &&
+                 (! EvaluationData(theEnv)->EvaluationError));
+
+           result->type = SYMBOL;
+           result->value = rv ? trueSymbol : falseSymbol;
+           break;
+
+         /*=====================================================*/
+         /* An error stops the evaluation of a network test, as */
+         /* EvaluateJoinExpression does. An and (or an or)      */
+         /* function call evaluated for its value is FALSE.     */
+         /*=====================================================*/
+
+         case CODE_JUMP_IF_FALSE:
+         case CODE_JUMP_IF_TRUE:
+           if (EvaluationData(theEnv)->EvaluationError)
+             {
+              if (theInstruction->first)
+                {
+                 returnValue->type = SYMBOL;
+                 returnValue->value = falseSymbol;
+                 return(TRUE);
+                }
+
+              result->type = SYMBOL;
+              result->value = falseSymbol;
+              theInstruction = theCode->instructions + theInstruction->second;
+              continue;
+             }
+
+           if ((result->value == falseSymbol) && (result->type == SYMBOL))
+             { rv = FALSE; }
+           else
+             { rv = TRUE; }
+
+           if ((theInstruction->op == CODE_JUMP_IF_FALSE) && (! rv))
+             {
+              theInstruction = theCode->instructions + theInstruction->second;
+              continue;
+             }
+
+           if ((theInstruction->op == CODE_JUMP_IF_TRUE) && rv)
+             {
+              result->type = SYMBOL;
+              result->value = trueSymbol;
+              theInstruction = theCode->instructions + theInstruction->second;
+              continue;
+             }
+           break;
+
+         case CODE_TRUE:
+           result->type = SYMBOL;
+           result->value = trueSymbol;
+           break;
+        }
+
+      theInstruction++;
+     }
+
+   if (EvaluationData(theEnv)->EvaluationError)
+     {
+      returnValue->type = SYMBOL;
+      returnValue->value = falseSymbol;
+      return(TRUE);
+     }
+
+   *returnValue = registers[0];
+   return(FALSE);
+  }
+
+/*************************************************************/
+/* ReturnExpressionCode: Returns a compiled expression. The  */
+/*   expression it was compiled from isn't affected.         */
+/*************************************************************/
+globle void ReturnExpressionCode(
+  void *theEnv,
+  struct expressionCode *theCode)
+  {
+   if (theCode == NULL) return;
+
+   genfree(theEnv,theCode->instructions,sizeof(struct exprInstruction) * theCode->length);
+   rtn_struct(theEnv,expressionCode,theCode);
+  }
+
+#if DEFRULE_CONSTRUCT
+
+/******************************************************************/
+/* EnvCompileJoinExpressions: Compiles the network tests of the   */
+/*   joins of every rule which haven't been compiled yet. Meant   */
+/*   to be called once the rules are loaded, before the           */
+/*   constructs of a binary image are frozen. Only the LHS tests  */
+/*   are compiled: RHS actions and deffunction bodies are still   */
+/*   evaluated by EvaluateExpression, and operand types are       */
+/*   checked at run time rather than taken from slot constraints. */
+/*   Returns the number of tests compiled.                        */
+/******************************************************************/
+globle long EnvCompileJoinExpressions(
+  void *theEnv)
+  {
+   struct defmodule *theModule;
+   struct defrule *theRule, *theDisjunct;
+   long count = 0;
+
+   if (ConstructData(theEnv)->ConstructsFrozen)
+     { return(0); }
+
+   SaveCurrentModule(theEnv);
+
+   for (theModule = (struct defmodule *) EnvGetNextDefmodule(theEnv,NULL);
+        theModule != NULL;
+        theModule = (struct defmodule *) EnvGetNextDefmodule(theEnv,theModule))
+     {
+      EnvSetCurrentModule(theEnv,(void *) theModule);
+
+      for (theRule = (struct defrule *) EnvGetNextDefrule(theEnv,NULL);
+           theRule != NULL;
+           theRule = (struct defrule *) EnvGetNextDefrule(theEnv,theRule))
+        {
+         for (theDisjunct = theRule; theDisjunct != NULL; theDisjunct = theDisjunct->disjunct)
+           { count += CompileRuleJoins(theEnv,theDisjunct->lastJoin); }
+        }
+     }
+
+   RestoreCurrentModule(theEnv);
+
+   return(count);
+  }
+
+/****************************************************************/
+/* ReturnJoinExpressionCode: Returns the compiled network tests */
+/*   of a join when the join is removed.                        */
+/****************************************************************/
+globle void ReturnJoinExpressionCode(
+  void *theEnv,
+  struct joinNode *theJoin)
+  {
+   ReturnExpressionCode(theEnv,theJoin->networkCode);
+   ReturnExpressionCode(theEnv,theJoin->secondaryNetworkCode);
+   theJoin->networkCode = NULL;
+   theJoin->secondaryNetworkCode = NULL;
+  }
+
+/*****************************************************************/
+/* CompileRuleJoins: Compiles the network tests of the joins of  */
+/*   a rule, including the joins entering them from the right.   */
+/*   A join shared by several rules is only compiled once. A     */
+/*   test continuing with further expressions (nextArg) is left  */
+/*   to EvaluateJoinExpression.                                  */
+/*****************************************************************/
+static long CompileRuleJoins(
+  void *theEnv,
+  struct joinNode *theJoin)
+  {
+   long count = 0;
+
+   for (; theJoin != NULL; theJoin = theJoin->lastLevel)
+     {
+      if (theJoin->joinFromTheRight)
+        { count += CompileRuleJoins(theEnv,(struct joinNode *) theJoin->rightSideEntryStructure); }
+
+      if ((theJoin->networkCode == NULL) &&
+          (theJoin->networkTest != NULL) &&
+          (theJoin->networkTest->nextArg == NULL))
+        {
+         theJoin->networkCode = CompileExpression(theEnv,theJoin->networkTest,TRUE);
+         if (theJoin->networkCode != NULL) count++;
+        }
+
+      if ((theJoin->secondaryNetworkCode == NULL) &&
+          (theJoin->secondaryNetworkTest != NULL) &&
+          (theJoin->secondaryNetworkTest->nextArg == NULL))
+        {
+         theJoin->secondaryNetworkCode = CompileExpression(theEnv,theJoin->secondaryNetworkTest,TRUE);
+         if (theJoin->secondaryNetworkCode != NULL) count++;
+        }
+     }
+
+   return(count);
+  }
+
+#endif /* DEFRULE_CONSTRUCT */
+
+/******************************************************************/
+/* CompileNode: Emits the instructions storing the value of an    */
+/*   expression in the target register. The registers above the  */
+/*   target hold the operands of a function carried out by       */
+/*   instruction. Any other expression is left to                */
+/*   EvaluateExpression.                                         */
+/******************************************************************/
+static void CompileNode(
+  void *theEnv,
+  struct expr *theExpression,
+  struct codeBuffer *theBuffer,
+  unsigned short target,
+  int truthValue)
+  {
+   unsigned short op, start, position, i;
+
+   if (theBuffer->failed) return;
+
+   if ((target + 1) >= EXPRESSION_CODE_REGISTERS)
+     {
+      theBuffer->failed = TRUE;
+      return;
+     }
+
+   if (ConstantNode(theExpression))
+     {
+      EmitInstruction(theEnv,theBuffer,CODE_CONSTANT,target,0,0,theExpression);
+      return;
+     }
+
+   if (PrimitiveNode(theEnv,theExpression))
+     {
+      EmitInstruction(theEnv,theBuffer,(unsigned short) (truthValue ? CODE_PRIMITIVE_TEST : CODE_PRIMITIVE),
+                      target,0,0,theExpression);
+      return;
+     }
+
+   if (theExpression->type != FCALL)
+     {
+      EmitInstruction(theEnv,theBuffer,CODE_EVALUATE,target,0,0,theExpression);
+      return;
+     }
+
+   /*===========================================================*/
+   /* The arguments of and and or are tested the same way as    */
+   /* the junction itself, as EvaluateJoinExpression does.      */
+   /*===========================================================*/
+
+   if (theExpression->value == ExpressionData(theEnv)->PTR_AND)
+     {
+      CompileJunction(theEnv,theExpression->argList,theBuffer,target,truthValue,TRUE);
+      return;
+     }
+
+   if (theExpression->value == ExpressionData(theEnv)->PTR_OR)
+     {
+      CompileJunction(theEnv,theExpression->argList,theBuffer,target,truthValue,FALSE);
+      return;
+     }
+
+   if ((theExpression->value == ExpressionData(theEnv)->PTR_NOT) &&
+       (theExpression->argList != NULL) &&
+       (theExpression->argList->nextArg == NULL))
+     {
+      CompileNode(theEnv,theExpression->argList,theBuffer,target,FALSE);
+      EmitInstruction(theEnv,theBuffer,CODE_NOT,target,target,0,theExpression);
+      theBuffer->specialized++;
+      return;
+     }
+
+   if (((theExpression->value == ExpressionData(theEnv)->PTR_EQ) ||
+        (theExpression->value == ExpressionData(theEnv)->PTR_NEQ)) &&
+       (theExpression->argList != NULL) &&
+       (theExpression->argList->nextArg != NULL) &&
+       (theExpression->argList->nextArg->nextArg == NULL))
+     {
+      CompileNode(theEnv,theExpression->argList,theBuffer,target,FALSE);
+      CompileNode(theEnv,theExpression->argList->nextArg,theBuffer,(unsigned short) (target + 1),FALSE);
+      op = (theExpression->value == ExpressionData(theEnv)->PTR_EQ) ? CODE_EQ : CODE_NEQ;
+      EmitInstruction(theEnv,theBuffer,op,target,target,(unsigned short) (target + 1),theExpression);
+      theBuffer->specialized++;
+      return;
+     }
+
+   /*=======================================================*/
+   /* The operands of a numeric function must be evaluated  */
+   /* again to report one which isn't a number, so they     */
+   /* can only be constants, variables and other numeric    */
+   /* functions.                                            */
+   /*=======================================================*/
+
+   op = NumericOperation(theExpression);
+   if ((op != CODE_EVALUATE) &&
+       NumericOperand(theEnv,theExpression->argList) &&
+       NumericOperand(theEnv,theExpression->argList->nextArg))
+     {
+      start = theBuffer->length;
+      CompileNode(theEnv,theExpression->argList,theBuffer,target,FALSE);
+      CompileNode(theEnv,theExpression->argList->nextArg,theBuffer,(unsigned short) (target + 1),FALSE);
+      position = EmitInstruction(theEnv,theBuffer,op,target,target,(unsigned short) (target + 1),theExpression);
+      theBuffer->specialized++;
+
+      if (theBuffer->failed) return;
+
+      /*==================================================*/
+      /* The numeric functions nested in this one fall    */
+      /* back to evaluating this one, until it's nested   */
+      /* in another one.                                  */
+      /*==================================================*/
+
+      for (i = start; i < position; i++)
+        { theBuffer->instructions[i].fallback = position; }
+      return;
+     }
+
+   EmitInstruction(theEnv,theBuffer,CODE_EVALUATE,target,0,0,theExpression);
+  }
+
+/*****************************************************************/
+/* CompileJunction: Emits the instructions for the arguments of  */
+/*   an and (or an or) function call. Each argument is followed  */
+/*   by a jump to the end of the junction if it decides it. The  */
+/*   jumps are patched once the end is known.                    */
+/*****************************************************************/
+static void CompileJunction(
+  void *theEnv,
+  struct expr *theArgument,
+  struct codeBuffer *theBuffer,
+  unsigned short target,
+  int truthValue,
+  int andJunction)
+  {
+   unsigned short start, i;
+
+   start = theBuffer->length;
+
+   for (; theArgument != NULL; theArgument = theArgument->nextArg)
+     {
+      CompileNode(theEnv,theArgument,theBuffer,target,truthValue);
+      EmitInstruction(theEnv,theBuffer,(unsigned short) (andJunction ? CODE_JUMP_IF_FALSE : CODE_JUMP_IF_TRUE),
+                      target,(unsigned short) (truthValue ? TRUE : FALSE),PENDING_JUMP,NULL);
+     }
+
+   /*=====================================================*/
+   /* An and function reaching its end is TRUE. An or     */
+   /* function reaching its end is FALSE, the value of    */
+   /* its last argument, unless it had no argument.       */
+   /*=====================================================*/
+
+   if (andJunction)
+     { EmitInstruction(theEnv,theBuffer,CODE_TRUE,target,0,0,NULL); }
+   else if (start == theBuffer->length)
+     {
+      EmitInstruction(theEnv,theBuffer,CODE_TRUE,target,0,0,NULL);
+      EmitInstruction(theEnv,theBuffer,CODE_NOT,target,target,0,NULL);
+     }
+
+   if (theBuffer->failed) return;
+
+   for (i = start; i < theBuffer->length; i++)
+     {
+      if (((theBuffer->instructions[i].op == CODE_JUMP_IF_FALSE) ||
+           (theBuffer->instructions[i].op == CODE_JUMP_IF_TRUE)) &&
+          (theBuffer->instructions[i].second == PENDING_JUMP))
+        { theBuffer->instructions[i].second = theBuffer->length; }
+     }
+
+   theBuffer->specialized++;
+  }
+
+/*************************************************************/
+/* EmitInstruction: Adds an instruction to the instructions  */
+/*   being compiled, doubling the space for them when full.  */
+/*************************************************************/
+static unsigned short EmitInstruction(
+  void *theEnv,
+  struct codeBuffer *theBuffer,
+  unsigned short op,
+  unsigned short result,
+  unsigned short first,
+  unsigned short second,
+  struct expr *theExpression)
+  {
+   struct exprInstruction *newInstructions, *theInstruction;
+   unsigned short newSize;
+
+   if (theBuffer->failed) return(0);
+
+   if (theBuffer->length == theBuffer->size)
+     {
+      if (theBuffer->size >= (PENDING_JUMP / 2))
+        {
+         theBuffer->failed = TRUE;
+         return(0);
+        }
+
+      newSize = (unsigned short) ((theBuffer->size == 0) ? 16 : (theBuffer->size * 2));
+      newInstructions = (struct exprInstruction *)
+                        genalloc(theEnv,sizeof(struct exprInstruction) * newSize);
+      if (theBuffer->instructions != NULL)
+        {
+         memcpy(newInstructions,theBuffer->instructions,
+                sizeof(struct exprInstruction) * theBuffer->length);
+         genfree(theEnv,theBuffer->instructions,sizeof(struct exprInstruction) * theBuffer->size);
+        }
+      theBuffer->instructions = newInstructions;
+      theBuffer->size = newSize;
+     }
+
+   theInstruction = &theBuffer->instructions[theBuffer->length];
+   theInstruction->op = op;
+   theInstruction->result = result;
+   theInstruction->first = first;
+   theInstruction->second = second;
+   theInstruction->fallback = theBuffer->length;
+   theInstruction->theExpression = theExpression;
+
+   return(theBuffer->length++);
+  }
+
+/*************************************************************/
+/* NumericOperation: Returns the instruction carrying out a  */
+/*   numeric function call of two arguments, or              */
+/*   CODE_EVALUATE if there is none.                         */
+/*************************************************************/
+static unsigned short NumericOperation(
+  struct expr *theExpression)
+  {
+   const char *name;
+
+   if ((theExpression->type != FCALL) ||
+       (theExpression->argList == NULL) ||
+       (theExpression->argList->nextArg == NULL) ||
+       (theExpression->argList->nextArg->nextArg != NULL))
+     { return(CODE_EVALUATE); }
+
+   name = ValueToString(ExpressionFunctionCallName(theExpression));
+
+   if (strcmp(name,"<") == 0) return(CODE_LESS_THAN);
+   if (strcmp(name,"<=") == 0) return(CODE_LESS_OR_EQUAL);
+   if (strcmp(name,">") == 0) return(CODE_GREATER_THAN);
+   if (strcmp(name,">=") == 0) return(CODE_GREATER_OR_EQUAL);
+   if (strcmp(name,"=") == 0) return(CODE_NUMBER_EQUAL);
+   if ((strcmp(name,"<>") == 0) || (strcmp(name,"!=") == 0)) return(CODE_NUMBER_NOT_EQUAL);
+   if (strcmp(name,"+") == 0) return(CODE_ADD);
+   if (strcmp(name,"-") == 0) return(CODE_SUBTRACT);
+   if (strcmp(name,"*") == 0) return(CODE_MULTIPLY);
+
+   return(CODE_EVALUATE);
+  }
+
+/***************************************************************/
+/* NumericOperand: Returns TRUE if an operand of a numeric     */
+/*   function can be evaluated again without side effects: a   */
+/*   constant, a primitive without arguments such as a         */
+/*   variable reference, or a numeric function call of such    */
+/*   operands.                                                 */
+/***************************************************************/
+static intBool NumericOperand(
+  void *theEnv,
+  struct expr *theExpression)
+  {
+   if (ConstantNode(theExpression))
+     { return(TRUE); }
+
+   if (PrimitiveNode(theEnv,theExpression))
+     { return(theExpression->argList == NULL); }
+
+   if (NumericOperation(theExpression) == CODE_EVALUATE)
+     { return(FALSE); }
+
+   return(NumericOperand(theEnv,theExpression->argList) &&
+          NumericOperand(theEnv,theExpression->argList->nextArg));
+  }
+
+/**********************************************************/
+/* ConstantNode: Returns TRUE if an expression evaluates */
+/*   to its own type and value.                           */
+/**********************************************************/
+static intBool ConstantNode(
+  struct expr *theExpression)
+  {
+   switch (theExpression->type)
+     {
+      case STRING:
+      case SYMBOL:
+      case FLOAT:
+      case INTEGER:
+#if OBJECT_SYSTEM
+      case INSTANCE_NAME:
+#endif
+        return(TRUE);
+     }
+
+   return(FALSE);
+  }
+
+/************************************************************/
+/* PrimitiveNode: Returns TRUE if an expression is evaluated */
+/*   by the evaluation function of its primitive type, such  */
+/*   as the variable references of the join network.        */
+/************************************************************/
+static intBool PrimitiveNode(
+  void *theEnv,
+  struct expr *theExpression)
+  {
+   struct entityRecord *thePrimitive;
+
+   switch (theExpression->type)
+     {
+      case FCALL:
+      case MULTIFIELD:
+      case MF_VARIABLE:
+      case SF_VARIABLE:
+        return(FALSE);
+     }
+
+   thePrimitive = EvaluationData(theEnv)->PrimitivesArray[theExpression->type];
+
+   return((thePrimitive != NULL) &&
+          (! thePrimitive->copyToEvaluate) &&
+          (thePrimitive->evaluateFunction != NULL));
+  }
+
+/***********************************************************/
+/* CompareNumbers: Compares two numbers as the numeric     */
+/*   comparison functions do, as integers if both are      */
+/*   integers and otherwise as floats.                     */
+/***********************************************************/
+static intBool CompareNumbers(
+  unsigned short op,
+  DATA_OBJECT *first,
+  DATA_OBJECT *second)
+  {
+   long long firstInteger, secondInteger;
+   double firstFloat, secondFloat;
+
+   if ((first->type == INTEGER) && (second->type == INTEGER))
+     {
+      firstInteger = ValueToLong(first->value);
+      secondInteger = ValueToLong(second->value);
+
+      switch (op)
+        {
+         case CODE_LESS_THAN: return(firstInteger < secondInteger);
+         case CODE_LESS_OR_EQUAL: return(firstInteger <= secondInteger);
+         case CODE_GREATER_THAN: return(firstInteger > secondInteger);
+         case CODE_GREATER_OR_EQUAL: return(firstInteger >= secondInteger);
+         case CODE_NUMBER_EQUAL: return(firstInteger == secondInteger);
+         default: return(firstInteger != secondInteger);
+        }
+     }
+
+   firstFloat = (first->type == INTEGER) ? (double) ValueToLong(first->value) :
+                                           ValueToDouble(first->value);
+   secondFloat = (second->type == INTEGER) ? (double) ValueToLong(second->value) :
+                                             ValueToDouble(second->value);
+
+   switch (op)
+     {
+      case CODE_LESS_THAN: return(firstFloat < secondFloat);
+      case CODE_LESS_OR_EQUAL: return(firstFloat <= secondFloat);
+      case CODE_GREATER_THAN: return(firstFloat > secondFloat);
+      case CODE_GREATER_OR_EQUAL: return(firstFloat >= secondFloat);
+      case CODE_NUMBER_EQUAL: return(firstFloat == secondFloat);
+      default: return(firstFloat != secondFloat);
+     }
+  }
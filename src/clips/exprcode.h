@@ -0,0 +1,114 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.30  08/16/14            */
+   /*                                                     */
+   /*            EXPRESSION CODE HEADER FILE              */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Compiles expressions into a flat sequence of     */
+/*   instructions working on a small set of registers. The   */
+/*   numeric comparisons, arithmetic, eq, neq, not, and and  */
+/*   or functions are carried out by the instructions        */
+/*   themselves rather than by calls to their functions      */
+/*   evaluating their arguments one at a time. Join network  */
+/*   tests are compiled by EnvCompileJoinExpressions, other  */
+/*   expressions (RHS actions, deffunction bodies) are not.  */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_exprcode
+#define _H_exprcode
+
+#ifndef _H_evaluatn
+#include "evaluatn.h"
+#endif
+#ifndef _H_expressn
+#include "expressn.h"
+#endif
+#ifndef _H_network
+#include "network.h"
+#endif
+
+#ifdef LOCALE
+#undef LOCALE
+#endif
+
+#ifdef _EXPRCODE_SOURCE_
+#define LOCALE
+#else
+#define LOCALE extern
+#endif
+
+/*===================================================*/
+/* An expression nested deeper than the number of    */
+/* registers is left to EvaluateExpression.          */
+/*===================================================*/
+
+#define EXPRESSION_CODE_REGISTERS 16
+
+#define CODE_CONSTANT          0
+#define CODE_PRIMITIVE         1
+#define CODE_PRIMITIVE_TEST    2
+#define CODE_EVALUATE          3
+#define CODE_LESS_THAN         4
+#define CODE_LESS_OR_EQUAL     5
+#define CODE_GREATER_THAN      6
+#define CODE_GREATER_OR_EQUAL  7
+#define CODE_NUMBER_EQUAL      8
+#define CODE_NUMBER_NOT_EQUAL  9
+#define CODE_ADD              10
+#define CODE_SUBTRACT         11
+#define CODE_MULTIPLY         12
+#define CODE_EQ               13
+#define CODE_NEQ              14
+#define CODE_NOT              15
+#define CODE_JUMP_IF_FALSE    16
+#define CODE_JUMP_IF_TRUE     17
+#define CODE_TRUE             18
+
+/*=======================================================*/
+/* An instruction stores its result in a register. The   */
+/* operands are registers, except for the jumps whose    */
+/* first operand tells if an error stops the evaluation  */
+/* and whose second operand is the instruction jumped    */
+/* to. The expression is the one evaluated by a          */
+/* CODE_EVALUATE or primitive instruction, or the        */
+/* function call of a numeric instruction. A numeric     */
+/* instruction whose operand isn't a number falls back   */
+/* to the outermost numeric instruction it's nested in,  */
+/* whose function call is evaluated instead.             */
+/*=======================================================*/
+
+struct exprInstruction
+  {
+   unsigned short op;
+   unsigned short result;
+   unsigned short first;
+   unsigned short second;
+   unsigned short fallback;
+   struct expr *theExpression;
+  };
+
+struct expressionCode
+  {
+   unsigned short length;
+   struct exprInstruction *instructions;
+  };
+
+   LOCALE struct expressionCode         *CompileExpression(void *,struct expr *,int);
+   LOCALE int                            EvaluateExpressionCode(void *,struct expressionCode *,DATA_OBJECT *);
+   LOCALE void                           ReturnExpressionCode(void *,struct expressionCode *);
+#if DEFRULE_CONSTRUCT
+   LOCALE long                           EnvCompileJoinExpressions(void *);
+   LOCALE void                           ReturnJoinExpressionCode(void *,struct joinNode *);
+#endif
+
+#endif /* _H_exprcode */
@@ -422,11 +422,11 @@ globle void BsaveExpression(
       switch(testPtr->type)
         {
          case FLOAT:
-           newTest.value = (long) ((FLOAT_HN *) testPtr->value)->bucket;
+           newTest.value = (long) BoxedFloat(theEnv,testPtr->value)->bucket;
            break;
 
          case INTEGER:
-           newTest.value = (long) ((INTEGER_HN *) testPtr->value)->bucket;
+           newTest.value = (long) BoxedInteger(theEnv,testPtr->value)->bucket;
            break;
 
          case FCALL:
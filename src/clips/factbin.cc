@@ -41,6 +41,7 @@
 #include "rulebin.h"
 #include "moduldef.h"
 #include "envrnmnt.h"
+#include "factsel.h"
 
 #include "factbin.h"
 
@@ -114,7 +115,10 @@ static void DeallocateFactBloadData(
    int i;
    
    for (i = 0; i < FactBinaryData(theEnv)->NumberOfPatterns; i++)
-     { DestroyAlphaMemory(theEnv,&FactBinaryData(theEnv)->FactPatternArray[i].header,FALSE); }
+     {
+      DestroyAlphaMemory(theEnv,&FactBinaryData(theEnv)->FactPatternArray[i].header,FALSE);
+      ReturnSelectorTable(theEnv,&FactBinaryData(theEnv)->FactPatternArray[i]);
+     }
 
    space = FactBinaryData(theEnv)->NumberOfPatterns * sizeof(struct factPatternNode);
    if (space != 0) genfree(theEnv,(void *) FactBinaryData(theEnv)->FactPatternArray,space);
@@ -370,14 +374,8 @@ static void BloadBinaryItem(
                    
    for (i = 0; i < FactBinaryData(theEnv)->NumberOfPatterns; i++)
      {
-      if ((FactBinaryData(theEnv)->FactPatternArray[i].lastLevel != NULL) &&
-          (FactBinaryData(theEnv)->FactPatternArray[i].lastLevel->header.selector))
-        { 
-         AddHashedPatternNode(theEnv,FactBinaryData(theEnv)->FactPatternArray[i].lastLevel,
-                                     &FactBinaryData(theEnv)->FactPatternArray[i],
-                                     FactBinaryData(theEnv)->FactPatternArray[i].networkTest->type,
-                                     FactBinaryData(theEnv)->FactPatternArray[i].networkTest->value); 
-        }
+      if (FactBinaryData(theEnv)->FactPatternArray[i].header.selector)
+        { BuildSelectorTable(theEnv,&FactBinaryData(theEnv)->FactPatternArray[i]); }
      }
   }
 
@@ -406,6 +404,7 @@ static void UpdateFactPatterns(
    FactBinaryData(theEnv)->FactPatternArray[obji].nextLevel = BloadFactPatternPointer(bp->nextLevel);
    FactBinaryData(theEnv)->FactPatternArray[obji].lastLevel = BloadFactPatternPointer(bp->lastLevel);
    FactBinaryData(theEnv)->FactPatternArray[obji].leftNode  = BloadFactPatternPointer(bp->leftNode);
+   FactBinaryData(theEnv)->FactPatternArray[obji].selectorTable = NULL;
   }
 
 /***************************************************/
@@ -419,16 +418,7 @@ static void ClearBload(
    long i;
    
    for (i = 0; i < FactBinaryData(theEnv)->NumberOfPatterns; i++)
-     {
-      if ((FactBinaryData(theEnv)->FactPatternArray[i].lastLevel != NULL) &&
-          (FactBinaryData(theEnv)->FactPatternArray[i].lastLevel->header.selector))
-        { 
-         RemoveHashedPatternNode(theEnv,FactBinaryData(theEnv)->FactPatternArray[i].lastLevel,
-                                        &FactBinaryData(theEnv)->FactPatternArray[i],
-                                        FactBinaryData(theEnv)->FactPatternArray[i].networkTest->type,
-                                        FactBinaryData(theEnv)->FactPatternArray[i].networkTest->value); 
-        }
-     }
+     { ReturnSelectorTable(theEnv,&FactBinaryData(theEnv)->FactPatternArray[i]); }
 
 
    space = FactBinaryData(theEnv)->NumberOfPatterns * sizeof(struct factPatternNode);
@@ -43,6 +43,7 @@
 #include "reorder.h"
 #include "factcmp.h"
 #include "factmch.h"
+#include "factsel.h"
 #include "factgen.h"
 #include "factmngr.h"
 #include "factlhs.h"
@@ -50,6 +51,7 @@
 #include "modulutl.h"
 #include "tmpltdef.h"
 #include "envrnmnt.h"
+#include "lazymtch.h"
 
 #include "factbld.h"
 
@@ -102,6 +104,7 @@ globle void InitializeFactPatterns(
    newPtr->replaceGetPNValueFunction = FactReplaceGetfield;
    newPtr->genGetPNValueFunction = FactGenGetfield;
    newPtr->genComparePNValuesFunction = FactPNVariableComparison;
+   newPtr->genPNComparisonFunction = FactGenPNComparison;
    newPtr->returnUserDataFunction = NULL;
    newPtr->copyUserDataFunction = NULL;
 #else
@@ -118,6 +121,7 @@ globle void InitializeFactPatterns(
    newPtr->replaceGetPNValueFunction = NULL;
    newPtr->genGetPNValueFunction = NULL;
    newPtr->genComparePNValuesFunction = NULL;
+   newPtr->genPNComparisonFunction = NULL;
    newPtr->returnUserDataFunction = NULL;
    newPtr->copyUserDataFunction = NULL;   
 #endif
@@ -529,7 +533,11 @@ static struct lhsParseNode *RemoveUnneededSlots(
 
          theTest = FactGenCheckLength(theEnv,tempPattern->bottom);
          if (tempPattern->bottom->constantSelector != NULL)
-           { tempPattern->bottom->constantSelector->nextArg = CopyExpression(theEnv,theTest); }
+           {
+            tempPattern->bottom->constantSelector->nextArg =
+               CombineExpressions(theEnv,CopyExpression(theEnv,theTest),
+                                  tempPattern->bottom->constantSelector->nextArg);
+           }
          theTest = CombineExpressions(theEnv,theTest,tempPattern->bottom->networkTest);
          tempPattern->bottom->networkTest = theTest;
 
@@ -607,6 +615,7 @@ static struct factPatternNode *CreateNewPatternNode(
    newNode->nextLevel = NULL;
    newNode->rightNode = NULL;
    newNode->leftNode = NULL;
+   newNode->selectorTable = NULL;
    newNode->leaveFields = thePattern->singleFieldsAfter;
    InitializePatternHeader(theEnv,(struct patternNodeHeader *) &newNode->header);
 
@@ -658,7 +667,7 @@ static struct factPatternNode *CreateNewPatternNode(
    newNode->lastLevel = upperLevel;
    
    if ((upperLevel != NULL) && (upperLevel->header.selector))
-     { AddHashedPatternNode(theEnv,upperLevel,newNode,newNode->networkTest->type,newNode->networkTest->value); }
+     { ReturnSelectorTable(theEnv,upperLevel); }
 
    /*======================================================*/
    /* If there are no nodes on this level, then attach the */
@@ -740,6 +749,7 @@ static void DetachFactPattern(
 
    patternPtr = (struct factPatternNode *) thePattern;
    ClearPatternMatches(theEnv,patternPtr);
+   DiscardLazyMatches(theEnv,patternPtr);
 
    /*=======================================================*/
    /* If there are no joins entered from this pattern, then */
@@ -776,12 +786,13 @@ static void DetachFactPattern(
          else
            {
             if (upperLevel->header.selector)
-              { RemoveHashedPatternNode(theEnv,upperLevel,patternPtr,patternPtr->networkTest->type,patternPtr->networkTest->value); }
+              { ReturnSelectorTable(theEnv,upperLevel); }
               
             upperLevel->nextLevel = NULL;
             if (upperLevel->header.stopNode) upperLevel = NULL;
            }
 
+         ReturnSelectorTable(theEnv,patternPtr);
          RemoveHashedExpression(theEnv,patternPtr->networkTest);
          RemoveHashedExpression(theEnv,patternPtr->header.rightHash);
          rtn_struct(theEnv,factPatternNode,patternPtr);
@@ -798,12 +809,13 @@ static void DetachFactPattern(
          
          if ((patternPtr->lastLevel != NULL) && 
              (patternPtr->lastLevel->header.selector))
-           { RemoveHashedPatternNode(theEnv,patternPtr->lastLevel,patternPtr,patternPtr->networkTest->type,patternPtr->networkTest->value); }
+           { ReturnSelectorTable(theEnv,patternPtr->lastLevel); }
 
          upperLevel->leftNode->rightNode = upperLevel->rightNode;
          if (upperLevel->rightNode != NULL)
            { upperLevel->rightNode->leftNode = upperLevel->leftNode; }
 
+         ReturnSelectorTable(theEnv,patternPtr);
          RemoveHashedExpression(theEnv,patternPtr->networkTest);
          RemoveHashedExpression(theEnv,patternPtr->header.rightHash);
          rtn_struct(theEnv,factPatternNode,patternPtr);
@@ -824,12 +836,13 @@ static void DetachFactPattern(
          else
            { 
            if (upperLevel->header.selector)
-              { RemoveHashedPatternNode(theEnv,upperLevel,patternPtr,patternPtr->networkTest->type,patternPtr->networkTest->value); }
+              { ReturnSelectorTable(theEnv,upperLevel); }
 
             upperLevel->nextLevel = patternPtr->rightNode;
            }
          patternPtr->rightNode->leftNode = NULL;
 
+         ReturnSelectorTable(theEnv,patternPtr);
          RemoveHashedExpression(theEnv,patternPtr->networkTest);
          RemoveHashedExpression(theEnv,patternPtr->header.rightHash);
          rtn_struct(theEnv,factPatternNode,patternPtr); 
@@ -860,9 +873,7 @@ globle void DestroyFactPatternNetwork(
       
       DestroyAlphaMemory(theEnv,&thePattern->header,FALSE);
 
-      if ((thePattern->lastLevel != NULL) &&
-          (thePattern->lastLevel->header.selector))
-        { RemoveHashedPatternNode(theEnv,thePattern->lastLevel,thePattern,thePattern->networkTest->type,thePattern->networkTest->value); }
+      ReturnSelectorTable(theEnv,thePattern);
 
 #if (! BLOAD_ONLY) && (! RUN_TIME)
       rtn_struct(theEnv,factPatternNode,thePattern);
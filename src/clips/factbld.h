@@ -38,6 +38,8 @@
 #undef LOCALE
 #endif
 
+struct selectorTable;
+
 struct factPatternNode
   {
    struct patternNodeHeader header;
@@ -50,6 +52,7 @@ struct factPatternNode
    struct factPatternNode *lastLevel;
    struct factPatternNode *leftNode;
    struct factPatternNode *rightNode;
+   struct selectorTable *selectorTable;
   };
 
 #ifdef _FACTBUILD_SOURCE_
@@ -344,13 +344,19 @@ static void PatternNodeToCode(
    /*============*/
 
    if (thePatternNode->rightNode == NULL)
-     { fprintf(theFile,"NULL}"); }
+     { fprintf(theFile,"NULL,"); }
    else
      {
-      fprintf(theFile,"&%s%d_%ld[%ld]}",FactPrefix(),
+      fprintf(theFile,"&%s%d_%ld[%ld],",FactPrefix(),
             imageID,(thePatternNode->rightNode->bsaveID / maxIndices) + 1,
                 thePatternNode->rightNode->bsaveID % maxIndices);
      }
+
+   /*====================================*/
+   /* Selector Table (built at run time) */
+   /*====================================*/
+
+   fprintf(theFile,"NULL}");
   }
 
 /**********************************************************/
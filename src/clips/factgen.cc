@@ -36,6 +36,7 @@
 
 #include <stdio.h>
 #define _STDIO_INCLUDED_
+#include <string.h>
 
 #include "constant.h"
 #include "memalloc.h"
@@ -74,6 +75,8 @@ struct factgenData
    globle struct entityRecord   FactSlotLengthInfo;
    globle struct entityRecord   FactPNConstant1Info;
    globle struct entityRecord   FactPNConstant2Info;
+   globle struct entityRecord   FactPNNumber1Info;
+   globle struct entityRecord   FactPNNumber2Info;
   };
   
 #define FactgenData(theEnv) ((struct factgenData *) GetEnvironmentData(theEnv,FACTGEN_DATA))
@@ -180,6 +183,20 @@ globle void InitializeFactReteFunctions(
                                                         FactPNConstant2,
                                                         NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL };
 
+   struct entityRecord   factPNNumber1Info = { "FACT_PN_NUMBER1",
+                                                      FACT_PN_NUMBER1,0,1,1,
+                                                      PrintFactPNNumber1,
+                                                      PrintFactPNNumber1,NULL,
+                                                      FactPNNumber1,
+                                                      NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL };
+
+   struct entityRecord   factPNNumber2Info = { "FACT_PN_NUMBER2",
+                                                      FACT_PN_NUMBER2,0,1,1,
+                                                      PrintFactPNNumber2,
+                                                      PrintFactPNNumber2,NULL,
+                                                      FactPNNumber2,
+                                                      NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL };
+
    AllocateEnvironmentData(theEnv,FACTGEN_DATA,sizeof(struct factgenData),NULL);
    
    memcpy(&FactgenData(theEnv)->FactJNGV1Info,&factJNGV1Info,sizeof(struct entityRecord));   
@@ -195,6 +212,8 @@ globle void InitializeFactReteFunctions(
    memcpy(&FactgenData(theEnv)->FactSlotLengthInfo,&factSlotLengthInfo,sizeof(struct entityRecord));   
    memcpy(&FactgenData(theEnv)->FactPNConstant1Info,&factPNConstant1Info,sizeof(struct entityRecord));   
    memcpy(&FactgenData(theEnv)->FactPNConstant2Info,&factPNConstant2Info,sizeof(struct entityRecord));   
+   memcpy(&FactgenData(theEnv)->FactPNNumber1Info,&factPNNumber1Info,sizeof(struct entityRecord));
+   memcpy(&FactgenData(theEnv)->FactPNNumber2Info,&factPNNumber2Info,sizeof(struct entityRecord));
                                                         
    InstallPrimitive(theEnv,(ENTITY_RECORD_PTR) &FactData(theEnv)->FactInfo,FACT_ADDRESS);
    InstallPrimitive(theEnv,&FactgenData(theEnv)->FactJNGV1Info,FACT_JN_VAR1);
@@ -210,6 +229,8 @@ globle void InitializeFactReteFunctions(
    InstallPrimitive(theEnv,&FactgenData(theEnv)->FactSlotLengthInfo,FACT_SLOT_LENGTH);
    InstallPrimitive(theEnv,&FactgenData(theEnv)->FactPNConstant1Info,FACT_PN_CONSTANT1);
    InstallPrimitive(theEnv,&FactgenData(theEnv)->FactPNConstant2Info,FACT_PN_CONSTANT2);
+   InstallPrimitive(theEnv,&FactgenData(theEnv)->FactPNNumber1Info,FACT_PN_NUMBER1);
+   InstallPrimitive(theEnv,&FactgenData(theEnv)->FactPNNumber2Info,FACT_PN_NUMBER2);
 #endif
   }
 
@@ -314,6 +335,115 @@ globle struct expr *FactGenPNConstant(
    return(top);
   }
 
+/*****************************************************************/
+/* FactGenPNComparison: Replaces a pattern network test which    */
+/*   compares the value of a single field slot with <, <=, >,    */
+/*   >=, = or <> to a number, or to the value of another single  */
+/*   field slot, with a specialized routine doing the            */
+/*   comparison. The test becomes an argument of the routine,    */
+/*   evaluated instead when a value isn't a number. Returns NULL */
+/*   if the test can't be replaced.                              */
+/*****************************************************************/
+globle struct expr *FactGenPNComparison(
+  void *theEnv,
+  struct expr *theTest)
+  {
+   struct expr *top, *first, *second;
+   struct factNumberPN1Call hack1;
+   struct factNumberPN2Call hack2;
+   const char *name;
+   unsigned int comparison, reversed;
+
+   if ((theTest == NULL) ||
+       (theTest->type != FCALL) ||
+       (theTest->nextArg != NULL) ||
+       (theTest->argList == NULL) ||
+       (theTest->argList->nextArg == NULL) ||
+       (theTest->argList->nextArg->nextArg != NULL))
+     { return(NULL); }
+
+   /*===================================================*/
+   /* Determine the comparison, and the one to use when */
+   /* the slot value is the second argument.            */
+   /*===================================================*/
+
+   name = ValueToString(ExpressionFunctionCallName(theTest));
+
+   if (strcmp(name,"<") == 0)
+     {
+      comparison = FACT_NUMBER_LESS_THAN;
+      reversed = FACT_NUMBER_GREATER_THAN;
+     }
+   else if (strcmp(name,"<=") == 0)
+     {
+      comparison = FACT_NUMBER_LESS_OR_EQUAL;
+      reversed = FACT_NUMBER_GREATER_OR_EQUAL;
+     }
+   else if (strcmp(name,">") == 0)
+     {
+      comparison = FACT_NUMBER_GREATER_THAN;
+      reversed = FACT_NUMBER_LESS_THAN;
+     }
+   else if (strcmp(name,">=") == 0)
+     {
+      comparison = FACT_NUMBER_GREATER_OR_EQUAL;
+      reversed = FACT_NUMBER_LESS_OR_EQUAL;
+     }
+   else if (strcmp(name,"=") == 0)
+     { comparison = reversed = FACT_NUMBER_EQUAL; }
+   else if ((strcmp(name,"<>") == 0) || (strcmp(name,"!=") == 0))
+     { comparison = reversed = FACT_NUMBER_NOT_EQUAL; }
+   else
+     { return(NULL); }
+
+   first = theTest->argList;
+   second = first->nextArg;
+
+   /*==============================================*/
+   /* Compare the values of two single field slots. */
+   /*==============================================*/
+
+   if ((first->type == FACT_PN_VAR2) && (second->type == FACT_PN_VAR2))
+     {
+      ClearBitString(&hack2,sizeof(struct factNumberPN2Call));
+      hack2.comparison = comparison;
+      hack2.slot1 = ((struct factGetVarPN2Call *) ValueToBitMap(first->value))->whichSlot;
+      hack2.slot2 = ((struct factGetVarPN2Call *) ValueToBitMap(second->value))->whichSlot;
+
+      top = GenConstant(theEnv,FACT_PN_NUMBER2,EnvAddBitMap(theEnv,&hack2,sizeof(struct factNumberPN2Call)));
+      top->argList = theTest;
+
+      return(top);
+     }
+
+   /*====================================================*/
+   /* Compare the value of a single field slot to a      */
+   /* number, with the slot value as the first argument. */
+   /*====================================================*/
+
+   if ((second->type == FACT_PN_VAR2) &&
+       ((first->type == INTEGER) || (first->type == FLOAT)))
+     {
+      first = second;
+      second = theTest->argList;
+      comparison = reversed;
+     }
+
+   if ((first->type != FACT_PN_VAR2) ||
+       ((second->type != INTEGER) && (second->type != FLOAT)))
+     { return(NULL); }
+
+   ClearBitString(&hack1,sizeof(struct factNumberPN1Call));
+   hack1.comparison = comparison;
+   hack1.whichSlot = ((struct factGetVarPN2Call *) ValueToBitMap(first->value))->whichSlot;
+
+   top = GenConstant(theEnv,FACT_PN_NUMBER1,EnvAddBitMap(theEnv,&hack1,sizeof(struct factNumberPN1Call)));
+   top->argList = GenConstant(theEnv,second->type,second->value);
+   top->argList->nextArg = theTest;
+
+   return(top);
+  }
+
 /*******************************************************/
 /* FactGenGetfield: Generates an expression for use in */
 /*   the fact pattern network that retrieves a value   */
@@ -105,6 +105,39 @@ struct factConstantPN2Call
    unsigned short whichSlot;
   };
 
+/*****************************************************************/
+/* factNumberPN1Call: Used for comparing the number stored in a  */
+/*   single field slot to a numeric constant in the fact pattern */
+/*   network with <, <=, >, >=, = or <>. The first argument is   */
+/*   the constant and the second one is the comparison function  */
+/*   call, evaluated instead if the slot value isn't a number.   */
+/*****************************************************************/
+struct factNumberPN1Call
+  {
+   unsigned int comparison : 3;
+   unsigned short whichSlot;
+  };
+
+/*****************************************************************/
+/* factNumberPN2Call: Used for comparing the numbers stored in   */
+/*   two single field slots of a fact in the fact pattern        */
+/*   network. The argument is the comparison function call,      */
+/*   evaluated instead if either value isn't a number.           */
+/*****************************************************************/
+struct factNumberPN2Call
+  {
+   unsigned int comparison : 3;
+   unsigned short slot1;
+   unsigned short slot2;
+  };
+
+#define FACT_NUMBER_LESS_THAN          0
+#define FACT_NUMBER_LESS_OR_EQUAL      1
+#define FACT_NUMBER_GREATER_THAN       2
+#define FACT_NUMBER_GREATER_OR_EQUAL   3
+#define FACT_NUMBER_EQUAL              4
+#define FACT_NUMBER_NOT_EQUAL          5
+
 /**********************************************************/
 /* factGetVarJN1Call: This structure is used to store the */
 /*   arguments to the most general extraction routine for */
@@ -222,6 +255,7 @@ struct factCheckLengthPNCall
    LOCALE void                       FactReplaceGetvar(void *,struct expr *,struct lhsParseNode *,int);
    LOCALE void                       FactReplaceGetfield(void *,struct expr *,struct lhsParseNode *);
    LOCALE struct expr               *FactGenPNConstant(void *,struct lhsParseNode *);
+   LOCALE struct expr               *FactGenPNComparison(void *,struct expr *);
    LOCALE struct expr               *FactGenGetfield(void *,struct lhsParseNode *);
    LOCALE struct expr               *FactGenGetvar(void *,struct lhsParseNode *,int);
    LOCALE struct expr               *FactGenCheckLength(void *,struct lhsParseNode *);
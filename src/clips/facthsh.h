@@ -46,7 +46,7 @@ struct factHashEntry
    struct factHashEntry *next;
   };
 
-#define SIZE_FACT_HASH 16231
+#define SIZE_FACT_HASH 61
 
 #ifdef LOCALE
 #undef LOCALE
@@ -51,7 +51,9 @@
 #include "extnfunc.h"
 #include "factgen.h"
 #include "factrete.h"
+#include "factsel.h"
 #include "incrrset.h"
+#include "lazymtch.h"
 #include "memalloc.h"
 #include "reteutil.h"
 #include "router.h"
@@ -90,6 +92,7 @@ globle void FactPatternMatch(
    int offsetSlot;
    DATA_OBJECT theResult;
    struct factPatternNode *tempPtr;
+   struct selectorMatches theMatches;
    
    /*=========================================================*/
    /* If there's nothing left in the pattern network to match */
@@ -180,29 +183,38 @@ globle void FactPatternMatch(
 
          if (patternPtr->header.selector)
            {
+            /*=======================================================*/
+            /* Several children of a selector may be satisfied by    */
+            /* the value of the field, so the nodes beneath each one */
+            /* are matched recursively, in the order of children.    */
+            /*=======================================================*/
+
             if (EvaluatePatternExpression(theEnv,patternPtr,patternPtr->networkTest->nextArg))
               {
                EvaluateExpression(theEnv,patternPtr->networkTest,&theResult);
-            
-               tempPtr = (struct factPatternNode *) FindHashedPatternNode(theEnv,patternPtr,theResult.type,theResult.value);
-              }
-            else
-              { tempPtr = NULL; }
-              
-            if (tempPtr != NULL)
-              {
-               if (SkipFactPatternNode(theEnv,tempPtr))
-                 { patternPtr = GetNextFactPatternNode(theEnv,TRUE,patternPtr); }
-               else
+               tempPtr = StartSelectorMatches(theEnv,patternPtr,&theResult,&theMatches);
+               if (tempPtr != NULL)
+                 { PatternNetErrorMessage(theEnv,tempPtr); }
+
+               while ((tempPtr = NextSelectorMatch(&theMatches)) != NULL)
                  {
+                  if (SkipFactPatternNode(theEnv,tempPtr)) continue;
+
                   if (tempPtr->header.stopNode)
                     { ProcessFactAlphaMatch(theEnv,theFact,markers,tempPtr); }
-               
-                  patternPtr = GetNextFactPatternNode(theEnv,FALSE,tempPtr);
+
+                  if (tempPtr->nextLevel == NULL) continue;
+
+                  if (offsetSlot == tempPtr->nextLevel->whichSlot)
+                    { FactPatternMatch(theEnv,theFact,tempPtr->nextLevel,offset,markers,endMark); }
+                  else
+                    { FactPatternMatch(theEnv,theFact,tempPtr->nextLevel,0,markers,endMark); }
                  }
+
+               EndSelectorMatches(theEnv,&theMatches);
               }
-            else
-              { patternPtr = GetNextFactPatternNode(theEnv,TRUE,patternPtr); }
+
+            patternPtr = GetNextFactPatternNode(theEnv,TRUE,patternPtr);
            }
          
          /*=============================================*/
@@ -288,6 +300,7 @@ static void ProcessMultifieldNode(
    struct multifield *theSlotValue;
    DATA_OBJECT theResult;
    struct factPatternNode *tempPtr;
+   struct selectorMatches theMatches;
    intBool success;
 
    /*========================================*/
@@ -351,8 +364,10 @@ static void ProcessMultifieldNode(
          if (EvaluatePatternExpression(theEnv,thePattern,thePattern->networkTest->nextArg))
            {
             EvaluateExpression(theEnv,thePattern->networkTest,&theResult);
+            StartSelectorMatches(theEnv,thePattern,&theResult,&theMatches);
          
-            thePattern = (struct factPatternNode *) FindHashedPatternNode(theEnv,thePattern,theResult.type,theResult.value);
+            thePattern = NextSelectorMatch(&theMatches);
+            EndSelectorMatches(theEnv,&theMatches);
             if (thePattern != NULL)
               { success = TRUE; }
             else
@@ -416,8 +431,10 @@ static void ProcessMultifieldNode(
          if (EvaluatePatternExpression(theEnv,thePattern,thePattern->networkTest->nextArg))
            {
             EvaluateExpression(theEnv,thePattern->networkTest,&theResult);
+            StartSelectorMatches(theEnv,thePattern,&theResult,&theMatches);
          
-            tempPtr = (struct factPatternNode *) FindHashedPatternNode(theEnv,thePattern,theResult.type,theResult.value);
+            tempPtr = NextSelectorMatch(&theMatches);
+            EndSelectorMatches(theEnv,&theMatches);
             if (tempPtr != NULL)
               {
                FactPatternMatch(theEnv,FactData(theEnv)->CurrentPatternFact,
@@ -471,9 +488,7 @@ static struct factPatternNode *GetNextFactPatternNode(
    /* network until a side branch can be taken.      */
    /*================================================*/
 
-   while ((thePattern->rightNode == NULL) ||
-          ((thePattern->lastLevel != NULL) &&
-           (thePattern->lastLevel->header.selector)))
+   while (thePattern->rightNode == NULL)
      {
       /*========================================*/
       /* Back up to check the next side branch. */
@@ -487,25 +502,21 @@ static struct factPatternNode *GetNextFactPatternNode(
       /*======================================*/
 
       if (thePattern == NULL) return(NULL);
-      
-      /*======================================*/
-      /* Skip selector constants and pop back */
-      /* back to the selector node.           */
-      /*======================================*/
 
-      if ((thePattern->lastLevel != NULL) &&
-          (thePattern->lastLevel->header.selector))
-        { thePattern = thePattern->lastLevel; }
-
-      /*===================================================*/
-      /* If we branched up to a multifield node, then stop */
-      /* since these nodes are handled recursively. The    */
-      /* previous call to the pattern matching algorithm   */
-      /* on the stack will handle backing up to the nodes  */
-      /* above the multifield node in the pattern network. */
-      /*===================================================*/
+      /*====================================================*/
+      /* If we branched up to a multifield node or a child  */
+      /* of a selector node, then stop since the nodes      */
+      /* beneath these are handled recursively. The         */
+      /* previous call to the pattern matching algorithm on */
+      /* the stack will handle backing up to the nodes      */
+      /* above the node in the pattern network.             */
+      /*====================================================*/
 
       if (thePattern->header.multifieldNode) return(NULL);
+
+      if ((thePattern->lastLevel != NULL) &&
+          (thePattern->lastLevel->header.selector))
+        { return(NULL); }
      }
 
    /*==================================*/
@@ -517,11 +528,35 @@ static struct factPatternNode *GetNextFactPatternNode(
 
 /*******************************************************/
 /* ProcessFactAlphaMatch: When a fact pattern has been */
-/*   satisfied, this routine creates an alpha match to */
-/*   store in the pattern network and then sends the   */
-/*   new alpha match through the join network.         */
+/*   satisfied, this routine sends the match through   */
+/*   the join network, or queues it with the pattern   */
+/*   when matching is lazy (see EnvSetLazyMatching).   */
+/*   An incremental reset matches the facts through    */
+/*   the joins of the new rules right away.            */
 /*******************************************************/
 static void ProcessFactAlphaMatch(
+  void *theEnv,
+  struct fact *theFact,
+  struct multifieldMarker *theMarks,
+  struct factPatternNode *thePattern)
+  {
+   if (LazyMatchData(theEnv)->LazyMatching &&
+       (! EngineData(theEnv)->IncrementalResetInProgress))
+     {
+      DeferFactAlphaMatch(theEnv,theFact,theMarks,thePattern);
+      return;
+     }
+
+   CreateFactAlphaMatch(theEnv,theFact,theMarks,thePattern);
+  }
+
+/********************************************************/
+/* CreateFactAlphaMatch: Creates an alpha match for a   */
+/*   fact satisfying a pattern to store in the pattern  */
+/*   network and then sends the new alpha match through */
+/*   the join network.                                  */
+/********************************************************/
+globle void CreateFactAlphaMatch(
   void *theEnv,
   struct fact *theFact,
   struct multifieldMarker *theMarks,
@@ -629,6 +664,28 @@ static int EvaluatePatternExpression(
         rv = FactSlotLength(theEnv,theTest->value,&theResult);
         EvaluationData(theEnv)->CurrentExpression = oldArgument;
         return(rv);
+
+      /*=================================================*/
+      /* These primitives compare the number stored in a */
+      /* single field slot to a constant or to the       */
+      /* number stored in another single field slot.     */
+      /*=================================================*/
+
+      case FACT_PN_NUMBER1:
+      case FACT_PN_NUMBER2:
+        oldArgument = EvaluationData(theEnv)->CurrentExpression;
+        EvaluationData(theEnv)->CurrentExpression = theTest;
+        if (theTest->type == FACT_PN_NUMBER1)
+          { rv = FactPNNumber1(theEnv,theTest->value,&theResult); }
+        else
+          { rv = FactPNNumber2(theEnv,theTest->value,&theResult); }
+        EvaluationData(theEnv)->CurrentExpression = oldArgument;
+        if (EvaluationData(theEnv)->EvaluationError)
+          {
+           PatternNetErrorMessage(theEnv,patternPtr);
+           return(FALSE);
+          }
+        return(rv);
      }
 
    /*==============================================*/
@@ -63,6 +63,9 @@
                                                struct factPatternNode *,int,
                                                struct multifieldMarker *,
                                                struct multifieldMarker *);
+   LOCALE void                           CreateFactAlphaMatch(void *,struct fact *,
+                                               struct multifieldMarker *,
+                                               struct factPatternNode *);
    LOCALE void                           MarkFactPatternForIncrementalReset(void *,struct patternNodeHeader *,int);
    LOCALE void                           FactsIncrementalReset(void *);
 
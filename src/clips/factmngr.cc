@@ -97,6 +97,7 @@
 #include "utility.h"
 #include "factbin.h"
 #include "factmngr.h"
+#include "lazymtch.h"
 #include "facthsh.h"
 #include "default.h"
 #include "commline.h"
@@ -104,10 +105,16 @@
 #include "sysdep.h"
 
 #include "engine.h"
+#include "agenda.h"
 #include "lgcldpnd.h"
 #include "drive.h"
+#include "reteutil.h"
 #include "ruledlt.h"
 
+#if OBJECT_SYSTEM
+#include "inscom.h"
+#endif
+
 #include "tmpltbsc.h"
 #include "tmpltdef.h"
 #include "tmpltutl.h"
@@ -118,6 +125,13 @@
 /***************************************/
 
    static void                    ResetFacts(void *);
+   static void                    FlushFactsNetwork(void *);
+   static void                    BeginStaticFactsReset(void *);
+   static void                    EndStaticFactsReset(void *);
+   static void                    ClearStaticFacts(void *);
+   static void                    ClearHitLimit(void *);
+   static void                    SetStaticBase(void *);
+   static void                    RetractToStaticBase(void *);
    static int                     ClearFactsReady(void *);
    static void                    RemoveGarbageFacts(void *);
    static void                    DeallocateFactData(void *);
@@ -143,11 +157,12 @@ globle void InitializeFacts(
                                                    IncrementFactBasisCount,
                                                    MatchFactFunction,
                                                    NULL,
-                                                   FactIsDeleted
+                                                   FactIsDeleted,
+                                                   FactIsStatic
                                                  };
                                                  
    struct fact dummyFact = { { NULL, NULL, 0, 0L }, NULL, NULL, -1L, 0, 1,
-                                  NULL, NULL, NULL, NULL, { 1, 0UL, NULL, { { 0, NULL } } } };
+                                  NULL, NULL, NULL, NULL, NULL, { 1, 0UL, NULL, { { 0, NULL } } } };
 
    AllocateEnvironmentData(theEnv,FACTS_DATA,sizeof(struct factsData),DeallocateFactData);
 
@@ -169,7 +184,12 @@ globle void InitializeFacts(
    /*============================================*/
 
    EnvAddResetFunction(theEnv,"facts",ResetFacts,60);
+   EnvAddResetFunction(theEnv,"facts-network",FlushFactsNetwork,80);
+   EnvAddResetFunction(theEnv,"static-facts-begin",BeginStaticFactsReset,2000);
+   EnvAddResetFunction(theEnv,"static-facts-end",EndStaticFactsReset,-2000);
    AddClearReadyFunction(theEnv,"facts",ClearFactsReady,0);
+   EnvAddClearFunction(theEnv,"static-facts",ClearStaticFacts,0);
+   EnvAddClearFunction(theEnv,"hit-limit",ClearHitLimit,0);
 
    /*=============================*/
    /* Initialize periodic garbage */
@@ -183,6 +203,7 @@ globle void InitializeFacts(
    /*===================================*/
 
    InitializeFactPatterns(theEnv);
+   InitializeLazyMatching(theEnv);
 
    /*==================================*/
    /* Initialize the facts keyword for */
@@ -397,6 +418,191 @@ globle intBool FactIsDeleted(
    return(((struct fact *) theFact)->garbage);
   }
 
+/*****************************************************/
+/* FactIsStatic: Determines if a fact is one of the  */
+/*   static facts kept by reset (see EnvSetStaticFacts). */
+/*****************************************************/
+globle intBool FactIsStatic(
+  void *theEnv,
+  void *theFact)
+  {
+   if (! EngineData(theEnv)->StaticBaseValid) return(FALSE);
+
+   return(((struct fact *) theFact)->factIndex < FactData(theEnv)->StaticNextFactIndex);
+  }
+
+/*****************************************************************/
+/* EnvSetStaticFacts: Sets the static facts behavior. When it's  */
+/*   on, the facts asserted by a reset (those of the deffacts)   */
+/*   are static: the next resets only retract the facts asserted */
+/*   after them and keep the static ones, along with their       */
+/*   partial matches, in the pattern and join networks. The      */
+/*   activations of the static facts fired since are put back on */
+/*   the agenda with their original timetags and the fact index  */
+/*   and time tag counters are restored, so the state after the  */
+/*   reset is the one a full reset would have produced. A full   */
+/*   reset is done again once a static fact is retracted or      */
+/*   modified, or a deffacts is added or removed. Deffacts are   */
+/*   thus only evaluated by a full reset. Returns the old value. */
+/*****************************************************************/
+globle intBool EnvSetStaticFacts(
+  void *theEnv,
+  int value)
+  {
+   int ov;
+
+   ov = FactData(theEnv)->StaticFacts;
+   FactData(theEnv)->StaticFacts = value;
+   if (! value) InvalidateStaticFacts(theEnv);
+   return(ov);
+  }
+
+/*********************************************/
+/* EnvGetStaticFacts: Returns the static     */
+/*   facts behavior (see EnvSetStaticFacts). */
+/*********************************************/
+globle intBool EnvGetStaticFacts(
+  void *theEnv)
+  {
+   return(FactData(theEnv)->StaticFacts);
+  }
+
+/******************************************************************/
+/* EnvCheckpoint: Records the current working memory so that      */
+/*   EnvRollback can return to it. The facts asserted so far      */
+/*   become static as with EnvSetStaticFacts, along with their    */
+/*   partial matches and the activations on the agenda. Typically */
+/*   taken right after a reset, it makes each later rollback undo */
+/*   only what was asserted, matched and fired since. Replaces    */
+/*   the static facts of a previous reset or checkpoint.          */
+/******************************************************************/
+globle void EnvCheckpoint(
+  void *theEnv)
+  {
+   SetStaticBase(theEnv);
+   FactData(theEnv)->StaticBaseFromReset = FALSE;
+  }
+
+/*******************************************************************/
+/* EnvRollback: Returns working memory to the last checkpoint (or */
+/*   to the facts kept by a reset with EnvSetStaticFacts): the    */
+/*   facts asserted since are retracted, the activations fired    */
+/*   since are put back on the agenda, the fact index and time    */
+/*   tag counters are restored and the focus stack only holds the */
+/*   MAIN module, as after a reset. Defglobals are not restored.  */
+/*   Returns FALSE, doing nothing, if there is no checkpoint or   */
+/*   it was invalidated (a static fact was retracted or modified, */
+/*   a deffacts was changed, a reset or a clear happened); a      */
+/*   reset and a new checkpoint are then needed.                  */
+/*******************************************************************/
+globle intBool EnvRollback(
+  void *theEnv)
+  {
+   if ((! EngineData(theEnv)->StaticBaseValid) ||
+       EngineData(theEnv)->AlreadyRunning ||
+       ConstructData(theEnv)->ResetInProgress)
+     { return(FALSE); }
+
+   if (UtilityData(theEnv)->CurrentGarbageFrame->topLevel) SetHaltExecution(theEnv,FALSE);
+
+   EnvClearFocusStack(theEnv);
+   EnvFocus(theEnv,EnvFindDefmodule(theEnv,"MAIN"));
+
+   RetractToStaticBase(theEnv);
+
+   EnvSetCurrentModule(theEnv,(void *) EnvFindDefmodule(theEnv,"MAIN"));
+
+   /*===========================================*/
+   /* Perform periodic cleanup as a reset does. */
+   /*===========================================*/
+
+   if ((UtilityData(theEnv)->CurrentGarbageFrame->topLevel) && (! CommandLineData(theEnv)->EvaluatingTopLevelCommand) &&
+       (EvaluationData(theEnv)->CurrentExpression == NULL) && (UtilityData(theEnv)->GarbageCollectionLocks == 0))
+     {
+      CleanCurrentGarbageFrame(theEnv,NULL);
+      CallPeriodicTasks(theEnv);
+     }
+
+   return(TRUE);
+  }
+
+/*****************************************************************/
+/* EnvSetHitLimit: Stops the rules from firing once limit facts  */
+/*   of the given deftemplate have been asserted since the call, */
+/*   as a halt command would: the rule asserting the last of     */
+/*   them completes its actions and the run returns, leaving the */
+/*   remaining activations on the agenda. Meant for rule sets    */
+/*   where only the first hits of a decision matter. A NULL      */
+/*   deftemplate or a limit lower than one removes the limit.    */
+/*****************************************************************/
+globle void EnvSetHitLimit(
+  void *theEnv,
+  void *theDeftemplate,
+  long long limit)
+  {
+   if (limit < 1) theDeftemplate = NULL;
+
+   FactData(theEnv)->HitTemplate = (struct deftemplate *) theDeftemplate;
+   FactData(theEnv)->HitLimit = (theDeftemplate == NULL) ? 0 : limit;
+   FactData(theEnv)->HitCount = 0;
+   FactData(theEnv)->HitFactIndex = FactData(theEnv)->NextFactIndex;
+  }
+
+/***************************************************/
+/* EnvGetHitCount: Returns the number of facts of  */
+/*   the deftemplate given to EnvSetHitLimit which */
+/*   have been asserted since it was called.       */
+/***************************************************/
+globle long long EnvGetHitCount(
+  void *theEnv)
+  {
+   return(FactData(theEnv)->HitCount);
+  }
+
+/*******************************************************************/
+/* EnvGetNextHitFact: Returns the fact following the given one (or */
+/*   the first if it's NULL) among the facts of the deftemplate    */
+/*   given to EnvSetHitLimit which have been asserted since it was */
+/*   called and are still in the fact-list, in assertion order.    */
+/*******************************************************************/
+globle void *EnvGetNextHitFact(
+  void *theEnv,
+  void *theFact)
+  {
+   struct fact *factPtr;
+
+   if (FactData(theEnv)->HitTemplate == NULL) return(NULL);
+
+   if (theFact != NULL)
+     { return((void *) ((struct fact *) theFact)->nextTemplateFact); }
+
+   /*=================================================*/
+   /* The hits are the last facts of the deftemplate, */
+   /* look for the first of them from the end.        */
+   /*=================================================*/
+
+   factPtr = DeftemplateLastFact(theEnv,FactData(theEnv)->HitTemplate);
+   if ((factPtr == NULL) || (factPtr->factIndex < FactData(theEnv)->HitFactIndex))
+     { return(NULL); }
+
+   while ((factPtr->previousTemplateFact != NULL) &&
+          (factPtr->previousTemplateFact->factIndex >= FactData(theEnv)->HitFactIndex))
+     { factPtr = factPtr->previousTemplateFact; }
+
+   return((void *) factPtr);
+  }
+
+/*****************************************************/
+/* InvalidateStaticFacts: Makes the next reset a full */
+/*   one and drops the checkpoint, no fact is static  */
+/*   until then.                                      */
+/*****************************************************/
+globle void InvalidateStaticFacts(
+  void *theEnv)
+  {
+   EngineData(theEnv)->StaticBaseValid = FALSE;
+  }
+
 /**************************************************/
 /* PrintFact: Displays the printed representation */
 /*   of a fact containing the relation name and   */
@@ -494,6 +700,14 @@ globle intBool EnvRetract(
    /*======================================================*/
 
    if (theFact->garbage) return(FALSE);
+
+   /*==============================================*/
+   /* The next reset can't keep the static facts   */
+   /* once one of them is retracted (or modified). */
+   /*==============================================*/
+
+   if (FactIsStatic(theEnv,theFact))
+     { InvalidateStaticFacts(theEnv); }
    
    /*==========================================*/
    /* Execute the list of functions that are   */
@@ -550,14 +764,14 @@ globle intBool EnvRetract(
    /* Remove the fact from its template list. */
    /*=========================================*/
    
-   if (theFact == theTemplate->lastFact)
-     { theTemplate->lastFact = theFact->previousTemplateFact; }
+   if (theFact == DeftemplateLastFact(theEnv,theTemplate))
+     { DeftemplateLastFact(theEnv,theTemplate) = theFact->previousTemplateFact; }
 
    if (theFact->previousTemplateFact == NULL)
      {
-      theTemplate->factList = theTemplate->factList->nextTemplateFact;
-      if (theTemplate->factList != NULL)
-        { theTemplate->factList->previousTemplateFact = NULL; }
+      DeftemplateFactList(theEnv,theTemplate) = DeftemplateFactList(theEnv,theTemplate)->nextTemplateFact;
+      if (DeftemplateFactList(theEnv,theTemplate) != NULL)
+        { DeftemplateFactList(theEnv,theTemplate)->previousTemplateFact = NULL; }
      }
    else
      {
@@ -602,6 +816,15 @@ globle intBool EnvRetract(
 
    SetEvaluationError(theEnv,FALSE);
 
+   /*============================================*/
+   /* Drop the matches of the fact which weren't */
+   /* sent through the joins yet (see            */
+   /* EnvSetLazyMatching).                       */
+   /*============================================*/
+
+   if (theFact->lazyMatches != NULL)
+     { RemoveLazyMatches(theEnv,theFact); }
+
    /*===========================================*/
    /* Loop through the list of all the patterns */
    /* that matched the fact and process the     */
@@ -766,15 +989,15 @@ globle void *EnvAssert(
    /* Add the fact to its template list. */
    /*====================================*/
    
-   theFact->previousTemplateFact = theFact->whichDeftemplate->lastFact;
+   theFact->previousTemplateFact = DeftemplateLastFact(theEnv,theFact->whichDeftemplate);
    theFact->nextTemplateFact = NULL;
    
-   if (theFact->whichDeftemplate->lastFact == NULL)
-     { theFact->whichDeftemplate->factList = theFact; }
+   if (DeftemplateLastFact(theEnv,theFact->whichDeftemplate) == NULL)
+     { DeftemplateFactList(theEnv,theFact->whichDeftemplate) = theFact; }
    else
-     { theFact->whichDeftemplate->lastFact->nextTemplateFact = theFact; }
+     { DeftemplateLastFact(theEnv,theFact->whichDeftemplate)->nextTemplateFact = theFact; }
      
-   theFact->whichDeftemplate->lastFact = theFact;
+   DeftemplateLastFact(theEnv,theFact->whichDeftemplate) = theFact;
    
    /*==================================*/
    /* Set the fact index and time tag. */
@@ -826,6 +1049,15 @@ globle void *EnvAssert(
 
    FactData(theEnv)->ChangeToFactList = TRUE;
 
+   /*=======================================*/
+   /* Stop the rules from firing once the   */
+   /* hit limit of the deftemplate is met.  */
+   /*=======================================*/
+
+   if ((theFact->whichDeftemplate == FactData(theEnv)->HitTemplate) &&
+       (++FactData(theEnv)->HitCount >= FactData(theEnv)->HitLimit))
+     { EngineData(theEnv)->HaltRules = TRUE; }
+
    /*==========================================*/
    /* Check for constraint errors in the fact. */
    /*==========================================*/
@@ -1304,6 +1536,7 @@ globle struct fact *CreateFactBySize(
    theFact->previousTemplateFact = NULL;
    theFact->nextTemplateFact = NULL;
    theFact->list = NULL;
+   theFact->lazyMatches = NULL;
 
    theFact->theProposition.multifieldLength = size;
    theFact->theProposition.busyCount = 0;
@@ -1354,7 +1587,8 @@ globle void FactInstall(
    int i;
 
    FactData(theEnv)->NumberOfFacts++;
-   newFact->whichDeftemplate->busyCount++;
+   if (! ConstructData(theEnv)->ConstructsFrozen)
+     { newFact->whichDeftemplate->busyCount++; }
    theSegment = &newFact->theProposition;
 
    for (i = 0 ; i < (int) theSegment->multifieldLength ; i++)
@@ -1378,7 +1612,8 @@ globle void FactDeinstall(
 
    FactData(theEnv)->NumberOfFacts--;
    theSegment = &newFact->theProposition;
-   newFact->whichDeftemplate->busyCount--;
+   if (! ConstructData(theEnv)->ConstructsFrozen)
+     { newFact->whichDeftemplate->busyCount--; }
 
    for (i = 0 ; i < (int) theSegment->multifieldLength ; i++)
      {
@@ -1492,7 +1727,7 @@ globle void *GetNextFactInScope(
 
    while (theFact != NULL)
      {
-      if (theFact->whichDeftemplate->inScope) return((void *) theFact);
+      if (DeftemplateInScope(theEnv,theFact->whichDeftemplate)) return((void *) theFact);
 
       theFact = theFact->nextFact;
      }
@@ -1589,6 +1824,18 @@ globle unsigned long GetNumberOfFacts(
 static void ResetFacts(
   void *theEnv)
   {
+   /*=============================================*/
+   /* When the static facts are kept, only remove */
+   /* the facts asserted after them, and restore  */
+   /* the state following their assertion.        */
+   /*=============================================*/
+
+   if (EngineData(theEnv)->StaticResetInProgress)
+     {
+      RetractToStaticBase(theEnv);
+      return;
+     }
+
    /*====================================*/
    /* Initialize the fact index to zero. */
    /*====================================*/
@@ -1600,6 +1847,140 @@ static void ResetFacts(
    /*======================================*/
 
    RemoveAllFacts(theEnv);
+   EngineData(theEnv)->JoinNetworkFlushed = FALSE;
+  }
+
+/*******************************************************************/
+/* FlushFactsNetwork: Reset function called before the defrules    */
+/*   reset. When the reset removes every fact, the beta memories   */
+/*   are flushed in bulk (see FlushJoinNetwork) and ResetFacts     */
+/*   retracts the facts without the bookkeeping of a retraction    */
+/*   through the joins (unlinking the partial matches from the     */
+/*   memories, looking for other blockers of the not CEs and       */
+/*   propagating what they no longer block), see NetworkRetract.   */
+/*******************************************************************/
+static void FlushFactsNetwork(
+  void *theEnv)
+  {
+#if OBJECT_SYSTEM
+   INSTANCE_TYPE *theInstance;
+#endif
+
+   /*===================================================*/
+   /* Rule actions may use the partial matches, and the */
+   /* instances matched by object patterns are removed  */
+   /* through the join network by their own reset       */
+   /* function (the initial-object matches none).       */
+   /*===================================================*/
+
+   if (EngineData(theEnv)->StaticResetInProgress ||
+       (EngineData(theEnv)->ExecutingRule != NULL) ||
+       EngineData(theEnv)->JoinOperationInProgress ||
+       (FactData(theEnv)->FactList == NULL))
+     { return; }
+
+#if OBJECT_SYSTEM
+   for (theInstance = InstanceData(theEnv)->InstanceList;
+        theInstance != NULL;
+        theInstance = theInstance->nxtList)
+     { if (theInstance->partialMatchList != NULL) return; }
+#endif
+
+   FlushJoinNetwork(theEnv);
+   EngineData(theEnv)->JoinNetworkFlushed = TRUE;
+  }
+
+/*****************************************************************/
+/* BeginStaticFactsReset: Reset function called before the other */
+/*   reset functions, determines if the static facts are kept.   */
+/*****************************************************************/
+static void BeginStaticFactsReset(
+  void *theEnv)
+  {
+   EngineData(theEnv)->StaticResetInProgress =
+      FactData(theEnv)->StaticFacts && EngineData(theEnv)->StaticBaseValid &&
+      FactData(theEnv)->StaticBaseFromReset;
+
+   if (! EngineData(theEnv)->StaticResetInProgress)
+     { InvalidateStaticFacts(theEnv); }
+  }
+
+/****************************************************************/
+/* EndStaticFactsReset: Reset function called after the other   */
+/*   reset functions. After a full reset, the facts asserted by */
+/*   it become the static facts.                                */
+/****************************************************************/
+static void EndStaticFactsReset(
+  void *theEnv)
+  {
+   if (EngineData(theEnv)->StaticResetInProgress)
+     {
+      EngineData(theEnv)->StaticResetInProgress = FALSE;
+      return;
+     }
+
+   if (! FactData(theEnv)->StaticFacts) return;
+
+   SetStaticBase(theEnv);
+   FactData(theEnv)->StaticBaseFromReset = TRUE;
+  }
+
+/*************************************************************/
+/* SetStaticBase: The facts currently asserted become static. */
+/*   Activations parked before are not part of the state,    */
+/*   their rules fired before it.                            */
+/*************************************************************/
+static void SetStaticBase(
+  void *theEnv)
+  {
+   FlushLazyMatches(theEnv);
+   DiscardParkedActivations(theEnv);
+   FactData(theEnv)->LastStaticFact = FactData(theEnv)->LastFact;
+   FactData(theEnv)->StaticNextFactIndex = FactData(theEnv)->NextFactIndex;
+   FactData(theEnv)->StaticEntityTimeTag = DefruleData(theEnv)->CurrentEntityTimeTag;
+   EngineData(theEnv)->StaticBaseValid = TRUE;
+  }
+
+/*****************************************************************/
+/* RetractToStaticBase: Retracts the facts asserted after the    */
+/*   static facts, then restores the fact index, the time tag    */
+/*   and the activations of the static facts fired since.        */
+/*****************************************************************/
+static void RetractToStaticBase(
+  void *theEnv)
+  {
+   struct fact *theFact;
+
+   for (theFact = (FactData(theEnv)->LastStaticFact == NULL) ?
+                  FactData(theEnv)->FactList : FactData(theEnv)->LastStaticFact->nextFact;
+        theFact != NULL;
+        theFact = (FactData(theEnv)->LastStaticFact == NULL) ?
+                  FactData(theEnv)->FactList : FactData(theEnv)->LastStaticFact->nextFact)
+     { EnvRetract(theEnv,(void *) theFact); }
+
+   FactData(theEnv)->NextFactIndex = FactData(theEnv)->StaticNextFactIndex;
+   DefruleData(theEnv)->CurrentEntityTimeTag = FactData(theEnv)->StaticEntityTimeTag;
+   RestoreParkedActivations(theEnv);
+  }
+
+/**************************************************/
+/* ClearStaticFacts: Clear function for the static */
+/*   facts, the next reset is a full one.          */
+/**************************************************/
+static void ClearStaticFacts(
+  void *theEnv)
+  {
+   InvalidateStaticFacts(theEnv);
+  }
+
+/****************************************************/
+/* ClearHitLimit: Clear function for the hit limit, */
+/*   its deftemplate is about to be deleted.        */
+/****************************************************/
+static void ClearHitLimit(
+  void *theEnv)
+  {
+   EnvSetHitLimit(theEnv,NULL,0);
   }
 
 /************************************************************/
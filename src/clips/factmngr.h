@@ -60,6 +60,7 @@
 #define _H_factmngr
 
 struct fact;
+struct lazyMatch;
 
 #ifndef _H_facthsh
 #include "facthsh.h"
@@ -90,6 +91,7 @@ struct fact
    struct fact *nextFact;
    struct fact *previousTemplateFact;
    struct fact *nextTemplateFact;
+   struct lazyMatch *lazyMatches;
    struct multifield theProposition;
   };
   
@@ -125,6 +127,15 @@ struct factsData
    struct multifieldMarker *CurrentPatternMarks;
 #endif
    long LastModuleIndex;
+   intBool StaticFacts;
+   intBool StaticBaseFromReset;
+   struct fact *LastStaticFact;
+   long long StaticNextFactIndex;
+   unsigned long long StaticEntityTimeTag;
+   struct deftemplate *HitTemplate;
+   long long HitLimit;
+   long long HitCount;
+   long long HitFactIndex;
   };
   
 #define FactData(theEnv) ((struct factsData *) GetEnvironmentData(theEnv,FACTS_DATA))
@@ -165,6 +176,15 @@ struct factsData
    LOCALE void                           DecrementFactBasisCount(void *,void *);
    LOCALE void                           IncrementFactBasisCount(void *,void *);
    LOCALE intBool                        FactIsDeleted(void *,void *);
+   LOCALE intBool                        FactIsStatic(void *,void *);
+   LOCALE intBool                        EnvSetStaticFacts(void *,int);
+   LOCALE intBool                        EnvGetStaticFacts(void *);
+   LOCALE void                           InvalidateStaticFacts(void *);
+   LOCALE void                           EnvCheckpoint(void *);
+   LOCALE intBool                        EnvRollback(void *);
+   LOCALE void                           EnvSetHitLimit(void *,void *,long long);
+   LOCALE long long                      EnvGetHitCount(void *);
+   LOCALE void                          *EnvGetNextHitFact(void *,void *);
    LOCALE void                           ReturnFact(void *,struct fact *);
    LOCALE void                           MatchFactFunction(void *,void *);
    LOCALE intBool                        EnvPutFactSlot(void *,void *,const char *,DATA_OBJECT *);
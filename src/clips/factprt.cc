@@ -45,6 +45,10 @@
 
 #include "factprt.h"
 
+#if DEVELOPER
+   static const char             *FactNumberComparisonNames[] = { " < ", " <= ", " > ", " >= ", " = ", " <> " };
+#endif
+
 /***************************************/
 /* PrintFactJNCompVars1: Print routine */
 /*   for the FactJNCompVars1 function. */
@@ -488,6 +492,68 @@ globle void PrintFactPNConstant2(
 #endif
   }
 
+/*************************************/
+/* PrintFactPNNumber1: Print routine */
+/*   for the FactPNNumber1 function. */
+/*************************************/
+globle void PrintFactPNNumber1(
+  void *theEnv,
+  const char *logicalName,
+  void *theValue)
+  {
+#if DEVELOPER
+   struct factNumberPN1Call *hack;
+
+   hack = (struct factNumberPN1Call *) ValueToBitMap(theValue);
+
+   EnvPrintRouter(theEnv,logicalName,"(fact-pn-number1 ");
+
+   PrintLongInteger(theEnv,logicalName,(long long) hack->whichSlot);
+
+   EnvPrintRouter(theEnv,logicalName,FactNumberComparisonNames[hack->comparison]);
+
+   PrintAtom(theEnv,logicalName,GetFirstArgument()->type,GetFirstArgument()->value);
+   EnvPrintRouter(theEnv,logicalName,")");
+#else
+#if MAC_XCD
+#pragma unused(theEnv)
+#pragma unused(logicalName)
+#pragma unused(theValue)
+#endif
+#endif
+  }
+
+/*************************************/
+/* PrintFactPNNumber2: Print routine */
+/*   for the FactPNNumber2 function. */
+/*************************************/
+globle void PrintFactPNNumber2(
+  void *theEnv,
+  const char *logicalName,
+  void *theValue)
+  {
+#if DEVELOPER
+   struct factNumberPN2Call *hack;
+
+   hack = (struct factNumberPN2Call *) ValueToBitMap(theValue);
+
+   EnvPrintRouter(theEnv,logicalName,"(fact-pn-number2 ");
+
+   PrintLongInteger(theEnv,logicalName,(long long) hack->slot1);
+
+   EnvPrintRouter(theEnv,logicalName,FactNumberComparisonNames[hack->comparison]);
+
+   PrintLongInteger(theEnv,logicalName,(long long) hack->slot2);
+   EnvPrintRouter(theEnv,logicalName,")");
+#else
+#if MAC_XCD
+#pragma unused(theEnv)
+#pragma unused(logicalName)
+#pragma unused(theValue)
+#endif
+#endif
+  }
+
 #endif /* DEFTEMPLATE_CONSTRUCT && DEFRULE_CONSTRUCT */
 
 
@@ -55,6 +55,8 @@
    LOCALE void                           PrintFactSlotLength(void *,const char *,void *);
    LOCALE void                           PrintFactPNConstant1(void *,const char *,void *);
    LOCALE void                           PrintFactPNConstant2(void *,const char *,void *);
+   LOCALE void                           PrintFactPNNumber1(void *,const char *,void *);
+   LOCALE void                           PrintFactPNNumber2(void *,const char *,void *);
 
 #endif /* _H_factprt */
 
@@ -419,6 +419,8 @@ static intBool ReplaceTemplateNameWithReference(
 
       theExp->type = DEFTEMPLATE_PTR;
       theExp->value = theDeftemplate;
+      if (! ConstructData(theEnv)->ConstructsFrozen)
+        { ((struct deftemplate *) theDeftemplate)->queried = TRUE; }
       
 #if (! RUN_TIME) && (! BLOAD_ONLY)
       if (! ConstructData(theEnv)->ParsingConstruct)
@@ -426,6 +428,15 @@ static intBool ReplaceTemplateNameWithReference(
 #endif
      }
 
+   /*=================================================*/
+   /* Templates computed when the query is evaluated  */
+   /* can't be known in advance, remember that such a */
+   /* query exists.                                   */
+   /*=================================================*/
+
+   else
+     { FactQueryData(theEnv)->DynamicQueryTemplates = TRUE; }
+
    return(TRUE);
   }
 
@@ -129,6 +129,24 @@ globle void SetupFactQuery(
 #endif
   }
 
+/****************************************************
+  NAME         : EnvGetDynamicQueryTemplates
+  DESCRIPTION  : Determines if any parsed fact query
+                   names its templates with an expression
+                   that is only evaluated at run time
+  INPUTS       : None
+  RETURNS      : TRUE if such a query exists, FALSE
+                   otherwise
+  SIDE EFFECTS : None
+  NOTES        : Templates named by a constant are
+                   marked as queried by the parser
+ ****************************************************/
+globle intBool EnvGetDynamicQueryTemplates(
+  void *theEnv)
+  {
+   return(FactQueryData(theEnv)->DynamicQueryTemplates);
+  }
+
 /*************************************************************
   NAME         : GetQueryFact
   DESCRIPTION  : Internal function for referring to fact
@@ -915,7 +933,7 @@ static int TestForFirstFactInTemplate(
    newGarbageFrame.priorFrame = oldGarbageFrame;
    UtilityData(theEnv)->CurrentGarbageFrame = &newGarbageFrame;
 
-   theFact = templatePtr->factList;
+   theFact = DeftemplateFactList(theEnv,templatePtr);
    while (theFact != NULL)
      {
       FactQueryData(theEnv)->QueryCore->solns[indx] = theFact;
@@ -1022,7 +1040,7 @@ static void TestEntireTemplate(
    newGarbageFrame.priorFrame = oldGarbageFrame;
    UtilityData(theEnv)->CurrentGarbageFrame = &newGarbageFrame;
 
-   theFact = templatePtr->factList;
+   theFact = DeftemplateFactList(theEnv,templatePtr);
    while (theFact != NULL)
      {
       FactQueryData(theEnv)->QueryCore->solns[indx] = theFact;
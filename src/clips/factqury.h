@@ -76,6 +76,7 @@ struct factQueryData
    QUERY_CORE *QueryCore;
    QUERY_STACK *QueryCoreStack;
    int AbortQuery;
+   int DynamicQueryTemplates;
   };
 
 #define FactQueryData(theEnv) ((struct factQueryData *) GetEnvironmentData(theEnv,FACT_QUERY_DATA))
@@ -93,6 +94,7 @@ struct factQueryData
 #define QUERY_DELIMETER_STRING     "(QDS)"
 
    LOCALE void                           SetupFactQuery(void *);
+   LOCALE intBool                        EnvGetDynamicQueryTemplates(void *);
    LOCALE void                           GetQueryFact(void *,DATA_OBJECT *);
    LOCALE void                           GetQueryFactSlot(void *,DATA_OBJECT *);
    LOCALE intBool                        AnyFacts(void *);
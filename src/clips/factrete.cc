@@ -52,6 +52,12 @@
 
 #include "factrete.h"
 
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static intBool                 CompareFactNumbers(void *,unsigned int,struct field *,DATA_OBJECT_PTR);
+
 /***************************************************************/
 /* FactPNGetVar1: Fact pattern network function for extracting */
 /*   a variable's value. This is the most generalized routine. */
@@ -359,6 +365,122 @@ globle intBool FactPNConstant2(
    return(hack->testForEquality);
   }
 
+/*****************************************************************/
+/* FactPNNumber1: Fact pattern network function for comparing    */
+/*   the number stored in a single field slot to a numeric       */
+/*   constant. A value which isn't a number is left to the       */
+/*   comparison function, which reports the error.               */
+/*****************************************************************/
+globle intBool FactPNNumber1(
+  void *theEnv,
+  void *theValue,
+  DATA_OBJECT_PTR returnValue)
+  {
+   struct factNumberPN1Call *hack;
+   struct field *fieldPtr;
+   struct expr *theConstant;
+
+   hack = (struct factNumberPN1Call *) ValueToBitMap(theValue);
+   fieldPtr = &FactData(theEnv)->CurrentPatternFact->theProposition.theFields[hack->whichSlot];
+   theConstant = GetFirstArgument();
+
+   if ((fieldPtr->type != INTEGER) && (fieldPtr->type != FLOAT))
+     {
+      EvaluateExpression(theEnv,GetNextArgument(theConstant),returnValue);
+      return((returnValue->value != EnvFalseSymbol(theEnv)) || (returnValue->type != SYMBOL));
+     }
+
+   returnValue->type = theConstant->type;
+   returnValue->value = theConstant->value;
+
+   return(CompareFactNumbers(theEnv,hack->comparison,fieldPtr,returnValue));
+  }
+
+/*****************************************************************/
+/* FactPNNumber2: Fact pattern network function for comparing    */
+/*   the numbers stored in two single field slots of a fact.     */
+/*****************************************************************/
+globle intBool FactPNNumber2(
+  void *theEnv,
+  void *theValue,
+  DATA_OBJECT_PTR returnValue)
+  {
+   struct factNumberPN2Call *hack;
+   struct field *fieldPtr1, *fieldPtr2;
+
+   hack = (struct factNumberPN2Call *) ValueToBitMap(theValue);
+   fieldPtr1 = &FactData(theEnv)->CurrentPatternFact->theProposition.theFields[hack->slot1];
+   fieldPtr2 = &FactData(theEnv)->CurrentPatternFact->theProposition.theFields[hack->slot2];
+
+   if (((fieldPtr1->type != INTEGER) && (fieldPtr1->type != FLOAT)) ||
+       ((fieldPtr2->type != INTEGER) && (fieldPtr2->type != FLOAT)))
+     {
+      EvaluateExpression(theEnv,GetFirstArgument(),returnValue);
+      return((returnValue->value != EnvFalseSymbol(theEnv)) || (returnValue->type != SYMBOL));
+     }
+
+   returnValue->type = fieldPtr2->type;
+   returnValue->value = fieldPtr2->value;
+
+   return(CompareFactNumbers(theEnv,hack->comparison,fieldPtr1,returnValue));
+  }
+
+/*****************************************************************/
+/* CompareFactNumbers: Compares a number stored in a slot to the */
+/*   number in returnValue as the numeric comparison functions   */
+/*   do, as integers if both are integers and otherwise as       */
+/*   floats. The result of the comparison is stored in           */
+/*   returnValue and returned.                                   */
+/*****************************************************************/
+static intBool CompareFactNumbers(
+  void *theEnv,
+  unsigned int comparison,
+  struct field *fieldPtr,
+  DATA_OBJECT_PTR returnValue)
+  {
+   long long integer1, integer2;
+   double float1, float2;
+   intBool rv;
+
+   if ((fieldPtr->type == INTEGER) && (returnValue->type == INTEGER))
+     {
+      integer1 = ValueToLong(fieldPtr->value);
+      integer2 = ValueToLong(returnValue->value);
+
+      switch (comparison)
+        {
+         case FACT_NUMBER_LESS_THAN: rv = (integer1 < integer2); break;
+         case FACT_NUMBER_LESS_OR_EQUAL: rv = (integer1 <= integer2); break;
+         case FACT_NUMBER_GREATER_THAN: rv = (integer1 > integer2); break;
+         case FACT_NUMBER_GREATER_OR_EQUAL: rv = (integer1 >= integer2); break;
+         case FACT_NUMBER_EQUAL: rv = (integer1 == integer2); break;
+         default: rv = (integer1 != integer2); break;
+        }
+     }
+   else
+     {
+      float1 = (fieldPtr->type == INTEGER) ? (double) ValueToLong(fieldPtr->value) :
+                                             ValueToDouble(fieldPtr->value);
+      float2 = (returnValue->type == INTEGER) ? (double) ValueToLong(returnValue->value) :
+                                                ValueToDouble(returnValue->value);
+
+      switch (comparison)
+        {
+         case FACT_NUMBER_LESS_THAN: rv = (float1 < float2); break;
+         case FACT_NUMBER_LESS_OR_EQUAL: rv = (float1 <= float2); break;
+         case FACT_NUMBER_GREATER_THAN: rv = (float1 > float2); break;
+         case FACT_NUMBER_GREATER_OR_EQUAL: rv = (float1 >= float2); break;
+         case FACT_NUMBER_EQUAL: rv = (float1 == float2); break;
+         default: rv = (float1 != float2); break;
+        }
+     }
+
+   returnValue->type = SYMBOL;
+   returnValue->value = rv ? EnvTrueSymbol(theEnv) : EnvFalseSymbol(theEnv);
+
+   return(rv);
+  }
+
 /**************************************************************/
 /* FactJNGetVar1: Fact join network function for extracting a */
 /*   variable's value. This is the most generalized routine.  */
@@ -60,6 +60,8 @@
    LOCALE int                            FactPNCompVars1(void *,void *,DATA_OBJECT_PTR);
    LOCALE intBool                        FactPNConstant1(void *,void *,DATA_OBJECT_PTR);
    LOCALE intBool                        FactPNConstant2(void *,void *,DATA_OBJECT_PTR);
+   LOCALE intBool                        FactPNNumber1(void *,void *,DATA_OBJECT_PTR);
+   LOCALE intBool                        FactPNNumber2(void *,void *,DATA_OBJECT_PTR);
    LOCALE int                            FactStoreMultifield(void *,void *,DATA_OBJECT_PTR);
    LOCALE unsigned short                 AdjustFieldPosition(void *,struct multifieldMarker *,
                                                              unsigned short,unsigned short,int *);
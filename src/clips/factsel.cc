@@ -0,0 +1,809 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.30  08/16/14            */
+   /*                                                     */
+   /*             FACT PATTERN SELECTOR MODULE            */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Dispatches the value of a fact field tested by a */
+/*   selector node of the fact pattern network to the child  */
+/*   nodes whose constant keys it satisfies. A child node is */
+/*   satisfied by one key (red), any one of several keys     */
+/*   (red|blue), any value except its keys (~red&~blue), or  */
+/*   any number above or below a bound (:(>= ?x 200)).       */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#define _FACTSEL_SOURCE_
+
+#include <stdio.h>
+#define _STDIO_INCLUDED_
+#include <stdlib.h>
+#include <string.h>
+
+#include "setup.h"
+
+#if DEFTEMPLATE_CONSTRUCT && DEFRULE_CONSTRUCT
+
+#include "envrnmnt.h"
+#include "evaluatn.h"
+#include "expressn.h"
+#include "extnfunc.h"
+#include "memalloc.h"
+#include "symbol.h"
+
+#include "factsel.h"
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static struct expr                *SelectorKeyList(void *,struct expr *,intBool *);
+   static struct selectorKey         *FindSelectorKey(struct selectorTable *,unsigned short,void *,intBool);
+   static int                         SelectorBoundKey(struct expr *,struct selectorBound *);
+   static void                        AddSatisfiedBounds(void *,struct selectorMatches *,
+                                                         struct selectorBoundList *,int,DATA_OBJECT *);
+   static int                         BoundComparison(struct selectorBound *,int,long long,double);
+   static struct factPatternNode     *BoundTypeError(void *,struct selectorTable *,DATA_OBJECT *);
+   static void                        AddRangeMatch(void *,struct selectorMatches *,struct selectorChild *);
+   static int                         CompareBounds(const struct selectorBound *,const struct selectorBound *);
+   static int                         CompareLowerBounds(const void *,const void *);
+   static int                         CompareUpperBounds(const void *,const void *);
+   static int                         CompareChildPositions(const void *,const void *);
+
+/***************************************************************/
+/* StartSelectorMatches: Determines the children of a selector */
+/*   node satisfied by the value of the field it tests. The    */
+/*   children are then retrieved with NextSelectorMatch. If    */
+/*   the selector has bounds and the value isn't a number, the */
+/*   comparison of the first bounded child raises its error as */
+/*   it would have in the join network, and that child is      */
+/*   returned. Otherwise returns NULL.                         */
+/***************************************************************/
+globle struct factPatternNode *StartSelectorMatches(
+  void *theEnv,
+  struct factPatternNode *theSelector,
+  DATA_OBJECT *theValue,
+  struct selectorMatches *theMatches)
+  {
+   struct selectorTable *theTable;
+   struct selectorKey *theKey;
+   int list;
+
+   /*=================================================*/
+   /* The table is discarded when the children of the */
+   /* selector change and rebuilt when next needed.   */
+   /*=================================================*/
+
+   if (theSelector->selectorTable == NULL)
+     { BuildSelectorTable(theEnv,theSelector); }
+   theTable = theSelector->selectorTable;
+
+   theMatches->complement = theTable->children;
+   theMatches->complementEnd = theTable->children + theTable->complementCount;
+
+   theKey = FindSelectorKey(theTable,theValue->type,theValue->value,FALSE);
+   if (theKey == NULL)
+     {
+      theMatches->match = theMatches->matchEnd = NULL;
+      theMatches->exclusion = theMatches->exclusionEnd = NULL;
+     }
+   else
+     {
+      theMatches->match = theTable->children + theKey->matches;
+      theMatches->matchEnd = theMatches->match + theKey->matchCount;
+      theMatches->exclusion = theTable->children + theKey->exclusions;
+      theMatches->exclusionEnd = theMatches->exclusion + theKey->exclusionCount;
+     }
+
+   /*====================================================*/
+   /* The bounds satisfied by a number are found with a  */
+   /* binary search, then put back in the child order.   */
+   /*====================================================*/
+
+   theMatches->range = NULL;
+   theMatches->rangePosition = 0;
+   theMatches->rangeCount = 0;
+
+   if (theTable->boundCount == 0)
+     { return(NULL); }
+
+   if ((theValue->type != INTEGER) && (theValue->type != FLOAT))
+     { return(BoundTypeError(theEnv,theTable,theValue)); }
+
+   theMatches->range = theMatches->rangeBuffer;
+   theMatches->rangeSize = SELECTOR_RANGE_BUFFER_SIZE;
+
+   for (list = 0; list < SELECTOR_BOUND_LISTS; list++)
+     { AddSatisfiedBounds(theEnv,theMatches,&theTable->boundLists[list],list,theValue); }
+
+   if (theMatches->rangeCount > 1)
+     {
+      qsort(theMatches->range,theMatches->rangeCount,
+            sizeof(struct selectorChild *),CompareChildPositions);
+     }
+
+   return(NULL);
+  }
+
+/****************************************************************/
+/* NextSelectorMatch: Returns the next child of a selector node */
+/*   satisfied by the value of the field, in the order of the   */
+/*   children, or NULL if no more children are satisfied.       */
+/****************************************************************/
+globle struct factPatternNode *NextSelectorMatch(
+  struct selectorMatches *theMatches)
+  {
+   struct selectorChild *theChild;
+
+   /*======================================================*/
+   /* Skip the children with a complemented key list which */
+   /* exclude the key. Both runs are in the child order.   */
+   /*======================================================*/
+
+   while ((theMatches->complement < theMatches->complementEnd) &&
+          (theMatches->exclusion < theMatches->exclusionEnd) &&
+          (theMatches->exclusion->position <= theMatches->complement->position))
+     {
+      if (theMatches->exclusion->position == theMatches->complement->position)
+        { theMatches->complement++; }
+      theMatches->exclusion++;
+     }
+
+   /*================================================*/
+   /* Merge the children matching the key, the       */
+   /* children with a complemented key list, and the */
+   /* children with a bound satisfied by the value.  */
+   /*================================================*/
+
+   theChild = NULL;
+
+   if (theMatches->match < theMatches->matchEnd)
+     { theChild = theMatches->match; }
+
+   if ((theMatches->complement < theMatches->complementEnd) &&
+       ((theChild == NULL) || (theMatches->complement->position < theChild->position)))
+     { theChild = theMatches->complement; }
+
+   if ((theMatches->rangePosition < theMatches->rangeCount) &&
+       ((theChild == NULL) ||
+        (theMatches->range[theMatches->rangePosition]->position < theChild->position)))
+     { theChild = theMatches->range[theMatches->rangePosition]; }
+
+   if (theChild == NULL)
+     { return(NULL); }
+
+   if (theChild == theMatches->match)
+     { theMatches->match++; }
+   else if (theChild == theMatches->complement)
+     { theMatches->complement++; }
+   else
+     { theMatches->rangePosition++; }
+
+   return(theChild->node);
+  }
+
+/*******************************************************/
+/* EndSelectorMatches: Releases the list of children   */
+/*   satisfied by bounds made by StartSelectorMatches. */
+/*******************************************************/
+globle void EndSelectorMatches(
+  void *theEnv,
+  struct selectorMatches *theMatches)
+  {
+   if ((theMatches->range != NULL) && (theMatches->range != theMatches->rangeBuffer))
+     { genfree(theEnv,theMatches->range,sizeof(struct selectorChild *) * theMatches->rangeSize); }
+
+   theMatches->range = NULL;
+  }
+
+/*************************************************************/
+/* BuildSelectorTable: Creates the key table of a selector   */
+/*   node from the keys of its children. Each child is given */
+/*   the next position in the order of the children.         */
+/*************************************************************/
+globle void BuildSelectorTable(
+  void *theEnv,
+  struct factPatternNode *theSelector)
+  {
+   struct selectorTable *theTable;
+   struct selectorKey *theKey;
+   struct factPatternNode *theChild;
+   struct expr *keyList, *keyPtr;
+   struct selectorChild *theEntry;
+   struct selectorBound theBound;
+   struct selectorBoundList *theList;
+   unsigned long position, keyCount = 0, i, offset;
+   intBool complement;
+   int list;
+
+   ReturnSelectorTable(theEnv,theSelector);
+
+   theTable = get_struct(theEnv,selectorTable);
+   theTable->complementCount = 0;
+   theTable->boundCount = 0;
+   for (list = 0; list < SELECTOR_BOUND_LISTS; list++)
+     {
+      theTable->boundLists[list].count = 0;
+      theTable->boundLists[list].bounds = NULL;
+     }
+
+   /*==============================================*/
+   /* Keep the table at most half full even if all */
+   /* the keys referred to by children differ.     */
+   /*==============================================*/
+
+   for (theChild = theSelector->nextLevel;
+        theChild != NULL;
+        theChild = theChild->rightNode)
+     {
+      list = SelectorBoundKey(theChild->networkTest,&theBound);
+      if (list >= 0)
+        {
+         theTable->boundLists[list].count++;
+         theTable->boundCount++;
+         continue;
+        }
+
+      for (keyPtr = SelectorKeyList(theEnv,theChild->networkTest,&complement);
+           keyPtr != NULL;
+           keyPtr = keyPtr->nextArg)
+        { keyCount++; }
+     }
+
+   for (theTable->size = 4; theTable->size < (keyCount * 2); theTable->size *= 2)
+     { /* Do Nothing */ }
+
+   theTable->keys = (struct selectorKey *)
+                    genalloc(theEnv,sizeof(struct selectorKey) * theTable->size);
+   for (i = 0; i < theTable->size; i++)
+     {
+      theTable->keys[i].value = NULL;
+      theTable->keys[i].matchCount = 0;
+      theTable->keys[i].exclusionCount = 0;
+     }
+
+   /*==========================================================*/
+   /* Count the children referring to each key. The start of a */
+   /* key's runs temporarily holds the position of the last    */
+   /* child counted so that a key repeated by a child          */
+   /* (red|red) is only counted once.                          */
+   /*==========================================================*/
+
+   for (theChild = theSelector->nextLevel, position = 1;
+        theChild != NULL;
+        theChild = theChild->rightNode, position++)
+     {
+      if (SelectorBoundKey(theChild->networkTest,&theBound) >= 0)
+        { continue; }
+
+      keyList = SelectorKeyList(theEnv,theChild->networkTest,&complement);
+      if (complement) theTable->complementCount++;
+
+      for (keyPtr = keyList; keyPtr != NULL; keyPtr = keyPtr->nextArg)
+        {
+         theKey = FindSelectorKey(theTable,keyPtr->type,keyPtr->value,TRUE);
+         if (complement)
+           {
+            if ((theKey->exclusionCount == 0) || (theKey->exclusions != position))
+              {
+               theKey->exclusionCount++;
+               theKey->exclusions = position;
+              }
+           }
+         else
+           {
+            if ((theKey->matchCount == 0) || (theKey->matches != position))
+              {
+               theKey->matchCount++;
+               theKey->matches = position;
+              }
+           }
+        }
+     }
+
+   /*=================================================*/
+   /* Lay out the runs of the keys after the children */
+   /* with a complemented key list.                   */
+   /*=================================================*/
+
+   offset = theTable->complementCount;
+   for (i = 0; i < theTable->size; i++)
+     {
+      theKey = &theTable->keys[i];
+      theKey->matches = offset;
+      offset += theKey->matchCount;
+      theKey->exclusions = offset;
+      offset += theKey->exclusionCount;
+      theKey->matchCount = 0;
+      theKey->exclusionCount = 0;
+     }
+
+   theTable->childCount = offset;
+   if (offset == 0)
+     { theTable->children = NULL; }
+   else
+     {
+      theTable->children = (struct selectorChild *)
+                           genalloc(theEnv,sizeof(struct selectorChild) * offset);
+     }
+
+   /*========================================*/
+   /* Fill in the runs in the order in which */
+   /* the children are to be matched.        */
+   /*========================================*/
+
+   offset = 0;
+   for (theChild = theSelector->nextLevel, position = 1;
+        theChild != NULL;
+        theChild = theChild->rightNode, position++)
+     {
+      if (SelectorBoundKey(theChild->networkTest,&theBound) >= 0)
+        { continue; }
+
+      keyList = SelectorKeyList(theEnv,theChild->networkTest,&complement);
+      if (complement)
+        {
+         theTable->children[offset].node = theChild;
+         theTable->children[offset].position = position;
+         offset++;
+        }
+
+      for (keyPtr = keyList; keyPtr != NULL; keyPtr = keyPtr->nextArg)
+        {
+         theKey = FindSelectorKey(theTable,keyPtr->type,keyPtr->value,FALSE);
+         if (complement)
+           {
+            theEntry = &theTable->children[theKey->exclusions + theKey->exclusionCount];
+            if ((theKey->exclusionCount != 0) && ((theEntry - 1)->position == position))
+              { continue; }
+            theKey->exclusionCount++;
+           }
+         else
+           {
+            theEntry = &theTable->children[theKey->matches + theKey->matchCount];
+            if ((theKey->matchCount != 0) && ((theEntry - 1)->position == position))
+              { continue; }
+            theKey->matchCount++;
+           }
+
+         theEntry->node = theChild;
+         theEntry->position = position;
+        }
+     }
+
+   /*==========================================*/
+   /* Sort the bounds so that the bounds a     */
+   /* number satisfies come before the others. */
+   /*==========================================*/
+
+   for (list = 0; list < SELECTOR_BOUND_LISTS; list++)
+     {
+      theList = &theTable->boundLists[list];
+      if (theList->count != 0)
+        {
+         theList->bounds = (struct selectorBound *)
+                           genalloc(theEnv,sizeof(struct selectorBound) * theList->count);
+         theList->count = 0;
+        }
+     }
+
+   for (theChild = theSelector->nextLevel, position = 1;
+        theChild != NULL;
+        theChild = theChild->rightNode, position++)
+     {
+      list = SelectorBoundKey(theChild->networkTest,&theBound);
+      if (list < 0) continue;
+
+      theBound.child.node = theChild;
+      theBound.child.position = position;
+      theList = &theTable->boundLists[list];
+      theList->bounds[theList->count++] = theBound;
+     }
+
+   for (list = 0; list < SELECTOR_BOUND_LISTS; list++)
+     {
+      theList = &theTable->boundLists[list];
+      if (theList->count < 2) continue;
+
+      if ((list == SELECTOR_LOWER_INTEGERS) || (list == SELECTOR_LOWER_FLOATS))
+        { qsort(theList->bounds,theList->count,sizeof(struct selectorBound),CompareLowerBounds); }
+      else
+        { qsort(theList->bounds,theList->count,sizeof(struct selectorBound),CompareUpperBounds); }
+     }
+
+   theSelector->selectorTable = theTable;
+  }
+
+/****************************************************************/
+/* BuildSelectorTables: Creates the key tables of all selector  */
+/*   nodes in a fact pattern network. Used once the network of */
+/*   a binary image or constructs-to-c image has been loaded.  */
+/****************************************************************/
+globle void BuildSelectorTables(
+  void *theEnv,
+  struct factPatternNode *theNode)
+  {
+   while (theNode != NULL)
+     {
+      if (theNode->header.selector)
+        { BuildSelectorTable(theEnv,theNode); }
+
+      BuildSelectorTables(theEnv,theNode->nextLevel);
+      theNode = theNode->rightNode;
+     }
+  }
+
+/*************************************************************/
+/* ReturnSelectorTable: Deletes the key table of a selector. */
+/*************************************************************/
+globle void ReturnSelectorTable(
+  void *theEnv,
+  struct factPatternNode *theSelector)
+  {
+   struct selectorTable *theTable = theSelector->selectorTable;
+   int list;
+
+   if (theTable == NULL) return;
+
+   genfree(theEnv,theTable->keys,sizeof(struct selectorKey) * theTable->size);
+   if (theTable->children != NULL)
+     { genfree(theEnv,theTable->children,sizeof(struct selectorChild) * theTable->childCount); }
+   for (list = 0; list < SELECTOR_BOUND_LISTS; list++)
+     {
+      if (theTable->boundLists[list].bounds != NULL)
+        {
+         genfree(theEnv,theTable->boundLists[list].bounds,
+                 sizeof(struct selectorBound) * theTable->boundLists[list].count);
+        }
+     }
+   rtn_struct(theEnv,selectorTable,theTable);
+
+   theSelector->selectorTable = NULL;
+  }
+
+/*************************************************************/
+/* SelectorKeyList: Returns the list of keys of a child of a */
+/*   selector node. The key of a child is a constant, an or  */
+/*   function call of constants, or a not function call of   */
+/*   either for a complemented key list.                     */
+/*************************************************************/
+static struct expr *SelectorKeyList(
+  void *theEnv,
+  struct expr *theKeys,
+  intBool *complement)
+  {
+   *complement = FALSE;
+
+   if ((theKeys->type == FCALL) &&
+       (theKeys->value == ExpressionData(theEnv)->PTR_NOT))
+     {
+      *complement = TRUE;
+      theKeys = theKeys->argList;
+     }
+
+   if ((theKeys->type == FCALL) &&
+       (theKeys->value == ExpressionData(theEnv)->PTR_OR))
+     { return(theKeys->argList); }
+
+   return(theKeys);
+  }
+
+/**************************************************************/
+/* FindSelectorKey: Finds the slot of a key in the key table. */
+/*   If the key isn't in the table, either returns NULL or    */
+/*   claims an empty slot for the key.                        */
+/**************************************************************/
+static struct selectorKey *FindSelectorKey(
+  struct selectorTable *theTable,
+  unsigned short keyType,
+  void *keyValue,
+  intBool add)
+  {
+   unsigned long i, mask = theTable->size - 1;
+   struct selectorKey *theKey;
+
+   for (i = MixHashValue(GetAtomicHashValue(keyType,keyValue,1)) & mask;
+        ;
+        i = (i + 1) & mask)
+     {
+      theKey = &theTable->keys[i];
+
+      if (theKey->value == NULL)
+        {
+         if (! add) return(NULL);
+
+         theKey->type = keyType;
+         theKey->value = keyValue;
+         return(theKey);
+        }
+
+      if ((theKey->value == keyValue) && (theKey->type == keyType))
+        { return(theKey); }
+     }
+  }
+
+/**************************************************************/
+/* SelectorBoundKey: Determines whether the key of a child of */
+/*   a selector node is a bound, a >, >=, < or <= function    */
+/*   call of a number, and if so fills in the bound and       */
+/*   returns the list it belongs to. Otherwise returns -1.    */
+/**************************************************************/
+static int SelectorBoundKey(
+  struct expr *theKey,
+  struct selectorBound *theBound)
+  {
+   const char *name;
+   int lower;
+
+   if ((theKey->type != FCALL) || (theKey->argList == NULL))
+     { return(-1); }
+
+   name = ValueToString(ExpressionFunctionCallName(theKey));
+
+   if (strcmp(name,">") == 0)
+     { lower = TRUE; theBound->strict = TRUE; }
+   else if (strcmp(name,">=") == 0)
+     { lower = TRUE; theBound->strict = FALSE; }
+   else if (strcmp(name,"<") == 0)
+     { lower = FALSE; theBound->strict = TRUE; }
+   else if (strcmp(name,"<=") == 0)
+     { lower = FALSE; theBound->strict = FALSE; }
+   else
+     { return(-1); }
+
+   if (theKey->argList->type == INTEGER)
+     {
+      theBound->integerBound = ValueToLong(theKey->argList->value);
+      theBound->floatBound = (double) theBound->integerBound;
+      return(lower ? SELECTOR_LOWER_INTEGERS : SELECTOR_UPPER_INTEGERS);
+     }
+
+   if (theKey->argList->type == FLOAT)
+     {
+      theBound->integerBound = 0;
+      theBound->floatBound = ValueToDouble(theKey->argList->value);
+      return(lower ? SELECTOR_LOWER_FLOATS : SELECTOR_UPPER_FLOATS);
+     }
+
+   return(-1);
+  }
+
+/*****************************************************************/
+/* AddSatisfiedBounds: Adds the children whose bounds in a list  */
+/*   are satisfied by a number to the list of a match. An        */
+/*   integer is compared to integer bounds as an integer, other  */
+/*   comparisons are done with floats. Since the bounds are      */
+/*   sorted, the bounds the number is strictly beyond are at the */
+/*   start of the list, followed by those equal to the number.   */
+/*****************************************************************/
+static void AddSatisfiedBounds(
+  void *theEnv,
+  struct selectorMatches *theMatches,
+  struct selectorBoundList *theList,
+  int list,
+  DATA_OBJECT *theValue)
+  {
+   unsigned long low = 0, high = theList->count, middle, i;
+   int lower, integers;
+   long long theInteger = 0;
+   double theFloat;
+
+   lower = ((list == SELECTOR_LOWER_INTEGERS) || (list == SELECTOR_LOWER_FLOATS));
+   integers = ((list == SELECTOR_LOWER_INTEGERS) || (list == SELECTOR_UPPER_INTEGERS)) &&
+              (theValue->type == INTEGER);
+
+   if (theValue->type == INTEGER)
+     {
+      theInteger = ValueToLong(theValue->value);
+      theFloat = (double) theInteger;
+     }
+   else
+     { theFloat = ValueToDouble(theValue->value); }
+
+   while (low < high)
+     {
+      middle = low + ((high - low) / 2);
+      if (BoundComparison(&theList->bounds[middle],integers,theInteger,theFloat) == (lower ? -1 : 1))
+        { low = middle + 1; }
+      else
+        { high = middle; }
+     }
+
+   for (i = 0; i < low; i++)
+     { AddRangeMatch(theEnv,theMatches,&theList->bounds[i].child); }
+
+   /*===============================================*/
+   /* The bounds equal to the number are satisfied  */
+   /* unless they're strict.                        */
+   /*===============================================*/
+
+   for (i = low;
+        (i < theList->count) &&
+        (BoundComparison(&theList->bounds[i],integers,theInteger,theFloat) == 0);
+        i++)
+     {
+      if (! theList->bounds[i].strict)
+        { AddRangeMatch(theEnv,theMatches,&theList->bounds[i].child); }
+     }
+  }
+
+/*****************************************************************/
+/* BoundComparison: Returns -1, 0 or 1 as a bound is lower than, */
+/*   equal to or greater than a number, comparing integers if    */
+/*   the bound and the number are both integers, floats if not.  */
+/*****************************************************************/
+static int BoundComparison(
+  struct selectorBound *theBound,
+  int integers,
+  long long theInteger,
+  double theFloat)
+  {
+   if (integers)
+     {
+      if (theBound->integerBound < theInteger) return(-1);
+      if (theBound->integerBound > theInteger) return(1);
+      return(0);
+     }
+
+   if (theBound->floatBound < theFloat) return(-1);
+   if (theBound->floatBound > theFloat) return(1);
+   return(0);
+  }
+
+/******************************************************************/
+/* BoundTypeError: Evaluates the comparison of the first child    */
+/*   with a bound, in the order of the children, against a value  */
+/*   which isn't a number, so that the comparison function        */
+/*   reports the argument type error and halts execution. Returns */
+/*   that child.                                                  */
+/******************************************************************/
+static struct factPatternNode *BoundTypeError(
+  void *theEnv,
+  struct selectorTable *theTable,
+  DATA_OBJECT *theValue)
+  {
+   struct selectorChild *theChild = NULL;
+   struct selectorBoundList *theList;
+   struct expr theCall, theArgument;
+   DATA_OBJECT theResult;
+   unsigned long i;
+   int list;
+
+   for (list = 0; list < SELECTOR_BOUND_LISTS; list++)
+     {
+      theList = &theTable->boundLists[list];
+      for (i = 0; i < theList->count; i++)
+        {
+         if ((theChild == NULL) || (theList->bounds[i].child.position < theChild->position))
+           { theChild = &theList->bounds[i].child; }
+        }
+     }
+
+   /*=====================================================*/
+   /* The key (>= 200) of the child is evaluated as the   */
+   /* call (>= <value> 200) the test was compiled from.   */
+   /*=====================================================*/
+
+   theArgument.type = theValue->type;
+   theArgument.value = theValue->value;
+   theArgument.argList = NULL;
+   theArgument.nextArg = theChild->node->networkTest->argList;
+
+   theCall.type = FCALL;
+   theCall.value = theChild->node->networkTest->value;
+   theCall.argList = &theArgument;
+   theCall.nextArg = NULL;
+
+   EvaluateExpression(theEnv,&theCall,&theResult);
+
+   return(theChild->node);
+  }
+
+/***************************************************************/
+/* AddRangeMatch: Adds a child satisfied by a bound to the     */
+/*   list of a match, moving the list out of the buffer of the */
+/*   match when it's full.                                     */
+/***************************************************************/
+static void AddRangeMatch(
+  void *theEnv,
+  struct selectorMatches *theMatches,
+  struct selectorChild *theChild)
+  {
+   struct selectorChild **newRange;
+
+   if (theMatches->rangeCount == theMatches->rangeSize)
+     {
+      newRange = (struct selectorChild **)
+                 genalloc(theEnv,sizeof(struct selectorChild *) * theMatches->rangeSize * 2);
+      memcpy(newRange,theMatches->range,sizeof(struct selectorChild *) * theMatches->rangeCount);
+      if (theMatches->range != theMatches->rangeBuffer)
+        { genfree(theEnv,theMatches->range,sizeof(struct selectorChild *) * theMatches->rangeSize); }
+      theMatches->range = newRange;
+      theMatches->rangeSize *= 2;
+     }
+
+   theMatches->range[theMatches->rangeCount++] = theChild;
+  }
+
+/***************************************************************/
+/* CompareBounds: Orders two bounds of the same list by value. */
+/*   Integer bounds are ordered as integers, the float bound   */
+/*   of an integer being its conversion.                       */
+/***************************************************************/
+static int CompareBounds(
+  const struct selectorBound *b1,
+  const struct selectorBound *b2)
+  {
+   if (b1->integerBound < b2->integerBound) return(-1);
+   if (b1->integerBound > b2->integerBound) return(1);
+   if (b1->floatBound < b2->floatBound) return(-1);
+   if (b1->floatBound > b2->floatBound) return(1);
+   return(0);
+  }
+
+/***********************************************************/
+/* CompareLowerBounds: Orders lower bounds from the lowest */
+/*   bound, a non-strict bound before a strict one.        */
+/***********************************************************/
+static int CompareLowerBounds(
+  const void *first,
+  const void *second)
+  {
+   const struct selectorBound *b1 = (const struct selectorBound *) first;
+   const struct selectorBound *b2 = (const struct selectorBound *) second;
+   int comparison;
+
+   comparison = CompareBounds(b1,b2);
+   if (comparison != 0) return(comparison);
+   if (b1->strict != b2->strict) return(b1->strict ? 1 : -1);
+   if (b1->child.position < b2->child.position) return(-1);
+   if (b1->child.position > b2->child.position) return(1);
+   return(0);
+  }
+
+/*************************************************************/
+/* CompareUpperBounds: Orders upper bounds from the highest  */
+/*   bound, a non-strict bound before a strict one.          */
+/*************************************************************/
+static int CompareUpperBounds(
+  const void *first,
+  const void *second)
+  {
+   const struct selectorBound *b1 = (const struct selectorBound *) first;
+   const struct selectorBound *b2 = (const struct selectorBound *) second;
+   int comparison;
+
+   comparison = CompareBounds(b2,b1);
+   if (comparison != 0) return(comparison);
+   if (b1->strict != b2->strict) return(b1->strict ? 1 : -1);
+   if (b1->child.position < b2->child.position) return(-1);
+   if (b1->child.position > b2->child.position) return(1);
+   return(0);
+  }
+
+/**************************************************************/
+/* CompareChildPositions: Orders the children satisfied by    */
+/*   bounds in the order in which the children are matched.   */
+/**************************************************************/
+static int CompareChildPositions(
+  const void *first,
+  const void *second)
+  {
+   const struct selectorChild *c1 = *(struct selectorChild * const *) first;
+   const struct selectorChild *c2 = *(struct selectorChild * const *) second;
+
+   if (c1->position < c2->position) return(-1);
+   if (c1->position > c2->position) return(1);
+   return(0);
+  }
+
+#endif /* DEFTEMPLATE_CONSTRUCT && DEFRULE_CONSTRUCT */
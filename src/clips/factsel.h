@@ -0,0 +1,151 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.30  08/16/14            */
+   /*                                                     */
+   /*         FACT PATTERN SELECTOR HEADER FILE           */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Dispatches the value of a fact field tested by a */
+/*   selector node of the fact pattern network to the child  */
+/*   nodes whose constant keys it satisfies. A child node is */
+/*   satisfied by one key (red), any one of several keys     */
+/*   (red|blue), any value except its keys (~red&~blue), or  */
+/*   any number above or below a bound (:(>= ?x 200)).       */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_factsel
+#define _H_factsel
+
+#ifndef _H_evaluatn
+#include "evaluatn.h"
+#endif
+#ifndef _H_factbld
+#include "factbld.h"
+#endif
+
+#ifdef LOCALE
+#undef LOCALE
+#endif
+
+#ifdef _FACTSEL_SOURCE_
+#define LOCALE
+#else
+#define LOCALE extern
+#endif
+
+#define SELECTOR_RANGE_BUFFER_SIZE 32
+
+/*=======================================================*/
+/* The position of a child is its place among the other  */
+/* children of the selector, which is the order in which */
+/* the children are matched.                             */
+/*=======================================================*/
+
+struct selectorChild
+  {
+   struct factPatternNode *node;
+   unsigned long position;
+  };
+
+/*====================================================*/
+/* The children satisfied by a key, and the children  */
+/* with a complemented key list excluding the key.    */
+/* Both runs are stored in the child array of the     */
+/* table. A slot of the table not holding a key has   */
+/* a NULL value.                                      */
+/*====================================================*/
+
+struct selectorKey
+  {
+   unsigned short type;
+   void *value;
+   unsigned long matches;
+   unsigned long matchCount;
+   unsigned long exclusions;
+   unsigned long exclusionCount;
+  };
+
+/*=======================================================*/
+/* A child satisfied by the numbers above a lower bound  */
+/* (> or >=) or below an upper bound (< or <=). A strict */
+/* bound isn't satisfied by the bound itself. Integer    */
+/* bounds are compared to integers as integers, and to   */
+/* floats as floats, as the comparison functions do.     */
+/*=======================================================*/
+
+struct selectorBound
+  {
+   long long integerBound;
+   double floatBound;
+   int strict;
+   struct selectorChild child;
+  };
+
+/*======================================================*/
+/* The lower and upper bounds of a selector, integers   */
+/* and floats kept apart so that each list is sorted    */
+/* the way a number is compared to its bounds.          */
+/*======================================================*/
+
+#define SELECTOR_LOWER_INTEGERS 0
+#define SELECTOR_LOWER_FLOATS   1
+#define SELECTOR_UPPER_INTEGERS 2
+#define SELECTOR_UPPER_FLOATS   3
+#define SELECTOR_BOUND_LISTS    4
+
+struct selectorBoundList
+  {
+   unsigned long count;
+   struct selectorBound *bounds;
+  };
+
+struct selectorTable
+  {
+   unsigned long size;
+   struct selectorKey *keys;
+   unsigned long childCount;
+   unsigned long complementCount;
+   struct selectorChild *children;
+   unsigned long boundCount;
+   struct selectorBoundList boundLists[SELECTOR_BOUND_LISTS];
+  };
+
+/*=====================================================*/
+/* The children satisfied by bounds are listed in the  */
+/* order of the children, using the buffer unless      */
+/* there are too many of them.                         */
+/*=====================================================*/
+
+struct selectorMatches
+  {
+   struct selectorChild *match;
+   struct selectorChild *matchEnd;
+   struct selectorChild *complement;
+   struct selectorChild *complementEnd;
+   struct selectorChild *exclusion;
+   struct selectorChild *exclusionEnd;
+   struct selectorChild **range;
+   unsigned long rangePosition;
+   unsigned long rangeCount;
+   unsigned long rangeSize;
+   struct selectorChild *rangeBuffer[SELECTOR_RANGE_BUFFER_SIZE];
+  };
+
+   LOCALE struct factPatternNode        *StartSelectorMatches(void *,struct factPatternNode *,
+                                                              DATA_OBJECT *,struct selectorMatches *);
+   LOCALE struct factPatternNode        *NextSelectorMatch(struct selectorMatches *);
+   LOCALE void                           EndSelectorMatches(void *,struct selectorMatches *);
+   LOCALE void                           BuildSelectorTable(void *,struct factPatternNode *);
+   LOCALE void                           BuildSelectorTables(void *,struct factPatternNode *);
+   LOCALE void                           ReturnSelectorTable(void *,struct factPatternNode *);
+
+#endif /* _H_factsel */
@@ -33,6 +33,7 @@
 #include <stdio.h>
 #define _STDIO_INCLUDED_
 #include <stdlib.h>
+#include <string.h>
 
 #include "setup.h"
 
@@ -59,11 +60,12 @@
 /***************************************/
 
    static void                    ExtractAnds(void *,struct lhsParseNode *,int,
-                                              struct expr **,struct expr **,struct expr **,
-                                              struct expr **,struct nandFrame *);
+                                              struct expr **,struct expr **,struct nandFrame *);
    static void                    ExtractFieldTest(void *,struct lhsParseNode *,int,
-                                                   struct expr **,struct expr **,struct expr **,
-                                                   struct expr **,struct nandFrame *);
+                                                   struct expr **,struct expr **,struct nandFrame *);
+   static void                    GenSelectorKeys(void *,struct lhsParseNode *,int);
+   static struct expr            *GenSelectorBound(void *,struct lhsParseNode *,struct lhsParseNode *);
+   static int                     ConstantField(struct lhsParseNode *);
    static struct expr            *GetfieldReplace(void *,struct lhsParseNode *);
    static struct expr            *GenPNConstant(void *,struct lhsParseNode *);
    static struct expr            *GenJNConstant(void *,struct lhsParseNode *,int);
@@ -97,8 +99,6 @@ globle void FieldConversion(
    struct expr *tempExpression;
    struct expr *patternNetTest = NULL;
    struct expr *joinNetTest = NULL;
-   struct expr *constantSelector = NULL;
-   struct expr *constantValue = NULL;
 
    /*==================================================*/
    /* Consider a NULL pointer to be an internal error. */
@@ -142,33 +142,8 @@ globle void FieldConversion(
       /*=============================================*/
 
       ExtractAnds(theEnv,patternPtr,testInPatternNetwork,&patternNetTest,&joinNetTest,
-                  &constantSelector,&constantValue,theNandFrames);
+                  theNandFrames);
 
-      /*=============================================================*/
-      /* Constant hashing is only used in the pattern network if the */
-      /* field doesn't contain an or'ed constraint. For example, the */
-      /* constaint "red | blue" can not use hashing.                 */
-      /*=============================================================*/
-      
-      if (constantSelector != NULL)
-        {
-         if ((patternPtr == theField->bottom) &&
-             (patternPtr->bottom == NULL))
-           {
-            theField->constantSelector = constantSelector;
-            theField->constantValue = constantValue;
-           }
-         else
-           {
-            ReturnExpression(theEnv,constantSelector);
-            ReturnExpression(theEnv,constantValue);
-            ReturnExpression(theEnv,theField->constantSelector);
-            ReturnExpression(theEnv,theField->constantValue);
-            theField->constantSelector = NULL;
-            theField->constantValue = NULL;
-           }
-        }
-        
       /*=====================================================*/
       /* Add the new pattern network expressions to the list */
       /* of pattern network expressions being constructed.   */
@@ -223,6 +198,14 @@ globle void FieldConversion(
       tempExpression->argList = headOfJNExpression;
       headOfJNExpression = tempExpression;
      }
+
+   /*=========================================================*/
+   /* Determine if the constants tested by the field can be   */
+   /* used as the key of a selector node in the pattern       */
+   /* network, so that the field is tested by a table lookup. */
+   /*=========================================================*/
+
+   GenSelectorKeys(theEnv,theField,testInPatternNetwork);
      
    /*===============================================================*/
    /* If the field constraint binds a variable that was previously  */
@@ -304,11 +287,9 @@ static void ExtractAnds(
   int testInPatternNetwork,
   struct expr **patternNetTest,
   struct expr **joinNetTest,
-  struct expr **constantSelector,
-  struct expr **constantValue,
   struct nandFrame *theNandFrames)
   {
-   struct expr *newPNTest, *newJNTest, *newConstantSelector, *newConstantValue;
+   struct expr *newPNTest, *newJNTest;
 
    /*=================================================*/
    /* Before starting, the subfield has no pattern or */
@@ -317,8 +298,6 @@ static void ExtractAnds(
 
    *patternNetTest = NULL;
    *joinNetTest = NULL;
-   *constantSelector = NULL;
-   *constantValue = NULL;
 
    /*=========================================*/
    /* Loop through each of the subfields tied */
@@ -335,7 +314,7 @@ static void ExtractAnds(
       /*======================================*/
 
       ExtractFieldTest(theEnv,andField,testInPatternNetwork,&newPNTest,&newJNTest,
-                       &newConstantSelector,&newConstantValue,theNandFrames);
+                       theNandFrames);
 
       /*=================================================*/
       /* Add the new expressions to the list of pattern  */
@@ -344,8 +323,6 @@ static void ExtractAnds(
 
       *patternNetTest = CombineExpressions(theEnv,*patternNetTest,newPNTest);
       *joinNetTest = CombineExpressions(theEnv,*joinNetTest,newJNTest);
-      *constantSelector = CombineExpressions(theEnv,*constantSelector,newConstantSelector);
-      *constantValue = CombineExpressions(theEnv,*constantValue,newConstantValue);
      }
   }
 
@@ -371,14 +348,10 @@ static void ExtractFieldTest(
   int testInPatternNetwork,
   struct expr **patternNetTest,
   struct expr **joinNetTest,
-  struct expr **constantSelector,
-  struct expr **constantValue,
   struct nandFrame *theNandFrames)
   {
    *patternNetTest = NULL;
    *joinNetTest = NULL;
-   *constantSelector = NULL;
-   *constantValue = NULL;
 
    /*==========================================================*/
    /* Generate a network expression for a constant constraint. */
@@ -391,15 +364,7 @@ static void ExtractFieldTest(
        (theField->type == FLOAT) || (theField->type == INTEGER))
      {
       if (testInPatternNetwork == TRUE)
-        { 
-         *patternNetTest = GenPNConstant(theEnv,theField); 
-         
-         if (! theField->negated)
-           {
-            *constantSelector = (*theField->patternType->genGetPNValueFunction)(theEnv,theField);
-            *constantValue = GenConstant(theEnv,theField->type,theField->value);
-           }
-        }
+        { *patternNetTest = GenPNConstant(theEnv,theField); }
       else
         { *joinNetTest = GenJNConstant(theEnv,theField,FALSE); } // TBD Remove FALSE
      }
@@ -449,6 +414,246 @@ static void ExtractFieldTest(
      }
   }
 
+/******************************************************************/
+/* GenSelectorKeys: Determines if the constants tested by a field */
+/*   can be the key of a selector node in the pattern network.    */
+/*   The key is a single constant (red), an or function call of   */
+/*   constants for a field satisfied by any of several constants  */
+/*   (red|blue), a not function call of either for a field        */
+/*   satisfied by any value except the constants (~red&~blue), or */
+/*   a bound for a field satisfied by the numbers above or below  */
+/*   a constant (?x&:(>= ?x 200)). Variable comparisons to other  */
+/*   fields of the same pattern are tested by the selector node   */
+/*   before the lookup.                                           */
+/******************************************************************/
+static void GenSelectorKeys(
+  void *theEnv,
+  struct lhsParseNode *theField,
+  int testInPatternNetwork)
+  {
+   struct lhsParseNode *orField, *andField, *keyField;
+   struct expr *theKeys = NULL, *lastKey = NULL, *theResidual = NULL, *tempExpression;
+   struct expr *theBound = NULL;
+   int singleField, complement = FALSE, keyCount = 0;
+
+   if ((testInPatternNetwork == FALSE) || (theField->bottom == NULL))
+     { return; }
+
+   singleField = ((theField->type == SF_WILDCARD) || (theField->type == SF_VARIABLE));
+
+   /*===================================================*/
+   /* A field with several or'ed constraints is hashed  */
+   /* only if each constraint is a single constant.     */
+   /*===================================================*/
+
+   if (theField->bottom->bottom != NULL)
+     {
+      if (! singleField) return;
+
+      for (orField = theField->bottom; orField != NULL; orField = orField->bottom)
+        {
+         if ((orField->right != NULL) || orField->negated ||
+             (! ConstantField(orField)))
+           {
+            ReturnExpression(theEnv,theKeys);
+            return;
+           }
+
+         tempExpression = GenConstant(theEnv,orField->type,orField->value);
+         if (lastKey == NULL)
+           { theKeys = tempExpression; }
+         else
+           { lastKey->nextArg = tempExpression; }
+         lastKey = tempExpression;
+        }
+
+      tempExpression = GenConstant(theEnv,FCALL,ExpressionData(theEnv)->PTR_OR);
+      tempExpression->argList = theKeys;
+      theKeys = tempExpression;
+     }
+
+   /*=====================================================*/
+   /* A field with a single constraint is hashed if the   */
+   /* constants tested are either one positive constant,  */
+   /* negated constants, or one bound. The subfields      */
+   /* which aren't constants must be variables.           */
+   /*=====================================================*/
+
+   else
+     {
+      keyField = NULL;
+      for (andField = theField->bottom; andField != NULL; andField = andField->right)
+        {
+         if (andField->type == SF_VARIABLE)
+           {
+            if ((andField->referringNode != NULL) &&
+                (andField->referringNode->pattern == theField->pattern))
+              {
+               tempExpression = GenPNVariableComparison(theEnv,andField,andField->referringNode);
+               theResidual = CombineExpressions(theEnv,theResidual,tempExpression);
+              }
+            continue;
+           }
+
+         if ((andField->type == PREDICATE_CONSTRAINT) && (theBound == NULL))
+           {
+            theBound = GenSelectorBound(theEnv,theField,andField);
+            if (theBound != NULL) continue;
+           }
+
+         if (! ConstantField(andField))
+           { break; }
+
+         if (andField->negated)
+           {
+            complement = TRUE;
+            keyCount++;
+            tempExpression = GenConstant(theEnv,andField->type,andField->value);
+            if (lastKey == NULL)
+              { theKeys = tempExpression; }
+            else
+              { lastKey->nextArg = tempExpression; }
+            lastKey = tempExpression;
+           }
+         else if (keyField == NULL)
+           { keyField = andField; }
+         else
+           { break; }
+        }
+
+      /*==================================================*/
+      /* A positive constant is tested along with negated */
+      /* constants or a bound only by the field's network */
+      /* test, and only single field values can be        */
+      /* complemented.                                    */
+      /*==================================================*/
+
+      if ((andField != NULL) ||
+          ((keyField != NULL) && complement) ||
+          ((theBound != NULL) && ((keyField != NULL) || complement)) ||
+          ((keyField == NULL) && (! complement) && (theBound == NULL)) ||
+          (complement && (! singleField)))
+        {
+         ReturnExpression(theEnv,theKeys);
+         ReturnExpression(theEnv,theResidual);
+         ReturnExpression(theEnv,theBound);
+         return;
+        }
+
+      if (theBound != NULL)
+        { theKeys = theBound; }
+      else if (keyField != NULL)
+        { theKeys = GenConstant(theEnv,keyField->type,keyField->value); }
+      else
+        {
+         if (keyCount > 1)
+           {
+            tempExpression = GenConstant(theEnv,FCALL,ExpressionData(theEnv)->PTR_OR);
+            tempExpression->argList = theKeys;
+            theKeys = tempExpression;
+           }
+
+         tempExpression = GenConstant(theEnv,FCALL,ExpressionData(theEnv)->PTR_NOT);
+         tempExpression->argList = theKeys;
+         theKeys = tempExpression;
+        }
+     }
+
+   /*===================================================*/
+   /* A variable binding the field which was previously */
+   /* bound in the same pattern is compared as well.    */
+   /*===================================================*/
+
+   if ((theField->type == SF_VARIABLE) &&
+       (theField->referringNode != NULL) &&
+       (theField->referringNode->pattern == theField->pattern))
+     {
+      tempExpression = GenPNVariableComparison(theEnv,theField,theField->referringNode);
+      theResidual = CombineExpressions(theEnv,tempExpression,theResidual);
+     }
+
+   theField->constantSelector = (*theField->patternType->genGetPNValueFunction)(theEnv,theField);
+   theField->constantSelector->nextArg = theResidual;
+   theField->constantValue = theKeys;
+  }
+
+/*****************************************************************/
+/* GenSelectorBound: Returns the key of a selector node for a    */
+/*   predicate constraint comparing the variable bound by a      */
+/*   single field to a number with >, >=, < or <=. The key is    */
+/*   the comparison function call with the number as argument,   */
+/*   reversed if the number is compared to the variable, so that */
+/*   (< 200 ?x) has the key (> 200). Returns NULL if the         */
+/*   predicate constraint can't be the key of a selector node,   */
+/*   or if threshold indexing is off.                            */
+/*****************************************************************/
+static struct expr *GenSelectorBound(
+  void *theEnv,
+  struct lhsParseNode *theField,
+  struct lhsParseNode *thePredicate)
+  {
+   struct lhsParseNode *theCall, *theVariable, *theNumber;
+   const char *name;
+   struct expr *theBound;
+
+   theCall = thePredicate->expression;
+
+   if ((! DefruleData(theEnv)->ThresholdIndexingFlag) ||
+       (theField->type != SF_VARIABLE) ||
+       thePredicate->negated ||
+       (theCall == NULL) ||
+       (theCall->type != FCALL) ||
+       (theCall->bottom == NULL) ||
+       (theCall->bottom->right == NULL) ||
+       (theCall->bottom->right->right != NULL))
+     { return(NULL); }
+
+   name = ValueToString(((struct FunctionDefinition *) theCall->value)->callFunctionName);
+   if ((strcmp(name,">") != 0) && (strcmp(name,">=") != 0) &&
+       (strcmp(name,"<") != 0) && (strcmp(name,"<=") != 0))
+     { return(NULL); }
+
+   theVariable = theCall->bottom;
+   theNumber = theVariable->right;
+   if (theVariable->type != SF_VARIABLE)
+     {
+      theVariable = theNumber;
+      theNumber = theCall->bottom;
+
+      if (strcmp(name,">") == 0) name = "<";
+      else if (strcmp(name,">=") == 0) name = "<=";
+      else if (strcmp(name,"<") == 0) name = ">";
+      else name = ">=";
+     }
+
+   if ((theVariable->type != SF_VARIABLE) ||
+       (theVariable->value != theField->value) ||
+       ((theNumber->type != INTEGER) && (theNumber->type != FLOAT)))
+     { return(NULL); }
+
+   theBound = GenConstant(theEnv,FCALL,FindFunction(theEnv,name));
+   theBound->argList = GenConstant(theEnv,theNumber->type,theNumber->value);
+
+   return(theBound);
+  }
+
+/******************************************************/
+/* ConstantField: Returns TRUE if a subfield of a     */
+/*   field constraint is a constant, otherwise FALSE. */
+/******************************************************/
+static int ConstantField(
+  struct lhsParseNode *theField)
+  {
+   if ((theField->type == STRING) || (theField->type == SYMBOL) ||
+#if OBJECT_SYSTEM
+       (theField->type == INSTANCE_NAME) ||
+#endif
+       (theField->type == FLOAT) || (theField->type == INTEGER))
+     { return(TRUE); }
+
+   return(FALSE);
+  }
+
 /*********************************************************/
 /* GenPNConstant: Generates an expression for use in the */
 /*  pattern network of a data entity (such as a fact or  */
@@ -597,6 +802,17 @@ static struct expr *GenPNColon(
 
    conversion = GetfieldReplace(theEnv,theField->expression);
 
+   /*=================================================*/
+   /* A numeric comparison of slot values may be done */
+   /* by a routine specialized for the comparison.    */
+   /*=================================================*/
+
+   if (theField->patternType->genPNComparisonFunction != NULL)
+     {
+      top = (*theField->patternType->genPNComparisonFunction)(theEnv,conversion);
+      if (top != NULL) conversion = top;
+     }
+
    /*================================================*/
    /* If the predicate constraint is negated by a ~, */
    /* then wrap a "not" function call around the     */
@@ -122,6 +122,7 @@ static void UpdateRestriction(void *,void *,long);
 static void UpdateType(void *,void *,long);
 static void ClearBloadGenerics(void *);
 static void DeallocateDefgenericBinaryData(void *);
+static int DefgenericsFreezeReady(void *);
 
 /* =========================================
    *****************************************
@@ -154,6 +155,7 @@ globle void SetupGenericsBload(
                              BloadStorageGenerics,BloadGenerics,
                              ClearBloadGenerics);
 #endif
+   AddFreezeBloadReadyFunction(theEnv,"defgeneric",DefgenericsFreezeReady,0);
   }
   
 /***********************************************************/
@@ -183,6 +185,23 @@ static void DeallocateDefgenericBinaryData(
 #endif
   }
 
+/***************************************************************
+  NAME         : DefgenericsFreezeReady
+  DESCRIPTION  : Determines if a binary image can be shared
+                   by other environments
+  INPUTS       : None
+  RETURNS      : TRUE if there are no generic functions,
+                   FALSE otherwise
+  SIDE EFFECTS : None
+  NOTES        : Generic functions keep their method
+                   busy counts in the constructs
+ ***************************************************************/
+static int DefgenericsFreezeReady(
+  void *theEnv)
+  {
+   return(DefgenericBinaryData(theEnv)->GenericCount == 0L);
+  }
+
 /***************************************************
   NAME         : BloadDefgenericModuleReference
   DESCRIPTION  : Returns a pointer to the
@@ -625,7 +644,7 @@ static void BsaveRestrictionTypes(
 #if OBJECT_SYSTEM
             dummy_type = DefclassIndex(rptr->types[k]);
 #else
-            dummy_type = (long) ((INTEGER_HN *) rptr->types[k])->contents;
+            dummy_type = (long) ValueToLong(rptr->types[k]);
 #endif
             GenWrite(&dummy_type,sizeof(long),(FILE *) userBuffer);
            }
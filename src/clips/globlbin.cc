@@ -59,6 +59,7 @@
    static void                    UpdateDefglobal(void *,void *,long);
    static void                    ClearBload(void *);
    static void                    DeallocateDefglobalBloadData(void *);
+   static int                     DefglobalsFreezeReady(void *);
 
 /*********************************************/
 /* DefglobalBinarySetup: Installs the binary */
@@ -70,6 +71,7 @@ globle void DefglobalBinarySetup(
    AllocateEnvironmentData(theEnv,GLOBLBIN_DATA,sizeof(struct defglobalBinaryData),DeallocateDefglobalBloadData);
 #if (BLOAD_AND_BSAVE || BLOAD)
    AddAfterBloadFunction(theEnv,"defglobal",ResetDefglobals,50);
+   AddFreezeBloadReadyFunction(theEnv,"defglobal",DefglobalsFreezeReady,0);
 #endif
 
 #if BLOAD_AND_BSAVE
@@ -113,6 +115,17 @@ static void DeallocateDefglobalBloadData(
 #endif
   }
 
+/**********************************************************/
+/* DefglobalsFreezeReady: The values of the defglobals    */
+/*   are stored in the constructs, so a binary image with */
+/*   defglobals can't be shared by other environments.    */
+/**********************************************************/
+static int DefglobalsFreezeReady(
+  void *theEnv)
+  {
+   return(DefglobalBinaryData(theEnv)->NumberOfDefglobals == 0);
+  }
+
 #if BLOAD_AND_BSAVE
 
 /****************************************************/
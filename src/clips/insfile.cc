@@ -1078,10 +1078,10 @@ static void MarkNeededAtom(
          ((SYMBOL_HN *) value)->neededSymbol = TRUE;
          break;
       case FLOAT:
-         ((FLOAT_HN *) value)->neededFloat = TRUE;
+         BoxedFloat(theEnv,value)->neededFloat = TRUE;
          break;
       case INTEGER:
-         ((INTEGER_HN *) value)->neededInteger = TRUE;
+         BoxedInteger(theEnv,value)->neededInteger = TRUE;
          break;
       case INSTANCE_ADDRESS:
          GetFullInstanceName(theEnv,(INSTANCE_TYPE *) value)->neededSymbol = TRUE;
@@ -1207,10 +1207,10 @@ static void SaveAtomBinary(
          bsa.value = (long) ((SYMBOL_HN *) value)->bucket;
          break;
       case FLOAT:
-         bsa.value = (long) ((FLOAT_HN *) value)->bucket;
+         bsa.value = (long) BoxedFloat(theEnv,value)->bucket;
          break;
       case INTEGER:
-         bsa.value = (long) ((INTEGER_HN *) value)->bucket;
+         bsa.value = (long) BoxedInteger(theEnv,value)->bucket;
          break;
       case INSTANCE_ADDRESS:
          bsa.type = INSTANCE_NAME;
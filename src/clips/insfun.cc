@@ -1292,9 +1292,9 @@ static INSTANCE_TYPE *FindImportedInstance(
    struct portItem *importList;
    INSTANCE_TYPE *ins;
 
-   if (theModule->visitedFlag)
+   if (DefmoduleVisitedFlag(theEnv,theModule))
      return(NULL);
-   theModule->visitedFlag = TRUE;
+   DefmoduleVisitedFlag(theEnv,theModule) = TRUE;
    importList = theModule->importList;
    while (importList != NULL)
      {
@@ -59,6 +59,7 @@
 
 #include "classcom.h"
 #include "classfun.h"
+#include "constrct.h"
 #include "engine.h"
 #include "envrnmnt.h"
 #include "memalloc.h"
@@ -306,6 +307,14 @@ globle INSTANCE_TYPE *BuildInstance(
       return(NULL);
      }
 #endif
+   if (ConstructData(theEnv)->ConstructsFrozen)
+     {
+      PrintErrorID(theEnv,"INSMNGR",17,FALSE);
+      EnvPrintRouter(theEnv,WERROR,"Cannot create instances of classes shared\n");
+      EnvPrintRouter(theEnv,WERROR,"  by a frozen binary image.\n");
+      SetEvaluationError(theEnv,TRUE);
+      return(NULL);
+     }
    if (cls->abstract)
      {
       PrintErrorID(theEnv,"INSMNGR",3,FALSE);
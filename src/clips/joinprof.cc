@@ -0,0 +1,1658 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.30  08/16/14            */
+   /*                                                     */
+   /*                 JOIN PROFILE MODULE                 */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Saves the join activity of the rules (right      */
+/*   activations, left memory additions, comparisons and     */
+/*   partial matches passed on) as a join profile, and       */
+/*   reorders the pattern CEs of rules loaded while a        */
+/*   profile is in effect so the CEs predicted to need the   */
+/*   fewest comparisons are joined first. The predicted and  */
+/*   observed comparisons of the reordered rules, and the    */
+/*   runs of CEs left in rule order, are listed by the       */
+/*   join-profile-report command.                            */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#define _JOINPROF_SOURCE_
+
+#include <stdio.h>
+#define _STDIO_INCLUDED_
+#include <string.h>
+
+#include "setup.h"
+
+#if DEFRULE_CONSTRUCT
+
+#include "argacces.h"
+#include "constant.h"
+#include "constrct.h"
+#include "cstrccom.h"
+#include "envrnmnt.h"
+#include "extnfunc.h"
+#include "memalloc.h"
+#include "moduldef.h"
+#include "modulutl.h"
+#include "network.h"
+#include "prntutil.h"
+#include "router.h"
+#include "ruledef.h"
+#include "scanner.h"
+#include "sysdep.h"
+
+#include "joinprof.h"
+
+#define JOIN_PROFILE_TABLE_SIZE 64
+
+/*=====================================================*/
+/* The orders of runs of up to MAXIMUM_SEARCHED_RUN    */
+/* pattern CEs are all searched, longer runs are       */
+/* ordered greedily, and runs of more than             */
+/* MAXIMUM_REORDERED_RUN CEs aren't reordered. A run   */
+/* is only reordered if its predicted comparisons are  */
+/* below those of the order of the rule by at least    */
+/* the reorder threshold, a percentage set with the    */
+/* set-join-reorder-threshold command.                 */
+/*=====================================================*/
+
+#define MAXIMUM_SEARCHED_RUN        8
+#define MAXIMUM_REORDERED_RUN      64
+#define DEFAULT_REORDER_THRESHOLD  10.0
+
+/*====================================================*/
+/* A variable in a pattern CE, which the pattern CE   */
+/* binds if it isn't negated, or'ed, or used within   */
+/* a predicate or return value constraint. A variable */
+/* bound to the fact or instance matching a pattern   */
+/* can't be used by the CEs preceding the pattern.    */
+/*====================================================*/
+
+#define PATTERN_ADDRESS_BINDER 2
+
+struct patternVariable
+  {
+   SYMBOL_HN *name;
+   int binder;
+  };
+
+/*======================================================*/
+/* The estimates for the CEs of a run being reordered.  */
+/* A CE joined after the partial matches of the CEs     */
+/* preceding it compares and passes on the given rates  */
+/* of their cross product with its activations. A CE    */
+/* joined first in the rule needs no comparisons. The   */
+/* profiled rates of a CE are used as long as the CEs   */
+/* of the run it shares variables with precede it just  */
+/* as they did when profiled. Otherwise a CE sharing    */
+/* variables is assumed to pass on one match for each   */
+/* partial match, comparing one match if the variables  */
+/* are bound by both CEs, since their memories are then */
+/* hashed, and all matches otherwise, while a CE        */
+/* sharing none compares and passes on all matches. A   */
+/* CE must follow the CEs binding the variables it      */
+/* uses.                                                */
+/*======================================================*/
+
+struct joinOrderSearch
+  {
+   unsigned short count;
+   intBool startsRule;
+   double prefix;
+   double activations[MAXIMUM_REORDERED_RUN];
+   double passRate[MAXIMUM_REORDERED_RUN];
+   double firstPassRate[MAXIMUM_REORDERED_RUN];
+   double compareRate[MAXIMUM_REORDERED_RUN];
+   unsigned short position[MAXIMUM_REORDERED_RUN];
+   intBool profiledFirst[MAXIMUM_REORDERED_RUN];
+   intBool prefixShared[MAXIMUM_REORDERED_RUN];
+   intBool prefixBound[MAXIMUM_REORDERED_RUN];
+   unsigned long long shares[MAXIMUM_REORDERED_RUN];
+   unsigned long long binds[MAXIMUM_REORDERED_RUN];
+   unsigned long long profiledShares[MAXIMUM_REORDERED_RUN];
+   unsigned long long mustFollow[MAXIMUM_REORDERED_RUN];
+   unsigned short current[MAXIMUM_REORDERED_RUN];
+   unsigned short best[MAXIMUM_REORDERED_RUN];
+   double bestCost;
+  };
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                    DeallocateJoinProfileData(void *);
+   static void                    ClearJoinProfileOrders(void *);
+   static unsigned long           JoinProfileHashValue(SYMBOL_HN *,SYMBOL_HN *,unsigned short);
+   static struct joinProfile     *FindJoinProfile(void *,SYMBOL_HN *,SYMBOL_HN *,unsigned short,intBool);
+   static void                    GrowJoinProfileTable(void *);
+   static void                    ReturnJoinProfileUnits(void *,struct joinProfile *);
+   static void                    ReturnJoinProfileOrder(void *,struct joinProfile *);
+   static void                    PrintJoinProfileSkip(void *,const char *,struct joinProfileSkip *,unsigned short);
+   static unsigned short          RuleJoinChain(struct defrule *,struct joinNode **);
+   static void                    SaveJoinProfileAction(void *,struct constructHeader *,void *);
+   static intBool                 LoadJoinProfileEntry(void *,const char *,struct token *);
+   static void                    JoinProfileReportAction(void *,struct constructHeader *,void *);
+   static void                    PrintCompareReduction(void *,const char *,const char *,long long,long long);
+#if (! RUN_TIME) && (! BLOAD_ONLY)
+   static unsigned short          JoinUnits(struct lhsParseNode *,struct lhsParseNode **,intBool *);
+   static intBool                 MovablePattern(struct lhsParseNode *);
+   static unsigned long           PatternVariables(struct lhsParseNode *,struct patternVariable *);
+   static unsigned long           FieldVariables(struct lhsParseNode *,struct patternVariable *,unsigned long);
+   static unsigned long           ExpressionVariables(struct lhsParseNode *,struct patternVariable *,unsigned long);
+   static unsigned long           AddPatternVariable(struct patternVariable *,unsigned long,void *,int);
+   static void                    RunDependencies(void *,struct lhsParseNode **,unsigned short,struct joinOrderSearch *);
+   static intBool                 EstimateRun(struct joinProfile *,unsigned short,unsigned short,struct joinOrderSearch *);
+   static double                  StepCost(struct joinOrderSearch *,unsigned short,unsigned short,unsigned long long,double,double *);
+   static double                  OrderCost(struct joinOrderSearch *,unsigned short *);
+   static void                    SearchJoinOrder(struct joinOrderSearch *,unsigned short,unsigned long long,double,double);
+   static void                    GreedyJoinOrder(struct joinOrderSearch *);
+   static void                    SkipJoinRun(struct joinProfileSkip *,unsigned short *,unsigned short,
+                                              unsigned short,unsigned short,long long,long long);
+#endif
+
+/********************************************************/
+/* InitializeJoinProfiles: Allocates the join profile   */
+/*   table and defines the join profile commands.       */
+/********************************************************/
+globle void InitializeJoinProfiles(
+  void *theEnv)
+  {
+   AllocateEnvironmentData(theEnv,JOIN_PROFILE_DATA,sizeof(struct joinProfileData),DeallocateJoinProfileData);
+
+   JoinProfileData(theEnv)->ProfileTable = (struct joinProfile **)
+      CreateLinearHashTable(theEnv,&JoinProfileData(theEnv)->ProfileTableInfo,JOIN_PROFILE_TABLE_SIZE);
+
+   JoinProfileData(theEnv)->ReorderThreshold = DEFAULT_REORDER_THRESHOLD;
+
+   EnvAddClearFunction(theEnv,"join-profile-orders",ClearJoinProfileOrders,0);
+
+#if ! RUN_TIME
+   EnvDefineFunction2(theEnv,"save-join-profile",'b',PTIEF SaveJoinProfileCommand,
+                      "SaveJoinProfileCommand","11k");
+   EnvDefineFunction2(theEnv,"load-join-profile",'b',PTIEF LoadJoinProfileCommand,
+                      "LoadJoinProfileCommand","11k");
+   EnvDefineFunction2(theEnv,"clear-join-profile",'v',PTIEF ClearJoinProfileCommand,
+                      "ClearJoinProfileCommand","00");
+   EnvDefineFunction2(theEnv,"join-profile-report",'v',PTIEF JoinProfileReportCommand,
+                      "JoinProfileReportCommand","00");
+   EnvDefineFunction2(theEnv,"set-join-reorder-threshold",'d',PTIEF SetJoinReorderThresholdCommand,
+                      "SetJoinReorderThresholdCommand","11n");
+   EnvDefineFunction2(theEnv,"get-join-reorder-threshold",'d',PTIEF GetJoinReorderThresholdCommand,
+                      "GetJoinReorderThresholdCommand","00");
+#endif
+  }
+
+/*****************************************************/
+/* DeallocateJoinProfileData: Deallocates the join   */
+/*   profile table of an environment.                */
+/*****************************************************/
+static void DeallocateJoinProfileData(
+  void *theEnv)
+  {
+   struct joinProfile *theProfile, *nextProfile;
+   unsigned long i;
+
+   for (i = 0; i < JoinProfileData(theEnv)->ProfileTableInfo.size; i++)
+     {
+      for (theProfile = JoinProfileData(theEnv)->ProfileTable[i];
+           theProfile != NULL;
+           theProfile = nextProfile)
+        {
+         nextProfile = theProfile->next;
+         ReturnJoinProfileUnits(theEnv,theProfile);
+         ReturnJoinProfileOrder(theEnv,theProfile);
+         rtn_struct(theEnv,joinProfile,theProfile);
+        }
+     }
+
+   ReturnLinearHashTable(theEnv,&JoinProfileData(theEnv)->ProfileTableInfo,
+                         (void **) JoinProfileData(theEnv)->ProfileTable);
+  }
+
+/*********************************************************/
+/* ClearJoinProfileOrders: Forgets the orders in which   */
+/*   the CEs of the rules were joined, and the runs left */
+/*   in rule order, when the rules are cleared. The      */
+/*   profiles themselves are kept.                       */
+/*********************************************************/
+static void ClearJoinProfileOrders(
+  void *theEnv)
+  {
+   struct joinProfile *theProfile;
+   unsigned long i;
+
+   for (i = 0; i < JoinProfileData(theEnv)->ProfileTableInfo.size; i++)
+     {
+      for (theProfile = JoinProfileData(theEnv)->ProfileTable[i];
+           theProfile != NULL;
+           theProfile = theProfile->next)
+        { ReturnJoinProfileOrder(theEnv,theProfile); }
+     }
+  }
+
+/*********************************************************/
+/* JoinProfileHashValue: Returns the hash value of the   */
+/*   key of a profile, the module and name of the rule   */
+/*   and the disjunct profiled.                          */
+/*********************************************************/
+static unsigned long JoinProfileHashValue(
+  SYMBOL_HN *moduleName,
+  SYMBOL_HN *ruleName,
+  unsigned short disjunct)
+  {
+   return(MixHashValue((((unsigned long) ruleName->bucket) * 65599UL) +
+                       (((unsigned long) moduleName->bucket) * 257UL) + disjunct));
+  }
+
+/********************************************************/
+/* FindJoinProfile: Finds the profile of a disjunct of  */
+/*   a rule. If there's no such profile, either returns */
+/*   NULL or adds an empty profile for the disjunct.    */
+/********************************************************/
+static struct joinProfile *FindJoinProfile(
+  void *theEnv,
+  SYMBOL_HN *moduleName,
+  SYMBOL_HN *ruleName,
+  unsigned short disjunct,
+  intBool add)
+  {
+   struct joinProfile *theProfile;
+   unsigned long theBucket;
+
+   theBucket = LinearHashIndex(&JoinProfileData(theEnv)->ProfileTableInfo,
+                               JoinProfileHashValue(moduleName,ruleName,disjunct));
+
+   for (theProfile = JoinProfileData(theEnv)->ProfileTable[theBucket];
+        theProfile != NULL;
+        theProfile = theProfile->next)
+     {
+      if ((theProfile->ruleName == ruleName) &&
+          (theProfile->moduleName == moduleName) &&
+          (theProfile->disjunct == disjunct))
+        { return(theProfile); }
+     }
+
+   if (! add) return(NULL);
+
+   theProfile = get_struct(theEnv,joinProfile);
+   theProfile->moduleName = moduleName;
+   IncrementSymbolCount(moduleName);
+   theProfile->ruleName = ruleName;
+   IncrementSymbolCount(ruleName);
+   theProfile->disjunct = disjunct;
+   theProfile->unitCount = 0;
+   theProfile->units = NULL;
+   theProfile->orderCount = 0;
+   theProfile->order = NULL;
+   theProfile->skipCount = 0;
+   theProfile->skipped = NULL;
+   theProfile->profiledCompares = 0;
+   theProfile->predictedCompares = 0;
+   theProfile->next = JoinProfileData(theEnv)->ProfileTable[theBucket];
+   JoinProfileData(theEnv)->ProfileTable[theBucket] = theProfile;
+
+   if (++JoinProfileData(theEnv)->ProfileTableInfo.count > JoinProfileData(theEnv)->ProfileTableInfo.size)
+     { GrowJoinProfileTable(theEnv); }
+
+   return(theProfile);
+  }
+
+/****************************************************************/
+/* GrowJoinProfileTable: Splits the next bucket of the profile  */
+/*   table, moving the profiles whose hash value now maps to    */
+/*   the new bucket.                                            */
+/****************************************************************/
+static void GrowJoinProfileTable(
+  void *theEnv)
+  {
+   unsigned long splitBucket, newBucket;
+   struct joinProfile *theProfile, *nextProfile, *prev, **theTable;
+   struct linearHashInfo *theInfo;
+
+   theInfo = &JoinProfileData(theEnv)->ProfileTableInfo;
+   theTable = (struct joinProfile **)
+      ExpandLinearHashTable(theEnv,theInfo,(void **) JoinProfileData(theEnv)->ProfileTable,&splitBucket);
+   JoinProfileData(theEnv)->ProfileTable = theTable;
+
+   for (theProfile = theTable[splitBucket], prev = NULL;
+        theProfile != NULL;
+        theProfile = nextProfile)
+     {
+      nextProfile = theProfile->next;
+
+      newBucket = LinearHashIndex(theInfo,JoinProfileHashValue(theProfile->moduleName,
+                                                               theProfile->ruleName,
+                                                               theProfile->disjunct));
+      if (newBucket == splitBucket)
+        {
+         prev = theProfile;
+         continue;
+        }
+
+      if (prev == NULL)
+        { theTable[splitBucket] = nextProfile; }
+      else
+        { prev->next = nextProfile; }
+
+      theProfile->next = theTable[newBucket];
+      theTable[newBucket] = theProfile;
+     }
+  }
+
+/*******************************************************/
+/* ReturnJoinProfileUnits: Returns the join activity   */
+/*   stored in a profile.                              */
+/*******************************************************/
+static void ReturnJoinProfileUnits(
+  void *theEnv,
+  struct joinProfile *theProfile)
+  {
+   if (theProfile->units == NULL) return;
+
+   rm(theEnv,theProfile->units,sizeof(struct joinProfileUnit) * theProfile->unitCount);
+   theProfile->units = NULL;
+   theProfile->unitCount = 0;
+  }
+
+/*******************************************************/
+/* ReturnJoinProfileOrder: Returns the order in which  */
+/*   the CEs of a disjunct were joined and the runs of */
+/*   CEs left in rule order.                           */
+/*******************************************************/
+static void ReturnJoinProfileOrder(
+  void *theEnv,
+  struct joinProfile *theProfile)
+  {
+   if (theProfile->order != NULL)
+     { rm(theEnv,theProfile->order,sizeof(unsigned short) * theProfile->orderCount); }
+
+   if (theProfile->skipped != NULL)
+     { rm(theEnv,theProfile->skipped,sizeof(struct joinProfileSkip) * theProfile->skipCount); }
+
+   theProfile->order = NULL;
+   theProfile->orderCount = 0;
+   theProfile->skipped = NULL;
+   theProfile->skipCount = 0;
+  }
+
+/*************************************************************/
+/* RuleJoinChain: Stores the joins of a disjunct, from its   */
+/*   first join to the join activating the rule, and returns */
+/*   the number of joins before the join activating it.      */
+/*************************************************************/
+static unsigned short RuleJoinChain(
+  struct defrule *theDisjunct,
+  struct joinNode **theJoins)
+  {
+   struct joinNode *theJoin;
+   unsigned short count = 0;
+
+   for (theJoin = theDisjunct->lastJoin->lastLevel;
+        theJoin != NULL;
+        theJoin = theJoin->lastLevel)
+     { count++; }
+
+   if (theJoins == NULL) return(count);
+
+   theJoins[count] = theDisjunct->lastJoin;
+   for (theJoin = theDisjunct->lastJoin->lastLevel;
+        theJoin != NULL;
+        theJoin = theJoin->lastLevel)
+     { theJoins[theJoin->depth - 1] = theJoin; }
+
+   return(count);
+  }
+
+/*******************************************************/
+/* SaveJoinProfileCommand: H/L access routine for the  */
+/*   save-join-profile command.                        */
+/*******************************************************/
+globle int SaveJoinProfileCommand(
+  void *theEnv)
+  {
+   const char *fileName;
+
+   if ((fileName = GetFileName(theEnv,"save-join-profile",1)) == NULL) return(FALSE);
+
+   return(EnvSaveJoinProfile(theEnv,fileName));
+  }
+
+/*************************************************************/
+/* EnvSaveJoinProfile: C access routine for the              */
+/*   save-join-profile command. Saves the join activity      */
+/*   counted since the last join-activity-reset command for  */
+/*   every disjunct of every rule, identifying the CEs by    */
+/*   their order in the rule even if they were reordered.    */
+/*************************************************************/
+globle intBool EnvSaveJoinProfile(
+  void *theEnv,
+  const char *fileName)
+  {
+   FILE *filePtr;
+
+   if ((filePtr = GenOpen(theEnv,fileName,"w")) == NULL)
+     {
+      OpenErrorMessage(theEnv,"save-join-profile",fileName);
+      return(FALSE);
+     }
+
+   SetFastSave(theEnv,filePtr);
+
+   DoForAllConstructs(theEnv,SaveJoinProfileAction,
+                      DefruleData(theEnv)->DefruleModuleIndex,FALSE,filePtr);
+
+   GenClose(theEnv,filePtr);
+   SetFastSave(theEnv,NULL);
+
+   return(TRUE);
+  }
+
+/**************************************************************/
+/* SaveJoinProfileAction: Saves the join activity of each     */
+/*   disjunct of a rule as                                    */
+/*                                                            */
+/*   (<module>::<rule> <disjunct> <CE count>                  */
+/*      (<CE> <position> <right activations> <left adds>      */
+/*       <compares> <passes>)*)                               */
+/**************************************************************/
+static void SaveJoinProfileAction(
+  void *theEnv,
+  struct constructHeader *theConstruct,
+  void *buffer)
+  {
+   struct defrule *theDisjunct;
+   struct joinProfile *theProfile;
+   struct joinNode **theJoins, *theJoin;
+   SYMBOL_HN *moduleName;
+   const char *logicalName = (const char *) buffer;
+   unsigned short disjunct, count, position, unit;
+
+   moduleName = theConstruct->whichModule->theModule->name;
+
+   for (theDisjunct = (struct defrule *) theConstruct, disjunct = 1;
+        theDisjunct != NULL;
+        theDisjunct = theDisjunct->disjunct, disjunct++)
+     {
+      count = RuleJoinChain(theDisjunct,NULL);
+      if (count == 0) continue;
+
+      theJoins = (struct joinNode **) gm2(theEnv,sizeof(struct joinNode *) * (count + 1));
+      RuleJoinChain(theDisjunct,theJoins);
+
+      theProfile = FindJoinProfile(theEnv,moduleName,theConstruct->name,disjunct,FALSE);
+      if ((theProfile != NULL) && (theProfile->orderCount != count))
+        { theProfile = NULL; }
+
+      EnvPrintRouter(theEnv,logicalName,"(");
+      EnvPrintRouter(theEnv,logicalName,ValueToString(moduleName));
+      EnvPrintRouter(theEnv,logicalName,"::");
+      EnvPrintRouter(theEnv,logicalName,ValueToString(theConstruct->name));
+      EnvPrintRouter(theEnv,logicalName," ");
+      PrintLongInteger(theEnv,logicalName,(long long) disjunct);
+      EnvPrintRouter(theEnv,logicalName," ");
+      PrintLongInteger(theEnv,logicalName,(long long) count);
+
+      for (position = 1; position <= count; position++)
+        {
+         theJoin = theJoins[position - 1];
+         if ((theProfile != NULL) && (theProfile->order != NULL))
+           { unit = theProfile->order[position - 1]; }
+         else
+           { unit = position; }
+
+         EnvPrintRouter(theEnv,logicalName,"\n   (");
+         PrintLongInteger(theEnv,logicalName,(long long) unit);
+         EnvPrintRouter(theEnv,logicalName," ");
+         PrintLongInteger(theEnv,logicalName,(long long) position);
+         EnvPrintRouter(theEnv,logicalName," ");
+         PrintLongInteger(theEnv,logicalName,theJoin->memoryRightActivations);
+         EnvPrintRouter(theEnv,logicalName," ");
+         PrintLongInteger(theEnv,logicalName,theJoin->memoryLeftAdds);
+         EnvPrintRouter(theEnv,logicalName," ");
+         PrintLongInteger(theEnv,logicalName,theJoin->memoryCompares);
+         EnvPrintRouter(theEnv,logicalName," ");
+         PrintLongInteger(theEnv,logicalName,theJoins[position]->memoryLeftAdds);
+         EnvPrintRouter(theEnv,logicalName,")");
+        }
+
+      EnvPrintRouter(theEnv,logicalName,")\n");
+
+      rm(theEnv,theJoins,sizeof(struct joinNode *) * (count + 1));
+     }
+  }
+
+/*******************************************************/
+/* LoadJoinProfileCommand: H/L access routine for the  */
+/*   load-join-profile command.                        */
+/*******************************************************/
+globle int LoadJoinProfileCommand(
+  void *theEnv)
+  {
+   const char *fileName;
+
+   if ((fileName = GetFileName(theEnv,"load-join-profile",1)) == NULL) return(FALSE);
+
+   return(EnvLoadJoinProfile(theEnv,fileName));
+  }
+
+/*************************************************************/
+/* EnvLoadJoinProfile: C access routine for the              */
+/*   load-join-profile command. Replaces the profiles used   */
+/*   to reorder the CEs of the rules loaded afterwards with  */
+/*   those saved in a file by save-join-profile.             */
+/*************************************************************/
+globle intBool EnvLoadJoinProfile(
+  void *theEnv,
+  const char *fileName)
+  {
+   FILE *filePtr;
+   struct token theToken;
+   intBool error = FALSE;
+
+   if ((filePtr = GenOpen(theEnv,fileName,"r")) == NULL)
+     {
+      OpenErrorMessage(theEnv,"load-join-profile",fileName);
+      return(FALSE);
+     }
+
+   EnvClearJoinProfile(theEnv);
+
+   SetFastLoad(theEnv,filePtr);
+
+   GetToken(theEnv,(char *) filePtr,&theToken);
+   while ((theToken.type != STOP) && (! error))
+     {
+      if (! LoadJoinProfileEntry(theEnv,(char *) filePtr,&theToken))
+        { error = TRUE; }
+      else
+        { GetToken(theEnv,(char *) filePtr,&theToken); }
+     }
+
+   SetFastLoad(theEnv,NULL);
+   GenClose(theEnv,filePtr);
+
+   if (error)
+     {
+      PrintErrorID(theEnv,"JOINPROF",1,FALSE);
+      EnvPrintRouter(theEnv,WERROR,"Invalid join profile in file ");
+      EnvPrintRouter(theEnv,WERROR,fileName);
+      EnvPrintRouter(theEnv,WERROR,".\n");
+      EnvClearJoinProfile(theEnv);
+      return(FALSE);
+     }
+
+   return(TRUE);
+  }
+
+/*************************************************************/
+/* LoadJoinProfileEntry: Loads the profile of a disjunct,    */
+/*   starting with the already read left parenthesis.        */
+/*   Returns FALSE if the profile isn't well formed.         */
+/*************************************************************/
+static intBool LoadJoinProfileEntry(
+  void *theEnv,
+  const char *logicalName,
+  struct token *theToken)
+  {
+   struct joinProfile *theProfile;
+   struct joinProfileUnit *units, *theUnit;
+   SYMBOL_HN *moduleName, *ruleName;
+   const char *theName;
+   unsigned separator;
+   long long values[6], disjunct, count;
+   unsigned short i;
+   int j;
+
+   if (theToken->type != LPAREN) return(FALSE);
+
+   GetToken(theEnv,logicalName,theToken);
+   if (theToken->type != SYMBOL) return(FALSE);
+   theName = ValueToString(theToken->value);
+   separator = FindModuleSeparator(theName);
+   if (separator == FALSE) return(FALSE);
+   moduleName = ExtractModuleName(theEnv,separator,theName);
+   ruleName = ExtractConstructName(theEnv,separator,theName);
+   if ((moduleName == NULL) || (ruleName == NULL)) return(FALSE);
+
+   GetToken(theEnv,logicalName,theToken);
+   if (theToken->type != INTEGER) return(FALSE);
+   disjunct = ValueToLong(theToken->value);
+
+   GetToken(theEnv,logicalName,theToken);
+   if (theToken->type != INTEGER) return(FALSE);
+   count = ValueToLong(theToken->value);
+
+   if ((disjunct < 1) || (disjunct > 0xFFFF) || (count < 1) || (count > 0xFFFF))
+     { return(FALSE); }
+
+   units = (struct joinProfileUnit *) gm2(theEnv,sizeof(struct joinProfileUnit) * count);
+   for (i = 0; i < count; i++)
+     { units[i].position = 0; }
+
+   for (i = 0; i < count; i++)
+     {
+      GetToken(theEnv,logicalName,theToken);
+      if (theToken->type != LPAREN) break;
+
+      for (j = 0; j < 6; j++)
+        {
+         GetToken(theEnv,logicalName,theToken);
+         if (theToken->type != INTEGER) break;
+         values[j] = ValueToLong(theToken->value);
+        }
+      if (j < 6) break;
+
+      GetToken(theEnv,logicalName,theToken);
+      if (theToken->type != RPAREN) break;
+
+      if ((values[0] < 1) || (values[0] > count) ||
+          (values[1] < 1) || (values[1] > count))
+        { break; }
+
+      theUnit = &units[values[0] - 1];
+      if (theUnit->position != 0) break;
+
+      theUnit->position = (unsigned short) values[1];
+      theUnit->rightActivations = values[2];
+      theUnit->leftAdds = values[3];
+      theUnit->compares = values[4];
+      theUnit->passes = values[5];
+     }
+
+   if (i == count)
+     { GetToken(theEnv,logicalName,theToken); }
+
+   if ((i < count) || (theToken->type != RPAREN))
+     {
+      rm(theEnv,units,sizeof(struct joinProfileUnit) * count);
+      return(FALSE);
+     }
+
+   theProfile = FindJoinProfile(theEnv,moduleName,ruleName,(unsigned short) disjunct,TRUE);
+   ReturnJoinProfileUnits(theEnv,theProfile);
+   theProfile->units = units;
+   theProfile->unitCount = (unsigned short) count;
+
+   return(TRUE);
+  }
+
+/*******************************************************/
+/* ClearJoinProfileCommand: H/L access routine for the */
+/*   clear-join-profile command.                       */
+/*******************************************************/
+globle void ClearJoinProfileCommand(
+  void *theEnv)
+  {
+   EnvArgCountCheck(theEnv,"clear-join-profile",EXACTLY,0);
+   EnvClearJoinProfile(theEnv);
+  }
+
+/*************************************************************/
+/* EnvClearJoinProfile: C access routine for the             */
+/*   clear-join-profile command. Rules loaded afterwards     */
+/*   keep the order of their CEs. The orders of the rules    */
+/*   already reordered are kept so their join activity is    */
+/*   still saved by CE.                                      */
+/*************************************************************/
+globle void EnvClearJoinProfile(
+  void *theEnv)
+  {
+   struct joinProfile *theProfile;
+   unsigned long i;
+
+   for (i = 0; i < JoinProfileData(theEnv)->ProfileTableInfo.size; i++)
+     {
+      for (theProfile = JoinProfileData(theEnv)->ProfileTable[i];
+           theProfile != NULL;
+           theProfile = theProfile->next)
+        { ReturnJoinProfileUnits(theEnv,theProfile); }
+     }
+  }
+
+/*******************************************************/
+/* JoinProfileReportCommand: H/L access routine for    */
+/*   the join-profile-report command.                  */
+/*******************************************************/
+globle void JoinProfileReportCommand(
+  void *theEnv)
+  {
+   if (EnvArgCountCheck(theEnv,"join-profile-report",EXACTLY,0) == -1) return;
+
+   EnvJoinProfileReport(theEnv,WDISPLAY);
+  }
+
+/*************************************************************/
+/* EnvJoinProfileReport: C access routine for the            */
+/*   join-profile-report command. Lists, for each disjunct   */
+/*   whose CEs were reordered, the order of its CEs and its  */
+/*   comparisons in the profile, predicted for the new order */
+/*   and observed since the last join-activity-reset. The    */
+/*   runs of CEs left in rule order are listed with why      */
+/*   they weren't reordered.                                 */
+/*************************************************************/
+globle void EnvJoinProfileReport(
+  void *theEnv,
+  const char *logicalName)
+  {
+   DoForAllConstructs(theEnv,JoinProfileReportAction,
+                      DefruleData(theEnv)->DefruleModuleIndex,FALSE,(void *) logicalName);
+  }
+
+/*******************************************************/
+/* JoinProfileReportAction: Lists the comparisons of   */
+/*   the reordered disjuncts of a rule, and the runs   */
+/*   of CEs left in rule order.                        */
+/*******************************************************/
+static void JoinProfileReportAction(
+  void *theEnv,
+  struct constructHeader *theConstruct,
+  void *buffer)
+  {
+   struct defrule *theDisjunct;
+   struct joinProfile *theProfile;
+   struct joinNode *theJoin;
+   SYMBOL_HN *moduleName;
+   const char *logicalName = (const char *) buffer;
+   unsigned short disjunct, i;
+   long long observed;
+
+   moduleName = theConstruct->whichModule->theModule->name;
+
+   for (theDisjunct = (struct defrule *) theConstruct, disjunct = 1;
+        theDisjunct != NULL;
+        theDisjunct = theDisjunct->disjunct, disjunct++)
+     {
+      theProfile = FindJoinProfile(theEnv,moduleName,theConstruct->name,disjunct,FALSE);
+      if ((theProfile == NULL) ||
+          ((theProfile->order == NULL) && (theProfile->skipped == NULL)) ||
+          (theProfile->orderCount != RuleJoinChain(theDisjunct,NULL)))
+        { continue; }
+
+      EnvPrintRouter(theEnv,logicalName,ValueToString(moduleName));
+      EnvPrintRouter(theEnv,logicalName,"::");
+      EnvPrintRouter(theEnv,logicalName,ValueToString(theConstruct->name));
+      if ((theDisjunct != (struct defrule *) theConstruct) || (theDisjunct->disjunct != NULL))
+        {
+         EnvPrintRouter(theEnv,logicalName," disjunct ");
+         PrintLongInteger(theEnv,logicalName,(long long) disjunct);
+        }
+
+      if (theProfile->order == NULL)
+        { EnvPrintRouter(theEnv,logicalName,", CEs joined in rule order\n"); }
+      else
+        {
+         for (theJoin = theDisjunct->lastJoin, observed = 0;
+              theJoin != NULL;
+              theJoin = theJoin->lastLevel)
+           { observed += theJoin->memoryCompares; }
+
+         EnvPrintRouter(theEnv,logicalName,", CEs joined in order");
+         for (i = 0; i < theProfile->orderCount; i++)
+           {
+            EnvPrintRouter(theEnv,logicalName," ");
+            PrintLongInteger(theEnv,logicalName,(long long) theProfile->order[i]);
+           }
+         EnvPrintRouter(theEnv,logicalName,"\n");
+
+         EnvPrintRouter(theEnv,logicalName,"   Profiled compares:  ");
+         PrintLongInteger(theEnv,logicalName,theProfile->profiledCompares);
+         EnvPrintRouter(theEnv,logicalName,"\n");
+         PrintCompareReduction(theEnv,logicalName,"   Predicted compares: ",
+                               theProfile->predictedCompares,theProfile->profiledCompares);
+         PrintCompareReduction(theEnv,logicalName,"   Observed compares:  ",
+                               observed,theProfile->profiledCompares);
+        }
+
+      for (i = 0; i < theProfile->skipCount; i++)
+        { PrintJoinProfileSkip(theEnv,logicalName,&theProfile->skipped[i],theProfile->unitCount); }
+     }
+  }
+
+/*******************************************************/
+/* PrintJoinProfileSkip: Prints a run of CEs left in   */
+/*   rule order and why it wasn't reordered.           */
+/*******************************************************/
+static void PrintJoinProfileSkip(
+  void *theEnv,
+  const char *logicalName,
+  struct joinProfileSkip *theSkip,
+  unsigned short profiledCount)
+  {
+   EnvPrintRouter(theEnv,logicalName,"   CEs ");
+   PrintLongInteger(theEnv,logicalName,(long long) theSkip->first);
+   EnvPrintRouter(theEnv,logicalName,"-");
+   PrintLongInteger(theEnv,logicalName,(long long) theSkip->last);
+   EnvPrintRouter(theEnv,logicalName," left in rule order: ");
+
+   switch (theSkip->reason)
+     {
+      case JOIN_SKIP_SMALL_GAIN:
+        EnvPrintRouter(theEnv,logicalName,"gain below the reorder threshold\n");
+        EnvPrintRouter(theEnv,logicalName,"      Rule order compares: ");
+        PrintLongInteger(theEnv,logicalName,theSkip->ruleCompares);
+        EnvPrintRouter(theEnv,logicalName,"\n");
+        PrintCompareReduction(theEnv,logicalName,"      Best order compares: ",
+                              theSkip->bestCompares,theSkip->ruleCompares);
+        break;
+
+      case JOIN_SKIP_LONG_RUN:
+        EnvPrintRouter(theEnv,logicalName,"run longer than ");
+        PrintLongInteger(theEnv,logicalName,(long long) MAXIMUM_REORDERED_RUN);
+        EnvPrintRouter(theEnv,logicalName," CEs\n");
+        break;
+
+      case JOIN_SKIP_NO_ESTIMATE:
+        EnvPrintRouter(theEnv,logicalName,"not estimated by the profile\n");
+        break;
+
+      case JOIN_SKIP_CE_COUNT:
+        PrintLongInteger(theEnv,logicalName,(long long) profiledCount);
+        EnvPrintRouter(theEnv,logicalName," CEs were profiled\n");
+        break;
+     }
+  }
+
+/*******************************************************/
+/* PrintCompareReduction: Prints a number of compares  */
+/*   and its reduction from the profiled compares.     */
+/*******************************************************/
+static void PrintCompareReduction(
+  void *theEnv,
+  const char *logicalName,
+  const char *label,
+  long long compares,
+  long long profiled)
+  {
+   char buffer[40];
+
+   EnvPrintRouter(theEnv,logicalName,label);
+   PrintLongInteger(theEnv,logicalName,compares);
+   if (profiled > 0)
+     {
+      gensprintf(buffer," (%.1f%% fewer)",
+                 100.0 * ((double) (profiled - compares)) / ((double) profiled));
+      EnvPrintRouter(theEnv,logicalName,buffer);
+     }
+   EnvPrintRouter(theEnv,logicalName,"\n");
+  }
+
+/***********************************************************/
+/* SetJoinReorderThresholdCommand: H/L access routine for  */
+/*   the set-join-reorder-threshold command.               */
+/***********************************************************/
+globle double SetJoinReorderThresholdCommand(
+  void *theEnv)
+  {
+   DATA_OBJECT theValue;
+   double newThreshold;
+
+   if (EnvArgCountCheck(theEnv,"set-join-reorder-threshold",EXACTLY,1) == -1)
+     { return(JoinProfileData(theEnv)->ReorderThreshold); }
+
+   if (EnvArgTypeCheck(theEnv,"set-join-reorder-threshold",1,INTEGER_OR_FLOAT,&theValue) == FALSE)
+     { return(JoinProfileData(theEnv)->ReorderThreshold); }
+
+   if (GetType(theValue) == INTEGER)
+     { newThreshold = (double) DOToLong(theValue); }
+   else
+     { newThreshold = (double) DOToDouble(theValue); }
+
+   if ((newThreshold < 0.0) || (newThreshold > 100.0))
+     {
+      ExpectedTypeError1(theEnv,"set-join-reorder-threshold",1,
+                         "number in the range 0 to 100");
+      return(-1.0);
+     }
+
+   return(EnvSetJoinReorderThreshold(theEnv,newThreshold));
+  }
+
+/*************************************************************/
+/* EnvSetJoinReorderThreshold: C access routine for the      */
+/*   set-join-reorder-threshold command. A run of CEs of a   */
+/*   rule loaded afterwards is only reordered if the         */
+/*   profile predicts the new order needs at least this      */
+/*   percentage fewer comparisons than the rule order.       */
+/*   Returns the previous threshold, or -1 if the value      */
+/*   isn't in the range 0 to 100.                            */
+/*************************************************************/
+globle double EnvSetJoinReorderThreshold(
+  void *theEnv,
+  double value)
+  {
+   double oldThreshold;
+
+   if ((value < 0.0) || (value > 100.0))
+     { return(-1.0); }
+
+   oldThreshold = JoinProfileData(theEnv)->ReorderThreshold;
+   JoinProfileData(theEnv)->ReorderThreshold = value;
+
+   return(oldThreshold);
+  }
+
+/***********************************************************/
+/* GetJoinReorderThresholdCommand: H/L access routine for  */
+/*   the get-join-reorder-threshold command.               */
+/***********************************************************/
+globle double GetJoinReorderThresholdCommand(
+  void *theEnv)
+  {
+   EnvArgCountCheck(theEnv,"get-join-reorder-threshold",EXACTLY,0);
+
+   return(JoinProfileData(theEnv)->ReorderThreshold);
+  }
+
+/*********************************************************/
+/* EnvGetJoinReorderThreshold: C access routine for the  */
+/*   get-join-reorder-threshold command.                 */
+/*********************************************************/
+globle double EnvGetJoinReorderThreshold(
+  void *theEnv)
+  {
+   return(JoinProfileData(theEnv)->ReorderThreshold);
+  }
+
+#if (! RUN_TIME) && (! BLOAD_ONLY)
+
+/*************************************************************/
+/* ProfileReorderPatterns: Reorders the runs of consecutive  */
+/*   positive pattern CEs of a disjunct of a rule being      */
+/*   loaded, using the profile of the disjunct to predict    */
+/*   the comparisons made by their joins. A CE stays after   */
+/*   the CEs binding the variables it uses. Returns the      */
+/*   CEs of the disjunct, reordered or not.                  */
+/*************************************************************/
+globle struct lhsParseNode *ProfileReorderPatterns(
+  void *theEnv,
+  SYMBOL_HN *ruleName,
+  unsigned short disjunct,
+  struct lhsParseNode *theLHS)
+  {
+   struct joinProfile *theProfile;
+   struct joinOrderSearch *theSearch;
+   struct lhsParseNode **units, *prev, *node;
+   struct joinProfileSkip *skips;
+   intBool *movable, changed = FALSE;
+   unsigned short count, *order, start, end, i, skipCount = 0;
+   long long predicted = 0;
+   double identityCost, runCost;
+
+   if (JoinProfileData(theEnv)->ProfileTableInfo.count == 0) return(theLHS);
+
+   theProfile = FindJoinProfile(theEnv,((struct defmodule *) EnvGetCurrentModule(theEnv))->name,
+                                ruleName,disjunct,FALSE);
+   if (theProfile == NULL) return(theLHS);
+
+   ReturnJoinProfileOrder(theEnv,theProfile);
+   if (theProfile->units == NULL) return(theLHS);
+
+   /*===================================================*/
+   /* The disjunct must have as many CEs needing a join */
+   /* as the profiled one.                              */
+   /*===================================================*/
+
+   count = JoinUnits(theLHS,NULL,NULL);
+   if (count != theProfile->unitCount)
+     {
+      if (count > 0)
+        {
+         theProfile->skipped = (struct joinProfileSkip *) gm2(theEnv,sizeof(struct joinProfileSkip));
+         SkipJoinRun(theProfile->skipped,&theProfile->skipCount,JOIN_SKIP_CE_COUNT,0,
+                     (unsigned short) (count - 1),0,0);
+         theProfile->orderCount = count;
+        }
+      return(theLHS);
+     }
+
+   units = (struct lhsParseNode **) gm2(theEnv,sizeof(struct lhsParseNode *) * count);
+   movable = (intBool *) gm2(theEnv,sizeof(intBool) * count);
+   order = (unsigned short *) gm2(theEnv,sizeof(unsigned short) * count);
+   theSearch = (struct joinOrderSearch *) gm2(theEnv,sizeof(struct joinOrderSearch));
+   skips = (struct joinProfileSkip *) gm2(theEnv,sizeof(struct joinProfileSkip) * count);
+
+   JoinUnits(theLHS,units,movable);
+   for (i = 0; i < count; i++)
+     { order[i] = (unsigned short) (i + 1); }
+
+   /*======================================================*/
+   /* Reorder each run of positive pattern CEs which can   */
+   /* be moved, aren't separated by other CEs, and either  */
+   /* all or none of which are within a logical CE.        */
+   /*======================================================*/
+
+   for (start = 0; start < count; start = (unsigned short) (end + 1))
+     {
+      end = start;
+      if (movable[start])
+        {
+         while (((end + 1) < count) && movable[end + 1] &&
+                (units[end]->bottom == units[end + 1]) &&
+                (units[end + 1]->logical == units[start]->logical))
+           { end++; }
+        }
+
+      if ((end == start) || ((end - start) >= MAXIMUM_REORDERED_RUN) ||
+          (! EstimateRun(theProfile,start,end,theSearch)))
+        {
+         if ((end - start) >= MAXIMUM_REORDERED_RUN)
+           { SkipJoinRun(skips,&skipCount,JOIN_SKIP_LONG_RUN,start,end,0,0); }
+         else if (end != start)
+           { SkipJoinRun(skips,&skipCount,JOIN_SKIP_NO_ESTIMATE,start,end,0,0); }
+
+         for (i = start; i <= end; i++)
+           { predicted += theProfile->units[i].compares; }
+         continue;
+        }
+
+      RunDependencies(theEnv,units,start,theSearch);
+
+      for (i = 0; i < theSearch->count; i++)
+        { theSearch->best[i] = i; }
+      identityCost = OrderCost(theSearch,theSearch->best);
+      theSearch->bestCost = identityCost;
+
+      if (theSearch->count <= MAXIMUM_SEARCHED_RUN)
+        { SearchJoinOrder(theSearch,0,0,theSearch->prefix,0.0); }
+      else
+        { GreedyJoinOrder(theSearch); }
+
+      runCost = theSearch->bestCost;
+      if (runCost >= (identityCost * (1.0 - (JoinProfileData(theEnv)->ReorderThreshold / 100.0))))
+        {
+         SkipJoinRun(skips,&skipCount,JOIN_SKIP_SMALL_GAIN,start,end,
+                     (long long) (identityCost + 0.5),(long long) (runCost + 0.5));
+         runCost = identityCost;
+        }
+      else
+        {
+         /*===========================================*/
+         /* Link the pattern CEs of the run in their  */
+         /* new order in place of the run.            */
+         /*===========================================*/
+
+         for (prev = NULL, node = theLHS; node != units[start]; prev = node, node = node->bottom)
+           { /* Do Nothing */ }
+
+         node = units[end]->bottom;
+         for (i = 0; i < theSearch->count; i++)
+           {
+            if (prev == NULL)
+              { theLHS = units[start + theSearch->best[i]]; }
+            else
+              { prev->bottom = units[start + theSearch->best[i]]; }
+            prev = units[start + theSearch->best[i]];
+            order[start + i] = (unsigned short) (start + theSearch->best[i] + 1);
+           }
+         prev->bottom = node;
+         changed = TRUE;
+        }
+
+      predicted += (long long) (runCost + 0.5);
+     }
+
+   /*=====================================================*/
+   /* Renumber the reordered patterns and remember the    */
+   /* order of the CEs so their activity can be profiled, */
+   /* and the runs left in rule order for the report.     */
+   /*=====================================================*/
+
+   if (changed)
+     {
+      RenumberPatterns(theLHS);
+
+      theProfile->order = order;
+      theProfile->orderCount = count;
+      theProfile->profiledCompares = 0;
+      for (i = 0; i < count; i++)
+        { theProfile->profiledCompares += theProfile->units[i].compares; }
+      theProfile->predictedCompares = predicted;
+     }
+   else
+     { rm(theEnv,order,sizeof(unsigned short) * count); }
+
+   if (skipCount > 0)
+     {
+      theProfile->skipped = (struct joinProfileSkip *) gm2(theEnv,sizeof(struct joinProfileSkip) * skipCount);
+      GenCopyMemory(struct joinProfileSkip,skipCount,theProfile->skipped,skips);
+      theProfile->skipCount = skipCount;
+      theProfile->orderCount = count;
+     }
+
+   rm(theEnv,skips,sizeof(struct joinProfileSkip) * count);
+   rm(theEnv,theSearch,sizeof(struct joinOrderSearch));
+   rm(theEnv,movable,sizeof(intBool) * count);
+   rm(theEnv,units,sizeof(struct lhsParseNode *) * count);
+
+   return(theLHS);
+  }
+
+/*************************************************************/
+/* JoinUnits: Returns the number of CEs of a disjunct which  */
+/*   need a join of their own: each CE at the top level      */
+/*   except test CEs, which are evaluated by the join of the */
+/*   preceding CE, with a group of CEs joined from the right */
+/*   counting as one CE. Stores the first node of each CE    */
+/*   and whether the CE can be reordered.                    */
+/*************************************************************/
+static unsigned short JoinUnits(
+  struct lhsParseNode *theLHS,
+  struct lhsParseNode **units,
+  intBool *movable)
+  {
+   unsigned short count = 0;
+
+   while (theLHS != NULL)
+     {
+      if ((theLHS->type == TEST_CE) && (theLHS->beginNandDepth == 1))
+        {
+         theLHS = theLHS->bottom;
+         continue;
+        }
+
+      if (units != NULL)
+        {
+         units[count] = theLHS;
+         movable[count] = MovablePattern(theLHS);
+        }
+      count++;
+
+      if (theLHS->beginNandDepth > 1)
+        {
+         while (theLHS->endNandDepth > 1)
+           { theLHS = theLHS->bottom; }
+        }
+
+      theLHS = theLHS->bottom;
+     }
+
+   return(count);
+  }
+
+/*************************************************************/
+/* MovablePattern: Determines whether a CE is a positive     */
+/*   pattern CE at the top level specified by the user.      */
+/*************************************************************/
+static intBool MovablePattern(
+  struct lhsParseNode *theLHS)
+  {
+   return((theLHS->type == PATTERN_CE) &&
+          (theLHS->beginNandDepth == 1) &&
+          (theLHS->endNandDepth == 1) &&
+          (! theLHS->negated) &&
+          (! theLHS->exists) &&
+          theLHS->userCE);
+  }
+
+/*************************************************************/
+/* PatternVariables: Stores the variables of a pattern CE,   */
+/*   noting which ones it binds, and returns their number.   */
+/*   Only counts them if no storage is given.                */
+/*************************************************************/
+static unsigned long PatternVariables(
+  struct lhsParseNode *thePattern,
+  struct patternVariable *theVariables)
+  {
+   struct lhsParseNode *theField;
+   unsigned long count = 0;
+
+   if (thePattern->value != NULL)
+     { count = AddPatternVariable(theVariables,count,thePattern->value,PATTERN_ADDRESS_BINDER); }
+
+   count = ExpressionVariables(thePattern->expression,theVariables,count);
+
+   for (theField = thePattern->right; theField != NULL; theField = theField->right)
+     { count = FieldVariables(theField,theVariables,count); }
+
+   return(count);
+  }
+
+/*************************************************************/
+/* FieldVariables: Adds the variables of a field or slot of  */
+/*   a pattern. Only a variable heading the constraints of   */
+/*   the field binds it, all others are references.          */
+/*************************************************************/
+static unsigned long FieldVariables(
+  struct lhsParseNode *theField,
+  struct patternVariable *theVariables,
+  unsigned long count)
+  {
+   struct lhsParseNode *orField, *andField;
+
+   if (theField->multifieldSlot)
+     {
+      for (orField = theField->bottom; orField != NULL; orField = orField->right)
+        { count = FieldVariables(orField,theVariables,count); }
+      return(count);
+     }
+
+   if ((theField->type == SF_VARIABLE) || (theField->type == MF_VARIABLE))
+     { count = AddPatternVariable(theVariables,count,theField->value,TRUE); }
+
+   for (orField = theField->bottom; orField != NULL; orField = orField->bottom)
+     {
+      for (andField = orField; andField != NULL; andField = andField->right)
+        {
+         if ((andField->type == SF_VARIABLE) || (andField->type == MF_VARIABLE))
+           { count = AddPatternVariable(theVariables,count,andField->value,FALSE); }
+
+         count = ExpressionVariables(andField->expression,theVariables,count);
+         count = ExpressionVariables(andField->secondaryExpression,theVariables,count);
+        }
+     }
+
+   return(count);
+  }
+
+/*************************************************************/
+/* ExpressionVariables: Adds the variables used within an    */
+/*   expression, none of which are bound by it.              */
+/*************************************************************/
+static unsigned long ExpressionVariables(
+  struct lhsParseNode *theExpression,
+  struct patternVariable *theVariables,
+  unsigned long count)
+  {
+   for (; theExpression != NULL; theExpression = theExpression->right)
+     {
+      if ((theExpression->type == SF_VARIABLE) || (theExpression->type == MF_VARIABLE))
+        { count = AddPatternVariable(theVariables,count,theExpression->value,FALSE); }
+
+      count = ExpressionVariables(theExpression->bottom,theVariables,count);
+      count = ExpressionVariables(theExpression->expression,theVariables,count);
+      count = ExpressionVariables(theExpression->secondaryExpression,theVariables,count);
+     }
+
+   return(count);
+  }
+
+/*******************************************************/
+/* AddPatternVariable: Stores a variable of a pattern, */
+/*   if storage is given, and returns the new count.   */
+/*******************************************************/
+static unsigned long AddPatternVariable(
+  struct patternVariable *theVariables,
+  unsigned long count,
+  void *theName,
+  int binder)
+  {
+   if (theVariables != NULL)
+     {
+      theVariables[count].name = (SYMBOL_HN *) theName;
+      theVariables[count].binder = binder;
+     }
+
+   return(count + 1);
+  }
+
+/*************************************************************/
+/* RunDependencies: Determines for each pattern CE of a run  */
+/*   the CEs of the run preceding it which bind a variable   */
+/*   it uses, and so must still precede it, the CEs of the   */
+/*   run it shares variables with, binding them or not, and  */
+/*   whether it shares variables with the positive pattern   */
+/*   CEs preceding the run. Also determines the CEs it       */
+/*   shared variables with when profiled.                    */
+/*************************************************************/
+static void RunDependencies(
+  void *theEnv,
+  struct lhsParseNode **units,
+  unsigned short start,
+  struct joinOrderSearch *theSearch)
+  {
+   struct patternVariable **theVariables;
+   unsigned long *variableCounts, u, b;
+   unsigned short i, j, total;
+
+   total = (unsigned short) (start + theSearch->count);
+   theVariables = (struct patternVariable **) gm2(theEnv,sizeof(struct patternVariable *) * total);
+   variableCounts = (unsigned long *) gm2(theEnv,sizeof(unsigned long) * total);
+
+   for (i = 0; i < total; i++)
+     {
+      if ((i < start) && ! ((units[i]->type == PATTERN_CE) &&
+                            (units[i]->beginNandDepth == 1) &&
+                            (! units[i]->negated) &&
+                            (! units[i]->exists)))
+        { variableCounts[i] = 0; }
+      else
+        { variableCounts[i] = PatternVariables(units[i],NULL); }
+
+      if (variableCounts[i] == 0)
+        { theVariables[i] = NULL; }
+      else
+        {
+         theVariables[i] = (struct patternVariable *)
+            gm2(theEnv,sizeof(struct patternVariable) * variableCounts[i]);
+         PatternVariables(units[i],theVariables[i]);
+        }
+     }
+
+   for (i = start; i < total; i++)
+     {
+      theSearch->mustFollow[i - start] = 0;
+      theSearch->shares[i - start] = 0;
+      theSearch->binds[i - start] = 0;
+      theSearch->prefixShared[i - start] = FALSE;
+      theSearch->prefixBound[i - start] = FALSE;
+
+      for (u = 0; u < variableCounts[i]; u++)
+        {
+         if (theVariables[i][u].binder == PATTERN_ADDRESS_BINDER) continue;
+
+         for (j = 0; j < total; j++)
+           {
+            if (j == i) continue;
+
+            for (b = 0; b < variableCounts[j]; b++)
+              {
+               if (theVariables[j][b].name != theVariables[i][u].name) continue;
+
+               if (j < start)
+                 {
+                  if (theVariables[j][b].binder)
+                    {
+                     theSearch->prefixShared[i - start] = TRUE;
+                     if (theVariables[i][u].binder)
+                       { theSearch->prefixBound[i - start] = TRUE; }
+                    }
+                 }
+               else
+                 {
+                  theSearch->shares[i - start] |= (1ULL << (j - start));
+                  theSearch->shares[j - start] |= (1ULL << (i - start));
+                  if (theVariables[i][u].binder && theVariables[j][b].binder)
+                    {
+                     theSearch->binds[i - start] |= (1ULL << (j - start));
+                     theSearch->binds[j - start] |= (1ULL << (i - start));
+                    }
+
+                  if ((j < i) &&
+                      ((theVariables[j][b].binder == PATTERN_ADDRESS_BINDER) ||
+                       (theVariables[j][b].binder && (! theVariables[i][u].binder))))
+                    { theSearch->mustFollow[i - start] |= (1ULL << (j - start)); }
+                 }
+              }
+           }
+        }
+     }
+
+   for (i = 0; i < theSearch->count; i++)
+     {
+      theSearch->profiledShares[i] = 0;
+      for (j = 0; j < theSearch->count; j++)
+        {
+         if (theSearch->position[j] < theSearch->position[i])
+           { theSearch->profiledShares[i] |= (theSearch->shares[i] & (1ULL << j)); }
+        }
+     }
+
+   for (i = 0; i < total; i++)
+     {
+      if (theVariables[i] != NULL)
+        { rm(theEnv,theVariables[i],sizeof(struct patternVariable) * variableCounts[i]); }
+     }
+
+   rm(theEnv,variableCounts,sizeof(unsigned long) * total);
+   rm(theEnv,theVariables,sizeof(struct patternVariable *) * total);
+  }
+
+/*************************************************************/
+/* EstimateRun: Estimates from the profile how many partial  */
+/*   matches each CE of a run compares and passes on. The    */
+/*   estimates reproduce the profile for the order the CEs   */
+/*   were profiled in. Returns FALSE if the run wasn't       */
+/*   profiled at the same positions.                         */
+/*************************************************************/
+static intBool EstimateRun(
+  struct joinProfile *theProfile,
+  unsigned short start,
+  unsigned short end,
+  struct joinOrderSearch *theSearch)
+  {
+   struct joinProfileUnit *theUnit;
+   unsigned short i;
+   double cross;
+
+   theSearch->count = (unsigned short) (end - start + 1);
+   theSearch->startsRule = (start == 0);
+   theSearch->prefix = 1.0;
+
+   for (i = 0; i < theSearch->count; i++)
+     {
+      theUnit = &theProfile->units[start + i];
+      if ((theUnit->position <= start) || (theUnit->position > (end + 1)))
+        { return(FALSE); }
+
+      theSearch->position[i] = theUnit->position;
+      theSearch->activations[i] = (double) theUnit->rightActivations;
+      theSearch->profiledFirst[i] = (theUnit->position == 1);
+
+      if (theUnit->position == 1)
+        {
+         if (theUnit->rightActivations > 0)
+           { theSearch->firstPassRate[i] = ((double) theUnit->passes) / theSearch->activations[i]; }
+         else
+           { theSearch->firstPassRate[i] = 1.0; }
+         theSearch->passRate[i] = theSearch->firstPassRate[i];
+         theSearch->compareRate[i] = 1.0;
+        }
+      else
+        {
+         if (theUnit->position == (start + 1))
+           { theSearch->prefix = (double) theUnit->leftAdds; }
+
+         cross = ((double) theUnit->leftAdds) * theSearch->activations[i];
+         if (cross > 0.0)
+           {
+            theSearch->passRate[i] = ((double) theUnit->passes) / cross;
+            theSearch->compareRate[i] = ((double) theUnit->compares) / cross;
+           }
+         else
+           {
+            theSearch->passRate[i] = 1.0;
+            theSearch->compareRate[i] = 1.0;
+           }
+         theSearch->firstPassRate[i] = 1.0;
+        }
+     }
+
+   return(TRUE);
+  }
+
+/*************************************************************/
+/* StepCost: Returns the predicted comparisons of the join   */
+/*   of a CE of a run at a position within the run, given    */
+/*   the CEs of the run already joined and the partial       */
+/*   matches entering it, and stores the partial matches it  */
+/*   produces.                                               */
+/*************************************************************/
+static double StepCost(
+  struct joinOrderSearch *theSearch,
+  unsigned short which,
+  unsigned short depth,
+  unsigned long long used,
+  double prefix,
+  double *nextPrefix)
+  {
+   double cross, compareRate, passRate, oneMatch;
+
+   if ((depth == 0) && theSearch->startsRule)
+     {
+      *nextPrefix = theSearch->activations[which] * theSearch->firstPassRate[which];
+      return(0.0);
+     }
+
+   cross = prefix * theSearch->activations[which];
+   if (theSearch->activations[which] > 1.0)
+     { oneMatch = 1.0 / theSearch->activations[which]; }
+   else
+     { oneMatch = 1.0; }
+
+   if (((theSearch->shares[which] & used) == theSearch->profiledShares[which]) &&
+       (! theSearch->profiledFirst[which]))
+     {
+      compareRate = theSearch->compareRate[which];
+      passRate = theSearch->passRate[which];
+     }
+   else if (theSearch->prefixBound[which] || (theSearch->binds[which] & used))
+     { compareRate = passRate = oneMatch; }
+   else if (theSearch->prefixShared[which] || (theSearch->shares[which] & used))
+     {
+      compareRate = 1.0;
+      passRate = oneMatch;
+     }
+   else
+     {
+      compareRate = 1.0;
+      passRate = theSearch->firstPassRate[which];
+     }
+
+   *nextPrefix = cross * passRate;
+   return(cross * compareRate);
+  }
+
+/***********************************************************/
+/* OrderCost: Returns the predicted comparisons of the     */
+/*   joins of a run with its CEs in the given order.       */
+/***********************************************************/
+static double OrderCost(
+  struct joinOrderSearch *theSearch,
+  unsigned short *theOrder)
+  {
+   double prefix = theSearch->prefix, cost = 0.0;
+   unsigned long long used = 0;
+   unsigned short i;
+
+   for (i = 0; i < theSearch->count; i++)
+     {
+      cost += StepCost(theSearch,theOrder[i],i,used,prefix,&prefix);
+      used |= (1ULL << theOrder[i]);
+     }
+
+   return(cost);
+  }
+
+/*************************************************************/
+/* SearchJoinOrder: Searches the orders of the CEs of a run  */
+/*   keeping each CE after the CEs it must follow, for the   */
+/*   order with the fewest predicted comparisons. Orders     */
+/*   predicted to need at least the comparisons of the best  */
+/*   order found so far are abandoned.                       */
+/*************************************************************/
+static void SearchJoinOrder(
+  struct joinOrderSearch *theSearch,
+  unsigned short depth,
+  unsigned long long used,
+  double prefix,
+  double cost)
+  {
+   unsigned short i;
+   double stepCost, nextPrefix;
+
+   if (depth == theSearch->count)
+     {
+      theSearch->bestCost = cost;
+      memcpy(theSearch->best,theSearch->current,sizeof(unsigned short) * theSearch->count);
+      return;
+     }
+
+   for (i = 0; i < theSearch->count; i++)
+     {
+      if ((used & (1ULL << i)) || (theSearch->mustFollow[i] & ~used))
+        { continue; }
+
+      stepCost = StepCost(theSearch,i,depth,used,prefix,&nextPrefix);
+      if ((cost + stepCost) >= theSearch->bestCost)
+        { continue; }
+
+      theSearch->current[depth] = i;
+      SearchJoinOrder(theSearch,(unsigned short) (depth + 1),used | (1ULL << i),
+                      nextPrefix,cost + stepCost);
+     }
+  }
+
+/*************************************************************/
+/* GreedyJoinOrder: Orders the CEs of a run too long to be   */
+/*   searched by repeatedly joining next the CE predicted to */
+/*   add the fewest comparisons and partial matches.         */
+/*************************************************************/
+static void GreedyJoinOrder(
+  struct joinOrderSearch *theSearch)
+  {
+   unsigned long long used = 0;
+   unsigned short depth, i, chosen;
+   double prefix = theSearch->prefix, cost = 0.0;
+   double stepCost, nextPrefix, chosenCost, chosenPrefix;
+
+   for (depth = 0; depth < theSearch->count; depth++)
+     {
+      chosen = theSearch->count;
+      chosenCost = chosenPrefix = 0.0;
+
+      for (i = 0; i < theSearch->count; i++)
+        {
+         if ((used & (1ULL << i)) || (theSearch->mustFollow[i] & ~used))
+           { continue; }
+
+         stepCost = StepCost(theSearch,i,depth,used,prefix,&nextPrefix);
+         if ((chosen == theSearch->count) ||
+             ((stepCost + nextPrefix) < (chosenCost + chosenPrefix)))
+           {
+            chosen = i;
+            chosenCost = stepCost;
+            chosenPrefix = nextPrefix;
+           }
+        }
+
+      theSearch->current[depth] = chosen;
+      used |= (1ULL << chosen);
+      prefix = chosenPrefix;
+      cost += chosenCost;
+     }
+
+   if (cost < theSearch->bestCost)
+     {
+      theSearch->bestCost = cost;
+      memcpy(theSearch->best,theSearch->current,sizeof(unsigned short) * theSearch->count);
+     }
+  }
+
+/*************************************************************/
+/* SkipJoinRun: Adds a run of CEs left in the order of the   */
+/*   rule to the runs of a disjunct, with the predicted      */
+/*   comparisons of the rule order and of the best order if  */
+/*   the run was estimated.                                  */
+/*************************************************************/
+static void SkipJoinRun(
+  struct joinProfileSkip *skips,
+  unsigned short *skipCount,
+  unsigned short reason,
+  unsigned short start,
+  unsigned short end,
+  long long ruleCompares,
+  long long bestCompares)
+  {
+   struct joinProfileSkip *theSkip = &skips[*skipCount];
+
+   theSkip->first = (unsigned short) (start + 1);
+   theSkip->last = (unsigned short) (end + 1);
+   theSkip->reason = reason;
+   theSkip->ruleCompares = ruleCompares;
+   theSkip->bestCompares = bestCompares;
+   (*skipCount)++;
+  }
+
+#endif /* (! RUN_TIME) && (! BLOAD_ONLY) */
+
+#endif /* DEFRULE_CONSTRUCT */
@@ -0,0 +1,143 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.30  08/16/14            */
+   /*                                                     */
+   /*               JOIN PROFILE HEADER FILE              */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Saves the join activity of the rules (right      */
+/*   activations, left memory additions, comparisons and     */
+/*   partial matches passed on) as a join profile, and       */
+/*   reorders the pattern CEs of rules loaded while a        */
+/*   profile is in effect so the CEs predicted to need the   */
+/*   fewest comparisons are joined first. The predicted and  */
+/*   observed comparisons of the reordered rules, and the    */
+/*   runs of CEs left in rule order, are listed by the       */
+/*   join-profile-report command.                            */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_joinprof
+#define _H_joinprof
+
+#ifndef _H_reorder
+#include "reorder.h"
+#endif
+#ifndef _H_symbol
+#include "symbol.h"
+#endif
+
+#define JOIN_PROFILE_DATA 65
+
+#ifdef LOCALE
+#undef LOCALE
+#endif
+
+#ifdef _JOINPROF_SOURCE_
+#define LOCALE
+#else
+#define LOCALE extern
+#endif
+
+/*======================================================*/
+/* The activity of the join of a CE of a disjunct. The  */
+/* CEs joined by a single join (a pattern CE or a group */
+/* of CEs joined from the right) are numbered in the    */
+/* order they appear in the rule. The position is where */
+/* the join was in the profiled rule, and the passes    */
+/* are the partial matches it sent to the next join.    */
+/*======================================================*/
+
+struct joinProfileUnit
+  {
+   unsigned short position;
+   long long rightActivations;
+   long long leftAdds;
+   long long compares;
+   long long passes;
+  };
+
+/*======================================================*/
+/* A run of CEs of a disjunct which was left in the     */
+/* order of the rule, numbered like the CEs of the      */
+/* order, and why: the predicted comparisons of the     */
+/* best order found didn't beat those of the rule order */
+/* by the reorder threshold, the run was too long to be */
+/* reordered, or the profile couldn't estimate it. If   */
+/* the disjunct doesn't have as many CEs as profiled,   */
+/* all its CEs are left in order.                       */
+/*======================================================*/
+
+#define JOIN_SKIP_SMALL_GAIN  0
+#define JOIN_SKIP_LONG_RUN    1
+#define JOIN_SKIP_NO_ESTIMATE 2
+#define JOIN_SKIP_CE_COUNT    3
+
+struct joinProfileSkip
+  {
+   unsigned short first;
+   unsigned short last;
+   unsigned short reason;
+   long long ruleCompares;
+   long long bestCompares;
+  };
+
+/*=======================================================*/
+/* The profile of a disjunct, and the order in which its */
+/* CEs were joined when it was last built, if they were  */
+/* reordered. The order lists the CE joined at each      */
+/* position. The order count is the number of CEs of the */
+/* disjunct when it was last built with the profile.     */
+/*=======================================================*/
+
+struct joinProfile
+  {
+   SYMBOL_HN *moduleName;
+   SYMBOL_HN *ruleName;
+   unsigned short disjunct;
+   unsigned short unitCount;
+   struct joinProfileUnit *units;
+   unsigned short orderCount;
+   unsigned short *order;
+   unsigned short skipCount;
+   struct joinProfileSkip *skipped;
+   long long profiledCompares;
+   long long predictedCompares;
+   struct joinProfile *next;
+  };
+
+struct joinProfileData
+  {
+   struct joinProfile **ProfileTable;
+   struct linearHashInfo ProfileTableInfo;
+   double ReorderThreshold;
+  };
+
+#define JoinProfileData(theEnv) ((struct joinProfileData *) GetEnvironmentData(theEnv,JOIN_PROFILE_DATA))
+
+   LOCALE void                           InitializeJoinProfiles(void *);
+   LOCALE intBool                        EnvSaveJoinProfile(void *,const char *);
+   LOCALE intBool                        EnvLoadJoinProfile(void *,const char *);
+   LOCALE void                           EnvClearJoinProfile(void *);
+   LOCALE void                           EnvJoinProfileReport(void *,const char *);
+   LOCALE int                            SaveJoinProfileCommand(void *);
+   LOCALE int                            LoadJoinProfileCommand(void *);
+   LOCALE void                           ClearJoinProfileCommand(void *);
+   LOCALE void                           JoinProfileReportCommand(void *);
+   LOCALE double                         EnvSetJoinReorderThreshold(void *,double);
+   LOCALE double                         EnvGetJoinReorderThreshold(void *);
+   LOCALE double                         SetJoinReorderThresholdCommand(void *);
+   LOCALE double                         GetJoinReorderThresholdCommand(void *);
+#if (! RUN_TIME) && (! BLOAD_ONLY)
+   LOCALE struct lhsParseNode           *ProfileReorderPatterns(void *,SYMBOL_HN *,unsigned short,struct lhsParseNode *);
+#endif
+
+#endif /* _H_joinprof */
@@ -0,0 +1,846 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.30  08/16/14            */
+   /*                                                     */
+   /*                 LAZY MATCH MODULE                   */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Defers sending the facts matching the patterns   */
+/*   of the fact pattern network through the join network    */
+/*   until the agenda needs the activations they could       */
+/*   produce. The facts are kept in a queue for each         */
+/*   pattern, and a queue is matched through the joins when  */
+/*   the rule about to fire doesn't have a salience higher   */
+/*   than that of the rules its pattern leads to.            */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#define _LAZYMTCH_SOURCE_
+
+#include <stdio.h>
+#define _STDIO_INCLUDED_
+#include <limits.h>
+#include <string.h>
+
+#include "setup.h"
+
+#if DEFRULE_CONSTRUCT && DEFTEMPLATE_CONSTRUCT
+
+#include "argacces.h"
+#include "constant.h"
+#include "engine.h"
+#include "envrnmnt.h"
+#include "evaluatn.h"
+#include "extnfunc.h"
+#include "factmch.h"
+#include "factmngr.h"
+#include "lgcldpnd.h"
+#include "memalloc.h"
+#include "network.h"
+#include "prntutil.h"
+#include "reteutil.h"
+#include "retract.h"
+#include "router.h"
+#include "ruledef.h"
+#include "symbol.h"
+
+#include "lazymtch.h"
+
+#define LAZY_MATCH_TABLE_SIZE 64
+#define LAZY_MATCH_HEAP_SIZE  64
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static void                    DeallocateLazyMatchData(void *);
+   static unsigned long           LazyMatchHashValue(struct factPatternNode *);
+   static struct lazyMatchQueue  *FindLazyMatchQueue(void *,struct factPatternNode *);
+   static void                    GrowLazyMatchTable(void *);
+   static int                     ReachableSalience(struct joinNode *);
+   static int                     PatternSalience(struct factPatternNode *);
+   static intBool                 QueueGoesFirst(struct lazyMatchQueue *,struct lazyMatchQueue *);
+   static void                    PushLazyMatchQueue(void *,struct lazyMatchQueue *);
+   static void                    RemoveLazyMatchQueue(void *,struct lazyMatchQueue *);
+   static intBool                 MatchGoesFirst(struct lazyMatchQueue *,struct lazyMatchQueue *);
+   static void                    SiftUp(struct lazyMatchQueue **,unsigned long,
+                                         intBool (*)(struct lazyMatchQueue *,struct lazyMatchQueue *));
+   static void                    SiftDown(struct lazyMatchQueue **,unsigned long,unsigned long,
+                                           intBool (*)(struct lazyMatchQueue *,struct lazyMatchQueue *));
+   static struct lazyMatchQueue **GrowQueueArray(void *,struct lazyMatchQueue **,unsigned long *,unsigned long);
+   static void                    UnlinkLazyMatch(void *,struct lazyMatch *);
+   static void                    UnlinkFactLazyMatch(struct lazyMatch *);
+   static void                    ReturnLazyMatch(void *,struct lazyMatch *);
+   static void                    MatchLazyMatches(void *,int);
+
+/******************************************************/
+/* InitializeLazyMatching: Allocates the queues of    */
+/*   deferred matches and defines the lazy matching   */
+/*   commands.                                        */
+/******************************************************/
+globle void InitializeLazyMatching(
+  void *theEnv)
+  {
+   AllocateEnvironmentData(theEnv,LAZY_MATCH_DATA,sizeof(struct lazyMatchData),DeallocateLazyMatchData);
+
+   LazyMatchData(theEnv)->QueueTable = (struct lazyMatchQueue **)
+      CreateLinearHashTable(theEnv,&LazyMatchData(theEnv)->QueueTableInfo,LAZY_MATCH_TABLE_SIZE);
+   LazyMatchData(theEnv)->RuleGeneration = 1;
+
+#if ! RUN_TIME
+   EnvDefineFunction2(theEnv,"set-lazy-matching",'b',PTIEF SetLazyMatchingCommand,
+                      "SetLazyMatchingCommand","11");
+   EnvDefineFunction2(theEnv,"get-lazy-matching",'b',PTIEF GetLazyMatchingCommand,
+                      "GetLazyMatchingCommand","00");
+#endif
+  }
+
+/*****************************************************/
+/* DeallocateLazyMatchData: Deallocates the queues   */
+/*   of deferred matches of an environment.          */
+/*****************************************************/
+static void DeallocateLazyMatchData(
+  void *theEnv)
+  {
+   struct lazyMatchQueue *theQueue, *nextQueue;
+   struct lazyMatch *theMatch, *nextMatch;
+   unsigned long i;
+
+   for (i = 0; i < LazyMatchData(theEnv)->QueueTableInfo.size; i++)
+     {
+      for (theQueue = LazyMatchData(theEnv)->QueueTable[i];
+           theQueue != NULL;
+           theQueue = nextQueue)
+        {
+         nextQueue = theQueue->next;
+         for (theMatch = theQueue->first; theMatch != NULL; theMatch = nextMatch)
+           {
+            nextMatch = theMatch->next;
+            ReturnLazyMatch(theEnv,theMatch);
+           }
+         rtn_struct(theEnv,lazyMatchQueue,theQueue);
+        }
+     }
+
+   ReturnLinearHashTable(theEnv,&LazyMatchData(theEnv)->QueueTableInfo,
+                         (void **) LazyMatchData(theEnv)->QueueTable);
+
+   if (LazyMatchData(theEnv)->QueueHeap != NULL)
+     {
+      genfree(theEnv,LazyMatchData(theEnv)->QueueHeap,
+              sizeof(struct lazyMatchQueue *) * LazyMatchData(theEnv)->QueueHeapMaximum);
+     }
+
+   if (LazyMatchData(theEnv)->MergeHeap != NULL)
+     {
+      genfree(theEnv,LazyMatchData(theEnv)->MergeHeap,
+              sizeof(struct lazyMatchQueue *) * LazyMatchData(theEnv)->MergeHeapMaximum);
+     }
+  }
+
+/*******************************************************************/
+/* EnvSetLazyMatching: Sets the lazy matching behavior. When it's  */
+/*   on, a fact matching a pattern of the fact pattern network     */
+/*   isn't sent through the joins of the pattern when it's         */
+/*   asserted, but queued with the pattern. Before a rule fires,   */
+/*   the queues of the patterns leading to rules whose salience    */
+/*   isn't lower than that of the rule are matched through the     */
+/*   joins, so the rule fired is the one which would have fired    */
+/*   otherwise, up to the order of activations of equal salience.  */
+/*   The facts of patterns leading to rules of lower salience are  */
+/*   never joined if the run is halted before. The agenda only     */
+/*   lists the activations of the matches sent through the joins.  */
+/*   Turning lazy matching off matches the queued facts. Returns   */
+/*   the old value.                                                */
+/*******************************************************************/
+globle intBool EnvSetLazyMatching(
+  void *theEnv,
+  intBool value)
+  {
+   intBool ov;
+
+   ov = LazyMatchData(theEnv)->LazyMatching;
+   LazyMatchData(theEnv)->LazyMatching = value;
+   if (! value) FlushLazyMatches(theEnv);
+   return(ov);
+  }
+
+/*****************************************************/
+/* EnvGetLazyMatching: Returns the lazy matching     */
+/*   behavior (see EnvSetLazyMatching).              */
+/*****************************************************/
+globle intBool EnvGetLazyMatching(
+  void *theEnv)
+  {
+   return(LazyMatchData(theEnv)->LazyMatching);
+  }
+
+/*************************************************/
+/* SetLazyMatchingCommand: H/L access routine    */
+/*   for the set-lazy-matching command.          */
+/*************************************************/
+globle int SetLazyMatchingCommand(
+  void *theEnv)
+  {
+   int oldValue;
+   DATA_OBJECT argPtr;
+
+   oldValue = EnvGetLazyMatching(theEnv);
+
+   if (EnvArgCountCheck(theEnv,"set-lazy-matching",EXACTLY,1) == -1)
+     { return(oldValue); }
+
+   /*===================================================*/
+   /* Facts can't be matched through the joins when the */
+   /* command is called while pattern matching.         */
+   /*===================================================*/
+
+   if (EngineData(theEnv)->JoinOperationInProgress)
+     {
+      PrintErrorID(theEnv,"LAZYMTCH",1,FALSE);
+      EnvPrintRouter(theEnv,WERROR,"The lazy matching behavior cannot be changed during pattern-matching.\n");
+      SetEvaluationError(theEnv,TRUE);
+      return(oldValue);
+     }
+
+   EnvRtnUnknown(theEnv,1,&argPtr);
+
+   if ((argPtr.value == EnvFalseSymbol(theEnv)) && (argPtr.type == SYMBOL))
+     { EnvSetLazyMatching(theEnv,FALSE); }
+   else
+     { EnvSetLazyMatching(theEnv,TRUE); }
+
+   return(oldValue);
+  }
+
+/*************************************************/
+/* GetLazyMatchingCommand: H/L access routine    */
+/*   for the get-lazy-matching command.          */
+/*************************************************/
+globle int GetLazyMatchingCommand(
+  void *theEnv)
+  {
+   int oldValue;
+
+   oldValue = EnvGetLazyMatching(theEnv);
+
+   if (EnvArgCountCheck(theEnv,"get-lazy-matching",EXACTLY,0) == -1)
+     { return(oldValue); }
+
+   return(oldValue);
+  }
+
+/*******************************************************/
+/* LazyMatchHashValue: Returns the hash value of the   */
+/*   queue of a pattern, keyed by the pattern's node.  */
+/*   The nodes may be shared by environments (see      */
+/*   CreateSharedEnvironment), so the queues are kept  */
+/*   by each environment rather than in the nodes.     */
+/*******************************************************/
+static unsigned long LazyMatchHashValue(
+  struct factPatternNode *thePattern)
+  {
+   return(MixHashValue(((unsigned long) thePattern) >> 3));
+  }
+
+/********************************************************/
+/* FindLazyMatchQueue: Finds the queue of a pattern,    */
+/*   adding an empty queue if the pattern has none.     */
+/********************************************************/
+static struct lazyMatchQueue *FindLazyMatchQueue(
+  void *theEnv,
+  struct factPatternNode *thePattern)
+  {
+   struct lazyMatchQueue *theQueue;
+   unsigned long theBucket;
+
+   theBucket = LinearHashIndex(&LazyMatchData(theEnv)->QueueTableInfo,
+                               LazyMatchHashValue(thePattern));
+
+   for (theQueue = LazyMatchData(theEnv)->QueueTable[theBucket];
+        theQueue != NULL;
+        theQueue = theQueue->next)
+     { if (theQueue->thePattern == thePattern) return(theQueue); }
+
+   theQueue = get_struct(theEnv,lazyMatchQueue);
+   theQueue->thePattern = thePattern;
+   theQueue->salience = 0;
+   theQueue->generation = 0;
+   theQueue->heapIndex = 0;
+   theQueue->sequence = 0;
+   theQueue->first = NULL;
+   theQueue->last = NULL;
+   theQueue->next = LazyMatchData(theEnv)->QueueTable[theBucket];
+   LazyMatchData(theEnv)->QueueTable[theBucket] = theQueue;
+
+   if (++LazyMatchData(theEnv)->QueueTableInfo.count > LazyMatchData(theEnv)->QueueTableInfo.size)
+     { GrowLazyMatchTable(theEnv); }
+
+   return(theQueue);
+  }
+
+/***************************************************************/
+/* GrowLazyMatchTable: Splits the next bucket of the queue     */
+/*   table, moving the queues whose hash value now maps to     */
+/*   the new bucket.                                           */
+/***************************************************************/
+static void GrowLazyMatchTable(
+  void *theEnv)
+  {
+   unsigned long splitBucket, newBucket;
+   struct lazyMatchQueue *theQueue, *nextQueue, *prev, **theTable;
+   struct linearHashInfo *theInfo;
+
+   theInfo = &LazyMatchData(theEnv)->QueueTableInfo;
+   theTable = (struct lazyMatchQueue **)
+      ExpandLinearHashTable(theEnv,theInfo,(void **) LazyMatchData(theEnv)->QueueTable,&splitBucket);
+   LazyMatchData(theEnv)->QueueTable = theTable;
+
+   for (theQueue = theTable[splitBucket], prev = NULL;
+        theQueue != NULL;
+        theQueue = nextQueue)
+     {
+      nextQueue = theQueue->next;
+
+      newBucket = LinearHashIndex(theInfo,LazyMatchHashValue(theQueue->thePattern));
+      if (newBucket == splitBucket)
+        {
+         prev = theQueue;
+         continue;
+        }
+
+      if (prev == NULL)
+        { theTable[splitBucket] = nextQueue; }
+      else
+        { prev->next = nextQueue; }
+
+      theQueue->next = theTable[newBucket];
+      theTable[newBucket] = theQueue;
+     }
+  }
+
+/**************************************************************/
+/* ReachableSalience: Returns the highest salience of the     */
+/*   rules activated by a join or the joins following it. A   */
+/*   rule whose salience is dynamic, which has the auto-focus */
+/*   property, or which logically supports facts counts as    */
+/*   INT_MAX: its activations may change the focus or the     */
+/*   salience of other activations, or retract the facts      */
+/*   they match.                                              */
+/**************************************************************/
+static int ReachableSalience(
+  struct joinNode *theJoin)
+  {
+   struct joinLink *theLink;
+   struct defrule *theRule;
+   int salience = INT_MIN, linkSalience;
+
+   theRule = theJoin->ruleToActivate;
+   if (theRule != NULL)
+     {
+      if ((theRule->dynamicSalience != NULL) ||
+          theRule->autoFocus ||
+          (theRule->logicalJoin != NULL))
+        { return(INT_MAX); }
+      salience = theRule->salience;
+     }
+
+   for (theLink = theJoin->nextLinks; theLink != NULL; theLink = theLink->next)
+     {
+      linkSalience = ReachableSalience(theLink->join);
+      if (linkSalience > salience)
+        {
+         salience = linkSalience;
+         if (salience == INT_MAX) break;
+        }
+     }
+
+   return(salience);
+  }
+
+/*******************************************************/
+/* PatternSalience: Returns the highest salience of    */
+/*   the rules a pattern of the fact network leads to. */
+/*******************************************************/
+static int PatternSalience(
+  struct factPatternNode *thePattern)
+  {
+   struct joinNode *theJoin;
+   int salience = INT_MIN, joinSalience;
+
+   for (theJoin = thePattern->header.entryJoin;
+        theJoin != NULL;
+        theJoin = theJoin->rightMatchNode)
+     {
+      joinSalience = ReachableSalience(theJoin);
+      if (joinSalience > salience) salience = joinSalience;
+     }
+
+   return(salience);
+  }
+
+/***********************************************************/
+/* QueueGoesFirst: Determines if a queue is matched before */
+/*   another one, by salience and then by the order in     */
+/*   which they became nonempty.                           */
+/***********************************************************/
+static intBool QueueGoesFirst(
+  struct lazyMatchQueue *queue1,
+  struct lazyMatchQueue *queue2)
+  {
+   if (queue1->salience != queue2->salience)
+     { return(queue1->salience > queue2->salience); }
+
+   return(queue1->sequence < queue2->sequence);
+  }
+
+/************************************************************/
+/* MatchGoesFirst: Determines if the first deferred match   */
+/*   of a queue was deferred before that of another queue.  */
+/************************************************************/
+static intBool MatchGoesFirst(
+  struct lazyMatchQueue *queue1,
+  struct lazyMatchQueue *queue2)
+  {
+   return(queue1->first->sequence < queue2->first->sequence);
+  }
+
+/***********************************************/
+/* SiftUp: Moves a queue of a heap up to its   */
+/*   place, from the given index.              */
+/***********************************************/
+static void SiftUp(
+  struct lazyMatchQueue **theHeap,
+  unsigned long theIndex,
+  intBool (*goesFirst)(struct lazyMatchQueue *,struct lazyMatchQueue *))
+  {
+   struct lazyMatchQueue *theQueue = theHeap[theIndex];
+   unsigned long parent;
+
+   while (theIndex > 0)
+     {
+      parent = (theIndex - 1) / 2;
+      if (! (*goesFirst)(theQueue,theHeap[parent])) break;
+      theHeap[theIndex] = theHeap[parent];
+      theHeap[theIndex]->heapIndex = theIndex;
+      theIndex = parent;
+     }
+
+   theHeap[theIndex] = theQueue;
+   theQueue->heapIndex = theIndex;
+  }
+
+/*************************************************/
+/* SiftDown: Moves a queue of a heap of count    */
+/*   queues down to its place, from the given    */
+/*   index.                                      */
+/*************************************************/
+static void SiftDown(
+  struct lazyMatchQueue **theHeap,
+  unsigned long count,
+  unsigned long theIndex,
+  intBool (*goesFirst)(struct lazyMatchQueue *,struct lazyMatchQueue *))
+  {
+   struct lazyMatchQueue *theQueue = theHeap[theIndex];
+   unsigned long child;
+
+   while ((child = (theIndex * 2) + 1) < count)
+     {
+      if (((child + 1) < count) && (*goesFirst)(theHeap[child + 1],theHeap[child]))
+        { child++; }
+      if (! (*goesFirst)(theHeap[child],theQueue)) break;
+      theHeap[theIndex] = theHeap[child];
+      theHeap[theIndex]->heapIndex = theIndex;
+      theIndex = child;
+     }
+
+   theHeap[theIndex] = theQueue;
+   theQueue->heapIndex = theIndex;
+  }
+
+/**********************************************************/
+/* GrowQueueArray: Doubles the room of an array of queues */
+/*   holding count queues.                                */
+/**********************************************************/
+static struct lazyMatchQueue **GrowQueueArray(
+  void *theEnv,
+  struct lazyMatchQueue **theArray,
+  unsigned long *theMaximum,
+  unsigned long count)
+  {
+   struct lazyMatchQueue **newArray;
+   unsigned long newMaximum;
+
+   newMaximum = (*theMaximum == 0) ? LAZY_MATCH_HEAP_SIZE : (*theMaximum * 2);
+   newArray = (struct lazyMatchQueue **)
+              genalloc(theEnv,sizeof(struct lazyMatchQueue *) * newMaximum);
+
+   if (theArray != NULL)
+     {
+      memcpy(newArray,theArray,sizeof(struct lazyMatchQueue *) * count);
+      genfree(theEnv,theArray,sizeof(struct lazyMatchQueue *) * *theMaximum);
+     }
+
+   *theMaximum = newMaximum;
+   return(newArray);
+  }
+
+/************************************************************/
+/* PushLazyMatchQueue: Adds a queue which became nonempty   */
+/*   to the heap, computing its salience again if rules     */
+/*   were added since it was last computed.                 */
+/************************************************************/
+static void PushLazyMatchQueue(
+  void *theEnv,
+  struct lazyMatchQueue *theQueue)
+  {
+
+   if (theQueue->generation != LazyMatchData(theEnv)->RuleGeneration)
+     {
+      theQueue->salience = PatternSalience(theQueue->thePattern);
+      theQueue->generation = LazyMatchData(theEnv)->RuleGeneration;
+     }
+
+   theQueue->sequence = theQueue->first->sequence;
+
+   if (LazyMatchData(theEnv)->QueueHeapCount == LazyMatchData(theEnv)->QueueHeapMaximum)
+     {
+      LazyMatchData(theEnv)->QueueHeap = GrowQueueArray(theEnv,LazyMatchData(theEnv)->QueueHeap,
+                                          &LazyMatchData(theEnv)->QueueHeapMaximum,LazyMatchData(theEnv)->QueueHeapCount);
+     }
+
+   LazyMatchData(theEnv)->QueueHeap[LazyMatchData(theEnv)->QueueHeapCount] = theQueue;
+   SiftUp(LazyMatchData(theEnv)->QueueHeap,LazyMatchData(theEnv)->QueueHeapCount++,QueueGoesFirst);
+  }
+
+/**********************************************************/
+/* RemoveLazyMatchQueue: Removes a queue from the heap.   */
+/**********************************************************/
+static void RemoveLazyMatchQueue(
+  void *theEnv,
+  struct lazyMatchQueue *theQueue)
+  {
+   struct lazyMatchQueue **theHeap = LazyMatchData(theEnv)->QueueHeap;
+   unsigned long theIndex = theQueue->heapIndex;
+   unsigned long last = --LazyMatchData(theEnv)->QueueHeapCount;
+
+   if (theIndex == last) return;
+
+   theHeap[theIndex] = theHeap[last];
+   theHeap[theIndex]->heapIndex = theIndex;
+
+   if ((theIndex > 0) && QueueGoesFirst(theHeap[theIndex],theHeap[(theIndex - 1) / 2]))
+     { SiftUp(theHeap,theIndex,QueueGoesFirst); }
+   else
+     { SiftDown(theHeap,last,theIndex,QueueGoesFirst); }
+  }
+
+/*********************************************************/
+/* DeferFactAlphaMatch: Queues a fact matching a pattern */
+/*   of the fact network with the pattern rather than    */
+/*   sending it through the joins of the pattern. The    */
+/*   markers belong to the caller and are copied.        */
+/*********************************************************/
+globle void DeferFactAlphaMatch(
+  void *theEnv,
+  struct fact *theFact,
+  struct multifieldMarker *theMarks,
+  struct factPatternNode *thePattern)
+  {
+   struct lazyMatchQueue *theQueue;
+   struct lazyMatch *theMatch;
+
+   theQueue = FindLazyMatchQueue(theEnv,thePattern);
+
+   theMatch = get_struct(theEnv,lazyMatch);
+   theMatch->theFact = theFact;
+   theMatch->theMarks = (theMarks == NULL) ? NULL : CopyMultifieldMarkers(theEnv,theMarks);
+   theMatch->theQueue = theQueue;
+   theMatch->sequence = LazyMatchData(theEnv)->NextSequence++;
+   theMatch->previous = theQueue->last;
+   theMatch->next = NULL;
+   theMatch->nextForFact = theFact->lazyMatches;
+   theFact->lazyMatches = theMatch;
+
+   if (theQueue->last == NULL)
+     {
+      theQueue->first = theMatch;
+      theQueue->last = theMatch;
+      PushLazyMatchQueue(theEnv,theQueue);
+     }
+   else
+     {
+      theQueue->last->next = theMatch;
+      theQueue->last = theMatch;
+     }
+  }
+
+/***********************************************************/
+/* UnlinkLazyMatch: Removes a deferred match from its      */
+/*   queue, and the queue from the heap if it's now empty. */
+/***********************************************************/
+static void UnlinkLazyMatch(
+  void *theEnv,
+  struct lazyMatch *theMatch)
+  {
+   struct lazyMatchQueue *theQueue = theMatch->theQueue;
+
+   if (theMatch->previous == NULL)
+     { theQueue->first = theMatch->next; }
+   else
+     { theMatch->previous->next = theMatch->next; }
+
+   if (theMatch->next == NULL)
+     { theQueue->last = theMatch->previous; }
+   else
+     { theMatch->next->previous = theMatch->previous; }
+
+   if (theQueue->first == NULL)
+     { RemoveLazyMatchQueue(theEnv,theQueue); }
+  }
+
+/**********************************************************/
+/* UnlinkFactLazyMatch: Removes a deferred match from the */
+/*   list of deferred matches of its fact.                */
+/**********************************************************/
+static void UnlinkFactLazyMatch(
+  struct lazyMatch *theMatch)
+  {
+   struct lazyMatch *factMatch;
+
+   if (theMatch->theFact->lazyMatches == theMatch)
+     {
+      theMatch->theFact->lazyMatches = theMatch->nextForFact;
+      return;
+     }
+
+   for (factMatch = theMatch->theFact->lazyMatches;
+        factMatch->nextForFact != theMatch;
+        factMatch = factMatch->nextForFact)
+     { /* Do Nothing */ }
+
+   factMatch->nextForFact = theMatch->nextForFact;
+  }
+
+/*****************************************************/
+/* ReturnLazyMatch: Returns a deferred match and its */
+/*   markers to the pool of free memory.             */
+/*****************************************************/
+static void ReturnLazyMatch(
+  void *theEnv,
+  struct lazyMatch *theMatch)
+  {
+   struct multifieldMarker *theMark, *nextMark;
+
+   for (theMark = theMatch->theMarks; theMark != NULL; theMark = nextMark)
+     {
+      nextMark = theMark->next;
+      rtn_struct(theEnv,multifieldMarker,theMark);
+     }
+
+   rtn_struct(theEnv,lazyMatch,theMatch);
+  }
+
+/****************************************************************/
+/* MatchLazyMatches: Sends the deferred matches of the queues   */
+/*   whose salience isn't lower than the given one through the  */
+/*   joins of their patterns, in the order they were deferred,  */
+/*   as they would have been when the facts were asserted. The  */
+/*   queues are taken off the heap and merged by a heap of      */
+/*   their first matches. The logical retractions are then      */
+/*   carried out and the partial matches released are freed.    */
+/*   An error in the join network is reported as by the assert  */
+/*   of the fact, and doesn't halt the run matching it.         */
+/****************************************************************/
+static void MatchLazyMatches(
+  void *theEnv,
+  int salience)
+  {
+   struct lazyMatchQueue *theQueue;
+   struct lazyMatch *theMatch;
+   unsigned long count = 0;
+   int haltExecution, evaluationError;
+
+   while ((LazyMatchData(theEnv)->QueueHeapCount != 0) &&
+          (LazyMatchData(theEnv)->QueueHeap[0]->salience >= salience))
+     {
+      theQueue = LazyMatchData(theEnv)->QueueHeap[0];
+      RemoveLazyMatchQueue(theEnv,theQueue);
+      if (count == LazyMatchData(theEnv)->MergeHeapMaximum)
+        {
+         LazyMatchData(theEnv)->MergeHeap = GrowQueueArray(theEnv,LazyMatchData(theEnv)->MergeHeap,
+                                             &LazyMatchData(theEnv)->MergeHeapMaximum,count);
+        }
+      LazyMatchData(theEnv)->MergeHeap[count] = theQueue;
+      SiftUp(LazyMatchData(theEnv)->MergeHeap,count++,MatchGoesFirst);
+     }
+
+   haltExecution = EvaluationData(theEnv)->HaltExecution;
+   evaluationError = EvaluationData(theEnv)->EvaluationError;
+
+   EngineData(theEnv)->JoinOperationInProgress = TRUE;
+
+   while (count != 0)
+     {
+      theQueue = LazyMatchData(theEnv)->MergeHeap[0];
+      theMatch = theQueue->first;
+      theQueue->first = theMatch->next;
+
+      if (theQueue->first == NULL)
+        {
+         theQueue->last = NULL;
+         if (--count != 0)
+           {
+            LazyMatchData(theEnv)->MergeHeap[0] = LazyMatchData(theEnv)->MergeHeap[count];
+            SiftDown(LazyMatchData(theEnv)->MergeHeap,count,0,MatchGoesFirst);
+           }
+        }
+      else
+        {
+         theQueue->first->previous = NULL;
+         SiftDown(LazyMatchData(theEnv)->MergeHeap,count,0,MatchGoesFirst);
+        }
+
+      UnlinkFactLazyMatch(theMatch);
+
+      FactData(theEnv)->CurrentPatternFact = theMatch->theFact;
+      FactData(theEnv)->CurrentPatternMarks = theMatch->theMarks;
+      CreateFactAlphaMatch(theEnv,theMatch->theFact,theMatch->theMarks,theQueue->thePattern);
+      ReturnLazyMatch(theEnv,theMatch);
+
+      SetHaltExecution(theEnv,haltExecution);
+      SetEvaluationError(theEnv,evaluationError);
+     }
+
+   EngineData(theEnv)->JoinOperationInProgress = FALSE;
+
+   ForceLogicalRetractions(theEnv);
+
+   if (EngineData(theEnv)->ExecutingRule == NULL) FlushGarbagePartialMatches(theEnv);
+  }
+
+/***************************************************************/
+/* EvaluateLazyMatches: Returns the next activation on the     */
+/*   agenda of the current focus after matching the queues     */
+/*   whose patterns lead to rules whose salience isn't lower   */
+/*   than that of the activation. The queues are matched one   */
+/*   salience at a time, highest first, so the queues of lower */
+/*   salience are left alone once an activation of higher      */
+/*   salience is found. Every queue is matched if the agenda   */
+/*   stays empty, so the focus is only popped once no          */
+/*   activation can be added to it.                            */
+/***************************************************************/
+globle struct activation *EvaluateLazyMatches(
+  void *theEnv)
+  {
+   struct activation *theActivation;
+   int salience;
+
+   while (TRUE)
+     {
+      theActivation = EngineData(theEnv)->CurrentFocus->theDefruleModule->agenda;
+      if (LazyMatchData(theEnv)->QueueHeapCount == 0) return(theActivation);
+
+      salience = LazyMatchData(theEnv)->QueueHeap[0]->salience;
+      if ((theActivation != NULL) && (salience < theActivation->salience))
+        { return(theActivation); }
+
+      MatchLazyMatches(theEnv,salience);
+     }
+  }
+
+/**********************************************************/
+/* FlushLazyMatches: Sends every deferred match through   */
+/*   the joins of its pattern.                            */
+/**********************************************************/
+globle void FlushLazyMatches(
+  void *theEnv)
+  {
+   while (LazyMatchData(theEnv)->QueueHeapCount != 0)
+     { MatchLazyMatches(theEnv,INT_MIN); }
+  }
+
+/***************************************************************/
+/* LazyMatchRulesChanged: Called before the joins of a rule    */
+/*   are added to the network. The deferred matches are sent   */
+/*   through the joins first, so the new joins are primed from */
+/*   the alpha memories just as if matching wasn't deferred,   */
+/*   and the saliences of the queues are computed again.       */
+/***************************************************************/
+globle void LazyMatchRulesChanged(
+  void *theEnv)
+  {
+   FlushLazyMatches(theEnv);
+   LazyMatchData(theEnv)->RuleGeneration++;
+  }
+
+/*****************************************************/
+/* RemoveLazyMatches: Removes the deferred matches   */
+/*   of a fact being retracted.                      */
+/*****************************************************/
+globle void RemoveLazyMatches(
+  void *theEnv,
+  struct fact *theFact)
+  {
+   struct lazyMatch *theMatch, *nextMatch;
+
+   for (theMatch = theFact->lazyMatches; theMatch != NULL; theMatch = nextMatch)
+     {
+      nextMatch = theMatch->nextForFact;
+      UnlinkLazyMatch(theEnv,theMatch);
+      ReturnLazyMatch(theEnv,theMatch);
+     }
+
+   theFact->lazyMatches = NULL;
+  }
+
+/*******************************************************/
+/* DiscardLazyMatches: Removes the queue of a pattern  */
+/*   node being removed from the fact network, along   */
+/*   with its deferred matches.                        */
+/*******************************************************/
+globle void DiscardLazyMatches(
+  void *theEnv,
+  struct factPatternNode *thePattern)
+  {
+   struct lazyMatchQueue *theQueue, *prev;
+   struct lazyMatch *theMatch;
+   unsigned long theBucket;
+
+   theBucket = LinearHashIndex(&LazyMatchData(theEnv)->QueueTableInfo,
+                               LazyMatchHashValue(thePattern));
+
+   for (theQueue = LazyMatchData(theEnv)->QueueTable[theBucket], prev = NULL;
+        theQueue != NULL;
+        prev = theQueue, theQueue = theQueue->next)
+     { if (theQueue->thePattern == thePattern) break; }
+
+   if (theQueue == NULL) return;
+
+   while ((theMatch = theQueue->first) != NULL)
+     {
+      UnlinkLazyMatch(theEnv,theMatch);
+
+      UnlinkFactLazyMatch(theMatch);
+
+      ReturnLazyMatch(theEnv,theMatch);
+     }
+
+   if (prev == NULL)
+     { LazyMatchData(theEnv)->QueueTable[theBucket] = theQueue->next; }
+   else
+     { prev->next = theQueue->next; }
+   LazyMatchData(theEnv)->QueueTableInfo.count--;
+
+   rtn_struct(theEnv,lazyMatchQueue,theQueue);
+  }
+
+#endif /* DEFRULE_CONSTRUCT && DEFTEMPLATE_CONSTRUCT */
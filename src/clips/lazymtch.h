@@ -0,0 +1,130 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.30  08/16/14            */
+   /*                                                     */
+   /*               LAZY MATCH HEADER FILE                */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Defers sending the facts matching the patterns   */
+/*   of the fact pattern network through the join network    */
+/*   until the agenda needs the activations they could       */
+/*   produce. The facts are kept in a queue for each         */
+/*   pattern, and a queue is matched through the joins when  */
+/*   the rule about to fire doesn't have a salience higher   */
+/*   than that of the rules its pattern leads to.            */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_lazymtch
+#define _H_lazymtch
+
+struct lazyMatch;
+struct lazyMatchQueue;
+
+#ifndef _H_agenda
+#include "agenda.h"
+#endif
+#ifndef _H_factbld
+#include "factbld.h"
+#endif
+#ifndef _H_factmngr
+#include "factmngr.h"
+#endif
+#ifndef _H_symbol
+#include "symbol.h"
+#endif
+
+#define LAZY_MATCH_DATA 66
+
+#ifdef LOCALE
+#undef LOCALE
+#endif
+
+#ifdef _LAZYMTCH_SOURCE_
+#define LOCALE
+#else
+#define LOCALE extern
+#endif
+
+/*=====================================================*/
+/* A fact matching a pattern which hasn't been sent    */
+/* through the joins of the pattern yet, along with    */
+/* the multifield markers of the match. It's linked in */
+/* the queue of the pattern and in the list of         */
+/* deferred matches of the fact. The sequence number   */
+/* orders the deferred matches as the facts were       */
+/* asserted.                                           */
+/*=====================================================*/
+
+struct lazyMatch
+  {
+   struct fact *theFact;
+   struct multifieldMarker *theMarks;
+   struct lazyMatchQueue *theQueue;
+   long long sequence;
+   struct lazyMatch *previous;
+   struct lazyMatch *next;
+   struct lazyMatch *nextForFact;
+  };
+
+/*=======================================================*/
+/* The deferred matches of a pattern, oldest first. The  */
+/* salience is the highest one of the rules the pattern  */
+/* leads to, computed for the rules loaded in the given  */
+/* generation. Nonempty queues are kept in a heap by     */
+/* salience, those which became nonempty first going     */
+/* first among equal saliences. The queues being         */
+/* matched are merged by the sequence number of their    */
+/* first match in a second heap.                         */
+/*=======================================================*/
+
+struct lazyMatchQueue
+  {
+   struct factPatternNode *thePattern;
+   int salience;
+   unsigned long generation;
+   unsigned long heapIndex;
+   long long sequence;
+   struct lazyMatch *first;
+   struct lazyMatch *last;
+   struct lazyMatchQueue *next;
+  };
+
+struct lazyMatchData
+  {
+   intBool LazyMatching;
+   struct lazyMatchQueue **QueueTable;
+   struct linearHashInfo QueueTableInfo;
+   struct lazyMatchQueue **QueueHeap;
+   unsigned long QueueHeapCount;
+   unsigned long QueueHeapMaximum;
+   struct lazyMatchQueue **MergeHeap;
+   unsigned long MergeHeapMaximum;
+   unsigned long RuleGeneration;
+   long long NextSequence;
+  };
+
+#define LazyMatchData(theEnv) ((struct lazyMatchData *) GetEnvironmentData(theEnv,LAZY_MATCH_DATA))
+#define LazyMatchesPending(theEnv) (LazyMatchData(theEnv)->QueueHeapCount != 0)
+
+   LOCALE void                           InitializeLazyMatching(void *);
+   LOCALE intBool                        EnvSetLazyMatching(void *,intBool);
+   LOCALE intBool                        EnvGetLazyMatching(void *);
+   LOCALE int                            SetLazyMatchingCommand(void *);
+   LOCALE int                            GetLazyMatchingCommand(void *);
+   LOCALE void                           DeferFactAlphaMatch(void *,struct fact *,struct multifieldMarker *,struct factPatternNode *);
+   LOCALE struct activation             *EvaluateLazyMatches(void *);
+   LOCALE void                           FlushLazyMatches(void *);
+   LOCALE void                           LazyMatchRulesChanged(void *);
+   LOCALE void                           RemoveLazyMatches(void *,struct fact *);
+   LOCALE void                           DiscardLazyMatches(void *,struct factPatternNode *);
+
+#endif /* _H_lazymtch */
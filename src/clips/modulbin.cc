@@ -54,6 +54,7 @@
    static void                    UpdateDefmodule(void *,void *,long);
    static void                    UpdatePortItem(void *,void *,long);
    static void                    ClearBload(void *);
+   static void                    ShareDefmodules(void *,void *);
 
 /*********************************************/
 /* DefmoduleBinarySetup: Installs the binary */
@@ -72,6 +73,7 @@ globle void DefmoduleBinarySetup(
 #endif
 
    AddAbortBloadFunction(theEnv,"defmodule",CreateMainModule,0);
+   AddShareBloadFunction(theEnv,"defmodule",ShareDefmodules,-2000);
 
 #if (BLOAD || BLOAD_ONLY)
    AddBinaryItem(theEnv,"defmodule",0,NULL,NULL,NULL,NULL,
@@ -437,6 +439,33 @@ static void BloadBinaryItem(
    EnvSetCurrentModule(theEnv,(void *) EnvGetNextDefmodule(theEnv,NULL));
   }
 
+/*****************************************************/
+/* ShareDefmodules: Uses the defmodules of a frozen  */
+/*   binary image. The visited flags used to search  */
+/*   the module hierarchy are kept per environment.  */
+/*   Called last, so that the functions called when  */
+/*   the current module is set see the other         */
+/*   constructs already shared.                      */
+/*****************************************************/
+static void ShareDefmodules(
+  void *theEnv,
+  void *frozenEnv)
+  {
+   long i;
+
+   DefmoduleData(theEnv)->SharedDefmoduleArray = DefmoduleData(frozenEnv)->DefmoduleArray;
+   DefmoduleData(theEnv)->NumberOfSharedDefmodules = DefmoduleData(frozenEnv)->BNumberOfDefmodules;
+   if (DefmoduleData(theEnv)->NumberOfSharedDefmodules == 0) return;
+
+   DefmoduleData(theEnv)->VisitedFlagArray = (unsigned *)
+      genalloc(theEnv,sizeof(unsigned) * DefmoduleData(theEnv)->NumberOfSharedDefmodules);
+   for (i = 0; i < DefmoduleData(theEnv)->NumberOfSharedDefmodules; i++)
+     { DefmoduleData(theEnv)->VisitedFlagArray[i] = FALSE; }
+
+   SetListOfDefmodules(theEnv,(void *) DefmoduleData(theEnv)->SharedDefmoduleArray);
+   EnvSetCurrentModule(theEnv,(void *) EnvGetNextDefmodule(theEnv,NULL));
+  }
+
 /******************************************/
 /* UpdateDefmodule: Bload refresh routine */
 /*   for defmodule data structure.        */
@@ -124,6 +124,13 @@ static void DeallocateDefmoduleData(
 
    space = DefmoduleData(theEnv)->NumberOfPortItems * sizeof(struct portItem);
    if (space != 0) genfree(theEnv,(void *) DefmoduleData(theEnv)->PortItemArray,space);
+
+   if (DefmoduleData(theEnv)->SharedDefmoduleArray != NULL)
+     {
+      space = DefmoduleData(theEnv)->NumberOfSharedDefmodules * sizeof(unsigned);
+      if (space != 0) genfree(theEnv,(void *) DefmoduleData(theEnv)->VisitedFlagArray,space);
+      DefmoduleData(theEnv)->ListOfDefmodules = NULL;
+     }
 #endif
 
 #if (! RUN_TIME) && (! BLOAD_ONLY)
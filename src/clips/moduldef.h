@@ -198,11 +198,27 @@ struct defmoduleData
    long NumberOfPortItems;
    struct portItem *PortItemArray;
    struct defmodule *DefmoduleArray;
+   struct defmodule *SharedDefmoduleArray;
+   long NumberOfSharedDefmodules;
+   unsigned *VisitedFlagArray;
 #endif
   };
   
 #define DefmoduleData(theEnv) ((struct defmoduleData *) GetEnvironmentData(theEnv,DEFMODULE_DATA))
 
+/*=====================================================*/
+/* The visited flags of the defmodules in a shared     */
+/* binary image belong to the environment using them.  */
+/*=====================================================*/
+
+#if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
+#define DefmoduleVisitedFlag(theEnv,theModule) \
+   (*((DefmoduleData(theEnv)->SharedDefmoduleArray == NULL) ? &(theModule)->visitedFlag : \
+      &DefmoduleData(theEnv)->VisitedFlagArray[(theModule) - DefmoduleData(theEnv)->SharedDefmoduleArray]))
+#else
+#define DefmoduleVisitedFlag(theEnv,theModule) ((theModule)->visitedFlag)
+#endif
+
 #ifdef LOCALE
 #undef LOCALE
 #endif
@@ -366,11 +366,11 @@ globle void MarkModulesAsUnvisited(
   {
    struct defmodule *theModule;
 
-   DefmoduleData(theEnv)->CurrentModule->visitedFlag = FALSE;
+   DefmoduleVisitedFlag(theEnv,DefmoduleData(theEnv)->CurrentModule) = FALSE;
    for (theModule = (struct defmodule *) EnvGetNextDefmodule(theEnv,NULL);
         theModule != NULL;
         theModule = (struct defmodule *) EnvGetNextDefmodule(theEnv,theModule))
-     { theModule->visitedFlag = FALSE; }
+     { DefmoduleVisitedFlag(theEnv,theModule) = FALSE; }
   }
 
 /***********************************************************/
@@ -401,7 +401,7 @@ static void *SearchImportedConstructModules(
    /*=========================================*/
 
    currentModule = ((struct defmodule *) EnvGetCurrentModule(theEnv));
-   if (currentModule->visitedFlag) return(NULL);
+   if (DefmoduleVisitedFlag(theEnv,currentModule)) return(NULL);
 
    /*=======================================================*/
    /* The searchCurrent flag indicates whether the current  */
@@ -453,7 +453,7 @@ static void *SearchImportedConstructModules(
    /* Mark the current module as visited. */
    /*=====================================*/
 
-   currentModule->visitedFlag = TRUE;
+   DefmoduleVisitedFlag(theEnv,currentModule) = TRUE;
 
    /*===================================*/
    /* Search through all of the modules */
@@ -598,7 +598,7 @@ globle intBool AllImportedModulesVisited(
      {
       theImportModule = (struct defmodule *) EnvFindDefmodule(theEnv,ValueToString(theImportList->moduleName));
 
-      if (! theImportModule->visitedFlag) return FALSE;
+      if (! DefmoduleVisitedFlag(theEnv,theImportModule)) return FALSE;
       
       theImportList = theImportList->next;
      }
@@ -204,7 +204,8 @@ globle void DestroyHandlerLinks(
      {
       tmp = mhead;
       mhead = mhead->nxt;
-      tmp->hnd->busy--;
+      if (! ConstructData(theEnv)->ConstructsFrozen)
+        tmp->hnd->busy--;
       DecrementDefclassBusyCount(theEnv,(void *) tmp->hnd->cls);
       rtn_struct(theEnv,messageHandlerLink,tmp);
      }
@@ -466,7 +467,8 @@ globle void FindApplicableOfName(
         break;
 
       tmp = get_struct(theEnv,messageHandlerLink);
-      hnd[arr[i]].busy++;
+      if (! ConstructData(theEnv)->ConstructsFrozen)
+        hnd[arr[i]].busy++;
       IncrementDefclassBusyCount(theEnv,(void *) hnd[arr[i]].cls);
       tmp->hnd = &hnd[arr[i]];
       if (tops[tmp->hnd->type] == NULL)
@@ -651,7 +651,7 @@ globle unsigned long HashMultifield(
 #if OBJECT_SYSTEM
           case INSTANCE_NAME:
 #endif
-            tvalue = (unsigned long) HashSymbol(ValueToString(fieldPtr[i].value),theRange);
+            tvalue = SymbolHashValue(fieldPtr[i].value);
             count += (unsigned long) (tvalue * (i + 29));
             break;
          }
@@ -27,6 +27,7 @@
 struct patternNodeHeader;
 struct joinNode;
 struct alphaMemoryHash;
+struct rangeIndex;
 
 #ifndef _H_match
 #include "match.h"
@@ -61,7 +62,13 @@ struct patternNodeHashEntry
    struct patternNodeHashEntry *next;
   };
 
-#define SIZE_PATTERN_HASH 16231
+/*==================================================*/
+/* Initial number of buckets in the pattern node    */
+/* hash table, which grows with the pattern nodes.  */
+/* Must be a power of two.                          */
+/*==================================================*/
+
+#define SIZE_PATTERN_HASH 64
 
 struct alphaMemoryHash
   {
@@ -81,16 +88,31 @@ typedef struct alphaMemoryHash ALPHA_MEMORY_HASH;
 #include "ruledef.h"
 #endif
 
+/*==================================================*/
+/* A hashed beta memory grows once it holds more    */
+/* than BETA_HASH_LOAD partial matches per bucket.  */
+/* When it empties, it shrinks to the size needed   */
+/* by the most partial matches it held since it     */
+/* last emptied (peak), so a memory refilled to the */
+/* same level after each reset keeps its size.      */
+/*==================================================*/
+
 #define INITIAL_BETA_HASH_SIZE 17
+#define BETA_HASH_LOAD 2
+#define NextBetaHashSize(size) (((size) * 4) + 1)
 
 struct betaMemory
   {
    unsigned long size;
    unsigned long count;
+   unsigned long peak;
    struct partialMatch **beta;
    struct partialMatch **last;
+   struct rangeIndex *rangeIndex;
   };
 
+struct expressionCode;
+
 struct joinLink
   {
    char enterDirection;
@@ -108,6 +130,7 @@ struct joinNode
    unsigned int patternIsExists : 1;
    unsigned int initialize : 1;
    unsigned int marked : 1;
+   unsigned int rangeLeftBelow : 1;
    unsigned int rhsType : 3;
    unsigned int depth : 16;
    long bsaveID;
@@ -116,12 +139,18 @@ struct joinNode
    long long memoryLeftDeletes;
    long long memoryRightDeletes;
    long long memoryCompares;
+   long long memoryProbes;
+   long long memoryRightActivations;
    struct betaMemory *leftMemory;
    struct betaMemory *rightMemory;
    struct expr *networkTest;
    struct expr *secondaryNetworkTest;
    struct expr *leftHash;
    struct expr *rightHash;
+   struct expr *leftRange;
+   struct expr *rightRange;
+   struct expressionCode *networkCode;
+   struct expressionCode *secondaryNetworkCode;
    void *rightSideEntryStructure;
    struct joinLink *nextLinks;
    struct joinNode *lastLevel;
@@ -48,6 +48,7 @@
 #include "cstrcbin.h"
 #include "cstrnbin.h"
 #include "envrnmnt.h"
+#include "inscom.h"
 #include "insfun.h"
 #include "memalloc.h"
 #include "modulbin.h"
@@ -192,6 +193,8 @@ static void UpdateTemplateSlot(void *,void *,long);
 static void UpdateHandler(void *,void *,long);
 static void ClearBloadObjects(void *);
 static void DeallocateObjectBinaryData(void *);
+static int ObjectsFreezeReady(void *);
+static void ShareObjects(void *,void *);
 
 /* =========================================
    *****************************************
@@ -228,6 +231,8 @@ globle void SetupObjectsBload(
                              ClearBloadObjects);
 #endif
 
+   AddFreezeBloadReadyFunction(theEnv,"defclass",ObjectsFreezeReady,0);
+   AddShareBloadFunction(theEnv,"defclass",ShareObjects,0);
   }
   
 /*******************************************************/
@@ -294,6 +299,54 @@ static void DeallocateObjectBinaryData(
 #endif
   }
 
+/***************************************************
+  NAME         : ObjectsFreezeReady
+  DESCRIPTION  : Determines if a binary image can
+                 be shared by other environments
+  INPUTS       : None
+  RETURNS      : TRUE if there are no instances,
+                 FALSE otherwise
+  SIDE EFFECTS : None
+  NOTES        : Instances are linked into the
+                 lists of their classes
+ ***************************************************/
+static int ObjectsFreezeReady(
+  void *theEnv)
+  {
+   return(InstanceData(theEnv)->InstanceList == NULL);
+  }
+
+/***************************************************
+  NAME         : ShareObjects
+  DESCRIPTION  : Uses the classes, slot names and
+                 message-handlers of a frozen
+                 binary image
+  INPUTS       : The frozen environment
+  RETURNS      : Nothing useful
+  SIDE EFFECTS : Class tables of the environment
+                 replaced with those of the image
+  NOTES        : Environments sharing the image
+                 can't create instances, so the
+                 classes are only read
+ ***************************************************/
+static void ShareObjects(
+  void *theEnv,
+  void *frozenEnv)
+  {
+   int i;
+
+   genfree(theEnv,(void *) DefclassData(theEnv)->ClassTable,sizeof(DEFCLASS *) * CLASS_TABLE_HASH_SIZE);
+   genfree(theEnv,(void *) DefclassData(theEnv)->SlotNameTable,sizeof(SLOT_NAME *) * SLOT_NAME_TABLE_HASH_SIZE);
+
+   DefclassData(theEnv)->ClassTable = DefclassData(frozenEnv)->ClassTable;
+   DefclassData(theEnv)->SlotNameTable = DefclassData(frozenEnv)->SlotNameTable;
+   DefclassData(theEnv)->ClassIDMap = DefclassData(frozenEnv)->ClassIDMap;
+   DefclassData(theEnv)->MaxClassID = DefclassData(frozenEnv)->MaxClassID;
+   DefclassData(theEnv)->AvailClassID = DefclassData(frozenEnv)->AvailClassID;
+   for (i = 0 ; i < PRIMITIVE_CLASSES ; i++)
+     DefclassData(theEnv)->PrimitiveClassMap[i] = DefclassData(frozenEnv)->PrimitiveClassMap[i];
+  }
+
 /***************************************************
   NAME         : BloadDefclassModuleReference
   DESCRIPTION  : Returns a pointer to the
@@ -109,6 +109,7 @@ static void UpdateAlpha(void *,void *,long);
 static void UpdatePattern(void *,void *,long);
 static void ClearBloadObjectPatterns(void *);
 static void DeallocateObjectReteBinaryData(void *);
+static int ObjectPatternsFreezeReady(void *);
 
 /* =========================================
    *****************************************
@@ -142,6 +143,7 @@ globle void SetupObjectPatternsBload(
                              BloadStorageObjectPatterns,BloadObjectPatterns,
                              ClearBloadObjectPatterns);
 #endif
+   AddFreezeBloadReadyFunction(theEnv,"object patterns",ObjectPatternsFreezeReady,0);
   }
   
 /***********************************************************/
@@ -167,6 +169,24 @@ static void DeallocateObjectReteBinaryData(
 #endif
   }
 
+/***************************************************
+  NAME         : ObjectPatternsFreezeReady
+  DESCRIPTION  : Determines if a binary image can
+                 be shared by other environments
+  INPUTS       : None
+  RETURNS      : TRUE if no rule matches objects,
+                 FALSE otherwise
+  SIDE EFFECTS : None
+  NOTES        : Environments sharing the image
+                 can't create instances
+ ***************************************************/
+static int ObjectPatternsFreezeReady(
+  void *theEnv)
+  {
+   return((ObjectReteBinaryData(theEnv)->AlphaNodeCount == 0L) &&
+          (ObjectReteBinaryData(theEnv)->PatternNodeCount == 0L));
+  }
+
 /* =========================================
    *****************************************
           INTERNALLY VISIBLE FUNCTIONS
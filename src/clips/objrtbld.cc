@@ -216,6 +216,7 @@ globle void SetupObjectPatternStuff(
    newPtr->replaceGetPNValueFunction = ReplaceGetPNObjectValue;
    newPtr->genGetPNValueFunction = GenGetPNObjectValue;
    newPtr->genComparePNValuesFunction = ObjectPNVariableComparison;
+   newPtr->genPNComparisonFunction = NULL;
    newPtr->returnUserDataFunction = DeleteClassBitMap;
    newPtr->copyUserDataFunction = CopyClassBitMap;
 
@@ -716,6 +717,22 @@ static struct patternNodeHeader *PlaceObjectPattern(
       else
         { endSlot = FALSE; }
 
+      /*=====================================================*/
+      /* Selector nodes of the object pattern network only   */
+      /* dispatch single constants, so a field satisfied by  */
+      /* several constants or complemented constants is      */
+      /* tested by its network test instead.                 */
+      /*=====================================================*/
+
+      if ((thePattern->constantValue != NULL) &&
+          (thePattern->constantValue->type == FCALL))
+        {
+         ReturnExpression(theEnv,thePattern->constantSelector);
+         ReturnExpression(theEnv,thePattern->constantValue);
+         thePattern->constantSelector = NULL;
+         thePattern->constantValue = NULL;
+        }
+
       /*========================================*/
       /* Is there a node in the pattern network */
       /* that can be reused (shared)?           */
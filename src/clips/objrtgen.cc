@@ -231,7 +231,11 @@ globle void GenObjectLengthTest(
                                          (int) sizeof(struct ObjectMatchLength)));
                                          
    if (theNode->constantSelector != NULL)
-     { theNode->constantSelector->nextArg = CopyExpression(theEnv,theTest); }
+     {
+      theNode->constantSelector->nextArg =
+         CombineExpressions(theEnv,CopyExpression(theEnv,theTest),
+                            theNode->constantSelector->nextArg);
+     }
 
    theNode->networkTest = CombineExpressions(theEnv,theTest,theNode->networkTest);
   }
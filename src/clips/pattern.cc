@@ -64,7 +64,8 @@
    static void                            TallyFieldTypes(struct lhsParseNode *);
 #endif
    static void                            DeallocatePatternData(void *);
-   static struct patternNodeHashEntry   **CreatePatternHashTable(void *,unsigned long);
+   static unsigned long                   PatternNodeHashValue(void *,unsigned short,void *);
+   static void                            GrowPatternHashTable(void *);
    
 /*****************************************************************************/
 /* InitializePatterns: Initializes the global data associated with patterns. */
@@ -74,30 +75,10 @@ globle void InitializePatterns(
   {   
    AllocateEnvironmentData(theEnv,PATTERN_DATA,sizeof(struct patternData),DeallocatePatternData);
    PatternData(theEnv)->NextPosition = 1;
-   PatternData(theEnv)->PatternHashTable = CreatePatternHashTable(theEnv,SIZE_PATTERN_HASH);
-   PatternData(theEnv)->PatternHashTableSize = SIZE_PATTERN_HASH;
+   PatternData(theEnv)->PatternHashTable = (struct patternNodeHashEntry **)
+      CreateLinearHashTable(theEnv,&PatternData(theEnv)->PatternHashTableInfo,SIZE_PATTERN_HASH);
   }
 
-/*******************************************************************/
-/* CreatePatternHashTable: Creates and initializes a fact hash table. */
-/*******************************************************************/
-static struct patternNodeHashEntry **CreatePatternHashTable(
-   void *theEnv,
-   unsigned long tableSize)
-   {
-    unsigned long i;
-    struct patternNodeHashEntry **theTable;
-
-    theTable = (struct patternNodeHashEntry **)
-               gm3(theEnv,sizeof (struct patternNodeHashEntry *) * tableSize);
-
-    if (theTable == NULL) EnvExitRouter(theEnv,EXIT_FAILURE);
-    
-    for (i = 0; i < tableSize; i++) theTable[i] = NULL;
-    
-    return(theTable);
-   }
-       
 /**************************************************/
 /* DeallocatePatternData: Deallocates environment */
 /*    data for rule pattern registration.         */
@@ -126,7 +107,9 @@ static void DeallocatePatternData(
       tmpPPPtr = nextPPPtr;
      }
    
-   for (i = 0; i < PatternData(theEnv)->PatternHashTableSize; i++) 
+   if (PatternData(theEnv)->PatternHashTableShared) return;
+
+   for (i = 0; i < PatternData(theEnv)->PatternHashTableInfo.size; i++)
      {
       tmpPNEPtr = PatternData(theEnv)->PatternHashTable[i];
       
@@ -138,8 +121,8 @@ static void DeallocatePatternData(
         }
      }
   
-   rm3(theEnv,PatternData(theEnv)->PatternHashTable,
-       sizeof(struct patternNodeHashEntry *) * PatternData(theEnv)->PatternHashTableSize);
+   ReturnLinearHashTable(theEnv,&PatternData(theEnv)->PatternHashTableInfo,
+                         (void **) PatternData(theEnv)->PatternHashTable);
   }
 
 /******************************************************************************/
@@ -155,7 +138,7 @@ globle void AddHashedPatternNode(
    unsigned long hashValue;
    struct patternNodeHashEntry *newhash, *temp;
 
-   hashValue = GetAtomicHashValue(keyType,keyValue,1) + HashExternalAddress(parent,0); /* TBD mult * 30 */
+   hashValue = PatternNodeHashValue(parent,keyType,keyValue);
 
    newhash = get_struct(theEnv,patternNodeHashEntry);
    newhash->parent = parent;
@@ -163,11 +146,14 @@ globle void AddHashedPatternNode(
    newhash->type = keyType;
    newhash->value = keyValue;
 
-   hashValue = (hashValue % PatternData(theEnv)->PatternHashTableSize);
+   hashValue = LinearHashIndex(&PatternData(theEnv)->PatternHashTableInfo,hashValue);
    
    temp = PatternData(theEnv)->PatternHashTable[hashValue];
    PatternData(theEnv)->PatternHashTable[hashValue] = newhash;
    newhash->next = temp;
+
+   if (++PatternData(theEnv)->PatternHashTableInfo.count > PatternData(theEnv)->PatternHashTableInfo.size)
+     { GrowPatternHashTable(theEnv); }
   }
 
 /***************************************************/
@@ -184,8 +170,8 @@ globle intBool RemoveHashedPatternNode(
    unsigned long hashValue;
    struct patternNodeHashEntry *hptr, *prev;
 
-   hashValue = GetAtomicHashValue(keyType,keyValue,1) + HashExternalAddress(parent,0); /* TBD mult * 30 */
-   hashValue = (hashValue % PatternData(theEnv)->PatternHashTableSize);
+   hashValue = PatternNodeHashValue(parent,keyType,keyValue);
+   hashValue = LinearHashIndex(&PatternData(theEnv)->PatternHashTableInfo,hashValue);
 
    for (hptr = PatternData(theEnv)->PatternHashTable[hashValue], prev = NULL;
         hptr != NULL;
@@ -193,6 +179,8 @@ globle intBool RemoveHashedPatternNode(
      {
       if (hptr->child == child)
         {
+         PatternData(theEnv)->PatternHashTableInfo.count--;
+
          if (prev == NULL)
            {
             PatternData(theEnv)->PatternHashTable[hashValue] = hptr->next;
@@ -225,8 +213,8 @@ globle void *FindHashedPatternNode(
    unsigned long hashValue;
    struct patternNodeHashEntry *hptr;
 
-   hashValue = GetAtomicHashValue(keyType,keyValue,1) + HashExternalAddress(parent,0); /* TBD mult * 30 */
-   hashValue = (hashValue % PatternData(theEnv)->PatternHashTableSize);
+   hashValue = PatternNodeHashValue(parent,keyType,keyValue);
+   hashValue = LinearHashIndex(&PatternData(theEnv)->PatternHashTableInfo,hashValue);
 
    for (hptr = PatternData(theEnv)->PatternHashTable[hashValue];
         hptr != NULL;
@@ -240,6 +228,77 @@ globle void *FindHashedPatternNode(
 
    return(NULL);
   }
+
+/*****************************************************************/
+/* SharePatternHashTable: Uses the pattern node hash table of an */
+/*   environment whose pattern networks are shared, instead of   */
+/*   the (empty) table of the environment.                       */
+/*****************************************************************/
+globle void SharePatternHashTable(
+  void *theEnv,
+  void *sharedEnv)
+  {
+   if (PatternData(theEnv)->PatternHashTableShared) return;
+
+   ReturnLinearHashTable(theEnv,&PatternData(theEnv)->PatternHashTableInfo,
+                         (void **) PatternData(theEnv)->PatternHashTable);
+
+   PatternData(theEnv)->PatternHashTable = PatternData(sharedEnv)->PatternHashTable;
+   PatternData(theEnv)->PatternHashTableInfo = PatternData(sharedEnv)->PatternHashTableInfo;
+   PatternData(theEnv)->PatternHashTableShared = TRUE;
+  }
+
+/**************************************************************/
+/* PatternNodeHashValue: Returns the hash value of the key of */
+/*   a pattern node entry in the pattern node hash table.     */
+/**************************************************************/
+static unsigned long PatternNodeHashValue(
+  void *parent,
+  unsigned short keyType,
+  void *keyValue)
+  {
+   return(MixHashValue(GetAtomicHashValue(keyType,keyValue,1) + HashExternalAddress(parent,0)));
+  }
+
+/***************************************************************/
+/* GrowPatternHashTable: Splits the next bucket of the pattern */
+/*   node hash table, moving the entries whose hash value now  */
+/*   maps to the new bucket.                                   */
+/***************************************************************/
+static void GrowPatternHashTable(
+  void *theEnv)
+  {
+   unsigned long splitBucket, newBucket;
+   struct patternNodeHashEntry *hptr, *nextPtr, *prev, **theTable;
+   struct linearHashInfo *theInfo;
+
+   theInfo = &PatternData(theEnv)->PatternHashTableInfo;
+   theTable = (struct patternNodeHashEntry **)
+      ExpandLinearHashTable(theEnv,theInfo,(void **) PatternData(theEnv)->PatternHashTable,&splitBucket);
+   PatternData(theEnv)->PatternHashTable = theTable;
+
+   for (hptr = theTable[splitBucket], prev = NULL;
+        hptr != NULL;
+        hptr = nextPtr)
+     {
+      nextPtr = hptr->next;
+
+      newBucket = LinearHashIndex(theInfo,PatternNodeHashValue(hptr->parent,(unsigned short) hptr->type,hptr->value));
+      if (newBucket == splitBucket)
+        {
+         prev = hptr;
+         continue;
+        }
+
+      if (prev == NULL)
+        { theTable[splitBucket] = nextPtr; }
+      else
+        { prev->next = nextPtr; }
+
+      hptr->next = theTable[newBucket];
+      theTable[newBucket] = hptr;
+     }
+  }
   
 /******************************************************************/
 /* AddReservedPatternSymbol: Adds a symbol to the list of symbols */
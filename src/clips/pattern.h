@@ -52,6 +52,7 @@ struct patternEntityRecord
    void (*matchFunction)(void *,void *);
    intBool (*synchronized)(void *,void *);
    intBool (*isDeleted)(void *,void *);
+   intBool (*isStatic)(void *,void *);
   };
 
 typedef struct patternEntityRecord PTRN_ENTITY_RECORD;
@@ -109,6 +110,7 @@ struct patternParser
    void (*replaceGetPNValueFunction)(void *,struct expr *,struct lhsParseNode *);
    struct expr *(*genGetPNValueFunction)(void *,struct lhsParseNode *);
    struct expr *(*genComparePNValuesFunction)(void *,struct lhsParseNode *,struct lhsParseNode *);
+   struct expr *(*genPNComparisonFunction)(void *,struct expr *);
    void (*returnUserDataFunction)(void *,void *);
    void *(*copyUserDataFunction)(void *,void *);
    void (*markIRPatternFunction)(void *,struct patternNodeHeader *,int);
@@ -141,7 +143,8 @@ struct patternData
    int GlobalAutoFocus;
    struct expr *SalienceExpression;
    struct patternNodeHashEntry **PatternHashTable;
-   unsigned long PatternHashTableSize;
+   struct linearHashInfo PatternHashTableInfo;
+   intBool PatternHashTableShared;
   };
 
 #define PatternData(theEnv) ((struct patternData *) GetEnvironmentData(theEnv,PATTERN_DATA))
@@ -175,6 +178,7 @@ struct patternData
    LOCALE void                           AddHashedPatternNode(void *,void *,void *,unsigned short,void *);
    LOCALE intBool                        RemoveHashedPatternNode(void *,void *,void *,unsigned short,void *);
    LOCALE void                          *FindHashedPatternNode(void *,void *,unsigned short,void *);
+   LOCALE void                           SharePatternHashTable(void *,void *);
 
 #endif /* _H_pattern */
 
@@ -0,0 +1,729 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.30  08/16/14            */
+   /*                                                     */
+   /*                 RANGE INDEX MODULE                  */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Keeps the partial matches of joins testing a     */
+/*   numeric inequality between their left and right sides   */
+/*   ordered by the value compared, so that a partial match  */
+/*   entering the join is only compared to the partial       */
+/*   matches on the other side which can satisfy the test.   */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#define _RANGEIDX_SOURCE_
+
+#include <math.h>
+#include <stdio.h>
+#define _STDIO_INCLUDED_
+#include <stdlib.h>
+#include <string.h>
+
+#include "setup.h"
+
+#if DEFRULE_CONSTRUCT
+
+#include "constant.h"
+#include "engine.h"
+#include "envrnmnt.h"
+#include "evaluatn.h"
+#include "extnfunc.h"
+#include "memalloc.h"
+#include "reteutil.h"
+#include "ruledef.h"
+#include "symbol.h"
+
+#if DEFTEMPLATE_CONSTRUCT
+#include "factgen.h"
+#endif
+
+#include "rangeidx.h"
+
+/***************************************/
+/* LOCAL INTERNAL FUNCTION DEFINITIONS */
+/***************************************/
+
+   static intBool                     RangeAccessorSide(struct expr *,int *);
+   static intBool                     RangeKey(void *,struct joinNode *,struct partialMatch *,int,double *);
+   static struct rangeIndex          *CreateRangeIndex(void *,struct joinNode *);
+   static void                        AddRangeEntry(void *,struct joinNode *,struct rangeIndex *,
+                                                    struct rangeIndexTree *,struct partialMatch *,
+                                                    int,long long);
+   static intBool                     RangeEntryBefore(struct rangeIndexEntry *,struct rangeIndexEntry *);
+   static void                        InsertTreapEntry(struct rangeIndexEntry **,struct rangeIndexEntry *);
+   static struct rangeIndexEntry    **FindTreapEntry(struct rangeIndexEntry **,double,struct partialMatch *);
+   static void                        DeleteTreapEntry(struct rangeIndexEntry **);
+   static void                        CollectRange(void *,struct rangeIndexEntry *,double,double,struct rangeProbe *);
+   static void                        AddProbeEntry(void *,struct rangeProbe *,struct rangeIndexEntry *);
+   static int                         CompareRangeSequences(const void *,const void *);
+   static void                        ReturnTreap(void *,struct rangeIndexEntry *);
+   static intBool                     AlphaMemoryReaches(struct partialMatch *,unsigned long);
+
+/******************************************************************/
+/* SetJoinRangeTest: Determines whether the partial matches of a  */
+/*   join can be indexed by range. The join must be a positive    */
+/*   join of a fact pattern without hashed memories, and its test */
+/*   (or the first test of a conjunction) must compare a value    */
+/*   from the left with a value from the right using <, <=, > or  */
+/*   >=. The comparison has to come first so that skipping the    */
+/*   partial matches failing it skips no other evaluation.        */
+/******************************************************************/
+globle void SetJoinRangeTest(
+  void *theEnv,
+  struct joinNode *join)
+  {
+   struct expr *theTest, *firstArg, *secondArg;
+   const char *functionName;
+   int firstSide, secondSide;
+   intBool lessThan;
+
+   join->leftRange = NULL;
+   join->rightRange = NULL;
+   join->rangeLeftBelow = FALSE;
+
+   if (join->firstJoin || join->joinFromTheRight ||
+       join->patternIsNegated || join->patternIsExists ||
+       (join->leftHash != NULL) || (join->rightHash != NULL) ||
+       (join->rightSideEntryStructure == NULL) ||
+       (join->networkTest == NULL))
+     { return; }
+
+   if (((struct patternNodeHeader *) join->rightSideEntryStructure)->rightHash != NULL)
+     { return; }
+
+   /*=============================================*/
+   /* Find the comparison at the head of the test. */
+   /*=============================================*/
+
+   theTest = join->networkTest;
+   if ((theTest->type == FCALL) && (theTest->value == ExpressionData(theEnv)->PTR_AND))
+     { theTest = theTest->argList; }
+
+   if ((theTest == NULL) || (theTest->type != FCALL))
+     { return; }
+
+   functionName = ValueToString(ExpressionFunctionCallName(theTest));
+   if ((strcmp(functionName,"<") == 0) || (strcmp(functionName,"<=") == 0))
+     { lessThan = TRUE; }
+   else if ((strcmp(functionName,">") == 0) || (strcmp(functionName,">=") == 0))
+     { lessThan = FALSE; }
+   else
+     { return; }
+
+   firstArg = theTest->argList;
+   if (firstArg == NULL) return;
+   secondArg = firstArg->nextArg;
+   if ((secondArg == NULL) || (secondArg->nextArg != NULL)) return;
+
+   if ((! RangeAccessorSide(firstArg,&firstSide)) ||
+       (! RangeAccessorSide(secondArg,&secondSide)) ||
+       (firstSide == secondSide))
+     { return; }
+
+   /*================================================*/
+   /* The bounds used for the index are inclusive so */
+   /* the same entries are found for a strict test.  */
+   /*================================================*/
+
+   if (firstSide == LHS)
+     {
+      join->leftRange = firstArg;
+      join->rightRange = secondArg;
+      join->rangeLeftBelow = lessThan;
+     }
+   else
+     {
+      join->leftRange = secondArg;
+      join->rightRange = firstArg;
+      join->rangeLeftBelow = ! lessThan;
+     }
+  }
+
+/*****************************************************************/
+/* RangeAccessorSide: Determines whether an argument of a range  */
+/*   test retrieves a fact slot value from one side of the join. */
+/*   Instances are excluded since their slot values can change   */
+/*   while their partial matches remain in the memories.         */
+/*****************************************************************/
+static intBool RangeAccessorSide(
+  struct expr *theArgument,
+  int *theSide)
+  {
+#if DEFTEMPLATE_CONSTRUCT
+   struct factGetVarJN1Call *hack1;
+   struct factGetVarJN2Call *hack2;
+   struct factGetVarJN3Call *hack3;
+   unsigned int lhs, rhs;
+   unsigned short whichPattern;
+
+   switch (theArgument->type)
+     {
+      case FACT_JN_VAR1:
+        hack1 = (struct factGetVarJN1Call *) ValueToBitMap(theArgument->value);
+        if (hack1->factAddress) return(FALSE);
+        lhs = hack1->lhs;
+        rhs = hack1->rhs;
+        whichPattern = hack1->whichPattern;
+        break;
+
+      case FACT_JN_VAR2:
+        hack2 = (struct factGetVarJN2Call *) ValueToBitMap(theArgument->value);
+        lhs = hack2->lhs;
+        rhs = hack2->rhs;
+        whichPattern = hack2->whichPattern;
+        break;
+
+      case FACT_JN_VAR3:
+        hack3 = (struct factGetVarJN3Call *) ValueToBitMap(theArgument->value);
+        lhs = hack3->lhs;
+        rhs = hack3->rhs;
+        whichPattern = hack3->whichPattern;
+        break;
+
+      default:
+        return(FALSE);
+     }
+
+   if (lhs == rhs) return(FALSE);
+   if (rhs && (whichPattern != 0)) return(FALSE);
+
+   *theSide = lhs ? LHS : RHS;
+   return(TRUE);
+#else
+#if MAC_XCD
+#pragma unused(theArgument,theSide)
+#endif
+   return(FALSE);
+#endif
+  }
+
+/***************************************************************/
+/* RangeKey: Retrieves the value compared by the range test of */
+/*   a join from a partial match on the specified side. Returns */
+/*   FALSE if the value isn't a number.                        */
+/***************************************************************/
+static intBool RangeKey(
+  void *theEnv,
+  struct joinNode *join,
+  struct partialMatch *theMatch,
+  int side,
+  double *theKey)
+  {
+   DATA_OBJECT theResult;
+   struct expr *theExpr, *oldArgument;
+   struct partialMatch *oldLHSBinds;
+   struct partialMatch *oldRHSBinds;
+   struct joinNode *oldJoin;
+
+   theExpr = (side == LHS) ? join->leftRange : join->rightRange;
+
+   oldLHSBinds = EngineData(theEnv)->GlobalLHSBinds;
+   oldRHSBinds = EngineData(theEnv)->GlobalRHSBinds;
+   oldJoin = EngineData(theEnv)->GlobalJoin;
+   oldArgument = EvaluationData(theEnv)->CurrentExpression;
+
+   EngineData(theEnv)->GlobalLHSBinds = (side == LHS) ? theMatch : NULL;
+   EngineData(theEnv)->GlobalRHSBinds = (side == LHS) ? NULL : theMatch;
+   EngineData(theEnv)->GlobalJoin = join;
+   EvaluationData(theEnv)->CurrentExpression = theExpr;
+
+   (*EvaluationData(theEnv)->PrimitivesArray[theExpr->type]->evaluateFunction)(theEnv,theExpr->value,&theResult);
+
+   EvaluationData(theEnv)->CurrentExpression = oldArgument;
+   EngineData(theEnv)->GlobalLHSBinds = oldLHSBinds;
+   EngineData(theEnv)->GlobalRHSBinds = oldRHSBinds;
+   EngineData(theEnv)->GlobalJoin = oldJoin;
+
+   if (theResult.type == INTEGER)
+     { *theKey = (double) ValueToLong(theResult.value); }
+   else if (theResult.type == FLOAT)
+     { *theKey = ValueToDouble(theResult.value); }
+   else
+     { return(FALSE); }
+
+   return(*theKey == *theKey);
+  }
+
+/****************************************************************/
+/* StartRangeProbe: Finds the partial matches on the other side */
+/*   of a join which can satisfy its range test with a partial  */
+/*   match entering from the specified side. The index is built */
+/*   the first time the memory searched is large enough. The    */
+/*   partial matches are listed in the order of the memory so   */
+/*   that they're compared in the same order as without the     */
+/*   index. Returns FALSE if the whole memory must be searched. */
+/****************************************************************/
+globle intBool StartRangeProbe(
+  void *theEnv,
+  struct joinNode *join,
+  struct partialMatch *theMatch,
+  int side,
+  struct rangeProbe *theProbe)
+  {
+   struct betaMemory *theMemory;
+   struct rangeIndexTree *theTree;
+   struct rangeIndexEntry *theEntry;
+   double theKey, low, high;
+   unsigned long i;
+
+   theMemory = JoinLeftMemory(theEnv,join);
+
+   if (theMemory->rangeIndex == NULL)
+     {
+      if (side == RHS)
+        {
+         if (theMemory->count < RANGE_INDEX_MINIMUM)
+           { return(FALSE); }
+        }
+      else if (! AlphaMemoryReaches(GetAlphaMemory(theEnv,(struct patternNodeHeader *) join->rightSideEntryStructure,0),
+                                    RANGE_INDEX_MINIMUM))
+        { return(FALSE); }
+
+      theMemory->rangeIndex = CreateRangeIndex(theEnv,join);
+     }
+
+   if (! RangeKey(theEnv,join,theMatch,side,&theKey))
+     { return(FALSE); }
+
+   if (side == RHS)
+     {
+      theTree = &theMemory->rangeIndex->left;
+      if (join->rangeLeftBelow)
+        { low = -HUGE_VAL; high = theKey; }
+      else
+        { low = theKey; high = HUGE_VAL; }
+     }
+   else
+     {
+      theTree = &theMemory->rangeIndex->right;
+      if (join->rangeLeftBelow)
+        { low = theKey; high = HUGE_VAL; }
+      else
+        { low = -HUGE_VAL; high = theKey; }
+     }
+
+   theProbe->entries = theProbe->buffer;
+   theProbe->size = RANGE_PROBE_BUFFER_SIZE;
+   theProbe->position = 0;
+
+   CollectRange(theEnv,theTree->root,low,high,theProbe);
+   for (theEntry = theTree->unkeyed; theEntry != NULL; theEntry = theEntry->right)
+     { AddProbeEntry(theEnv,theProbe,theEntry); }
+
+   if (theProbe->position > 1)
+     { qsort(theProbe->entries,theProbe->position,sizeof(void *),CompareRangeSequences); }
+
+   for (i = 0; i < theProbe->position; i++)
+     { theProbe->entries[i] = ((struct rangeIndexEntry *) theProbe->entries[i])->theMatch; }
+
+   theProbe->entries[theProbe->position] = NULL;
+   theProbe->position = 0;
+
+   return(TRUE);
+  }
+
+/***********************************************/
+/* EndRangeProbe: Releases the list of partial */
+/*   matches found by StartRangeProbe.         */
+/***********************************************/
+globle void EndRangeProbe(
+  void *theEnv,
+  struct rangeProbe *theProbe)
+  {
+   if ((theProbe->entries != NULL) && (theProbe->entries != theProbe->buffer))
+     { genfree(theEnv,theProbe->entries,sizeof(void *) * theProbe->size); }
+
+   theProbe->entries = NULL;
+  }
+
+/********************************************************/
+/* AddRangeIndexMatch: Adds a partial match stored in a */
+/*   memory of a join to the join's range index. Left   */
+/*   memories are added to at the front and alpha       */
+/*   memories at the end.                               */
+/********************************************************/
+globle void AddRangeIndexMatch(
+  void *theEnv,
+  struct joinNode *join,
+  struct partialMatch *theMatch,
+  int side)
+  {
+   struct rangeIndex *theIndex;
+
+   theIndex = JoinLeftMemory(theEnv,join)->rangeIndex;
+
+   if (side == LHS)
+     { AddRangeEntry(theEnv,join,theIndex,&theIndex->left,theMatch,LHS,--theIndex->left.lowSequence); }
+   else
+     { AddRangeEntry(theEnv,join,theIndex,&theIndex->right,theMatch,RHS,++theIndex->right.highSequence); }
+  }
+
+/*************************************************************/
+/* RemoveRangeIndexMatch: Removes a partial match leaving a  */
+/*   memory of a join from the join's range index. The value */
+/*   indexed is retrieved again since facts don't change.    */
+/*************************************************************/
+globle void RemoveRangeIndexMatch(
+  void *theEnv,
+  struct joinNode *join,
+  struct partialMatch *theMatch,
+  int side)
+  {
+   struct rangeIndex *theIndex;
+   struct rangeIndexTree *theTree;
+   struct rangeIndexEntry **theLink, *theEntry;
+   double theKey;
+
+   theIndex = JoinLeftMemory(theEnv,join)->rangeIndex;
+   theTree = (side == LHS) ? &theIndex->left : &theIndex->right;
+
+   if (RangeKey(theEnv,join,theMatch,side,&theKey))
+     {
+      theLink = FindTreapEntry(&theTree->root,theKey,theMatch);
+      if (theLink == NULL) return;
+      theEntry = *theLink;
+      DeleteTreapEntry(theLink);
+     }
+   else
+     {
+      for (theLink = &theTree->unkeyed;
+           (*theLink != NULL) && ((*theLink)->theMatch != theMatch);
+           theLink = &(*theLink)->right)
+        { /* Do Nothing */ }
+
+      if (*theLink == NULL) return;
+      theEntry = *theLink;
+      *theLink = theEntry->right;
+     }
+
+   rtn_struct(theEnv,rangeIndexEntry,theEntry);
+  }
+
+/*******************************************************/
+/* ReturnRangeIndex: Returns the range index of a join */
+/*   along with the left memory being emptied.         */
+/*******************************************************/
+globle void ReturnRangeIndex(
+  void *theEnv,
+  struct betaMemory *theMemory)
+  {
+   struct rangeIndex *theIndex;
+
+   theIndex = theMemory->rangeIndex;
+   if (theIndex == NULL) return;
+
+   ReturnTreap(theEnv,theIndex->left.root);
+   ReturnTreap(theEnv,theIndex->left.unkeyed);
+   ReturnTreap(theEnv,theIndex->right.root);
+   ReturnTreap(theEnv,theIndex->right.unkeyed);
+
+   rtn_struct(theEnv,rangeIndex,theIndex);
+   theMemory->rangeIndex = NULL;
+  }
+
+/***************************************************************/
+/* CreateRangeIndex: Indexes the left memory of a join and the */
+/*   alpha memory entering it from the right, numbering their  */
+/*   partial matches in the order of the memories.             */
+/***************************************************************/
+static struct rangeIndex *CreateRangeIndex(
+  void *theEnv,
+  struct joinNode *join)
+  {
+   struct rangeIndex *theIndex;
+   struct betaMemory *theMemory;
+   struct partialMatch *theMatch;
+   unsigned long i;
+
+   theIndex = get_struct(theEnv,rangeIndex);
+   theIndex->left.root = NULL;
+   theIndex->left.unkeyed = NULL;
+   theIndex->left.lowSequence = 0;
+   theIndex->left.highSequence = -1;
+   theIndex->right = theIndex->left;
+   theIndex->seed = 1;
+
+   theMemory = JoinLeftMemory(theEnv,join);
+   for (i = 0; i < theMemory->size; i++)
+     {
+      for (theMatch = theMemory->beta[i];
+           theMatch != NULL;
+           theMatch = theMatch->nextInMemory)
+        { AddRangeEntry(theEnv,join,theIndex,&theIndex->left,theMatch,LHS,++theIndex->left.highSequence); }
+     }
+
+   for (theMatch = GetAlphaMemory(theEnv,(struct patternNodeHeader *) join->rightSideEntryStructure,0);
+        theMatch != NULL;
+        theMatch = theMatch->nextInMemory)
+     { AddRangeEntry(theEnv,join,theIndex,&theIndex->right,theMatch,RHS,++theIndex->right.highSequence); }
+
+   return(theIndex);
+  }
+
+/*****************************************************************/
+/* AddRangeEntry: Adds a partial match to one side of an index. */
+/*****************************************************************/
+static void AddRangeEntry(
+  void *theEnv,
+  struct joinNode *join,
+  struct rangeIndex *theIndex,
+  struct rangeIndexTree *theTree,
+  struct partialMatch *theMatch,
+  int side,
+  long long sequence)
+  {
+   struct rangeIndexEntry *theEntry;
+
+   theEntry = get_struct(theEnv,rangeIndexEntry);
+   theEntry->theMatch = theMatch;
+   theEntry->sequence = sequence;
+   theEntry->left = NULL;
+   theEntry->right = NULL;
+
+   if (! RangeKey(theEnv,join,theMatch,side,&theEntry->key))
+     {
+      theEntry->key = 0.0;
+      theEntry->priority = 0;
+      theEntry->right = theTree->unkeyed;
+      theTree->unkeyed = theEntry;
+      return;
+     }
+
+   theIndex->seed = (theIndex->seed * 1103515245UL) + 12345UL;
+   theEntry->priority = theIndex->seed >> 16;
+
+   InsertTreapEntry(&theTree->root,theEntry);
+  }
+
+/**************************************************************/
+/* RangeEntryBefore: Orders the entries of a treap by key and */
+/*   then by partial match so each entry can be found again.  */
+/**************************************************************/
+static intBool RangeEntryBefore(
+  struct rangeIndexEntry *entry1,
+  struct rangeIndexEntry *entry2)
+  {
+   if (entry1->key < entry2->key) return(TRUE);
+   if (entry1->key > entry2->key) return(FALSE);
+   return(((size_t) entry1->theMatch) < ((size_t) entry2->theMatch));
+  }
+
+/***************************************************************/
+/* InsertTreapEntry: Inserts an entry below the entries with a */
+/*   higher priority, splitting the subtree it replaces.       */
+/***************************************************************/
+static void InsertTreapEntry(
+  struct rangeIndexEntry **theLink,
+  struct rangeIndexEntry *theEntry)
+  {
+   struct rangeIndexEntry *theNode, **leftLink, **rightLink;
+
+   while ((*theLink != NULL) && ((*theLink)->priority >= theEntry->priority))
+     {
+      if (RangeEntryBefore(theEntry,*theLink))
+        { theLink = &(*theLink)->left; }
+      else
+        { theLink = &(*theLink)->right; }
+     }
+
+   theNode = *theLink;
+   leftLink = &theEntry->left;
+   rightLink = &theEntry->right;
+
+   while (theNode != NULL)
+     {
+      if (RangeEntryBefore(theNode,theEntry))
+        {
+         *leftLink = theNode;
+         leftLink = &theNode->right;
+         theNode = theNode->right;
+        }
+      else
+        {
+         *rightLink = theNode;
+         rightLink = &theNode->left;
+         theNode = theNode->left;
+        }
+     }
+
+   *leftLink = NULL;
+   *rightLink = NULL;
+   *theLink = theEntry;
+  }
+
+/**************************************************/
+/* FindTreapEntry: Returns the link to the entry  */
+/*   of a partial match with the specified key.   */
+/**************************************************/
+static struct rangeIndexEntry **FindTreapEntry(
+  struct rangeIndexEntry **theLink,
+  double theKey,
+  struct partialMatch *theMatch)
+  {
+   struct rangeIndexEntry *theNode;
+
+   while ((theNode = *theLink) != NULL)
+     {
+      if (theNode->theMatch == theMatch)
+        { return(theLink); }
+
+      if ((theKey < theNode->key) ||
+          ((theKey == theNode->key) && (((size_t) theMatch) < ((size_t) theNode->theMatch))))
+        { theLink = &theNode->left; }
+      else
+        { theLink = &theNode->right; }
+     }
+
+   return(NULL);
+  }
+
+/******************************************************************/
+/* DeleteTreapEntry: Rotates an entry down until it has at most   */
+/*   one subtree, keeping the priorities ordered, then unlinks it. */
+/******************************************************************/
+static void DeleteTreapEntry(
+  struct rangeIndexEntry **theLink)
+  {
+   struct rangeIndexEntry *theEntry, *theChild;
+
+   theEntry = *theLink;
+
+   while ((theEntry->left != NULL) && (theEntry->right != NULL))
+     {
+      if (theEntry->left->priority > theEntry->right->priority)
+        {
+         theChild = theEntry->left;
+         theEntry->left = theChild->right;
+         theChild->right = theEntry;
+         *theLink = theChild;
+         theLink = &theChild->right;
+        }
+      else
+        {
+         theChild = theEntry->right;
+         theEntry->right = theChild->left;
+         theChild->left = theEntry;
+         *theLink = theChild;
+         theLink = &theChild->left;
+        }
+     }
+
+   *theLink = (theEntry->left != NULL) ? theEntry->left : theEntry->right;
+  }
+
+/*************************************************************/
+/* CollectRange: Adds the entries of a treap whose keys fall */
+/*   within the specified bounds to a probe.                 */
+/*************************************************************/
+static void CollectRange(
+  void *theEnv,
+  struct rangeIndexEntry *theNode,
+  double low,
+  double high,
+  struct rangeProbe *theProbe)
+  {
+   while (theNode != NULL)
+     {
+      if (theNode->key < low)
+        { theNode = theNode->right; }
+      else if (theNode->key > high)
+        { theNode = theNode->left; }
+      else
+        {
+         CollectRange(theEnv,theNode->left,low,high,theProbe);
+         AddProbeEntry(theEnv,theProbe,theNode);
+         theNode = theNode->right;
+        }
+     }
+  }
+
+/***************************************************************/
+/* AddProbeEntry: Adds an entry to the list of a probe, always */
+/*   leaving room for the entry terminating the list.          */
+/***************************************************************/
+static void AddProbeEntry(
+  void *theEnv,
+  struct rangeProbe *theProbe,
+  struct rangeIndexEntry *theEntry)
+  {
+   void **newEntries;
+
+   if ((theProbe->position + 1) >= theProbe->size)
+     {
+      newEntries = (void **) genalloc(theEnv,sizeof(void *) * theProbe->size * 2);
+      memcpy(newEntries,theProbe->entries,sizeof(void *) * theProbe->position);
+      if (theProbe->entries != theProbe->buffer)
+        { genfree(theEnv,theProbe->entries,sizeof(void *) * theProbe->size); }
+      theProbe->entries = newEntries;
+      theProbe->size *= 2;
+     }
+
+   theProbe->entries[theProbe->position++] = theEntry;
+  }
+
+/*****************************************************/
+/* CompareRangeSequences: Orders the entries found   */
+/*   by a probe as their partial matches are ordered */
+/*   in the memory.                                  */
+/*****************************************************/
+static int CompareRangeSequences(
+  const void *item1,
+  const void *item2)
+  {
+   long long sequence1, sequence2;
+
+   sequence1 = (*((struct rangeIndexEntry * const *) item1))->sequence;
+   sequence2 = (*((struct rangeIndexEntry * const *) item2))->sequence;
+
+   if (sequence1 < sequence2) return(-1);
+   if (sequence1 > sequence2) return(1);
+   return(0);
+  }
+
+/********************************************/
+/* ReturnTreap: Returns the entries of a    */
+/*   treap or of a list of unkeyed entries. */
+/********************************************/
+static void ReturnTreap(
+  void *theEnv,
+  struct rangeIndexEntry *theNode)
+  {
+   struct rangeIndexEntry *nextNode;
+
+   while (theNode != NULL)
+     {
+      ReturnTreap(theEnv,theNode->left);
+      nextNode = theNode->right;
+      rtn_struct(theEnv,rangeIndexEntry,theNode);
+      theNode = nextNode;
+     }
+  }
+
+/***************************************************/
+/* AlphaMemoryReaches: Determines whether a memory */
+/*   holds at least the specified number of        */
+/*   partial matches.                              */
+/***************************************************/
+static intBool AlphaMemoryReaches(
+  struct partialMatch *theMatch,
+  unsigned long theCount)
+  {
+   for (;
+        theMatch != NULL;
+        theMatch = theMatch->nextInMemory)
+     { if (--theCount == 0) return(TRUE); }
+
+   return(FALSE);
+  }
+
+#endif /* DEFRULE_CONSTRUCT */
@@ -0,0 +1,105 @@
+   /*******************************************************/
+   /*      "C" Language Integrated Production System      */
+   /*                                                     */
+   /*             CLIPS Version 6.30  08/16/14            */
+   /*                                                     */
+   /*              RANGE INDEX HEADER FILE                */
+   /*******************************************************/
+
+/*************************************************************/
+/* Purpose: Keeps the partial matches of joins testing a     */
+/*   numeric inequality between their left and right sides   */
+/*   ordered by the value compared, so that a partial match  */
+/*   entering the join is only compared to the partial       */
+/*   matches on the other side which can satisfy the test.   */
+/*                                                           */
+/* Principal Programmer(s):                                  */
+/*                                                           */
+/* Contributing Programmer(s):                               */
+/*                                                           */
+/* Revision History:                                         */
+/*                                                           */
+/*************************************************************/
+
+#ifndef _H_rangeidx
+#define _H_rangeidx
+
+#ifndef _H_match
+#include "match.h"
+#endif
+#ifndef _H_network
+#include "network.h"
+#endif
+
+#ifdef LOCALE
+#undef LOCALE
+#endif
+
+#ifdef _RANGEIDX_SOURCE_
+#define LOCALE
+#else
+#define LOCALE extern
+#endif
+
+/*==================================================*/
+/* A join's memories are indexed once the memory to */
+/* be searched holds this many partial matches.     */
+/*==================================================*/
+
+#define RANGE_INDEX_MINIMUM     16
+#define RANGE_PROBE_BUFFER_SIZE 32
+
+struct rangeIndexEntry
+  {
+   double key;
+   long long sequence;
+   unsigned long priority;
+   struct partialMatch *theMatch;
+   struct rangeIndexEntry *left;
+   struct rangeIndexEntry *right;
+  };
+
+/*===================================================*/
+/* The entries of a memory are ordered by key in a   */
+/* treap. Partial matches whose value isn't a number */
+/* are kept in the unkeyed list and always compared. */
+/* The sequence numbers give the order of the        */
+/* partial matches in the memory.                    */
+/*===================================================*/
+
+struct rangeIndexTree
+  {
+   struct rangeIndexEntry *root;
+   struct rangeIndexEntry *unkeyed;
+   long long lowSequence;
+   long long highSequence;
+  };
+
+struct rangeIndex
+  {
+   struct rangeIndexTree left;
+   struct rangeIndexTree right;
+   unsigned long seed;
+  };
+
+struct rangeProbe
+  {
+   void **entries;
+   unsigned long position;
+   unsigned long size;
+   void *buffer[RANGE_PROBE_BUFFER_SIZE];
+  };
+
+#define NextRangeMatch(theProbe,theMatch) \
+   (((theProbe).entries == NULL) ? (theMatch)->nextInMemory : \
+                                   (struct partialMatch *) (theProbe).entries[++(theProbe).position])
+
+   LOCALE void                           SetJoinRangeTest(void *,struct joinNode *);
+   LOCALE intBool                        StartRangeProbe(void *,struct joinNode *,struct partialMatch *,
+                                                         int,struct rangeProbe *);
+   LOCALE void                           EndRangeProbe(void *,struct rangeProbe *);
+   LOCALE void                           AddRangeIndexMatch(void *,struct joinNode *,struct partialMatch *,int);
+   LOCALE void                           RemoveRangeIndexMatch(void *,struct joinNode *,struct partialMatch *,int);
+   LOCALE void                           ReturnRangeIndex(void *,struct betaMemory *);
+
+#endif /* _H_rangeidx */
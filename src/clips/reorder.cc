@@ -1587,6 +1587,17 @@ static struct lhsParseNode *AssignPatternIndices(
    return(NULL);
   }
 
+/*************************************************************/
+/* RenumberPatterns: Assigns the pattern indices and join    */
+/*   depths of the CEs of a disjunct again after the pattern */
+/*   CEs have been moved within the disjunct.                */
+/*************************************************************/
+globle void RenumberPatterns(
+  struct lhsParseNode *theLHS)
+  {
+   AssignPatternIndices(theLHS,1,1,0);
+  }
+
 /***********************************************************/
 /* PropagateIndexSlotPatternValues: Assigns pattern, field */
 /*   and slot identifiers to a field in a pattern.         */
@@ -123,6 +123,7 @@ struct lhsParseNode
    LOCALE int                            IsExistsSubjoin(struct lhsParseNode *,int);
    LOCALE struct lhsParseNode           *CombineLHSParseNodes(void *,struct lhsParseNode *,struct lhsParseNode *);
    LOCALE void                           AssignPatternMarkedFlag(struct lhsParseNode *,short);
+   LOCALE void                           RenumberPatterns(struct lhsParseNode *);
 
 #endif /* _H_reorder */
 
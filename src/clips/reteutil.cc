@@ -53,6 +53,7 @@
 
 #if DEFRULE_CONSTRUCT
 
+#include "agenda.h"
 #include "drive.h"
 #include "engine.h"
 #include "envrnmnt.h"
@@ -61,6 +62,7 @@
 #include "memalloc.h"
 #include "moduldef.h"
 #include "pattern.h"
+#include "rangeidx.h"
 #include "retract.h"
 #include "router.h"
 #include "rulecom.h"
@@ -76,11 +78,17 @@
    static unsigned long               AlphaMemoryHashValue(struct patternNodeHeader *,unsigned long);
    static void                        UnlinkAlphaMemory(void *,struct patternNodeHeader *,struct alphaMemoryHash *);
    static void                        UnlinkAlphaMemoryBucketSiblings(void *,struct alphaMemoryHash *);
+   static void                        GrowAlphaMemoryTable(void *);
+   static void                        ResetAlphaMemoryTable(void *);
    static void                        InitializePMLinks(struct partialMatch *);
    static void                        UnlinkBetaPartialMatchfromAlphaAndBetaLineage(struct partialMatch *);
    static int                         CountPriorPatterns(struct joinNode *);
-   static void                        ResizeBetaMemory(void *,struct betaMemory *);
+   static void                        ResizeBetaMemory(void *,struct betaMemory *,unsigned long);
    static void                        ResetBetaMemory(void *,struct betaMemory *);
+   static void                        UnlinkPartialMatchFromParents(struct partialMatch *);
+   static void                        FlushRuleJoins(void *,struct joinNode *);
+   static void                        ClearBetaMemory(void *,struct betaMemory *);
+   static void                        ClearPrimeLinks(void *,struct partialMatch *);
 #if (CONSTRUCT_COMPILER || BLOAD_AND_BSAVE) && (! RUN_TIME)
    static void                        TagNetworkTraverseJoins(void *,long int *,long int *,struct joinNode *);
 #endif
@@ -198,12 +206,12 @@ globle void UpdateBetaPMLinks(
    
    if (side == LHS)
      { 
-      theMemory = join->leftMemory; 
+      theMemory = JoinLeftMemory(theEnv,join); 
       thePM->rhsMemory = FALSE;
      }
    else
      {
-      theMemory = join->rightMemory;
+      theMemory = JoinRightMemory(theEnv,join);
       thePM->rhsMemory = TRUE;
      }
    
@@ -236,13 +244,18 @@ globle void UpdateBetaPMLinks(
      }
      
    theMemory->count++;
-   if (side == LHS)
+   if (! CountJoinActivity(theEnv))
+    { /* Do Nothing */ }
+   else if (side == LHS)
     { join->memoryLeftAdds++; }
    else
     { join->memoryRightAdds++; }
    
    thePM->owner = join;
 
+   if ((side == LHS) && (theMemory->rangeIndex != NULL))
+     { AddRangeIndexMatch(theEnv,join,thePM,LHS); }
+
    /*======================================*/
    /* Update the alpha memory linked list. */
    /*======================================*/
@@ -272,9 +285,12 @@ globle void UpdateBetaPMLinks(
    if (! DefruleData(theEnv)->BetaMemoryResizingFlag)
      { return; }
 
+   if (theMemory->count > theMemory->peak)
+     { theMemory->peak = theMemory->count; }
+
    if ((theMemory->size > 1) &&
-       (theMemory->count > (theMemory->size * 11)))
-     { ResizeBetaMemory(theEnv,theMemory); }
+       (theMemory->count > (theMemory->size * BETA_HASH_LOAD)))
+     { ResizeBetaMemory(theEnv,theMemory,NextBetaHashSize(theMemory->size)); }
   }
 
 /**********************************************************/
@@ -336,9 +352,9 @@ globle void UnlinkBetaPMFromNodeAndLineage(
    struct betaMemory *theMemory;
 
    if (side == LHS)
-     { theMemory = join->leftMemory; }
+     { theMemory = JoinLeftMemory(theEnv,join); }
    else
-     { theMemory = join->rightMemory; }
+     { theMemory = JoinRightMemory(theEnv,join); }
    
    /*=============================================*/
    /* Update the nextInMemory/prevInMemory links. */
@@ -346,11 +362,16 @@ globle void UnlinkBetaPMFromNodeAndLineage(
    
    theMemory->count--;
 
-   if (side == LHS)
+   if (! CountJoinActivity(theEnv))
+    { /* Do Nothing */ }
+   else if (side == LHS)
     { join->memoryLeftDeletes++; }
    else
     { join->memoryRightDeletes++; }
 
+   if ((side == LHS) && (theMemory->rangeIndex != NULL))
+     { RemoveRangeIndexMatch(theEnv,join,thePM,LHS); }
+
    betaLocation = thePM->hashValue % theMemory->size;
    
    if ((side == RHS) &&
@@ -394,9 +415,9 @@ globle void UnlinkNonLeftLineage(
    struct partialMatch *tempPM;
 
    if (side == LHS)
-     { theMemory = join->leftMemory; }
+     { theMemory = JoinLeftMemory(theEnv,join); }
    else
-     { theMemory = join->rightMemory; }
+     { theMemory = JoinRightMemory(theEnv,join); }
    
    /*=============================================*/
    /* Update the nextInMemory/prevInMemory links. */
@@ -404,11 +425,16 @@ globle void UnlinkNonLeftLineage(
    
    theMemory->count--;
 
-   if (side == LHS)
+   if (! CountJoinActivity(theEnv))
+    { /* Do Nothing */ }
+   else if (side == LHS)
     { join->memoryLeftDeletes++; }
    else
     { join->memoryRightDeletes++; }
 
+   if ((side == LHS) && (theMemory->rangeIndex != NULL))
+     { RemoveRangeIndexMatch(theEnv,join,thePM,LHS); }
+
    betaLocation = thePM->hashValue % theMemory->size;
    
    if ((side == RHS) &&
@@ -484,43 +510,7 @@ static void UnlinkBetaPartialMatchfromAlphaAndBetaLineage(
   {
    struct partialMatch *tempPM;
    
-   /*=========================*/
-   /* Update the alpha lists. */
-   /*=========================*/
-
-   if (thePM->prevRightChild == NULL)
-     { 
-      if (thePM->rightParent != NULL)
-        { thePM->rightParent->children = thePM->nextRightChild; } 
-     }
-   else
-     { thePM->prevRightChild->nextRightChild = thePM->nextRightChild; }
-
-   if (thePM->nextRightChild != NULL)
-     { thePM->nextRightChild->prevRightChild = thePM->prevRightChild; }
-
-   thePM->rightParent = NULL;
-   thePM->nextRightChild = NULL;
-   thePM->prevRightChild = NULL;
-   
-   /*========================*/
-   /* Update the beta lists. */
-   /*========================*/
-
-   if (thePM->prevLeftChild == NULL)
-     { 
-      if (thePM->leftParent != NULL)
-        { thePM->leftParent->children = thePM->nextLeftChild; } 
-     }
-   else
-     { thePM->prevLeftChild->nextLeftChild = thePM->nextLeftChild; }
-
-   if (thePM->nextLeftChild != NULL)
-     { thePM->nextLeftChild->prevLeftChild = thePM->prevLeftChild; }
-
-   thePM->leftParent = NULL;
-   thePM->nextLeftChild = NULL;
-   thePM->prevLeftChild = NULL;
+   UnlinkPartialMatchFromParents(thePM);
 
    /*===========================*/
    /* Update the blocked lists. */
@@ -563,6 +553,53 @@ static void UnlinkBetaPartialMatchfromAlphaAndBetaLineage(
       thePM->children = NULL;
      }
   } 
+
+/*******************************************************/
+/* UnlinkPartialMatchFromParents: Removes a partial    */
+/*   match from the child lists of its alpha (or right */
+/*   memory) and beta parents.                         */
+/*******************************************************/
+static void UnlinkPartialMatchFromParents(
+  struct partialMatch *thePM)
+  {
+   /*=========================*/
+   /* Update the alpha lists. */
+   /*=========================*/
+
+   if (thePM->prevRightChild == NULL)
+     { 
+      if (thePM->rightParent != NULL)
+        { thePM->rightParent->children = thePM->nextRightChild; } 
+     }
+   else
+     { thePM->prevRightChild->nextRightChild = thePM->nextRightChild; }
+
+   if (thePM->nextRightChild != NULL)
+     { thePM->nextRightChild->prevRightChild = thePM->prevRightChild; }
+
+   thePM->rightParent = NULL;
+   thePM->nextRightChild = NULL;
+   thePM->prevRightChild = NULL;
+   
+   /*========================*/
+   /* Update the beta lists. */
+   /*========================*/
+
+   if (thePM->prevLeftChild == NULL)
+     { 
+      if (thePM->leftParent != NULL)
+        { thePM->leftParent->children = thePM->nextLeftChild; } 
+     }
+   else
+     { thePM->prevLeftChild->nextLeftChild = thePM->nextLeftChild; }
+
+   if (thePM->nextLeftChild != NULL)
+     { thePM->nextLeftChild->prevLeftChild = thePM->prevLeftChild; }
+
+   thePM->leftParent = NULL;
+   thePM->nextLeftChild = NULL;
+   thePM->prevLeftChild = NULL;
+  }
   
 /********************************************************/
 /* MergePartialMatches: Merges two partial matches. The */
@@ -657,6 +694,7 @@ globle struct partialMatch *CreateAlphaMatch(
    struct alphaMatch *afbtemp;
    unsigned long hashValue;
    struct alphaMemoryHash *theAlphaMemory;
+   struct joinNode *theJoin;
 
    /*==================================================*/
    /* Create the alpha match and intialize its values. */
@@ -694,6 +732,9 @@ globle struct partialMatch *CreateAlphaMatch(
 
    if (theAlphaMemory == NULL)
      {
+      if (DefruleData(theEnv)->AlphaMemoryTableInfo.count == 0)
+        { ResetAlphaMemoryTable(theEnv); }
+
       theAlphaMemory = get_struct(theEnv,alphaMemoryHash);
       theAlphaMemory->bucket = hashValue;
       theAlphaMemory->owner = theHeader;
@@ -701,14 +742,28 @@ globle struct partialMatch *CreateAlphaMatch(
       theAlphaMemory->endOfQueue = NULL;
       theAlphaMemory->nextHash = NULL;
 
+      hashValue = LinearHashIndex(&DefruleData(theEnv)->AlphaMemoryTableInfo,hashValue);
       theAlphaMemory->next = DefruleData(theEnv)->AlphaMemoryTable[hashValue];
       if (theAlphaMemory->next != NULL)
         { theAlphaMemory->next->prev = theAlphaMemory; }
 
       theAlphaMemory->prev = NULL; 
       DefruleData(theEnv)->AlphaMemoryTable[hashValue] = theAlphaMemory;
+
+      if (++DefruleData(theEnv)->AlphaMemoryTableInfo.count > DefruleData(theEnv)->AlphaMemoryPeak)
+        { DefruleData(theEnv)->AlphaMemoryPeak = DefruleData(theEnv)->AlphaMemoryTableInfo.count; }
+
+      if (DefruleData(theEnv)->AlphaMemoryTableInfo.count > DefruleData(theEnv)->AlphaMemoryTableInfo.size)
+        { GrowAlphaMemoryTable(theEnv); }
       
-      if (theHeader->firstHash == NULL)
+      /*==================================================*/
+      /* The pattern nodes of a shared binary image can't */
+      /* list the alpha memories of every environment.    */
+      /*==================================================*/
+
+      if (SharedRuleNetwork(theEnv))
+        { theAlphaMemory->prevHash = NULL; }
+      else if (theHeader->firstHash == NULL)
         {
          theHeader->firstHash = theAlphaMemory;
          theHeader->lastHash = theAlphaMemory;
@@ -739,6 +794,19 @@ globle struct partialMatch *CreateAlphaMatch(
       theAlphaMemory->endOfQueue = theMatch;
      }
 
+   /*==============================================*/
+   /* Add the alpha match to the range indices of  */
+   /* the joins which the pattern node enters.     */
+   /*==============================================*/
+
+   for (theJoin = theHeader->entryJoin;
+        theJoin != NULL;
+        theJoin = theJoin->rightMatchNode)
+     {
+      if ((theJoin->leftRange != NULL) && (JoinLeftMemory(theEnv,theJoin)->rangeIndex != NULL))
+        { AddRangeIndexMatch(theEnv,theJoin,theMatch,RHS); }
+     }
+
    /*===================================================*/
    /* Return a pointer to the newly create alpha match. */
    /*===================================================*/
@@ -875,13 +943,21 @@ globle void TraceErrorToRule(
   {
    int patternCount;
    
-   MarkRuleNetwork(theEnv,0);
+   /*=================================================*/
+   /* The joins of a frozen network are left unmarked */
+   /* (a rule sharing joins may then be listed more   */
+   /* than once).                                     */
+   /*=================================================*/
+
+   if (! ConstructData(theEnv)->ConstructsFrozen)
+     { MarkRuleNetwork(theEnv,0); }
 
    patternCount = CountPriorPatterns(joinPtr->lastLevel) + 1;
 
    TraceErrorToRuleDriver(theEnv,joinPtr,indentSpaces,patternCount,FALSE);
 
-   MarkRuleNetwork(theEnv,0);
+   if (! ConstructData(theEnv)->ConstructsFrozen)
+     { MarkRuleNetwork(theEnv,0); }
   }
 
 /**************************************************************/
@@ -908,7 +984,8 @@ static void TraceErrorToRuleDriver(
      { /* Do Nothing */ }
    else if (joinPtr->ruleToActivate != NULL)
      {
-      joinPtr->marked = 1;
+      if (! ConstructData(theEnv)->ConstructsFrozen)
+        { joinPtr->marked = 1; }
       name = EnvGetDefruleName(theEnv,joinPtr->ruleToActivate);
       EnvPrintRouter(theEnv,WERROR,indentSpaces);
 
@@ -920,7 +997,8 @@ static void TraceErrorToRuleDriver(
      }
    else
      {
-      joinPtr->marked = 1;
+      if (! ConstructData(theEnv)->ConstructsFrozen)
+        { joinPtr->marked = 1; }
         
       theLinks = joinPtr->nextLinks;
       while (theLinks != NULL)
@@ -1050,14 +1128,15 @@ globle struct partialMatch *GetAlphaMemory(
 /*   of matches from a beta memory.      */
 /*****************************************/ 
 globle struct partialMatch *GetLeftBetaMemory(
+  void *theEnv,
   struct joinNode *theJoin,
   unsigned long hashValue)
   {
    unsigned long betaLocation;
    
-   betaLocation = hashValue % theJoin->leftMemory->size;
+   betaLocation = hashValue % JoinLeftMemory(theEnv,theJoin)->size;
 
-   return theJoin->leftMemory->beta[betaLocation];
+   return JoinLeftMemory(theEnv,theJoin)->beta[betaLocation];
   }
 
 /******************************************/
@@ -1065,14 +1144,15 @@ globle struct partialMatch *GetLeftBetaMemory(
 /*   of matches from a beta memory.       */
 /******************************************/ 
 globle struct partialMatch *GetRightBetaMemory(
+  void *theEnv,
   struct joinNode *theJoin,
   unsigned long hashValue)
   {
    unsigned long betaLocation;
    
-   betaLocation = hashValue % theJoin->rightMemory->size;
+   betaLocation = hashValue % JoinRightMemory(theEnv,theJoin)->size;
 
-   return theJoin->rightMemory->beta[betaLocation];
+   return JoinRightMemory(theEnv,theJoin)->beta[betaLocation];
   }
     
 /***************************************/
@@ -1083,10 +1163,11 @@ globle void ReturnLeftMemory(
   void *theEnv,
   struct joinNode *theJoin)
   {
-   if (theJoin->leftMemory == NULL) return;
-   genfree(theEnv,theJoin->leftMemory->beta,sizeof(struct partialMatch *) * theJoin->leftMemory->size);
-   rtn_struct(theEnv,betaMemory,theJoin->leftMemory);
-   theJoin->leftMemory = NULL;
+   if (JoinLeftMemory(theEnv,theJoin) == NULL) return;
+   ReturnRangeIndex(theEnv,JoinLeftMemory(theEnv,theJoin));
+   genfree(theEnv,JoinLeftMemory(theEnv,theJoin)->beta,sizeof(struct partialMatch *) * JoinLeftMemory(theEnv,theJoin)->size);
+   rtn_struct(theEnv,betaMemory,JoinLeftMemory(theEnv,theJoin));
+   JoinLeftMemory(theEnv,theJoin) = NULL;
   }
 
 /***************************************/
@@ -1097,11 +1178,11 @@ globle void ReturnRightMemory(
   void *theEnv,
   struct joinNode *theJoin)
   {
-   if (theJoin->rightMemory == NULL) return;
-   genfree(theEnv,theJoin->rightMemory->beta,sizeof(struct partialMatch *) * theJoin->rightMemory->size);
-   genfree(theEnv,theJoin->rightMemory->last,sizeof(struct partialMatch *) * theJoin->rightMemory->size);
-   rtn_struct(theEnv,betaMemory,theJoin->rightMemory);
-   theJoin->rightMemory = NULL;
+   if (JoinRightMemory(theEnv,theJoin) == NULL) return;
+   genfree(theEnv,JoinRightMemory(theEnv,theJoin)->beta,sizeof(struct partialMatch *) * JoinRightMemory(theEnv,theJoin)->size);
+   genfree(theEnv,JoinRightMemory(theEnv,theJoin)->last,sizeof(struct partialMatch *) * JoinRightMemory(theEnv,theJoin)->size);
+   rtn_struct(theEnv,betaMemory,JoinRightMemory(theEnv,theJoin));
+   JoinRightMemory(theEnv,theJoin) = NULL;
   }
   
 /****************************************************************/
@@ -1121,17 +1202,17 @@ globle void DestroyBetaMemory(
        
    if (side == LHS)
      {
-      if (theJoin->leftMemory == NULL) return;
+      if (JoinLeftMemory(theEnv,theJoin) == NULL) return;
    
-      for (i = 0; i < theJoin->leftMemory->size; i++)
-        { DestroyAlphaBetaMemory(theEnv,theJoin->leftMemory->beta[i]); }
+      for (i = 0; i < JoinLeftMemory(theEnv,theJoin)->size; i++)
+        { DestroyAlphaBetaMemory(theEnv,JoinLeftMemory(theEnv,theJoin)->beta[i]); }
      }
    else
      {
-      if (theJoin->rightMemory == NULL) return;
+      if (JoinRightMemory(theEnv,theJoin) == NULL) return;
    
-      for (i = 0; i < theJoin->rightMemory->size; i++)
-        { DestroyAlphaBetaMemory(theEnv,theJoin->rightMemory->beta[i]); }
+      for (i = 0; i < JoinRightMemory(theEnv,theJoin)->size; i++)
+        { DestroyAlphaBetaMemory(theEnv,JoinRightMemory(theEnv,theJoin)->beta[i]); }
      }
   }
     
@@ -1151,20 +1232,158 @@ globle void FlushBetaMemory(
    
    if (side == LHS)
      {
-      if (theJoin->leftMemory == NULL) return;
+      if (JoinLeftMemory(theEnv,theJoin) == NULL) return;
 
-      for (i = 0; i < theJoin->leftMemory->size; i++)
-        { FlushAlphaBetaMemory(theEnv,theJoin->leftMemory->beta[i]); }
+      for (i = 0; i < JoinLeftMemory(theEnv,theJoin)->size; i++)
+        { FlushAlphaBetaMemory(theEnv,JoinLeftMemory(theEnv,theJoin)->beta[i]); }
      }
    else
      {
-      if (theJoin->rightMemory == NULL) return;
+      if (JoinRightMemory(theEnv,theJoin) == NULL) return;
 
-      for (i = 0; i < theJoin->rightMemory->size; i++)
-        { FlushAlphaBetaMemory(theEnv,theJoin->rightMemory->beta[i]); }
+      for (i = 0; i < JoinRightMemory(theEnv,theJoin)->size; i++)
+        { FlushAlphaBetaMemory(theEnv,JoinRightMemory(theEnv,theJoin)->beta[i]); }
      }
  }
   
+/*******************************************************************/
+/* FlushJoinNetwork: Empties the beta memories of the join network */
+/*   in bulk, for a reset about to retract every pattern entity.   */
+/*   The buckets of the memories are cleared and the partial       */
+/*   matches below the prime joins are returned (see               */
+/*   DiscardChildMatches). The partial matches below the alpha     */
+/*   memories are returned as the entities are retracted, with the */
+/*   JoinNetworkFlushed flag set (see NetworkRetract). Rules must  */
+/*   not be executing.                                             */
+/*******************************************************************/
+globle void FlushJoinNetwork(
+  void *theEnv)
+  {
+   struct defrule *rulePtr, *disjunctPtr;
+   struct defmodule *modulePtr;
+
+   SaveCurrentModule(theEnv);
+   for (modulePtr = (struct defmodule *) EnvGetNextDefmodule(theEnv,NULL);
+        modulePtr != NULL;
+        modulePtr = (struct defmodule *) EnvGetNextDefmodule(theEnv,modulePtr))
+     {
+      EnvSetCurrentModule(theEnv,(void *) modulePtr);
+
+      for (rulePtr = (struct defrule *) EnvGetNextDefrule(theEnv,NULL);
+           rulePtr != NULL;
+           rulePtr = (struct defrule *) EnvGetNextDefrule(theEnv,rulePtr))
+        {
+         for (disjunctPtr = rulePtr; disjunctPtr != NULL; disjunctPtr = disjunctPtr->disjunct)
+           { FlushRuleJoins(theEnv,disjunctPtr->lastJoin); }
+        }
+     }
+   RestoreCurrentModule(theEnv);
+  }
+
+/*******************************************************************/
+/* FlushRuleJoins: Flushes the joins of a rule. The memories of    */
+/*   joins shared with a rule already flushed are empty and        */
+/*   skipped. The left memory of a first join and the right memory */
+/*   of a join without a pattern only hold the partial match of a  */
+/*   prime join, which is kept.                                    */
+/*******************************************************************/
+static void FlushRuleJoins(
+  void *theEnv,
+  struct joinNode *joinPtr)
+  {
+   for (;
+        joinPtr != NULL;
+        joinPtr = joinPtr->lastLevel)
+     {
+      if (joinPtr->firstJoin)
+        {
+         if (JoinLeftMemory(theEnv,joinPtr) != NULL)
+           { ClearPrimeLinks(theEnv,JoinLeftMemory(theEnv,joinPtr)->beta[0]); }
+        }
+      else if ((JoinLeftMemory(theEnv,joinPtr)->count > 0) ||
+               (JoinLeftMemory(theEnv,joinPtr)->rangeIndex != NULL))
+        { ClearBetaMemory(theEnv,JoinLeftMemory(theEnv,joinPtr)); }
+
+      if (joinPtr->joinFromTheRight)
+        {
+         if (JoinRightMemory(theEnv,joinPtr)->count > 0)
+           { ClearBetaMemory(theEnv,JoinRightMemory(theEnv,joinPtr)); }
+         FlushRuleJoins(theEnv,(struct joinNode *) joinPtr->rightSideEntryStructure);
+        }
+      else if (joinPtr->rightSideEntryStructure == NULL)
+        { ClearPrimeLinks(theEnv,JoinRightMemory(theEnv,joinPtr)->beta[0]); }
+     }
+  }
+
+/****************************************************/
+/* ClearBetaMemory: Empties the buckets of a beta   */
+/*   memory, its partial matches are returned by    */
+/*   DiscardChildMatches. The range index of a left */
+/*   memory is rebuilt when it's next searched.     */
+/****************************************************/
+static void ClearBetaMemory(
+  void *theEnv,
+  struct betaMemory *theMemory)
+  {
+   ReturnRangeIndex(theEnv,theMemory);
+   memset(theMemory->beta,0,sizeof(struct partialMatch *) * theMemory->size);
+   if (theMemory->last != NULL)
+     { memset(theMemory->last,0,sizeof(struct partialMatch *) * theMemory->size); }
+   theMemory->count = 0;
+
+   if (DefruleData(theEnv)->BetaMemoryResizingFlag && (theMemory->size > 1))
+     { ResetBetaMemory(theEnv,theMemory); }
+  }
+
+/**********************************************************/
+/* ClearPrimeLinks: Returns the partial matches below the */
+/*   partial match of a prime join and drops its links to */
+/*   the partial matches blocking or blocked by it (they  */
+/*   are returned along with the other partial matches).  */
+/**********************************************************/
+static void ClearPrimeLinks(
+  void *theEnv,
+  struct partialMatch *thePM)
+  {
+   if (thePM == NULL) return;
+
+   DiscardChildMatches(theEnv,thePM);
+
+   thePM->blockList = NULL;
+   thePM->marker = NULL;
+   thePM->nextBlocked = NULL;
+   thePM->prevBlocked = NULL;
+  }
+
+/*******************************************************************/
+/* DiscardChildMatches: Returns the partial matches descending     */
+/*   from a partial match, along with their activations, once the  */
+/*   beta memories holding them have been cleared (see             */
+/*   FlushJoinNetwork). The lineage is followed depth first, in    */
+/*   the order the partial matches were created. Each partial      */
+/*   match is only unlinked from its parents so that the child     */
+/*   lists walked later never hold returned partial matches: the   */
+/*   links to the blockers and the memories are left as they are.  */
+/*******************************************************************/
+globle void DiscardChildMatches(
+  void *theEnv,
+  struct partialMatch *thePM)
+  {
+   struct partialMatch *theChild;
+
+   while ((theChild = thePM->children) != NULL)
+     {
+      DiscardChildMatches(theEnv,theChild);
+
+      if ((((struct joinNode *) theChild->owner)->ruleToActivate != NULL) ?
+          (theChild->marker != NULL) : FALSE)
+        { RemoveActivation(theEnv,(struct activation *) theChild->marker,TRUE,TRUE); }
+
+      UnlinkPartialMatchFromParents(theChild);
+      ReturnPartialMatch(theEnv,theChild);
+     }
+  }
+
 /*****************************************************************/
 /* BetaMemoryNotEmpty:  */
 /*****************************************************************/
@@ -1198,6 +1417,15 @@ globle void RemoveAlphaMemoryMatches(
   {
    struct alphaMemoryHash *theAlphaMemory = NULL;
    unsigned long hashValue;
+   struct joinNode *theJoin;
+
+   for (theJoin = theHeader->entryJoin;
+        theJoin != NULL;
+        theJoin = theJoin->rightMatchNode)
+     {
+      if ((theJoin->leftRange != NULL) && (JoinLeftMemory(theEnv,theJoin)->rangeIndex != NULL))
+        { RemoveRangeIndexMatch(theEnv,theJoin,theMatch,RHS); }
+     }
 
    if ((theMatch->prevInMemory == NULL) || (theMatch->nextInMemory == NULL))
      {
@@ -1276,6 +1504,78 @@ globle void FlushAlphaMemory(
    theHeader->lastHash = NULL;
   }
 
+/*****************************************************************/
+/* GetNextAlphaMemory: Returns the alpha memory of a pattern     */
+/*   node following the one specified, or its first alpha memory */
+/*   if NULL is specified. The pattern nodes of a shared binary  */
+/*   image don't list the alpha memories of the environments     */
+/*   using it, so they're looked for in the alpha memory table.  */
+/*****************************************************************/
+globle struct alphaMemoryHash *GetNextAlphaMemory(
+  void *theEnv,
+  struct patternNodeHeader *theHeader,
+  struct alphaMemoryHash *theAlphaMemory)
+  {
+   unsigned long i;
+
+   if (! SharedRuleNetwork(theEnv))
+     {
+      if (theAlphaMemory == NULL)
+        { return theHeader->firstHash; }
+      return theAlphaMemory->nextHash;
+     }
+
+   if (theAlphaMemory == NULL)
+     {
+      i = 0;
+      theAlphaMemory = DefruleData(theEnv)->AlphaMemoryTable[0];
+     }
+   else
+     {
+      i = LinearHashIndex(&DefruleData(theEnv)->AlphaMemoryTableInfo,theAlphaMemory->bucket);
+      theAlphaMemory = theAlphaMemory->next;
+     }
+
+   while (TRUE)
+     {
+      for (;
+           theAlphaMemory != NULL;
+           theAlphaMemory = theAlphaMemory->next)
+        { if (theAlphaMemory->owner == theHeader) return theAlphaMemory; }
+
+      if (++i >= DefruleData(theEnv)->AlphaMemoryTableInfo.size)
+        { return NULL; }
+      theAlphaMemory = DefruleData(theEnv)->AlphaMemoryTable[i];
+     }
+  }
+
+/*****************************************************************/
+/* DestroyAllAlphaMemories: Returns every alpha memory in the    */
+/*   alpha memory table along with its partial matches. Used by  */
+/*   environments sharing a binary image (see CreateAlphaMatch). */
+/*****************************************************************/
+globle void DestroyAllAlphaMemories(
+  void *theEnv)
+  {
+   struct alphaMemoryHash *theAlphaMemory, *tempMemory;
+   unsigned long i;
+
+   for (i = 0; i < DefruleData(theEnv)->AlphaMemoryTableInfo.size; i++)
+     {
+      theAlphaMemory = DefruleData(theEnv)->AlphaMemoryTable[i];
+      while (theAlphaMemory != NULL)
+        {
+         tempMemory = theAlphaMemory->next;
+         DestroyAlphaBetaMemory(theEnv,theAlphaMemory->alphaMemory); 
+         rtn_struct(theEnv,alphaMemoryHash,theAlphaMemory);
+         theAlphaMemory = tempMemory;
+        }
+      DefruleData(theEnv)->AlphaMemoryTable[i] = NULL;
+     }
+
+   DefruleData(theEnv)->AlphaMemoryTableInfo.count = 0;
+  }
+
 /*****************************************************************/
 /* FindAlphaMemory:  */
 /*****************************************************************/
@@ -1286,11 +1586,12 @@ static struct alphaMemoryHash *FindAlphaMemory(
   {
    struct alphaMemoryHash *theAlphaMemory;
       
-   theAlphaMemory = DefruleData(theEnv)->AlphaMemoryTable[hashValue];
+   theAlphaMemory = DefruleData(theEnv)->AlphaMemoryTable[LinearHashIndex(&DefruleData(theEnv)->AlphaMemoryTableInfo,hashValue)];
 
    if (theAlphaMemory != NULL)
      {
-      while ((theAlphaMemory != NULL) && (theAlphaMemory->owner != theHeader))
+      while ((theAlphaMemory != NULL) &&
+             ((theAlphaMemory->owner != theHeader) || (theAlphaMemory->bucket != hashValue)))
         { theAlphaMemory = theAlphaMemory->next; }
      }
      
@@ -1314,8 +1615,7 @@ static unsigned long AlphaMemoryHashValue(
    fis.uv = 0;
    fis.vv = theHeader;
    
-   hashValue = fis.uv + hashOffset;
-   hashValue = hashValue % ALPHA_MEMORY_HASH_SIZE;
+   hashValue = MixHashValue(fis.uv + hashOffset);
    
    return hashValue;
   }
@@ -1334,6 +1634,12 @@ static void UnlinkAlphaMemory(
     
    UnlinkAlphaMemoryBucketSiblings(theEnv,theAlphaMemory);
       
+   if (SharedRuleNetwork(theEnv))
+     {
+      rtn_struct(theEnv,alphaMemoryHash,theAlphaMemory);
+      return;
+     }
+
    /*================================*/
    /* Update firstHash and lastHash. */
    /*================================*/
@@ -1364,15 +1670,99 @@ static void UnlinkAlphaMemoryBucketSiblings(
   void *theEnv,
   struct alphaMemoryHash *theAlphaMemory)
   {
+   unsigned long theBucket;
+
    if (theAlphaMemory->prev == NULL)
-     { DefruleData(theEnv)->AlphaMemoryTable[theAlphaMemory->bucket] = theAlphaMemory->next; }
+     {
+      theBucket = LinearHashIndex(&DefruleData(theEnv)->AlphaMemoryTableInfo,theAlphaMemory->bucket);
+      DefruleData(theEnv)->AlphaMemoryTable[theBucket] = theAlphaMemory->next;
+     }
    else
      { theAlphaMemory->prev->next = theAlphaMemory->next; }
         
    if (theAlphaMemory->next != NULL)
      { theAlphaMemory->next->prev = theAlphaMemory->prev; }
+
+   DefruleData(theEnv)->AlphaMemoryTableInfo.count--;
   }   
 
+/*****************************************************************/
+/* GrowAlphaMemoryTable: Splits the next bucket of the alpha     */
+/*   memory table, moving the entries whose hash value now maps  */
+/*   to the new bucket.                                          */
+/*****************************************************************/
+static void GrowAlphaMemoryTable(
+  void *theEnv)
+  {
+   unsigned long splitBucket, newBucket;
+   struct alphaMemoryHash *theAlphaMemory, *nextMemory, **theTable;
+   struct linearHashInfo *theInfo;
+
+   theInfo = &DefruleData(theEnv)->AlphaMemoryTableInfo;
+   theTable = (struct alphaMemoryHash **)
+      ExpandLinearHashTable(theEnv,theInfo,(void **) DefruleData(theEnv)->AlphaMemoryTable,&splitBucket);
+   DefruleData(theEnv)->AlphaMemoryTable = theTable;
+
+   for (theAlphaMemory = theTable[splitBucket];
+        theAlphaMemory != NULL;
+        theAlphaMemory = nextMemory)
+     {
+      nextMemory = theAlphaMemory->next;
+
+      newBucket = LinearHashIndex(theInfo,theAlphaMemory->bucket);
+      if (newBucket == splitBucket)
+        { continue; }
+
+      /*=========================================*/
+      /* Unlink the memory from the split bucket */
+      /* and push it onto the new bucket.        */
+      /*=========================================*/
+
+      if (theAlphaMemory->prev == NULL)
+        { theTable[splitBucket] = nextMemory; }
+      else
+        { theAlphaMemory->prev->next = nextMemory; }
+
+      if (nextMemory != NULL)
+        { nextMemory->prev = theAlphaMemory->prev; }
+
+      theAlphaMemory->prev = NULL;
+      theAlphaMemory->next = theTable[newBucket];
+      if (theAlphaMemory->next != NULL)
+        { theAlphaMemory->next->prev = theAlphaMemory; }
+      theTable[newBucket] = theAlphaMemory;
+     }
+  }
+
+/*****************************************************************/
+/* ResetAlphaMemoryTable: Called when the first alpha memory is  */
+/*   added to an empty alpha memory table. If the table is more  */
+/*   than four times the size needed for the most alpha memories */
+/*   it held since it was last empty, it's replaced by a table   */
+/*   of that size. A table refilled to the same level after each */
+/*   reset keeps its size.                                       */
+/*****************************************************************/
+static void ResetAlphaMemoryTable(
+  void *theEnv)
+  {
+   unsigned long newSize;
+   struct linearHashInfo *theInfo;
+
+   theInfo = &DefruleData(theEnv)->AlphaMemoryTableInfo;
+
+   newSize = ALPHA_MEMORY_HASH_SIZE;
+   while (newSize < DefruleData(theEnv)->AlphaMemoryPeak)
+     { newSize <<= 1; }
+   DefruleData(theEnv)->AlphaMemoryPeak = 0;
+
+   if ((newSize << 2) > theInfo->size)
+     { return; }
+
+   ReturnLinearHashTable(theEnv,theInfo,(void **) DefruleData(theEnv)->AlphaMemoryTable);
+   DefruleData(theEnv)->AlphaMemoryTable = (ALPHA_MEMORY_HASH **)
+      CreateLinearHashTable(theEnv,theInfo,newSize);
+  }
+
 /********************************************/
 /* ComputeRightHashValue:       */
 /********************************************/ 
@@ -1413,11 +1803,11 @@ unsigned long ComputeRightHashValue(
             break;
              
           case INTEGER:
-            hashValue += (((INTEGER_HN *) theResult.value)->bucket * multiplier);
+            hashValue += (NumberHashValue(theResult.value) * multiplier);
             break;
              
           case FLOAT:
-            hashValue += (((FLOAT_HN *) theResult.value)->bucket * multiplier);
+            hashValue += (NumberHashValue(theResult.value) * multiplier);
             break;
             
           case FACT_ADDRESS:
@@ -1441,11 +1831,13 @@ unsigned long ComputeRightHashValue(
     }
 
 /***********************************************************/
-/* ResizeBetaMemory:                                */
+/* ResizeBetaMemory: Rehashes the partial matches of a     */
+/*   beta memory into the specified number of buckets.     */
 /***********************************************************/
-globle void ResizeBetaMemory(
+static void ResizeBetaMemory(
   void *theEnv,
-  struct betaMemory *theMemory)
+  struct betaMemory *theMemory,
+  unsigned long newSize)
   {
    struct partialMatch **oldArray, **lastAdd, *thePM, *nextPM;
    unsigned long i, oldSize, betaLocation;
@@ -1453,7 +1845,7 @@ globle void ResizeBetaMemory(
    oldSize = theMemory->size;
    oldArray = theMemory->beta;
    
-   theMemory->size = oldSize * 11;
+   theMemory->size = newSize;
    theMemory->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *) * theMemory->size);
      
    lastAdd = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *) * theMemory->size);
@@ -1494,24 +1886,32 @@ globle void ResizeBetaMemory(
    genfree(theEnv,oldArray,sizeof(struct partialMatch *) * oldSize);
   }
 
-/***********************************************************/
-/* ResetBetaMemory:                                */
-/***********************************************************/
+/***************************************************************/
+/* ResetBetaMemory: Called when a hashed beta memory empties.  */
+/*   Shrinks it to the size needed for the most partial        */
+/*   matches it held since it last emptied, if that is smaller */
+/*   than its current size, and starts a new peak count.       */
+/***************************************************************/
 static void ResetBetaMemory(
   void *theEnv,
   struct betaMemory *theMemory)
   {
    struct partialMatch **oldArray, **lastAdd;
-   unsigned long oldSize;
+   unsigned long oldSize, newSize;
+
+   newSize = INITIAL_BETA_HASH_SIZE;
+   while ((newSize * BETA_HASH_LOAD) < theMemory->peak)
+     { newSize = NextBetaHashSize(newSize); }
+   theMemory->peak = 0;
 
    if ((theMemory->size == 1) ||
-       (theMemory->size == INITIAL_BETA_HASH_SIZE))
+       (newSize >= theMemory->size))
      { return; }
 
    oldSize = theMemory->size;
    oldArray = theMemory->beta;
    
-   theMemory->size = INITIAL_BETA_HASH_SIZE;
+   theMemory->size = newSize;
    theMemory->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *) * theMemory->size);
    memset(theMemory->beta,0,sizeof(struct partialMatch *) * theMemory->size);
    genfree(theEnv,oldArray,sizeof(struct partialMatch *) * oldSize);
@@ -75,17 +75,21 @@
    LOCALE struct partialMatch           *MergePartialMatches(void *,struct partialMatch *,struct partialMatch *);
    LOCALE long int                       IncrementPseudoFactIndex(void);
    LOCALE struct partialMatch           *GetAlphaMemory(void *,struct patternNodeHeader *,unsigned long);
-   LOCALE struct partialMatch           *GetLeftBetaMemory(struct joinNode *,unsigned long);
-   LOCALE struct partialMatch           *GetRightBetaMemory(struct joinNode *,unsigned long);
+   LOCALE struct partialMatch           *GetLeftBetaMemory(void *,struct joinNode *,unsigned long);
+   LOCALE struct partialMatch           *GetRightBetaMemory(void *,struct joinNode *,unsigned long);
    LOCALE void                           ReturnLeftMemory(void *,struct joinNode *);
    LOCALE void                           ReturnRightMemory(void *,struct joinNode *);
    LOCALE void                           DestroyBetaMemory(void *,struct joinNode *,int);
    LOCALE void                           FlushBetaMemory(void *,struct joinNode *,int);
+   LOCALE void                           FlushJoinNetwork(void *);
+   LOCALE void                           DiscardChildMatches(void *,struct partialMatch *);
    LOCALE intBool                        BetaMemoryNotEmpty(struct joinNode *);
    LOCALE void                           RemoveAlphaMemoryMatches(void *,struct patternNodeHeader *,struct partialMatch *,
                                                                   struct alphaMatch *); 
    LOCALE void                           DestroyAlphaMemory(void *,struct patternNodeHeader *,int);
    LOCALE void                           FlushAlphaMemory(void *,struct patternNodeHeader *);
+   LOCALE struct alphaMemoryHash        *GetNextAlphaMemory(void *,struct patternNodeHeader *,struct alphaMemoryHash *);
+   LOCALE void                           DestroyAllAlphaMemories(void *);
    LOCALE void                           FlushAlphaBetaMemory(void *,struct partialMatch *);
    LOCALE void                           DestroyAlphaBetaMemory(void *,struct partialMatch *);
    LOCALE int                            GetPatternNumberFromJoin(struct joinNode *);
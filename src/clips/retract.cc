@@ -90,11 +90,25 @@ globle void NetworkRetract(
      {
       nextMatch = tempMatch->next;
 
-      if (tempMatch->theMatch->children != NULL)
-        { PosEntryRetractAlpha(theEnv,tempMatch->theMatch,NETWORK_RETRACT); }
+      /*====================================================*/
+      /* Once a reset has flushed the join network, the     */
+      /* partial matches below the alpha match are returned */
+      /* without propagating the retraction.                */
+      /*====================================================*/
 
-      if (tempMatch->theMatch->blockList != NULL)
-        { NegEntryRetractAlpha(theEnv,tempMatch->theMatch,NETWORK_RETRACT); }
+      if (EngineData(theEnv)->JoinNetworkFlushed)
+        {
+         DiscardChildMatches(theEnv,tempMatch->theMatch);
+         tempMatch->theMatch->blockList = NULL;
+        }
+      else
+        {
+         if (tempMatch->theMatch->children != NULL)
+           { PosEntryRetractAlpha(theEnv,tempMatch->theMatch,NETWORK_RETRACT); }
+
+         if (tempMatch->theMatch->blockList != NULL)
+           { NegEntryRetractAlpha(theEnv,tempMatch->theMatch,NETWORK_RETRACT); }
+        }
       
       /*===================================================*/
       /* Remove from the alpha memory of the pattern node. */
@@ -306,6 +320,9 @@ static intBool FindNextConflictingMatch(
    struct partialMatch *oldRHSBinds = NULL;
    struct joinNode *oldJoin = NULL;
 
+   if (CountJoinActivity(theEnv))
+     { theJoin->memoryProbes++; }
+
    /*====================================*/
    /* Check each of the possible partial */
    /* matches which could conflict.      */
@@ -333,7 +350,8 @@ static intBool FindNextConflictingMatch(
         possibleConflicts != NULL;
         possibleConflicts = possibleConflicts->nextInMemory)
      {
-      theJoin->memoryCompares++;
+      if (CountJoinActivity(theEnv))
+        { theJoin->memoryCompares++; }
       
       /*=====================================*/
       /* Initially indicate that the partial */
@@ -47,6 +47,7 @@
 #include "bload.h"
 #include "bsave.h"
 #include "envrnmnt.h"
+#include "exprcode.h"
 #include "reteutil.h"
 #include "agenda.h"
 #include "engine.h"
@@ -54,6 +55,7 @@
 #include "rulebsc.h"
 #include "pattern.h"
 #include "moduldef.h"
+#include "rangeidx.h"
 
 #include "rulebin.h"
 
@@ -82,6 +84,8 @@
    static void                    UpdateLink(void *,void *,long);
    static void                    ClearBload(void *);
    static void                    DeallocateDefruleBloadData(void *);
+   static void                    ReturnModuleAgendas(void *,struct defruleModule *,long);
+   static void                    ShareDefrules(void *,void *);
 
 /*****************************************************/
 /* DefruleBinarySetup: Installs the binary save/load */
@@ -103,6 +107,7 @@ globle void DefruleBinarySetup(
                              BloadStorage,BloadBinaryItem,
                              ClearBload);
 #endif
+   AddShareBloadFunction(theEnv,"defrule",ShareDefrules,0);
   }
 
 /*******************************************************/
@@ -115,9 +120,8 @@ static void DeallocateDefruleBloadData(
 #if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
    size_t space;
    long i;
-   struct defruleModule *theModuleItem;
+   struct joinNode *theJoin;
    struct activation *theActivation, *tmpActivation;
-   struct salienceGroup *theGroup, *tmpGroup;
 
    for (i = 0; i < DefruleBinaryData(theEnv)->NumberOfJoins; i++)
      { 
@@ -125,31 +129,49 @@ static void DeallocateDefruleBloadData(
       DestroyBetaMemory(theEnv,&DefruleBinaryData(theEnv)->JoinArray[i],RHS); 
       ReturnLeftMemory(theEnv,&DefruleBinaryData(theEnv)->JoinArray[i]);
       ReturnRightMemory(theEnv,&DefruleBinaryData(theEnv)->JoinArray[i]);
+      ReturnJoinExpressionCode(theEnv,&DefruleBinaryData(theEnv)->JoinArray[i]);
      }
 
-   for (i = 0; i < DefruleBinaryData(theEnv)->NumberOfDefruleModules; i++)
+   ReturnModuleAgendas(theEnv,DefruleBinaryData(theEnv)->ModuleArray,
+                       DefruleBinaryData(theEnv)->NumberOfDefruleModules);
+
+   /*=================================================*/
+   /* The memories and agendas of an environment      */
+   /* sharing a binary image are kept in its own      */
+   /* arrays, the join network belongs to the image.  */
+   /*=================================================*/
+
+   for (i = 0; i < DefruleData(theEnv)->NumberOfSharedJoins; i++)
      {
-      theModuleItem = &DefruleBinaryData(theEnv)->ModuleArray[i];
-      
-      theActivation = theModuleItem->agenda;
+      theJoin = &DefruleData(theEnv)->SharedJoinArray[i];
+      DestroyBetaMemory(theEnv,theJoin,LHS); 
+      DestroyBetaMemory(theEnv,theJoin,RHS); 
+      ReturnLeftMemory(theEnv,theJoin);
+      ReturnRightMemory(theEnv,theJoin);
+     }
+
+   ReturnModuleAgendas(theEnv,DefruleData(theEnv)->ModuleItemArray,
+                       DefruleData(theEnv)->NumberOfSharedModules);
+
+   if (SharedRuleNetwork(theEnv))
+     { DestroyAllAlphaMemories(theEnv); }
+
+   space = DefruleData(theEnv)->NumberOfSharedJoins * sizeof(struct joinMemories);
+   if (space != 0) genfree(theEnv,(void *) DefruleData(theEnv)->JoinMemoryArray,space);
+
+   space = DefruleData(theEnv)->NumberOfSharedModules * sizeof(struct defruleModule);
+   if (space != 0) genfree(theEnv,(void *) DefruleData(theEnv)->ModuleItemArray,space);
+
+   if (Bloaded(theEnv))
+     {
+      theActivation = AgendaData(theEnv)->ParkedActivations;
       while (theActivation != NULL)
         {
          tmpActivation = theActivation->next;
-         
          rtn_struct(theEnv,activation,theActivation);
-         
          theActivation = tmpActivation;
         }
-
-      theGroup = theModuleItem->groupings;
-      while (theGroup != NULL)
-        {
-         tmpGroup = theGroup->next;
-         
-         rtn_struct(theEnv,salienceGroup,theGroup);
-         
-         theGroup = tmpGroup;
-        }
+      AgendaData(theEnv)->ParkedActivations = NULL;
      }
      
    space = DefruleBinaryData(theEnv)->NumberOfDefruleModules * sizeof(struct defruleModule);
@@ -165,10 +187,99 @@ static void DeallocateDefruleBloadData(
    if (space != 0) genfree(theEnv,(void *) DefruleBinaryData(theEnv)->LinkArray,space);
    
    if (Bloaded(theEnv))
-     { rm3(theEnv,DefruleData(theEnv)->AlphaMemoryTable,sizeof(ALPHA_MEMORY_HASH *) * ALPHA_MEMORY_HASH_SIZE); }
+     {
+      ReturnLinearHashTable(theEnv,&DefruleData(theEnv)->AlphaMemoryTableInfo,
+                            (void **) DefruleData(theEnv)->AlphaMemoryTable);
+     }
 #endif
   }
 
+/**************************************************/
+/* ReturnModuleAgendas: Returns the activations   */
+/*   and salience groups of defrule module items. */
+/**************************************************/
+static void ReturnModuleAgendas(
+  void *theEnv,
+  struct defruleModule *theModuleArray,
+  long moduleCount)
+  {
+   long i;
+   struct defruleModule *theModuleItem;
+   struct activation *theActivation, *tmpActivation;
+   struct salienceGroup *theGroup, *tmpGroup;
+
+   for (i = 0; i < moduleCount; i++)
+     {
+      theModuleItem = &theModuleArray[i];
+      
+      theActivation = theModuleItem->agenda;
+      while (theActivation != NULL)
+        {
+         tmpActivation = theActivation->next;
+         
+         rtn_struct(theEnv,activation,theActivation);
+         
+         theActivation = tmpActivation;
+        }
+
+      theGroup = theModuleItem->groupings;
+      while (theGroup != NULL)
+        {
+         tmpGroup = theGroup->next;
+         
+         rtn_struct(theEnv,salienceGroup,theGroup);
+         
+         theGroup = tmpGroup;
+        }
+     }
+  }
+
+/*****************************************************/
+/* ShareDefrules: Uses the join network of a frozen  */
+/*   binary image. The environment gets its own beta */
+/*   memories for the joins and its own agendas for  */
+/*   the defrule modules.                            */
+/*****************************************************/
+static void ShareDefrules(
+  void *theEnv,
+  void *frozenEnv)
+  {
+   long i;
+
+   DefruleData(theEnv)->RightPrimeJoins = DefruleData(frozenEnv)->RightPrimeJoins;
+   DefruleData(theEnv)->LeftPrimeJoins = DefruleData(frozenEnv)->LeftPrimeJoins;
+   SharePatternHashTable(theEnv,frozenEnv);
+
+   DefruleData(theEnv)->SharedModuleArray = DefruleBinaryData(frozenEnv)->ModuleArray;
+   DefruleData(theEnv)->NumberOfSharedModules = DefruleBinaryData(frozenEnv)->NumberOfDefruleModules;
+   if (DefruleData(theEnv)->NumberOfSharedModules != 0)
+     {
+      DefruleData(theEnv)->ModuleItemArray = (struct defruleModule *)
+         genalloc(theEnv,sizeof(struct defruleModule) * DefruleData(theEnv)->NumberOfSharedModules);
+      for (i = 0; i < DefruleData(theEnv)->NumberOfSharedModules; i++)
+        {
+         DefruleData(theEnv)->ModuleItemArray[i] = DefruleData(theEnv)->SharedModuleArray[i];
+         DefruleData(theEnv)->ModuleItemArray[i].agenda = NULL;
+         DefruleData(theEnv)->ModuleItemArray[i].groupings = NULL;
+        }
+     }
+
+   DefruleData(theEnv)->SharedJoinArray = DefruleBinaryData(frozenEnv)->JoinArray;
+   DefruleData(theEnv)->NumberOfSharedJoins = DefruleBinaryData(frozenEnv)->NumberOfJoins;
+   if (DefruleData(theEnv)->NumberOfSharedJoins == 0) return;
+
+   DefruleData(theEnv)->JoinMemoryArray = (struct joinMemories *)
+      genalloc(theEnv,sizeof(struct joinMemories) * DefruleData(theEnv)->NumberOfSharedJoins);
+   for (i = 0; i < DefruleData(theEnv)->NumberOfSharedJoins; i++)
+     {
+      DefruleData(theEnv)->JoinMemoryArray[i].leftMemory = NULL;
+      DefruleData(theEnv)->JoinMemoryArray[i].rightMemory = NULL;
+     }
+
+   for (i = 0; i < DefruleData(theEnv)->NumberOfSharedJoins; i++)
+     { AddBetaMemoriesToJoin(theEnv,&DefruleData(theEnv)->SharedJoinArray[i]); }
+  }
+
 #if BLOAD_AND_BSAVE
 
 /*************************************************************/
@@ -335,7 +446,7 @@ static void BsaveStorage(
    size_t space;
    long int value;
 
-   space = sizeof(long) * 5;
+   space = sizeof(long) * 6;
    GenWrite(&space,sizeof(size_t),fp);
    GenWrite(&DefruleBinaryData(theEnv)->NumberOfDefruleModules,sizeof(long int),fp);
    GenWrite(&DefruleBinaryData(theEnv)->NumberOfDefrules,sizeof(long int),fp);
@@ -961,6 +1072,11 @@ static void UpdateJoin(
    DefruleBinaryData(theEnv)->JoinArray[obji].secondaryNetworkTest = HashedExpressionPointer(bj->secondaryNetworkTest);
    DefruleBinaryData(theEnv)->JoinArray[obji].leftHash = HashedExpressionPointer(bj->leftHash);
    DefruleBinaryData(theEnv)->JoinArray[obji].rightHash = HashedExpressionPointer(bj->rightHash);
+   DefruleBinaryData(theEnv)->JoinArray[obji].leftRange = NULL;
+   DefruleBinaryData(theEnv)->JoinArray[obji].rightRange = NULL;
+   DefruleBinaryData(theEnv)->JoinArray[obji].networkCode = NULL;
+   DefruleBinaryData(theEnv)->JoinArray[obji].secondaryNetworkCode = NULL;
+   DefruleBinaryData(theEnv)->JoinArray[obji].rangeLeftBelow = 0;
    DefruleBinaryData(theEnv)->JoinArray[obji].nextLinks = BloadJoinLinkPointer(bj->nextLinks);
    DefruleBinaryData(theEnv)->JoinArray[obji].lastLevel = BloadJoinPointer(bj->lastLevel);
 
@@ -974,6 +1090,13 @@ static void UpdateJoin(
    DefruleBinaryData(theEnv)->JoinArray[obji].initialize = 0;
    DefruleBinaryData(theEnv)->JoinArray[obji].marked = 0;
    DefruleBinaryData(theEnv)->JoinArray[obji].bsaveID = 0L;
+   DefruleBinaryData(theEnv)->JoinArray[obji].memoryLeftAdds = 0;
+   DefruleBinaryData(theEnv)->JoinArray[obji].memoryRightAdds = 0;
+   DefruleBinaryData(theEnv)->JoinArray[obji].memoryLeftDeletes = 0;
+   DefruleBinaryData(theEnv)->JoinArray[obji].memoryRightDeletes = 0;
+   DefruleBinaryData(theEnv)->JoinArray[obji].memoryCompares = 0;
+   DefruleBinaryData(theEnv)->JoinArray[obji].memoryProbes = 0;
+   DefruleBinaryData(theEnv)->JoinArray[obji].memoryRightActivations = 0;
    DefruleBinaryData(theEnv)->JoinArray[obji].leftMemory = NULL;
    DefruleBinaryData(theEnv)->JoinArray[obji].rightMemory = NULL;
 
@@ -1026,6 +1149,7 @@ globle void UpdatePatternNodeHeader(
    while (theJoin != NULL)
      {
       theJoin->rightSideEntryStructure = (void *) theHeader;
+      SetJoinRangeTest(theEnv,theJoin);
       theJoin = theJoin->rightMatchNode;
      }
   }
@@ -1083,6 +1207,7 @@ static void ClearBload(
       ReturnLeftMemory(theEnv,&DefruleBinaryData(theEnv)->JoinArray[i]);
       FlushBetaMemory(theEnv,&DefruleBinaryData(theEnv)->JoinArray[i],RHS); 
       ReturnRightMemory(theEnv,&DefruleBinaryData(theEnv)->JoinArray[i]);
+      ReturnJoinExpressionCode(theEnv,&DefruleBinaryData(theEnv)->JoinArray[i]);
      }
 
    /*================================================*/
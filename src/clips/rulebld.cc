@@ -49,6 +49,7 @@
 #include "incrrset.h"
 #include "memalloc.h"
 #include "pattern.h"
+#include "rangeidx.h"
 #include "reteutil.h"
 #include "router.h"
 #include "rulebld.h"
@@ -1101,6 +1102,8 @@ static struct joinNode *CreateNewJoin(
          newJoin->leftMemory->last = NULL;
          newJoin->leftMemory->size = 1;
          newJoin->leftMemory->count = 0;
+         newJoin->leftMemory->peak = 0;
+         newJoin->leftMemory->rangeIndex = NULL;
          }
       else
         {
@@ -1110,6 +1113,8 @@ static struct joinNode *CreateNewJoin(
          newJoin->leftMemory->last = NULL;
          newJoin->leftMemory->size = INITIAL_BETA_HASH_SIZE;
          newJoin->leftMemory->count = 0;
+         newJoin->leftMemory->peak = 0;
+         newJoin->leftMemory->rangeIndex = NULL;
         }
       
       /*===========================================================*/
@@ -1140,6 +1145,8 @@ static struct joinNode *CreateNewJoin(
          newJoin->rightMemory->last[0] = NULL;
          newJoin->rightMemory->size = 1;
          newJoin->rightMemory->count = 0;
+         newJoin->rightMemory->peak = 0;
+         newJoin->rightMemory->rangeIndex = NULL;
          }
       else
         {
@@ -1150,6 +1157,8 @@ static struct joinNode *CreateNewJoin(
          memset(newJoin->rightMemory->last,0,sizeof(struct partialMatch *) * INITIAL_BETA_HASH_SIZE);
          newJoin->rightMemory->size = INITIAL_BETA_HASH_SIZE;
          newJoin->rightMemory->count = 0;
+         newJoin->rightMemory->peak = 0;
+         newJoin->rightMemory->rangeIndex = NULL;
         }     
      }
    else if (rhsEntryStruct == NULL)
@@ -1163,6 +1172,8 @@ static struct joinNode *CreateNewJoin(
       newJoin->rightMemory->last[0] = newJoin->rightMemory->beta[0];
       newJoin->rightMemory->size = 1;
       newJoin->rightMemory->count = 1;    
+      newJoin->rightMemory->peak = 0;
+      newJoin->rightMemory->rangeIndex = NULL;
      }
    else
      { newJoin->rightMemory = NULL; }
@@ -1185,6 +1196,8 @@ static struct joinNode *CreateNewJoin(
    newJoin->memoryLeftDeletes = 0;
    newJoin->memoryRightDeletes = 0;
    newJoin->memoryCompares = 0;
+   newJoin->memoryProbes = 0;
+   newJoin->memoryRightActivations = 0;
 
    /*==============================================*/
    /* Install the expressions used to determine    */
@@ -1203,6 +1216,11 @@ static struct joinNode *CreateNewJoin(
    
    newJoin->leftHash = AddHashedExpression(theEnv,leftHash);
    newJoin->rightHash = AddHashedExpression(theEnv,rightHash);
+   newJoin->leftRange = NULL;
+   newJoin->rightRange = NULL;
+   newJoin->networkCode = NULL;
+   newJoin->secondaryNetworkCode = NULL;
+   newJoin->rangeLeftBelow = FALSE;
 
    /*============================================================*/
    /* Initialize the values associated with the LHS of the join. */
@@ -1304,6 +1322,7 @@ static struct joinNode *CreateNewJoin(
      {
       newJoin->rightMatchNode = ((struct patternNodeHeader *) rhsEntryStruct)->entryJoin;
       ((struct patternNodeHeader *) rhsEntryStruct)->entryJoin = newJoin;
+      SetJoinRangeTest(theEnv,newJoin);
      }
 
    /*================================*/
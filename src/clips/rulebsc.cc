@@ -140,15 +140,24 @@ static void ResetDefrules(
    struct joinLink *theLink;
    struct partialMatch *notParent;
   
-   DefruleData(theEnv)->CurrentEntityTimeTag = 1L;
    EnvClearFocusStack(theEnv);
    theModule = (struct defmodule *) EnvFindDefmodule(theEnv,"MAIN");
    EnvFocus(theEnv,(void *) theModule);
+
+   /*=====================================================*/
+   /* A reset keeping the static facts keeps the partial  */
+   /* matches of the prime joins too, the facts module    */
+   /* restores the time tag (see EnvSetStaticFacts).      */
+   /*=====================================================*/
+
+   if (EngineData(theEnv)->StaticResetInProgress) return;
+
+   DefruleData(theEnv)->CurrentEntityTimeTag = 1L;
    
    for (theLink = DefruleData(theEnv)->RightPrimeJoins;
         theLink != NULL;
         theLink = theLink->next)
-     { PosEntryRetractAlpha(theEnv,theLink->join->rightMemory->beta[0],NETWORK_ASSERT); }
+     { PosEntryRetractAlpha(theEnv,JoinRightMemory(theEnv,theLink->join)->beta[0],NETWORK_ASSERT); }
 
    for (theLink = DefruleData(theEnv)->LeftPrimeJoins;
         theLink != NULL;
@@ -157,7 +166,7 @@ static void ResetDefrules(
       if ((theLink->join->patternIsNegated || theLink->join->joinFromTheRight) && 
           (! theLink->join->patternIsExists))
         {
-         notParent = theLink->join->leftMemory->beta[0];
+         notParent = JoinLeftMemory(theEnv,theLink->join)->beta[0];
          
          if (notParent->marker)
            { RemoveBlockedLink(notParent); }
@@ -186,10 +195,12 @@ static void ResetDefrulesPrime(
    struct joinLink *theLink;
    struct partialMatch *notParent;
       
+   if (EngineData(theEnv)->StaticResetInProgress) return;
+
    for (theLink = DefruleData(theEnv)->RightPrimeJoins;
         theLink != NULL;
         theLink = theLink->next)
-     { NetworkAssert(theEnv,theLink->join->rightMemory->beta[0],theLink->join); }
+     { NetworkAssert(theEnv,JoinRightMemory(theEnv,theLink->join)->beta[0],theLink->join); }
 
    for (theLink = DefruleData(theEnv)->LeftPrimeJoins;
         theLink != NULL;
@@ -198,7 +209,7 @@ static void ResetDefrulesPrime(
       if ((theLink->join->patternIsNegated || theLink->join->joinFromTheRight) && 
           (! theLink->join->patternIsExists))
         {
-         notParent = theLink->join->leftMemory->beta[0];
+         notParent = JoinLeftMemory(theEnv,theLink->join)->beta[0];
 
          if (theLink->join->secondaryNetworkTest != NULL)
            {
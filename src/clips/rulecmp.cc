@@ -503,12 +503,13 @@ static void JoinToCode(
    /* Flags and Integer Values. */
    /*===========================*/
 
-   fprintf(joinFile,"{%d,%d,%d,%d,%d,0,0,%d,%d,0,0,0,0,0,0,",
+   fprintf(joinFile,"{%d,%d,%d,%d,%d,0,0,0,%d,%d,0,0,0,0,0,0,0,0,",
                    theJoin->firstJoin,theJoin->logicalJoin,
                    theJoin->joinFromTheRight,theJoin->patternIsNegated,
                    theJoin->patternIsExists,
                    // initialize,
                    // marked
+                   // rangeLeftBelow
                    theJoin->rhsType,theJoin->depth);
                    // bsaveID
                    // memoryLeftAdds
@@ -516,6 +517,8 @@ static void JoinToCode(
                    // memoryLeftDeletes
                    // memoryRightDeletes
                    // memoryCompares
+                   // memoryProbes
+                   // memoryRightActivations
 
    /*==========================*/
    /* Left and right Memories. */
@@ -538,6 +541,19 @@ static void JoinToCode(
 
    PrintHashedExpressionReference(theEnv,joinFile,theJoin->rightHash,imageID,maxIndices);
    fprintf(joinFile,",");
+
+   /*==================================================*/
+   /* Range tests, found again in the run-time module. */
+   /*==================================================*/
+
+   fprintf(joinFile,"NULL,NULL,");
+
+   /*=========================================*/
+   /* Compiled network tests, compiled again  */
+   /* by the run-time program if it wants to. */
+   /*=========================================*/
+
+   fprintf(joinFile,"NULL,NULL,");
    
    /*============================*/
    /* Right Side Entry Structure */
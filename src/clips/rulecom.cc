@@ -102,6 +102,7 @@
    static const char             *BetaHeaderString(void *,struct joinInformation *,long,long);
    static const char             *ActivityHeaderString(void *,struct joinInformation *,long,long);
    static void                    JoinActivityReset(void *,struct constructHeader *,void *);
+   static unsigned long           LongestMemoryChain(struct betaMemory *);
 #endif
 
 /****************************************************************/
@@ -153,6 +154,11 @@ globle void DefruleCommands(
    EnvDefineFunction2(theEnv,"set-beta-memory-resizing",'b',
                    SetBetaMemoryResizingCommand,"SetBetaMemoryResizingCommand","11");
 
+   EnvDefineFunction2(theEnv,"get-threshold-indexing",'b',
+                   GetThresholdIndexingCommand,"GetThresholdIndexingCommand","00");
+   EnvDefineFunction2(theEnv,"set-threshold-indexing",'b',
+                   SetThresholdIndexingCommand,"SetThresholdIndexingCommand","11");
+
    EnvDefineFunction2(theEnv,"get-strategy", 'w', PTIEF GetStrategyCommand,  "GetStrategyCommand", "00");
    EnvDefineFunction2(theEnv,"set-strategy", 'w', PTIEF SetStrategyCommand,  "SetStrategyCommand", "11w");
 
@@ -254,6 +260,81 @@ globle int GetBetaMemoryResizingCommand(
    return(oldValue);
   }
 
+/*********************************************/
+/* EnvGetThresholdIndexing: C access routine */
+/*   for the get-threshold-indexing command. */
+/*********************************************/
+globle intBool EnvGetThresholdIndexing(
+  void *theEnv)
+  {
+   return(DefruleData(theEnv)->ThresholdIndexingFlag);
+  }
+
+/*****************************************************************/
+/* EnvSetThresholdIndexing: C access routine for the             */
+/*   set-threshold-indexing command. When it's on, the rules     */
+/*   loaded afterwards have their comparisons of a fact field to */
+/*   a number with >, >=, < or <=, in a test CE or a predicate   */
+/*   constraint, indexed by the selector node testing the field. */
+/*   Activations of the same salience can then be ordered        */
+/*   differently than with the comparisons in the join network.  */
+/*   Returns the old value.                                      */
+/*****************************************************************/
+globle intBool EnvSetThresholdIndexing(
+  void *theEnv,
+  int value)
+  {
+   int ov;
+
+   ov = DefruleData(theEnv)->ThresholdIndexingFlag;
+
+   DefruleData(theEnv)->ThresholdIndexingFlag = value;
+
+   return(ov);
+  }
+
+/***************************************************/
+/* SetThresholdIndexingCommand: H/L access routine */
+/*   for the set-threshold-indexing command.       */
+/***************************************************/
+globle int SetThresholdIndexingCommand(
+  void *theEnv)
+  {
+   int oldValue;
+   DATA_OBJECT argPtr;
+
+   oldValue = EnvGetThresholdIndexing(theEnv);
+
+   if (EnvArgCountCheck(theEnv,"set-threshold-indexing",EXACTLY,1) == -1)
+     { return(oldValue); }
+
+   EnvRtnUnknown(theEnv,1,&argPtr);
+
+   if ((argPtr.value == EnvFalseSymbol(theEnv)) && (argPtr.type == SYMBOL))
+     { EnvSetThresholdIndexing(theEnv,FALSE); }
+   else
+     { EnvSetThresholdIndexing(theEnv,TRUE); }
+
+   return(oldValue);
+  }
+
+/***************************************************/
+/* GetThresholdIndexingCommand: H/L access routine */
+/*   for the get-threshold-indexing command.       */
+/***************************************************/
+globle int GetThresholdIndexingCommand(
+  void *theEnv)
+  {
+   int oldValue;
+
+   oldValue = EnvGetThresholdIndexing(theEnv);
+
+   if (EnvArgCountCheck(theEnv,"get-threshold-indexing",EXACTLY,0) == -1)
+     { return(oldValue); }
+
+   return(oldValue);
+  }
+
 #if DEBUGGING_FUNCTIONS
 
 /****************************************/
@@ -631,11 +712,11 @@ static void BetaJoinsDriver(
    
    if (theJoin->joinFromTheRight)
      {
-      BetaJoinsDriver(theEnv,(struct joinNode *) theJoin->rightSideEntryStructure,betaIndex-1,theJoinInfoArray,theJoin->rightMemory,theJoin);
+      BetaJoinsDriver(theEnv,(struct joinNode *) theJoin->rightSideEntryStructure,betaIndex-1,theJoinInfoArray,JoinRightMemory(theEnv,theJoin),theJoin);
      }
    else if (theJoin->lastLevel != NULL)
      {
-      BetaJoinsDriver(theEnv,theJoin->lastLevel,betaIndex-1,theJoinInfoArray,theJoin->leftMemory,theJoin);
+      BetaJoinsDriver(theEnv,theJoin->lastLevel,betaIndex-1,theJoinInfoArray,JoinLeftMemory(theEnv,theJoin),theJoin);
      }
      
    return;
@@ -653,7 +734,7 @@ globle void EnvBetaJoins(
   {
    struct defrule *theDefrule = (struct defrule *) vTheDefrule;
       
-   BetaJoinsDriver(theEnv,theDefrule->lastJoin->lastLevel,betaArraySize,theInfo,theDefrule->lastJoin->leftMemory,theDefrule->lastJoin);
+   BetaJoinsDriver(theEnv,theDefrule->lastJoin->lastLevel,betaArraySize,theInfo,JoinLeftMemory(theEnv,theDefrule->lastJoin),theDefrule->lastJoin);
   }
 
 /**************************************************/
@@ -692,6 +773,7 @@ static long long ListAlphaMatches(
   int output)
   {
    struct alphaMemoryHash *listOfHashNodes;
+   struct patternNodeHeader *theHeader;
    struct partialMatch *listOfMatches;
    long long count;
    struct joinNode *theJoin;
@@ -711,12 +793,12 @@ static long long ListAlphaMatches(
      
    if (theJoin->rightSideEntryStructure == NULL)
      {
-      if (theJoin->rightMemory->beta[0]->children != NULL)
+      if (JoinRightMemory(theEnv,theJoin)->beta[0]->children != NULL)
         { alphaCount += 1; }
         
       if (output == VERBOSE)
         {
-         if (theJoin->rightMemory->beta[0]->children != NULL)
+         if (JoinRightMemory(theEnv,theJoin)->beta[0]->children != NULL)
            { EnvPrintRouter(theEnv,WDISPLAY,"*\n"); }
          else
            { EnvPrintRouter(theEnv,WDISPLAY," None\n"); }
@@ -727,7 +809,7 @@ static long long ListAlphaMatches(
          PrintLongInteger(theEnv,WDISPLAY,theInfo->whichCE);
          EnvPrintRouter(theEnv,WDISPLAY,": ");
 
-         if (theJoin->rightMemory->beta[0]->children != NULL)
+         if (JoinRightMemory(theEnv,theJoin)->beta[0]->children != NULL)
            { EnvPrintRouter(theEnv,WDISPLAY,"1"); }
          else
            { EnvPrintRouter(theEnv,WDISPLAY,"0"); }
@@ -737,11 +819,11 @@ static long long ListAlphaMatches(
       return(alphaCount);
      }
 
-   listOfHashNodes =  ((struct patternNodeHeader *) theJoin->rightSideEntryStructure)->firstHash;
+   theHeader = (struct patternNodeHeader *) theJoin->rightSideEntryStructure;
 
-   for (count = 0;
+   for (count = 0, listOfHashNodes = GetNextAlphaMemory(theEnv,theHeader,NULL);
         listOfHashNodes != NULL;
-        listOfHashNodes = listOfHashNodes->nextHash)
+        listOfHashNodes = GetNextAlphaMemory(theEnv,theHeader,listOfHashNodes))
      {
       listOfMatches = listOfHashNodes->alphaMemory;
 
@@ -1244,6 +1326,12 @@ static void ListBetaJoinActivity(
       EnvPrintRouter(theEnv,WDISPLAY,buffer);
       sprintf(buffer,"   Deletes:  %10lld\n",deletes);
       EnvPrintRouter(theEnv,WDISPLAY,buffer);
+      sprintf(buffer,"   Probes:   %10lld\n",theJoin->memoryProbes);
+      EnvPrintRouter(theEnv,WDISPLAY,buffer);
+      sprintf(buffer,"   Chain:    %10lu %lu\n",
+              LongestMemoryChain(JoinLeftMemory(theEnv,theJoin)),
+              LongestMemoryChain(JoinRightMemory(theEnv,theJoin)));
+      EnvPrintRouter(theEnv,WDISPLAY,buffer);
      }
    else if (output == SUCCINCT)
      {
@@ -1267,6 +1355,32 @@ static void ListBetaJoinActivity(
    SetMFValue(result->value,3,EnvAddLong(theEnv,deletes));
   }
 
+/*****************************************************/
+/* LongestMemoryChain: Returns the number of partial */
+/*   matches in the fullest bucket of a beta memory. */
+/*****************************************************/
+static unsigned long LongestMemoryChain(
+  struct betaMemory *theMemory)
+  {
+   unsigned long i, length, longest = 0;
+   struct partialMatch *theMatch;
+
+   if (theMemory == NULL) return(0);
+
+   for (i = 0; i < theMemory->size; i++)
+     {
+      for (theMatch = theMemory->beta[i], length = 0;
+           theMatch != NULL;
+           theMatch = theMatch->nextInMemory)
+        { length++; }
+
+      if (length > longest)
+        { longest = length; }
+     }
+
+   return(longest);
+  }
+
 /*********************************************/
 /* JoinActivityReset: Sets the join activity */
 /*   counts for each rule back to 0.         */
@@ -1285,6 +1399,8 @@ static void JoinActivityReset(
    while (theJoin != NULL)
      {
       theJoin->memoryCompares = 0;
+      theJoin->memoryProbes = 0;
+      theJoin->memoryRightActivations = 0;
       theJoin->memoryLeftAdds = 0;
       theJoin->memoryRightAdds = 0;
       theJoin->memoryLeftDeletes = 0;
@@ -1304,6 +1420,8 @@ static void JoinActivityReset(
 globle void JoinActivityResetCommand(
   void *theEnv)
   { 
+   if (! CountJoinActivity(theEnv)) return;
+
    DoForAllConstructs(theEnv,JoinActivityReset,DefruleData(theEnv)->DefruleModuleIndex,TRUE,NULL);
   }
 
@@ -1476,14 +1594,14 @@ static void ShowJoins(
          if (! joinList[numberOfJoins]->firstJoin)
            {
             EnvPrintRouter(theEnv,WDISPLAY,"    LM : ");
-            if (PrintBetaMemory(theEnv,WDISPLAY,joinList[numberOfJoins]->leftMemory,FALSE,"         ",SUCCINCT) == 0)
+            if (PrintBetaMemory(theEnv,WDISPLAY,JoinLeftMemory(theEnv,joinList[numberOfJoins]),FALSE,"         ",SUCCINCT) == 0)
               { EnvPrintRouter(theEnv,WDISPLAY,"None\n"); }
            }
          
          if (joinList[numberOfJoins]->joinFromTheRight)
            {
             EnvPrintRouter(theEnv,WDISPLAY,"    RM : ");
-            if (PrintBetaMemory(theEnv,WDISPLAY,joinList[numberOfJoins]->rightMemory,FALSE,"         ",SUCCINCT) == 0)
+            if (PrintBetaMemory(theEnv,WDISPLAY,JoinRightMemory(theEnv,joinList[numberOfJoins]),FALSE,"         ",SUCCINCT) == 0)
               { EnvPrintRouter(theEnv,WDISPLAY,"None\n"); }
            }
          
@@ -1512,7 +1630,7 @@ globle void ShowAlphaHashTable(
     struct partialMatch *theMatch;
     char buffer[40];
 
-    for (i = 0; i < ALPHA_MEMORY_HASH_SIZE; i++)
+    for (i = 0; i < (int) DefruleData(theEnv)->AlphaMemoryTableInfo.size; i++)
       {
        for (theEntry =  DefruleData(theEnv)->AlphaMemoryTable[i], count = 0;
             theEntry != NULL;
@@ -85,6 +85,10 @@ struct joinInformation
    LOCALE intBool                        EnvSetBetaMemoryResizing(void *,intBool);
    LOCALE int                            GetBetaMemoryResizingCommand(void *);
    LOCALE int                            SetBetaMemoryResizingCommand(void *);
+   LOCALE intBool                        EnvGetThresholdIndexing(void *);
+   LOCALE intBool                        EnvSetThresholdIndexing(void *,intBool);
+   LOCALE int                            GetThresholdIndexingCommand(void *);
+   LOCALE int                            SetThresholdIndexingCommand(void *);
 
    LOCALE void                           EnvMatches(void *,void *,int,DATA_OBJECT *);
    LOCALE void                           EnvJoinActivity(void *,void *,int,DATA_OBJECT *);
@@ -70,8 +70,10 @@
 #include "drive.h"
 #include "engine.h"
 #include "envrnmnt.h"
+#include "joinprof.h"
 #include "memalloc.h"
 #include "pattern.h"
+#include "rangeidx.h"
 #include "retract.h"
 #include "reteutil.h"
 #include "rulebsc.h"
@@ -109,7 +111,6 @@
 globle void InitializeDefrules(
   void *theEnv)
   {   
-   unsigned long i;
    AllocateEnvironmentData(theEnv,DEFRULE_DATA,sizeof(struct defruleData),DeallocateDefruleData);
 
    InitializeEngine(theEnv);
@@ -129,6 +130,8 @@ globle void InitializeDefrules(
 
    DefruleCommands(theEnv);
 
+   InitializeJoinProfiles(theEnv);
+
    DefruleData(theEnv)->DefruleConstruct =
       AddConstruct(theEnv,"defrule","defrules",
                    ParseDefrule,EnvFindDefrule,
@@ -137,9 +140,7 @@ globle void InitializeDefrules(
                    EnvIsDefruleDeletable,EnvUndefrule,ReturnDefrule);
 
    DefruleData(theEnv)->AlphaMemoryTable = (ALPHA_MEMORY_HASH **)
-                  gm3(theEnv,sizeof (ALPHA_MEMORY_HASH *) * ALPHA_MEMORY_HASH_SIZE);
-
-   for (i = 0; i < ALPHA_MEMORY_HASH_SIZE; i++) DefruleData(theEnv)->AlphaMemoryTable[i] = NULL;
+      CreateLinearHashTable(theEnv,&DefruleData(theEnv)->AlphaMemoryTableInfo,ALPHA_MEMORY_HASH_SIZE);
 
    DefruleData(theEnv)->BetaMemoryResizingFlag = TRUE;
    
@@ -198,8 +199,18 @@ static void DeallocateDefruleData(
       rtn_struct(theEnv,defruleModule,theModuleItem);
 #endif
      }   
+
+   theActivation = AgendaData(theEnv)->ParkedActivations;
+   while (theActivation != NULL)
+     {
+      tmpActivation = theActivation->next;
+      rtn_struct(theEnv,activation,theActivation);
+      theActivation = tmpActivation;
+     }
+   AgendaData(theEnv)->ParkedActivations = NULL;
      
-   rm3(theEnv,DefruleData(theEnv)->AlphaMemoryTable,sizeof (ALPHA_MEMORY_HASH *) * ALPHA_MEMORY_HASH_SIZE);
+   ReturnLinearHashTable(theEnv,&DefruleData(theEnv)->AlphaMemoryTableInfo,
+                         (void **) DefruleData(theEnv)->AlphaMemoryTable);
   }
   
 /********************************************************/
@@ -275,7 +286,7 @@ globle struct defruleModule *GetDefruleModuleItem(
   void *theEnv,
   struct defmodule *theModule)
   {   
-   return((struct defruleModule *) GetConstructModuleItemByIndex(theEnv,theModule,DefruleData(theEnv)->DefruleModuleIndex)); 
+   return(RuleModuleItem(theEnv,GetConstructModuleItemByIndex(theEnv,theModule,DefruleData(theEnv)->DefruleModuleIndex))); 
   }
 
 /*******************************************************************/
@@ -427,6 +438,7 @@ static void AddBetaMemoriesToRule(
   struct joinNode *theNode)
   {
    AddBetaMemoriesToJoin(theEnv,theNode);
+   SetJoinRangeTest(theEnv,theNode);
    
    if (theNode->lastLevel != NULL)
      { AddBetaMemoriesToRule(theEnv,theNode->lastLevel); }
@@ -446,76 +458,86 @@ globle void AddBetaMemoriesToJoin(
   void *theEnv,
   struct joinNode *theNode)
   {   
-   if ((theNode->leftMemory != NULL) || (theNode->rightMemory != NULL))
+   if ((JoinLeftMemory(theEnv,theNode) != NULL) || (JoinRightMemory(theEnv,theNode) != NULL))
      { return; }
 
    if ((! theNode->firstJoin) || theNode->patternIsExists || theNode-> patternIsNegated || theNode->joinFromTheRight)
      {
       if (theNode->leftHash == NULL)
         {
-         theNode->leftMemory = get_struct(theEnv,betaMemory); 
-         theNode->leftMemory->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *));
-         theNode->leftMemory->beta[0] = NULL;
-         theNode->leftMemory->size = 1;
-         theNode->leftMemory->count = 0;
-         theNode->leftMemory->last = NULL;
+         JoinLeftMemory(theEnv,theNode) = get_struct(theEnv,betaMemory); 
+         JoinLeftMemory(theEnv,theNode)->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *));
+         JoinLeftMemory(theEnv,theNode)->beta[0] = NULL;
+         JoinLeftMemory(theEnv,theNode)->size = 1;
+         JoinLeftMemory(theEnv,theNode)->count = 0;
+         JoinLeftMemory(theEnv,theNode)->peak = 0;
+         JoinLeftMemory(theEnv,theNode)->rangeIndex = NULL;
+         JoinLeftMemory(theEnv,theNode)->last = NULL;
         }
       else
         {
-         theNode->leftMemory = get_struct(theEnv,betaMemory); 
-         theNode->leftMemory->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *) * INITIAL_BETA_HASH_SIZE);
-         memset(theNode->leftMemory->beta,0,sizeof(struct partialMatch *) * INITIAL_BETA_HASH_SIZE);
-         theNode->leftMemory->size = INITIAL_BETA_HASH_SIZE;
-         theNode->leftMemory->count = 0;
-         theNode->leftMemory->last = NULL;
+         JoinLeftMemory(theEnv,theNode) = get_struct(theEnv,betaMemory); 
+         JoinLeftMemory(theEnv,theNode)->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *) * INITIAL_BETA_HASH_SIZE);
+         memset(JoinLeftMemory(theEnv,theNode)->beta,0,sizeof(struct partialMatch *) * INITIAL_BETA_HASH_SIZE);
+         JoinLeftMemory(theEnv,theNode)->size = INITIAL_BETA_HASH_SIZE;
+         JoinLeftMemory(theEnv,theNode)->count = 0;
+         JoinLeftMemory(theEnv,theNode)->peak = 0;
+         JoinLeftMemory(theEnv,theNode)->rangeIndex = NULL;
+         JoinLeftMemory(theEnv,theNode)->last = NULL;
         }
 
       if (theNode->firstJoin && (theNode->patternIsExists || theNode-> patternIsNegated || theNode->joinFromTheRight))
         {
-         theNode->leftMemory->beta[0] = CreateEmptyPartialMatch(theEnv); 
-         theNode->leftMemory->beta[0]->owner = theNode;
+         JoinLeftMemory(theEnv,theNode)->beta[0] = CreateEmptyPartialMatch(theEnv); 
+         JoinLeftMemory(theEnv,theNode)->beta[0]->owner = theNode;
         }
      }
    else
-     { theNode->leftMemory = NULL; }
+     { JoinLeftMemory(theEnv,theNode) = NULL; }
 
    if (theNode->joinFromTheRight)
      {
       if (theNode->leftHash == NULL)
         {
-         theNode->rightMemory = get_struct(theEnv,betaMemory); 
-         theNode->rightMemory->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *));
-         theNode->rightMemory->last = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *));
-         theNode->rightMemory->beta[0] = NULL;
-         theNode->rightMemory->last[0] = NULL;
-         theNode->rightMemory->size = 1;
-         theNode->rightMemory->count = 0;
+         JoinRightMemory(theEnv,theNode) = get_struct(theEnv,betaMemory); 
+         JoinRightMemory(theEnv,theNode)->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *));
+         JoinRightMemory(theEnv,theNode)->last = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *));
+         JoinRightMemory(theEnv,theNode)->beta[0] = NULL;
+         JoinRightMemory(theEnv,theNode)->last[0] = NULL;
+         JoinRightMemory(theEnv,theNode)->size = 1;
+         JoinRightMemory(theEnv,theNode)->count = 0;
+         JoinRightMemory(theEnv,theNode)->peak = 0;
+         JoinRightMemory(theEnv,theNode)->rangeIndex = NULL;
         }
       else
         {
-         theNode->rightMemory = get_struct(theEnv,betaMemory); 
-         theNode->rightMemory->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *) * INITIAL_BETA_HASH_SIZE);
-         theNode->rightMemory->last = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *) * INITIAL_BETA_HASH_SIZE);
-         memset(theNode->rightMemory->beta,0,sizeof(struct partialMatch **) * INITIAL_BETA_HASH_SIZE);
-         memset(theNode->rightMemory->last,0,sizeof(struct partialMatch **) * INITIAL_BETA_HASH_SIZE);
-         theNode->rightMemory->size = INITIAL_BETA_HASH_SIZE;
-         theNode->rightMemory->count = 0;
+         JoinRightMemory(theEnv,theNode) = get_struct(theEnv,betaMemory); 
+         JoinRightMemory(theEnv,theNode)->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *) * INITIAL_BETA_HASH_SIZE);
+         JoinRightMemory(theEnv,theNode)->last = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *) * INITIAL_BETA_HASH_SIZE);
+         memset(JoinRightMemory(theEnv,theNode)->beta,0,sizeof(struct partialMatch **) * INITIAL_BETA_HASH_SIZE);
+         memset(JoinRightMemory(theEnv,theNode)->last,0,sizeof(struct partialMatch **) * INITIAL_BETA_HASH_SIZE);
+         JoinRightMemory(theEnv,theNode)->size = INITIAL_BETA_HASH_SIZE;
+         JoinRightMemory(theEnv,theNode)->count = 0;
+         JoinRightMemory(theEnv,theNode)->peak = 0;
+         JoinRightMemory(theEnv,theNode)->rangeIndex = NULL;
         }
      }
    else if (theNode->rightSideEntryStructure == NULL)
      {
-      theNode->rightMemory = get_struct(theEnv,betaMemory); 
-      theNode->rightMemory->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *));
-      theNode->rightMemory->last = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *));
-      theNode->rightMemory->beta[0] = CreateEmptyPartialMatch(theEnv);
-      theNode->rightMemory->beta[0]->owner = theNode;
-      theNode->rightMemory->beta[0]->rhsMemory = TRUE;
-      theNode->rightMemory->last[0] = theNode->rightMemory->beta[0];
-      theNode->rightMemory->size = 1;
-      theNode->rightMemory->count = 1;    
+      JoinRightMemory(theEnv,theNode) = get_struct(theEnv,betaMemory); 
+      JoinRightMemory(theEnv,theNode)->beta = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *));
+      JoinRightMemory(theEnv,theNode)->last = (struct partialMatch **) genalloc(theEnv,sizeof(struct partialMatch *));
+      JoinRightMemory(theEnv,theNode)->beta[0] = CreateEmptyPartialMatch(theEnv);
+      JoinRightMemory(theEnv,theNode)->beta[0]->owner = theNode;
+      JoinRightMemory(theEnv,theNode)->beta[0]->rhsMemory = TRUE;
+      JoinRightMemory(theEnv,theNode)->last[0] = JoinRightMemory(theEnv,theNode)->beta[0];
+      JoinRightMemory(theEnv,theNode)->size = 1;
+      JoinRightMemory(theEnv,theNode)->count = 1;    
+      JoinRightMemory(theEnv,theNode)->peak = 0;
+      JoinRightMemory(theEnv,theNode)->rangeIndex = NULL;
      }
    else
-     { theNode->rightMemory = NULL; }
+     { JoinRightMemory(theEnv,theNode) = NULL; }
   }
 
 #endif /* RUN_TIME || BLOAD_ONLY || BLOAD || BLOAD_AND_BSAVE */
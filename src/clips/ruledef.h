@@ -121,8 +121,20 @@ struct defruleModule
    struct activation *agenda;
   };
 
+/*=================================================*/
+/* The beta memories of the joins in a shared      */
+/* binary image belong to the environment using    */
+/* them.                                           */
+/*=================================================*/
+
+struct joinMemories
+  {
+   struct betaMemory *leftMemory;
+   struct betaMemory *rightMemory;
+  };
+
 #ifndef ALPHA_MEMORY_HASH_SIZE
-#define ALPHA_MEMORY_HASH_SIZE       63559L
+#define ALPHA_MEMORY_HASH_SIZE       64L
 #endif
 
 #define DEFRULE_DATA 16
@@ -133,9 +145,20 @@ struct defruleData
    int DefruleModuleIndex;
    long long CurrentEntityTimeTag;
    struct alphaMemoryHash **AlphaMemoryTable;
+   struct linearHashInfo AlphaMemoryTableInfo;
+   unsigned long AlphaMemoryPeak;
    intBool BetaMemoryResizingFlag;
+   intBool ThresholdIndexingFlag;
    struct joinLink *RightPrimeJoins;
    struct joinLink *LeftPrimeJoins;
+#if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
+   struct joinNode *SharedJoinArray;
+   long NumberOfSharedJoins;
+   struct joinMemories *JoinMemoryArray;
+   struct defruleModule *SharedModuleArray;
+   long NumberOfSharedModules;
+   struct defruleModule *ModuleItemArray;
+#endif
 
 #if DEBUGGING_FUNCTIONS
     unsigned WatchRules;
@@ -151,6 +174,35 @@ struct defruleData
 
 #define DefruleData(theEnv) ((struct defruleData *) GetEnvironmentData(theEnv,DEFRULE_DATA))
 
+/*==================================================*/
+/* An environment sharing a binary image keeps the  */
+/* beta memories of its joins and the agendas of    */
+/* its defrule modules in arrays indexed like those */
+/* of the image, and its alpha memories only in     */
+/* the alpha memory table, since the pattern nodes  */
+/* are shared too. Join activity isn't counted.     */
+/*==================================================*/
+
+#if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
+#define JoinLeftMemory(theEnv,theJoin) \
+   (*((DefruleData(theEnv)->SharedJoinArray == NULL) ? &(theJoin)->leftMemory : \
+      &DefruleData(theEnv)->JoinMemoryArray[(theJoin) - DefruleData(theEnv)->SharedJoinArray].leftMemory))
+#define JoinRightMemory(theEnv,theJoin) \
+   (*((DefruleData(theEnv)->SharedJoinArray == NULL) ? &(theJoin)->rightMemory : \
+      &DefruleData(theEnv)->JoinMemoryArray[(theJoin) - DefruleData(theEnv)->SharedJoinArray].rightMemory))
+#define RuleModuleItem(theEnv,theItem) \
+   ((DefruleData(theEnv)->SharedModuleArray == NULL) ? ((struct defruleModule *) (theItem)) : \
+    &DefruleData(theEnv)->ModuleItemArray[((struct defruleModule *) (theItem)) - DefruleData(theEnv)->SharedModuleArray])
+#define SharedRuleNetwork(theEnv) (DefruleData(theEnv)->SharedJoinArray != NULL)
+#else
+#define JoinLeftMemory(theEnv,theJoin) ((theJoin)->leftMemory)
+#define JoinRightMemory(theEnv,theJoin) ((theJoin)->rightMemory)
+#define RuleModuleItem(theEnv,theItem) ((struct defruleModule *) (theItem))
+#define SharedRuleNetwork(theEnv) FALSE
+#endif
+
+#define CountJoinActivity(theEnv) (! SharedRuleNetwork(theEnv))
+
 #define GetPreviousJoin(theJoin) \
    (((theJoin)->joinFromTheRight) ? \
     ((struct joinNode *) (theJoin)->rightSideEntryStructure) : \
@@ -52,6 +52,7 @@
 #include "drive.h"
 #include "retract.h"
 #include "constrct.h"
+#include "exprcode.h"
 
 #if BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE
 #include "bload.h"
@@ -366,6 +367,8 @@ static void DetachJoins(
         }
 #endif
 
+      ReturnJoinExpressionCode(theEnv,join);
+
       /*============================*/
       /* Fix the right prime links. */
       /*============================*/
@@ -58,6 +58,7 @@
 #include "envrnmnt.h"
 #include "exprnpsr.h"
 #include "incrrset.h"
+#include "joinprof.h"
 #include "memalloc.h"
 #include "pattern.h"
 #include "prccode.h"
@@ -76,6 +77,7 @@
 #include "lgcldpnd.h"
 
 #if DEFTEMPLATE_CONSTRUCT
+#include "lazymtch.h"
 #include "tmpltfun.h"
 #endif
 
@@ -184,6 +186,16 @@ globle int ParseDefrule(
       return(TRUE);
      }
 
+   /*====================================================*/
+   /* Send the deferred matches of the facts through the */
+   /* joins before the rule's joins are added to them    */
+   /* (see EnvSetLazyMatching).                          */
+   /*====================================================*/
+
+#if DEFTEMPLATE_CONSTRUCT
+   LazyMatchRulesChanged(theEnv);
+#endif
+
    /*=======================*/
    /* Process the rule LHS. */
    /*=======================*/
@@ -291,6 +303,7 @@ static struct defrule *ProcessRuleLHS(
    int complexity;
    struct joinNode *lastJoin;
    intBool emptyLHS;
+   unsigned short disjunctIndex = 1;
 
    /*================================================*/
    /* Initially set the parsing error flag to FALSE. */
@@ -328,7 +341,17 @@ static struct defrule *ProcessRuleLHS(
         { tempNode = NULL; }
       else
         {
-         if (theLHS->type == AND_CE) tempNode = theLHS->right;
+         if (theLHS->type == AND_CE)
+           {
+            /*=============================================*/
+            /* Reorder the pattern CEs if the disjunct was */
+            /* profiled by a loaded join profile.          */
+            /*=============================================*/
+
+            if (! ConstructData(theEnv)->CheckSyntaxMode)
+              { theLHS->right = ProfileReorderPatterns(theEnv,ruleName,disjunctIndex,theLHS->right); }
+            tempNode = theLHS->right;
+           }
          else if (theLHS->type == PATTERN_CE) tempNode = theLHS;
         }
 
@@ -461,6 +484,7 @@ static struct defrule *ProcessRuleLHS(
       /*===========================================*/
 
       lastDisjunct = currentDisjunct;
+      disjunctIndex++;
       
       if (emptyLHS)
         { emptyLHS = FALSE; }
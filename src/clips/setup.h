@@ -407,6 +407,20 @@
 #define MULTIFIELD_FUNCTIONS 1
 #endif
 
+/**************************************************************/
+/* IMMEDIATE_NUMBERS: Stores integers and floats in the value */
+/*   pointer of fields and data objects instead of adding     */
+/*   them to the atom tables. Requires 64 bit pointers.       */
+/**************************************************************/
+
+#ifndef IMMEDIATE_NUMBERS
+#if defined(__LP64__) || defined(_WIN64)
+#define IMMEDIATE_NUMBERS 1
+#else
+#define IMMEDIATE_NUMBERS 0
+#endif
+#endif
+
 /****************************************************/
 /* DEBUGGING_FUNCTIONS: Includes functions such as  */
 /*   rules, facts, matches, ppdefrule, etc.         */
@@ -88,7 +88,7 @@ globle void InitAtomicValueNeededFlags(
 
    symbolArray = GetSymbolTable(theEnv);
 
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < GetSymbolTableSize(theEnv); i++)
      {
       symbolPtr = symbolArray[i];
       while (symbolPtr != NULL)
@@ -104,7 +104,7 @@ globle void InitAtomicValueNeededFlags(
 
    floatArray = GetFloatTable(theEnv);
 
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0; i < GetFloatTableSize(theEnv); i++)
      {
       floatPtr = floatArray[i];
       while (floatPtr != NULL)
@@ -120,7 +120,7 @@ globle void InitAtomicValueNeededFlags(
 
    integerArray = GetIntegerTable(theEnv);
 
-   for (i = 0; i < INTEGER_HASH_SIZE; i++)
+   for (i = 0; i < GetIntegerTableSize(theEnv); i++)
      {
       integerPtr = integerArray[i];
       while (integerPtr != NULL)
@@ -136,7 +136,7 @@ globle void InitAtomicValueNeededFlags(
 
    bitMapArray = GetBitMapTable(theEnv);
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < GetBitMapTableSize(theEnv); i++)
      {
       bitMapPtr = bitMapArray[i];
       while (bitMapPtr != NULL)
@@ -172,7 +172,7 @@ globle void WriteNeededSymbols(
    /* Get the number of symbols and the total string size. */
    /*======================================================*/
 
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < GetSymbolTableSize(theEnv); i++)
      {
       for (symbolPtr = symbolArray[i];
            symbolPtr != NULL;
@@ -193,7 +193,7 @@ globle void WriteNeededSymbols(
    GenWrite((void *) &numberOfUsedSymbols,(unsigned long) sizeof(unsigned long int),fp);
    GenWrite((void *) &size,(unsigned long) sizeof(unsigned long int),fp);
 
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < GetSymbolTableSize(theEnv); i++)
      {
       for (symbolPtr = symbolArray[i];
            symbolPtr != NULL;
@@ -231,7 +231,7 @@ globle void WriteNeededFloats(
    /* Get the number of floats. */
    /*===========================*/
 
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0; i < GetFloatTableSize(theEnv); i++)
      {
       for (floatPtr = floatArray[i];
            floatPtr != NULL;
@@ -245,7 +245,7 @@ globle void WriteNeededFloats(
 
    GenWrite(&numberOfUsedFloats,(unsigned long) sizeof(unsigned long int),fp);
 
-   for (i = 0 ; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0 ; i < GetFloatTableSize(theEnv); i++)
      {
       for (floatPtr = floatArray[i];
            floatPtr != NULL;
@@ -281,7 +281,7 @@ globle void WriteNeededIntegers(
    /* Get the number of integers. */
    /*=============================*/
 
-   for (i = 0 ; i < INTEGER_HASH_SIZE; i++)
+   for (i = 0 ; i < GetIntegerTableSize(theEnv); i++)
      {
       for (integerPtr = integerArray[i];
            integerPtr != NULL;
@@ -297,7 +297,7 @@ globle void WriteNeededIntegers(
 
    GenWrite(&numberOfUsedIntegers,(unsigned long) sizeof(unsigned long int),fp);
 
-   for (i = 0 ; i < INTEGER_HASH_SIZE; i++)
+   for (i = 0 ; i < GetIntegerTableSize(theEnv); i++)
      {
       for (integerPtr = integerArray[i];
            integerPtr != NULL;
@@ -336,7 +336,7 @@ static void WriteNeededBitMaps(
    /* Get the number of bitmaps and the total bitmap size. */
    /*======================================================*/
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < GetBitMapTableSize(theEnv); i++)
      {
       for (bitMapPtr = bitMapArray[i];
            bitMapPtr != NULL;
@@ -357,7 +357,7 @@ static void WriteNeededBitMaps(
    GenWrite((void *) &numberOfUsedBitMaps,(unsigned long) sizeof(unsigned long int),fp);
    GenWrite((void *) &size,(unsigned long) sizeof(unsigned long int),fp);
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < GetBitMapTableSize(theEnv); i++)
      {
       for (bitMapPtr = bitMapArray[i];
            bitMapPtr != NULL;
@@ -389,6 +389,33 @@ globle void ReadNeededAtomicValues(
    ReadNeededBitMaps(theEnv);
   }
 
+/****************************************************/
+/* SkipNeededAtomicValues: Moves past the symbols,  */
+/*   floats, integers, and bitmaps of the binary    */
+/*   image currently being loaded without reading   */
+/*   them, as ReadNeededAtomicValues would.         */
+/****************************************************/
+globle void SkipNeededAtomicValues(
+  void *theEnv)
+  {
+   long count;
+   unsigned long space;
+
+   GenReadBinary(theEnv,&count,(unsigned long) sizeof(long int));
+   GenReadBinary(theEnv,&space,(unsigned long) sizeof(unsigned long int));
+   if (count != 0) GetSeekCurBinary(theEnv,(long) space);
+
+   GenReadBinary(theEnv,&count,(unsigned long) sizeof(long int));
+   GetSeekCurBinary(theEnv,count * (long) sizeof(double));
+
+   GenReadBinary(theEnv,&count,(unsigned long) sizeof(unsigned long int));
+   GetSeekCurBinary(theEnv,count * (long) sizeof(long long));
+
+   GenReadBinary(theEnv,&count,(unsigned long) sizeof(long int));
+   GenReadBinary(theEnv,&space,(unsigned long) sizeof(unsigned long int));
+   if (count != 0) GetSeekCurBinary(theEnv,(long) space);
+  }
+
 /*******************************************/
 /* ReadNeededSymbols: Reads in the symbols */
 /*   used by the binary image.             */
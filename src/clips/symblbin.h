@@ -54,6 +54,7 @@
    LOCALE void                    MarkNeededAtomicValues(void);
    LOCALE void                    WriteNeededAtomicValues(void *,FILE *);
    LOCALE void                    ReadNeededAtomicValues(void *);
+   LOCALE void                    SkipNeededAtomicValues(void *);
    LOCALE void                    InitAtomicValueNeededFlags(void *);
    LOCALE void                    FreeAtomicValueStorage(void *);
    LOCALE void                    WriteNeededSymbols(void *,FILE *);
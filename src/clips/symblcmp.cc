@@ -170,7 +170,7 @@ static int SymbolHashNodesToCode(
               { fprintf(fp,"{&S%d_%d[%ld],",ConstructCompilerData(theEnv)->ImageID,arrayVersion,j + 1); }
            }
 
-         fprintf(fp,"%ld,1,0,0,%ld,",hashPtr->count + 1,i);
+         fprintf(fp,"%ld,1,0,0,0,%lu,",hashPtr->count + 1,AtomHashValue(HashSymbol(hashPtr->contents,0)));
          PrintCString(fp,hashPtr->contents);
 
          count++;
@@ -273,8 +273,8 @@ static int BitMapHashNodesToCode(
               { fprintf(fp,"{&B%d_%d[%d],",ConstructCompilerData(theEnv)->ImageID,arrayVersion,j + 1); }
            }
 
-         fprintf(fp,"%ld,1,0,0,%d,(char *) &L%d_%d[%d],%d",
-                     hashPtr->count + 1,i,
+         fprintf(fp,"%ld,1,0,0,0,%lu,(char *) &L%d_%d[%d],%d",
+                     hashPtr->count + 1,AtomHashValue(HashBitMap(hashPtr->contents,0,hashPtr->size)),
                      ConstructCompilerData(theEnv)->ImageID,longsReqdPartition,longsReqdPartitionCount,
                      hashPtr->size);
 
@@ -499,7 +499,7 @@ static int FloatHashNodesToCode(
               { fprintf(fp,"{&F%d_%d[%d],",ConstructCompilerData(theEnv)->ImageID,arrayVersion,j + 1); }
            }
 
-         fprintf(fp,"%ld,1,0,0,%d,",hashPtr->count + 1,i);
+         fprintf(fp,"%ld,1,0,0,0,%lu,",hashPtr->count + 1,AtomHashValue(HashFloat(hashPtr->contents,0)));
          fprintf(fp,"%s",FloatToString(theEnv,hashPtr->contents));
 
          count++;
@@ -601,7 +601,7 @@ static int IntegerHashNodesToCode(
               { fprintf(fp,"{&I%d_%d[%d],",ConstructCompilerData(theEnv)->ImageID,arrayVersion,j + 1); }
            }
 
-         fprintf(fp,"%ld,1,0,0,%d,",hashPtr->count + 1,i);
+         fprintf(fp,"%ld,1,0,0,0,%lu,",hashPtr->count + 1,AtomHashValue(HashInteger(hashPtr->contents,0)));
          fprintf(fp,"%lldLL",hashPtr->contents);
 
          count++;
@@ -655,7 +655,7 @@ static int HashTablesToCode(
    if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,1,FALSE)) == NULL) return(0);
 
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"extern struct symbolHashNode *sht%d[];\n",ConstructCompilerData(theEnv)->ImageID);
-   fprintf(fp,"struct symbolHashNode *sht%d[%ld] = {\n",ConstructCompilerData(theEnv)->ImageID,SYMBOL_HASH_SIZE);
+   fprintf(fp,"struct symbolHashNode *sht%d[%ld] = {\n",ConstructCompilerData(theEnv)->ImageID,SYMBOL_HASH_SIZE * 2);
 
    for (i = 0; i < SYMBOL_HASH_SIZE; i++)
       {
@@ -677,7 +677,7 @@ static int HashTablesToCode(
    if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,2,FALSE)) == NULL) return(0);
 
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"extern struct floatHashNode *fht%d[];\n",ConstructCompilerData(theEnv)->ImageID);
-   fprintf(fp,"struct floatHashNode *fht%d[%d] = {\n",ConstructCompilerData(theEnv)->ImageID,FLOAT_HASH_SIZE);
+   fprintf(fp,"struct floatHashNode *fht%d[%d] = {\n",ConstructCompilerData(theEnv)->ImageID,FLOAT_HASH_SIZE * 2);
 
    for (i = 0; i < FLOAT_HASH_SIZE; i++)
       {
@@ -700,7 +700,7 @@ static int HashTablesToCode(
    if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,3,FALSE)) == NULL) return(0);
 
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"extern struct integerHashNode *iht%d[];\n",ConstructCompilerData(theEnv)->ImageID);
-   fprintf(fp,"struct integerHashNode *iht%d[%d] = {\n",ConstructCompilerData(theEnv)->ImageID,INTEGER_HASH_SIZE);
+   fprintf(fp,"struct integerHashNode *iht%d[%d] = {\n",ConstructCompilerData(theEnv)->ImageID,INTEGER_HASH_SIZE * 2);
 
    for (i = 0; i < INTEGER_HASH_SIZE; i++)
       {
@@ -723,7 +723,7 @@ static int HashTablesToCode(
    if ((fp = NewCFile(theEnv,fileName,pathName,fileNameBuffer,1,4,FALSE)) == NULL) return(0);
 
    fprintf(ConstructCompilerData(theEnv)->HeaderFP,"extern struct bitMapHashNode *bmht%d[];\n",ConstructCompilerData(theEnv)->ImageID);
-   fprintf(fp,"struct bitMapHashNode *bmht%d[%d] = {\n",ConstructCompilerData(theEnv)->ImageID,BITMAP_HASH_SIZE);
+   fprintf(fp,"struct bitMapHashNode *bmht%d[%d] = {\n",ConstructCompilerData(theEnv)->ImageID,BITMAP_HASH_SIZE * 2);
 
    for (i = 0; i < BITMAP_HASH_SIZE; i++)
       {
@@ -758,13 +758,20 @@ globle void PrintSymbolReference(
 
 /****************************************************/
 /* PrintFloatReference: Prints the C code reference */
-/*   address to the specified float.                */
+/*   address to the specified float, or the value   */
+/*   itself for an immediate float.                 */
 /****************************************************/
 globle void PrintFloatReference(
   void *theEnv,
   FILE *theFile,
   struct floatHashNode *theFloat)
   {
+   if (IsImmediateNumber(theFloat))
+     {
+      fprintf(theFile,"((void *) 0x%llxULL)",(unsigned long long) (size_t) theFloat);
+      return;
+     }
+
    fprintf(theFile,"&F%d_%d[%d]",
                    ConstructCompilerData(theEnv)->ImageID,
                    (int) (theFloat->bucket / ConstructCompilerData(theEnv)->MaxIndices) + 1,
@@ -773,13 +780,20 @@ globle void PrintFloatReference(
 
 /******************************************************/
 /* PrintIntegerReference: Prints the C code reference */
-/*   address to the specified integer.                */
+/*   address to the specified integer, or the value   */
+/*   itself for an immediate integer.                 */
 /******************************************************/
 globle void PrintIntegerReference(
   void *theEnv,
   FILE *theFile,
   struct integerHashNode *theInteger)
   {
+   if (IsImmediateNumber(theInteger))
+     {
+      fprintf(theFile,"((void *) 0x%llxULL)",(unsigned long long) (size_t) theInteger);
+      return;
+     }
+
    fprintf(theFile,"&I%d_%d[%d]",
                    ConstructCompilerData(theEnv)->ImageID,
                    (int) (theInteger->bucket / ConstructCompilerData(theEnv)->MaxIndices) + 1,
@@ -90,16 +90,35 @@
 #define AVERAGE_BITMAP_SIZE sizeof(long)
 #define NUMBER_OF_LONGS_FOR_HASH 25
 
+/*==================================================*/
+/* A symbol's bucket holds its hash value, so most  */
+/* mismatches are found without comparing strings.  */
+/* While binary save indices are in the buckets,    */
+/* every string in the chain has to be compared.    */
+/*==================================================*/
+
+#define SameSymbol(theData,peek,hashValue,str) \
+   ((((peek)->bucket == (hashValue)) || (theData)->AtomicValueIndicesSet) && \
+    (strcmp((str),(peek)->contents) == 0))
+
 /***************************************/
 /* LOCAL INTERNAL FUNCTION DEFINITIONS */
 /***************************************/
 
-   static void                    RemoveHashNode(void *,GENERIC_HN *,GENERIC_HN **,int,int);
+   static void                    RemoveHashNode(void *,GENERIC_HN *,GENERIC_HN **,
+                                                 struct linearHashInfo *,int,int);
    static void                    AddEphemeralHashNode(void *,GENERIC_HN *,struct ephemeron **,
                                                        int,int,int);
    static void                    RemoveEphemeralHashNodes(void *,struct ephemeron **,
-                                                           GENERIC_HN **,
+                                                           GENERIC_HN **,struct linearHashInfo *,
                                                            int,int,int);
+   static GENERIC_HN            **GrowAtomTable(void *,struct linearHashInfo *,GENERIC_HN **);
+   static GENERIC_HN            **ResizeAtomTable(void *,struct linearHashInfo *,GENERIC_HN **,unsigned long);
+#if RUN_TIME
+   static GENERIC_HN            **LoadCompiledAtomTable(void *,struct linearHashInfo *,GENERIC_HN **,unsigned long);
+#endif
+   static void                   *AddFloatHashNode(void *,double);
+   static void                   *AddIntegerHashNode(void *,long long);
    static const char             *StringWithinString(const char *,const char *);
    static size_t                  CommonPrefixLength(const char *,const char *);
    static void                    DeallocateSymbolData(void *);
@@ -107,7 +126,9 @@
 /*******************************************************/
 /* InitializeAtomTables: Initializes the SymbolTable,  */
 /*   IntegerTable, and FloatTable. It also initializes */
-/*   the TrueSymbol and FalseSymbol.                   */
+/*   the TrueSymbol and FalseSymbol. If sharedEnv is   */
+/*   not NULL, the atoms of that frozen environment    */
+/*   are shared rather than duplicated.                */
 /*******************************************************/
 globle void InitializeAtomTables(
   void *theEnv,
@@ -115,7 +136,8 @@ globle void InitializeAtomTables(
   struct floatHashNode **floatTable,
   struct integerHashNode **integerTable,
   struct bitMapHashNode **bitmapTable,
-  struct externalAddressHashNode **externalAddressTable)
+  struct externalAddressHashNode **externalAddressTable,
+  void *sharedEnv)
   {
 #if MAC_XCD
 #pragma unused(symbolTable)
@@ -124,39 +146,35 @@ globle void InitializeAtomTables(
 #pragma unused(bitmapTable)
 #pragma unused(externalAddressTable)
 #endif
-   unsigned long i;
-   
    AllocateEnvironmentData(theEnv,SYMBOL_DATA,sizeof(struct symbolData),DeallocateSymbolData);
 
+   /*=================================================*/
+   /* Atoms already in the tables of a frozen         */
+   /* environment are used in place of creating them. */
+   /*=================================================*/
+
+   if (sharedEnv != NULL)
+     { SymbolData(theEnv)->SharedAtomTables = SymbolData(sharedEnv); }
+
 #if ! RUN_TIME
    /*=========================*/
    /* Create the hash tables. */
    /*=========================*/
 
    SymbolData(theEnv)->SymbolTable = (SYMBOL_HN **)
-                  gm3(theEnv,sizeof (SYMBOL_HN *) * SYMBOL_HASH_SIZE);
+      CreateLinearHashTable(theEnv,&SymbolData(theEnv)->SymbolTableInfo,SYMBOL_HASH_SIZE);
 
    SymbolData(theEnv)->FloatTable = (FLOAT_HN **)
-                  gm2(theEnv,(int) sizeof (FLOAT_HN *) * FLOAT_HASH_SIZE);
+      CreateLinearHashTable(theEnv,&SymbolData(theEnv)->FloatTableInfo,FLOAT_HASH_SIZE);
 
    SymbolData(theEnv)->IntegerTable = (INTEGER_HN **)
-                   gm2(theEnv,(int) sizeof (INTEGER_HN *) * INTEGER_HASH_SIZE);
+      CreateLinearHashTable(theEnv,&SymbolData(theEnv)->IntegerTableInfo,INTEGER_HASH_SIZE);
 
    SymbolData(theEnv)->BitMapTable = (BITMAP_HN **)
-                   gm2(theEnv,(int) sizeof (BITMAP_HN *) * BITMAP_HASH_SIZE);
+      CreateLinearHashTable(theEnv,&SymbolData(theEnv)->BitMapTableInfo,BITMAP_HASH_SIZE);
 
    SymbolData(theEnv)->ExternalAddressTable = (EXTERNAL_ADDRESS_HN **)
-                   gm2(theEnv,(int) sizeof (EXTERNAL_ADDRESS_HN *) * EXTERNAL_ADDRESS_HASH_SIZE);
-
-   /*===================================================*/
-   /* Initialize all of the hash table entries to NULL. */
-   /*===================================================*/
-
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++) SymbolData(theEnv)->SymbolTable[i] = NULL;
-   for (i = 0; i < FLOAT_HASH_SIZE; i++) SymbolData(theEnv)->FloatTable[i] = NULL;
-   for (i = 0; i < INTEGER_HASH_SIZE; i++) SymbolData(theEnv)->IntegerTable[i] = NULL;
-   for (i = 0; i < BITMAP_HASH_SIZE; i++) SymbolData(theEnv)->BitMapTable[i] = NULL;
-   for (i = 0; i < EXTERNAL_ADDRESS_HASH_SIZE; i++) SymbolData(theEnv)->ExternalAddressTable[i] = NULL;
+      CreateLinearHashTable(theEnv,&SymbolData(theEnv)->ExternalAddressTableInfo,EXTERNAL_ADDRESS_HASH_SIZE);
 
    /*========================*/
    /* Predefine some values. */
@@ -173,15 +191,26 @@ globle void InitializeAtomTables(
    SymbolData(theEnv)->Zero = EnvAddLong(theEnv,0LL);
    IncrementIntegerCount(SymbolData(theEnv)->Zero);
 #else
-   SetSymbolTable(theEnv,symbolTable);
-   SetFloatTable(theEnv,floatTable);
-   SetIntegerTable(theEnv,integerTable);
-   SetBitMapTable(theEnv,bitmapTable);
+   /*===================================================*/
+   /* The compiled tables are written with the initial  */
+   /* number of buckets. Grow them to fit their values. */
+   /*===================================================*/
+
+   SymbolData(theEnv)->SymbolTable = (SYMBOL_HN **)
+      LoadCompiledAtomTable(theEnv,&SymbolData(theEnv)->SymbolTableInfo,
+                            (GENERIC_HN **) symbolTable,SYMBOL_HASH_SIZE);
+   SymbolData(theEnv)->FloatTable = (FLOAT_HN **)
+      LoadCompiledAtomTable(theEnv,&SymbolData(theEnv)->FloatTableInfo,
+                            (GENERIC_HN **) floatTable,FLOAT_HASH_SIZE);
+   SymbolData(theEnv)->IntegerTable = (INTEGER_HN **)
+      LoadCompiledAtomTable(theEnv,&SymbolData(theEnv)->IntegerTableInfo,
+                            (GENERIC_HN **) integerTable,INTEGER_HASH_SIZE);
+   SymbolData(theEnv)->BitMapTable = (BITMAP_HN **)
+      LoadCompiledAtomTable(theEnv,&SymbolData(theEnv)->BitMapTableInfo,
+                            (GENERIC_HN **) bitmapTable,BITMAP_HASH_SIZE);
    
    SymbolData(theEnv)->ExternalAddressTable = (EXTERNAL_ADDRESS_HN **)
-                gm2(theEnv,(int) sizeof (EXTERNAL_ADDRESS_HN *) * EXTERNAL_ADDRESS_HASH_SIZE);
-
-   for (i = 0; i < EXTERNAL_ADDRESS_HASH_SIZE; i++) SymbolData(theEnv)->ExternalAddressTable[i] = NULL;
+      CreateLinearHashTable(theEnv,&SymbolData(theEnv)->ExternalAddressTableInfo,EXTERNAL_ADDRESS_HASH_SIZE);
 #endif
   }
 
@@ -192,7 +221,7 @@ globle void InitializeAtomTables(
 static void DeallocateSymbolData(
   void *theEnv)
   {
-   int i;
+   unsigned long i;
    SYMBOL_HN *shPtr, *nextSHPtr;
    INTEGER_HN *ihPtr, *nextIHPtr;
    FLOAT_HN *fhPtr, *nextFHPtr;
@@ -206,7 +235,7 @@ static void DeallocateSymbolData(
        (SymbolData(theEnv)->ExternalAddressTable == NULL))
      { return; }
      
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++) 
+   for (i = 0; i < SymbolData(theEnv)->SymbolTableInfo.size; i++) 
      {
       shPtr = SymbolData(theEnv)->SymbolTable[i];
       
@@ -222,7 +251,7 @@ static void DeallocateSymbolData(
         } 
      }
       
-   for (i = 0; i < FLOAT_HASH_SIZE; i++) 
+   for (i = 0; i < SymbolData(theEnv)->FloatTableInfo.size; i++) 
      {
       fhPtr = SymbolData(theEnv)->FloatTable[i];
 
@@ -235,7 +264,7 @@ static void DeallocateSymbolData(
         }
      }
      
-   for (i = 0; i < INTEGER_HASH_SIZE; i++) 
+   for (i = 0; i < SymbolData(theEnv)->IntegerTableInfo.size; i++) 
      {
       ihPtr = SymbolData(theEnv)->IntegerTable[i];
 
@@ -248,7 +277,7 @@ static void DeallocateSymbolData(
         }
      }
      
-   for (i = 0; i < BITMAP_HASH_SIZE; i++) 
+   for (i = 0; i < SymbolData(theEnv)->BitMapTableInfo.size; i++) 
      {
       bmhPtr = SymbolData(theEnv)->BitMapTable[i];
 
@@ -264,7 +293,7 @@ static void DeallocateSymbolData(
         }
      }
 
-   for (i = 0; i < EXTERNAL_ADDRESS_HASH_SIZE; i++) 
+   for (i = 0; i < SymbolData(theEnv)->ExternalAddressTableInfo.size; i++) 
      {
       eahPtr = SymbolData(theEnv)->ExternalAddressTable[i];
 
@@ -284,16 +313,21 @@ static void DeallocateSymbolData(
    /*================================*/
    
  #if ! RUN_TIME  
-   rm3(theEnv,SymbolData(theEnv)->SymbolTable,sizeof (SYMBOL_HN *) * SYMBOL_HASH_SIZE);
+   ReturnLinearHashTable(theEnv,&SymbolData(theEnv)->SymbolTableInfo,
+                         (void **) SymbolData(theEnv)->SymbolTable);
 
-   genfree(theEnv,SymbolData(theEnv)->FloatTable,(int) sizeof (FLOAT_HN *) * FLOAT_HASH_SIZE);
+   ReturnLinearHashTable(theEnv,&SymbolData(theEnv)->FloatTableInfo,
+                         (void **) SymbolData(theEnv)->FloatTable);
 
-   genfree(theEnv,SymbolData(theEnv)->IntegerTable,(int) sizeof (INTEGER_HN *) * INTEGER_HASH_SIZE);
+   ReturnLinearHashTable(theEnv,&SymbolData(theEnv)->IntegerTableInfo,
+                         (void **) SymbolData(theEnv)->IntegerTable);
 
-   genfree(theEnv,SymbolData(theEnv)->BitMapTable,(int) sizeof (BITMAP_HN *) * BITMAP_HASH_SIZE);
+   ReturnLinearHashTable(theEnv,&SymbolData(theEnv)->BitMapTableInfo,
+                         (void **) SymbolData(theEnv)->BitMapTable);
 #endif
    
-   genfree(theEnv,SymbolData(theEnv)->ExternalAddressTable,(int) sizeof (EXTERNAL_ADDRESS_HN *) * EXTERNAL_ADDRESS_HASH_SIZE);
+   ReturnLinearHashTable(theEnv,&SymbolData(theEnv)->ExternalAddressTableInfo,
+                         (void **) SymbolData(theEnv)->ExternalAddressTable);
 
    /*==============================*/
    /* Remove binary symbol tables. */
@@ -322,10 +356,11 @@ globle void *EnvAddSymbol(
   void *theEnv,
   const char *str)
   {
-   unsigned long tally;
+   unsigned long tally, hashValue;
    size_t length;
    SYMBOL_HN *past = NULL, *peek;
    char *buffer;
+   struct symbolData *shared;
 
     /*====================================*/
     /* Get the hash value for the string. */
@@ -337,7 +372,21 @@ globle void *EnvAddSymbol(
        EnvExitRouter(theEnv,EXIT_FAILURE);
       }
 
-    tally = HashSymbol(str,SYMBOL_HASH_SIZE);
+    length = strlen(str);
+    hashValue = AtomHashValue(HashCharacters(str,length));
+
+    if ((shared = SymbolData(theEnv)->SharedAtomTables) != NULL)
+      {
+       for (peek = shared->SymbolTable[LinearHashIndex(&shared->SymbolTableInfo,hashValue)];
+            peek != NULL;
+            peek = peek->next)
+         {
+          if (SameSymbol(shared,peek,hashValue,str))
+            { return((void *) peek); }
+         }
+      }
+
+    tally = LinearHashIndex(&SymbolData(theEnv)->SymbolTableInfo,hashValue);
     peek = SymbolData(theEnv)->SymbolTable[tally];
 
     /*==================================================*/
@@ -348,7 +397,7 @@ globle void *EnvAddSymbol(
 
     while (peek != NULL)
       {
-       if (strcmp(str,peek->contents) == 0)
+       if (SameSymbol(SymbolData(theEnv),peek,hashValue,str))
          { return((void *) peek); }
        past = peek;
        peek = peek->next;
@@ -364,14 +413,20 @@ globle void *EnvAddSymbol(
     if (past == NULL) SymbolData(theEnv)->SymbolTable[tally] = peek;
     else past->next = peek;
 
-    length = strlen(str) + 1;
-    buffer = (char *) gm2(theEnv,length);
-    genstrcpy(buffer,str);
+    buffer = (char *) gm2(theEnv,length + 1);
+    memcpy(buffer,str,length + 1);
     peek->contents = buffer;
     peek->next = NULL;
-    peek->bucket = tally;
+    peek->bucket = hashValue;
     peek->count = 0;
     peek->permanent = FALSE;
+    peek->shared = FALSE;
+
+    if (++SymbolData(theEnv)->SymbolTableInfo.count > SymbolData(theEnv)->SymbolTableInfo.size)
+      {
+       SymbolData(theEnv)->SymbolTable = (SYMBOL_HN **)
+          GrowAtomTable(theEnv,&SymbolData(theEnv)->SymbolTableInfo,(GENERIC_HN **) SymbolData(theEnv)->SymbolTable);
+      }
       
     /*================================================*/
     /* Add the string to the list of ephemeral items. */
@@ -396,16 +451,30 @@ globle SYMBOL_HN *FindSymbolHN(
   void *theEnv,
   const char *str)
   {
-   unsigned long tally;
+   unsigned long tally, hashValue;
    SYMBOL_HN *peek;
+   struct symbolData *shared;
+
+    hashValue = AtomHashValue(HashSymbol(str,0));
 
-    tally = HashSymbol(str,SYMBOL_HASH_SIZE);
+    if ((shared = SymbolData(theEnv)->SharedAtomTables) != NULL)
+      {
+       for (peek = shared->SymbolTable[LinearHashIndex(&shared->SymbolTableInfo,hashValue)];
+            peek != NULL;
+            peek = peek->next)
+         {
+          if (SameSymbol(shared,peek,hashValue,str))
+            { return(peek); }
+         }
+      }
+
+    tally = LinearHashIndex(&SymbolData(theEnv)->SymbolTableInfo,hashValue);
 
     for (peek = SymbolData(theEnv)->SymbolTable[tally];
          peek != NULL;
          peek = peek->next)
-      { 
-       if (strcmp(str,peek->contents) == 0) 
+      {
+       if (SameSymbol(SymbolData(theEnv),peek,hashValue,str))
          { return(peek); }
       }
 
@@ -413,23 +482,56 @@ globle SYMBOL_HN *FindSymbolHN(
    }
 
 /*******************************************************************/
-/* EnvAddDouble: Searches for the double in the hash table. If the */
-/*   double is already in the hash table, then the address of the  */
-/*   double is returned. Otherwise, the double is hashed into the  */
-/*   table and the address of the double is also returned.         */
+/* EnvAddDouble: Returns the value pointer for a double: either an */
+/*   immediate float or the address of its float table entry.      */
 /*******************************************************************/
 globle void *EnvAddDouble(
   void *theEnv,
   double number)
   {
-   unsigned long tally;
+#if IMMEDIATE_NUMBERS
+   union immediateFloat theFloat;
+
+   theFloat.value = number;
+   if (FloatBitsFitImmediate(theFloat.bits))
+     { return(FloatBitsToImmediate(theFloat.bits)); }
+#endif
+
+   return(AddFloatHashNode(theEnv,number));
+  }
+
+/*******************************************************************/
+/* AddFloatHashNode: Searches for the double in the hash table. If */
+/*   the double is already in the hash table, then the address of  */
+/*   the double is returned. Otherwise, the double is hashed into  */
+/*   the table and the address of the double is also returned.     */
+/*******************************************************************/
+static void *AddFloatHashNode(
+  void *theEnv,
+  double number)
+  {
+   unsigned long tally, hashValue;
    FLOAT_HN *past = NULL, *peek;
+   struct symbolData *shared;
 
     /*====================================*/
     /* Get the hash value for the double. */
     /*====================================*/
 
-    tally = HashFloat(number,FLOAT_HASH_SIZE);
+    hashValue = AtomHashValue(HashFloat(number,0));
+
+    if ((shared = SymbolData(theEnv)->SharedAtomTables) != NULL)
+      {
+       for (peek = shared->FloatTable[LinearHashIndex(&shared->FloatTableInfo,hashValue)];
+            peek != NULL;
+            peek = peek->next)
+         {
+          if (number == peek->contents)
+            { return((void *) peek); }
+         }
+      }
+
+    tally = LinearHashIndex(&SymbolData(theEnv)->FloatTableInfo,hashValue);
     peek = SymbolData(theEnv)->FloatTable[tally];
 
     /*==================================================*/
@@ -458,9 +560,16 @@ globle void *EnvAddDouble(
 
     peek->contents = number;
     peek->next = NULL;
-    peek->bucket = tally;
+    peek->bucket = hashValue;
     peek->count = 0;
     peek->permanent = FALSE;
+    peek->shared = FALSE;
+
+    if (++SymbolData(theEnv)->FloatTableInfo.count > SymbolData(theEnv)->FloatTableInfo.size)
+      {
+       SymbolData(theEnv)->FloatTable = (FLOAT_HN **)
+          GrowAtomTable(theEnv,&SymbolData(theEnv)->FloatTableInfo,(GENERIC_HN **) SymbolData(theEnv)->FloatTable);
+      }
 
     /*===============================================*/
     /* Add the float to the list of ephemeral items. */
@@ -478,23 +587,54 @@ globle void *EnvAddDouble(
    }
 
 /***************************************************************/
-/* EnvAddLong: Searches for the long in the hash table. If the */
-/*   long is already in the hash table, then the address of    */
-/*   the long is returned. Otherwise, the long is hashed into  */
-/*   the table and the address of the long is also returned.   */
+/* EnvAddLong: Returns the value pointer for a long: either an */
+/*   immediate integer or the address of its integer table     */
+/*   entry.                                                    */
 /***************************************************************/
 globle void *EnvAddLong(
   void *theEnv,
   long long number)
   {
-   unsigned long tally;
+#if IMMEDIATE_NUMBERS
+   if (LongFitsImmediate(number))
+     { return(LongToImmediate(number)); }
+#endif
+
+   return(AddIntegerHashNode(theEnv,number));
+  }
+
+/*****************************************************************/
+/* AddIntegerHashNode: Searches for the long in the hash table.  */
+/*   If the long is already in the hash table, then the address  */
+/*   of the long is returned. Otherwise, the long is hashed into */
+/*   the table and the address of the long is also returned.     */
+/*****************************************************************/
+static void *AddIntegerHashNode(
+  void *theEnv,
+  long long number)
+  {
+   unsigned long tally, hashValue;
    INTEGER_HN *past = NULL, *peek;
+   struct symbolData *shared;
 
     /*==================================*/
     /* Get the hash value for the long. */
     /*==================================*/
 
-    tally = HashInteger(number,INTEGER_HASH_SIZE);
+    hashValue = AtomHashValue(HashInteger(number,0));
+
+    if ((shared = SymbolData(theEnv)->SharedAtomTables) != NULL)
+      {
+       for (peek = shared->IntegerTable[LinearHashIndex(&shared->IntegerTableInfo,hashValue)];
+            peek != NULL;
+            peek = peek->next)
+         {
+          if (number == peek->contents)
+            { return((void *) peek); }
+         }
+      }
+
+    tally = LinearHashIndex(&SymbolData(theEnv)->IntegerTableInfo,hashValue);
     peek = SymbolData(theEnv)->IntegerTable[tally];
 
     /*================================================*/
@@ -522,9 +662,16 @@ globle void *EnvAddLong(
 
     peek->contents = number;
     peek->next = NULL;
-    peek->bucket = tally;
+    peek->bucket = hashValue;
     peek->count = 0;
     peek->permanent = FALSE;
+    peek->shared = FALSE;
+
+    if (++SymbolData(theEnv)->IntegerTableInfo.count > SymbolData(theEnv)->IntegerTableInfo.size)
+      {
+       SymbolData(theEnv)->IntegerTable = (INTEGER_HN **)
+          GrowAtomTable(theEnv,&SymbolData(theEnv)->IntegerTableInfo,(GENERIC_HN **) SymbolData(theEnv)->IntegerTable);
+      }
 
     /*=================================================*/
     /* Add the integer to the list of ephemeral items. */
@@ -549,10 +696,26 @@ globle INTEGER_HN *FindLongHN(
   void *theEnv,
   long long theLong)
   {
-   unsigned long tally;
+   unsigned long tally, hashValue;
    INTEGER_HN *peek;
+   struct symbolData *shared;
 
-   tally = HashInteger(theLong,INTEGER_HASH_SIZE);
+#if IMMEDIATE_NUMBERS
+   if (LongFitsImmediate(theLong))
+     { return((INTEGER_HN *) LongToImmediate(theLong)); }
+#endif
+
+   hashValue = AtomHashValue(HashInteger(theLong,0));
+
+   if ((shared = SymbolData(theEnv)->SharedAtomTables) != NULL)
+     {
+      for (peek = shared->IntegerTable[LinearHashIndex(&shared->IntegerTableInfo,hashValue)];
+           peek != NULL;
+           peek = peek->next)
+        { if (peek->contents == theLong) return(peek); }
+     }
+
+   tally = LinearHashIndex(&SymbolData(theEnv)->IntegerTableInfo,hashValue);
 
    for (peek = SymbolData(theEnv)->IntegerTable[tally];
         peek != NULL;
@@ -562,6 +725,37 @@ globle INTEGER_HN *FindLongHN(
    return(NULL);
   }
 
+/******************************************************************/
+/* BoxedFloat: Returns the float table entry for a float value.   */
+/*   An immediate float is given an entry of its own (one that    */
+/*   EnvAddDouble never returns) so that binary save can mark and */
+/*   index it in the same way as the floats already in the table. */
+/******************************************************************/
+globle FLOAT_HN *BoxedFloat(
+  void *theEnv,
+  void *theValue)
+  {
+   if (! IsImmediateNumber(theValue))
+     { return((FLOAT_HN *) theValue); }
+
+   return((FLOAT_HN *) AddFloatHashNode(theEnv,ValueToDouble(theValue)));
+  }
+
+/*********************************************************************/
+/* BoxedInteger: Returns the integer table entry for an integer      */
+/*   value, giving an immediate integer an entry of its own. See the */
+/*   BoxedFloat function.                                            */
+/*********************************************************************/
+globle INTEGER_HN *BoxedInteger(
+  void *theEnv,
+  void *theValue)
+  {
+   if (! IsImmediateNumber(theValue))
+     { return((INTEGER_HN *) theValue); }
+
+   return((INTEGER_HN *) AddIntegerHashNode(theEnv,ValueToLong(theValue)));
+  }
+
 /*******************************************************************/
 /* EnvAddBitMap: Searches for the bitmap in the hash table. If the */
 /*   bitmap is already in the hash table, then the address of the  */
@@ -574,10 +768,11 @@ globle void *EnvAddBitMap(
   unsigned size)
   {
    char *theBitMap = (char *) vTheBitMap;
-   unsigned long tally;
+   unsigned long tally, hashValue;
    unsigned i;
    BITMAP_HN *past = NULL, *peek;
    char *buffer;
+   struct symbolData *shared;
 
     /*====================================*/
     /* Get the hash value for the bitmap. */
@@ -589,7 +784,21 @@ globle void *EnvAddBitMap(
        EnvExitRouter(theEnv,EXIT_FAILURE);
       }
 
-    tally = HashBitMap(theBitMap,BITMAP_HASH_SIZE,size);
+    hashValue = AtomHashValue(HashBitMap(theBitMap,0,size));
+
+    if ((shared = SymbolData(theEnv)->SharedAtomTables) != NULL)
+      {
+       for (peek = shared->BitMapTable[LinearHashIndex(&shared->BitMapTableInfo,hashValue)];
+            peek != NULL;
+            peek = peek->next)
+         {
+          if ((peek->size == (unsigned short) size) &&
+              (memcmp(peek->contents,theBitMap,size) == 0))
+            { return((void *) peek); }
+         }
+      }
+
+    tally = LinearHashIndex(&SymbolData(theEnv)->BitMapTableInfo,hashValue);
     peek = SymbolData(theEnv)->BitMapTable[tally];
 
     /*==================================================*/
@@ -625,11 +834,18 @@ globle void *EnvAddBitMap(
     for (i = 0; i < size ; i++) buffer[i] = theBitMap[i];
     peek->contents = buffer;
     peek->next = NULL;
-    peek->bucket = tally;
+    peek->bucket = hashValue;
     peek->count = 0;
     peek->permanent = FALSE;
+    peek->shared = FALSE;
     peek->size = (unsigned short) size;
 
+    if (++SymbolData(theEnv)->BitMapTableInfo.count > SymbolData(theEnv)->BitMapTableInfo.size)
+      {
+       SymbolData(theEnv)->BitMapTable = (BITMAP_HN **)
+          GrowAtomTable(theEnv,&SymbolData(theEnv)->BitMapTableInfo,(GENERIC_HN **) SymbolData(theEnv)->BitMapTable);
+      }
+
     /*================================================*/
     /* Add the bitmap to the list of ephemeral items. */
     /*================================================*/
@@ -657,14 +873,29 @@ globle void *EnvAddExternalAddress(
   void *theExternalAddress,
   unsigned theType)
   {
-   unsigned long tally;
+   unsigned long tally, hashValue;
    EXTERNAL_ADDRESS_HN *past = NULL, *peek;
+   struct symbolData *shared;
 
     /*====================================*/
     /* Get the hash value for the bitmap. */
     /*====================================*/
 
-    tally = HashExternalAddress(theExternalAddress,EXTERNAL_ADDRESS_HASH_SIZE);
+    hashValue = AtomHashValue(HashExternalAddress(theExternalAddress,0));
+
+    if ((shared = SymbolData(theEnv)->SharedAtomTables) != NULL)
+      {
+       for (peek = shared->ExternalAddressTable[LinearHashIndex(&shared->ExternalAddressTableInfo,hashValue)];
+            peek != NULL;
+            peek = peek->next)
+         {
+          if ((peek->type == (unsigned short) theType) &&
+              (peek->externalAddress == theExternalAddress))
+            { return((void *) peek); }
+         }
+      }
+
+    tally = LinearHashIndex(&SymbolData(theEnv)->ExternalAddressTableInfo,hashValue);
 
     peek = SymbolData(theEnv)->ExternalAddressTable[tally];
 
@@ -696,9 +927,16 @@ globle void *EnvAddExternalAddress(
     peek->externalAddress = theExternalAddress;
     peek->type = (unsigned short) theType;
     peek->next = NULL;
-    peek->bucket = tally;
+    peek->bucket = hashValue;
     peek->count = 0;
     peek->permanent = FALSE;
+    peek->shared = FALSE;
+
+    if (++SymbolData(theEnv)->ExternalAddressTableInfo.count > SymbolData(theEnv)->ExternalAddressTableInfo.size)
+      {
+       SymbolData(theEnv)->ExternalAddressTable = (EXTERNAL_ADDRESS_HN **)
+          GrowAtomTable(theEnv,&SymbolData(theEnv)->ExternalAddressTableInfo,(GENERIC_HN **) SymbolData(theEnv)->ExternalAddressTable);
+      }
 
     /*================================================*/
     /* Add the bitmap to the list of ephemeral items. */
@@ -715,25 +953,61 @@ globle void *EnvAddExternalAddress(
     return((void *) peek);
    }
 
-/***************************************************/
-/* HashSymbol: Computes a hash value for a symbol. */
-/***************************************************/
+/*******************************************************/
+/* HashSymbol: Computes a hash value for a symbol. The */
+/*   value is reduced to the range by masking when the */
+/*   range is a power of two.                          */
+/*******************************************************/
 globle unsigned long HashSymbol(
   const char *word,
   unsigned long range)
   {
-   register int i;
-   unsigned long tally = 0;
+   unsigned long tally;
 
-   for (i = 0; word[i]; i++)
-     { tally = tally * 127 + word[i]; }
+   tally = HashCharacters(word,strlen(word));
 
    if (range == 0)
      { return tally; }
-     
+
+   if ((range & (range - 1)) == 0)
+     { return(tally & (range - 1)); }
+
    return(tally % range);
   }
 
+/**************************************************************/
+/* HashCharacters: Computes the hash value of a string of the */
+/*   given length, eight characters at a time. The result is  */
+/*   the one returned by HashSymbol for an unlimited range.   */
+/**************************************************************/
+globle unsigned long HashCharacters(
+  const char *word,
+  size_t length)
+  {
+   unsigned long long tally, chunk;
+
+   tally = (unsigned long long) length * 0x9e3779b97f4a7c15ULL;
+
+   while (length >= sizeof(chunk))
+     {
+      memcpy(&chunk,word,sizeof(chunk));
+      tally = (tally ^ chunk) * 0xff51afd7ed558ccdULL;
+      tally ^= tally >> 32;
+      word += sizeof(chunk);
+      length -= sizeof(chunk);
+     }
+
+   if (length > 0)
+     {
+      chunk = 0;
+      memcpy(&chunk,word,length);
+      tally = (tally ^ chunk) * 0xff51afd7ed558ccdULL;
+      tally ^= tally >> 32;
+     }
+
+   return((unsigned long) tally);
+  }
+
 /*************************************************/
 /* HashFloat: Computes a hash value for a float. */
 /*************************************************/
@@ -768,15 +1042,15 @@ globle unsigned long HashInteger(
 #if WIN_MVC
    if (number < 0)
      { number = - number; }
-   tally = (((unsigned) number) % range);
+   tally = ((unsigned) number);
 #else
-   tally = (((unsigned) llabs(number)) % range);
+   tally = ((unsigned) llabs(number));
 #endif
 
    if (range == 0)
      { return tally; }
      
-   return(tally);
+   return(tally % range);
   }
 
 /****************************************/
@@ -850,6 +1124,164 @@ globle unsigned long HashBitMap(
    return(tally);
   }
 
+/**************************************************************/
+/* MixHashValue: Scrambles a hash value so that all of its    */
+/*   bits can be used to select a bucket in a hash table whose */
+/*   size is a power of two.                                   */
+/**************************************************************/
+globle unsigned long MixHashValue(
+  unsigned long hashValue)
+  {
+   unsigned long long theValue = hashValue;
+
+   theValue ^= theValue >> 33;
+   theValue *= 0xff51afd7ed558ccdULL;
+   theValue ^= theValue >> 33;
+
+   return((unsigned long) theValue);
+  }
+
+/*******************************************************/
+/* CreateLinearHashTable: Allocates a hash table which */
+/*   grows by linear hashing. The initial size must be */
+/*   a power of two.                                   */
+/*******************************************************/
+globle void **CreateLinearHashTable(
+  void *theEnv,
+  struct linearHashInfo *theInfo,
+  unsigned long initialSize)
+  {
+   void **theTable;
+
+   theInfo->size = initialSize;
+   theInfo->level = initialSize;
+   theInfo->count = 0;
+
+   theTable = (void **) gm3(theEnv,sizeof(void *) * (initialSize << 1));
+   if (theTable == NULL) EnvExitRouter(theEnv,EXIT_FAILURE);
+
+   memset(theTable,0,sizeof(void *) * (initialSize << 1));
+
+   return(theTable);
+  }
+
+/**************************************************************/
+/* ExpandLinearHashTable: Adds one bucket to a hash table     */
+/*   grown by linear hashing. The index of the bucket whose   */
+/*   entries must be redistributed is stored in splitBucket.  */
+/*   Storage is doubled once all of the buckets allocated for */
+/*   the current level are in use, so the entries themselves  */
+/*   are never rehashed all at once. Returns the (possibly    */
+/*   reallocated) table.                                      */
+/**************************************************************/
+globle void **ExpandLinearHashTable(
+  void *theEnv,
+  struct linearHashInfo *theInfo,
+  void **theTable,
+  unsigned long *splitBucket)
+  {
+   void **newTable;
+
+   *splitBucket = theInfo->size - theInfo->level;
+   theInfo->size++;
+
+   if (theInfo->size < (theInfo->level << 1))
+     { return(theTable); }
+
+   /*==================================================*/
+   /* Every bucket for this level has been split, so   */
+   /* allocate room for the next level. Only the       */
+   /* bucket pointers are copied.                      */
+   /*==================================================*/
+
+   newTable = (void **) gm3(theEnv,sizeof(void *) * (theInfo->level << 2));
+   if (newTable == NULL) EnvExitRouter(theEnv,EXIT_FAILURE);
+
+   memcpy(newTable,theTable,sizeof(void *) * theInfo->size);
+   memset(newTable + theInfo->size,0,sizeof(void *) * theInfo->size);
+
+#if ! RUN_TIME
+   rm3(theEnv,theTable,sizeof(void *) * (theInfo->level << 1));
+#endif
+
+   theInfo->level <<= 1;
+
+   return(newTable);
+  }
+
+/***********************************************************/
+/* ReturnLinearHashTable: Frees the storage for a hash     */
+/*   table grown by linear hashing. The entries themselves */
+/*   must be released by the caller.                       */
+/***********************************************************/
+globle void ReturnLinearHashTable(
+  void *theEnv,
+  struct linearHashInfo *theInfo,
+  void **theTable)
+  {
+   if (theTable == NULL) return;
+
+   rm3(theEnv,theTable,sizeof(void *) * (theInfo->level << 1));
+  }
+
+/**************************************************************/
+/* GrowAtomTable: Splits the next bucket of one of the atomic */
+/*   value tables. Entries are moved using the hash value     */
+/*   stored in their bucket field.                            */
+/**************************************************************/
+static GENERIC_HN **GrowAtomTable(
+  void *theEnv,
+  struct linearHashInfo *theInfo,
+  GENERIC_HN **theTable)
+  {
+   unsigned long splitBucket, newBucket;
+   GENERIC_HN *theNode, *nextNode, *lastNode[2];
+   GENERIC_HN **destination;
+
+   /*===================================================*/
+   /* While the bucket fields hold binary save indices, */
+   /* the entries can't be moved, so defer the split.   */
+   /*===================================================*/
+
+   if (SymbolData(theEnv)->AtomicValueIndicesSet)
+     { return(theTable); }
+
+   theTable = (GENERIC_HN **) ExpandLinearHashTable(theEnv,theInfo,(void **) theTable,&splitBucket);
+
+   /*=================================================*/
+   /* Divide the entries between the split bucket and */
+   /* its new sibling, preserving their order.        */
+   /*=================================================*/
+
+   theNode = theTable[splitBucket];
+   theTable[splitBucket] = NULL;
+   lastNode[0] = lastNode[1] = NULL;
+
+   while (theNode != NULL)
+     {
+      nextNode = theNode->next;
+      theNode->next = NULL;
+
+      newBucket = LinearHashIndex(theInfo,(unsigned long) theNode->bucket);
+
+      if (newBucket == splitBucket)
+        {
+         destination = (lastNode[0] == NULL) ? &theTable[newBucket] : &lastNode[0]->next;
+         lastNode[0] = theNode;
+        }
+      else
+        {
+         destination = (lastNode[1] == NULL) ? &theTable[newBucket] : &lastNode[1]->next;
+         lastNode[1] = theNode;
+        }
+
+      *destination = theNode;
+      theNode = nextNode;
+     }
+
+   return(theTable);
+  }
+
 /*****************************************************/
 /* DecrementSymbolCount: Decrements the count value  */
 /*   for a SymbolTable entry. Adds the symbol to the */
@@ -859,6 +1291,8 @@ globle void DecrementSymbolCount(
   void *theEnv,
   SYMBOL_HN *theValue)
   {
+   if (theValue->shared) return;
+
    if (theValue->count < 0)
      {
       SystemError(theEnv,"SYMBOL",3);
@@ -894,6 +1328,8 @@ globle void DecrementFloatCount(
   void *theEnv,
   FLOAT_HN *theValue)
   {
+   if (IsImmediateNumber(theValue) || theValue->shared) return;
+
    if (theValue->count <= 0)
      {
       SystemError(theEnv,"SYMBOL",5);
@@ -923,6 +1359,8 @@ globle void DecrementIntegerCount(
   void *theEnv,
   INTEGER_HN *theValue)
   {
+   if (IsImmediateNumber(theValue) || theValue->shared) return;
+
    if (theValue->count <= 0)
      {
       SystemError(theEnv,"SYMBOL",6);
@@ -952,6 +1390,8 @@ globle void DecrementBitMapCount(
   void *theEnv,
   BITMAP_HN *theValue)
   {
+   if (theValue->shared) return;
+
    if (theValue->count < 0)
      {
       SystemError(theEnv,"SYMBOL",7);
@@ -987,6 +1427,8 @@ globle void DecrementExternalAddressCount(
   void *theEnv,
   EXTERNAL_ADDRESS_HN *theValue)
   {
+   if (theValue->shared) return;
+
    if (theValue->count < 0)
      {
       SystemError(theEnv,"SYMBOL",9);
@@ -1022,18 +1464,21 @@ static void RemoveHashNode(
   void *theEnv,
   GENERIC_HN *theValue,
   GENERIC_HN **theTable,
+  struct linearHashInfo *theInfo,
   int size,
   int type)
   {
    GENERIC_HN *previousNode, *currentNode;
    struct externalAddressHashNode *theAddress;
+   unsigned long theBucket;
 
    /*=============================================*/
    /* Find the entry in the specified hash table. */
    /*=============================================*/
 
+   theBucket = LinearHashIndex(theInfo,(unsigned long) theValue->bucket);
    previousNode = NULL;
-   currentNode = theTable[theValue->bucket];
+   currentNode = theTable[theBucket];
 
    while (currentNode != theValue)
      {
@@ -1053,10 +1498,12 @@ static void RemoveHashNode(
    /*===========================================*/
 
    if (previousNode == NULL)
-     { theTable[theValue->bucket] = theValue->next; }
+     { theTable[theBucket] = theValue->next; }
    else
      { previousNode->next = currentNode->next; }
 
+   theInfo->count--;
+
    /*=================================================*/
    /* Symbol and bit map nodes have additional memory */
    /* use to store the character or bitmap string.    */
@@ -1148,15 +1595,63 @@ globle void RemoveEphemeralAtoms(
    if (! theGarbageFrame->dirty) return;
    
    RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralSymbolList,(GENERIC_HN **) SymbolData(theEnv)->SymbolTable,
-                            sizeof(SYMBOL_HN),SYMBOL,AVERAGE_STRING_SIZE);
+                            &SymbolData(theEnv)->SymbolTableInfo,sizeof(SYMBOL_HN),SYMBOL,AVERAGE_STRING_SIZE);
    RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralFloatList,(GENERIC_HN **) SymbolData(theEnv)->FloatTable,
-                            sizeof(FLOAT_HN),FLOAT,0);
+                            &SymbolData(theEnv)->FloatTableInfo,sizeof(FLOAT_HN),FLOAT,0);
    RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralIntegerList,(GENERIC_HN **) SymbolData(theEnv)->IntegerTable,
-                            sizeof(INTEGER_HN),INTEGER,0);
+                            &SymbolData(theEnv)->IntegerTableInfo,sizeof(INTEGER_HN),INTEGER,0);
    RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralBitMapList,(GENERIC_HN **) SymbolData(theEnv)->BitMapTable,
-                            sizeof(BITMAP_HN),BITMAPARRAY,AVERAGE_BITMAP_SIZE);
+                            &SymbolData(theEnv)->BitMapTableInfo,sizeof(BITMAP_HN),BITMAPARRAY,AVERAGE_BITMAP_SIZE);
    RemoveEphemeralHashNodes(theEnv,&theGarbageFrame->ephemeralExternalAddressList,(GENERIC_HN **) SymbolData(theEnv)->ExternalAddressTable,
-                            sizeof(EXTERNAL_ADDRESS_HN),EXTERNAL_ADDRESS,0);
+                            &SymbolData(theEnv)->ExternalAddressTableInfo,sizeof(EXTERNAL_ADDRESS_HN),EXTERNAL_ADDRESS,0);
+  }
+
+/****************************************************/
+/* FreezeAtomTables: Marks every atom of a frozen   */
+/*   environment as shared. Environments created    */
+/*   from it look up their atoms in these tables    */
+/*   first and leave the counts of shared atoms     */
+/*   alone, so the tables must not change anymore.  */
+/****************************************************/
+globle void FreezeAtomTables(
+  void *theEnv)
+  {
+   unsigned long i;
+   SYMBOL_HN *shPtr;
+   FLOAT_HN *fhPtr;
+   INTEGER_HN *ihPtr;
+   BITMAP_HN *bmhPtr;
+   EXTERNAL_ADDRESS_HN *eahPtr;
+
+   for (i = 0; i < SymbolData(theEnv)->SymbolTableInfo.size; i++)
+     {
+      for (shPtr = SymbolData(theEnv)->SymbolTable[i]; shPtr != NULL; shPtr = shPtr->next)
+        { shPtr->shared = TRUE; }
+     }
+
+   for (i = 0; i < SymbolData(theEnv)->FloatTableInfo.size; i++)
+     {
+      for (fhPtr = SymbolData(theEnv)->FloatTable[i]; fhPtr != NULL; fhPtr = fhPtr->next)
+        { fhPtr->shared = TRUE; }
+     }
+
+   for (i = 0; i < SymbolData(theEnv)->IntegerTableInfo.size; i++)
+     {
+      for (ihPtr = SymbolData(theEnv)->IntegerTable[i]; ihPtr != NULL; ihPtr = ihPtr->next)
+        { ihPtr->shared = TRUE; }
+     }
+
+   for (i = 0; i < SymbolData(theEnv)->BitMapTableInfo.size; i++)
+     {
+      for (bmhPtr = SymbolData(theEnv)->BitMapTable[i]; bmhPtr != NULL; bmhPtr = bmhPtr->next)
+        { bmhPtr->shared = TRUE; }
+     }
+
+   for (i = 0; i < SymbolData(theEnv)->ExternalAddressTableInfo.size; i++)
+     {
+      for (eahPtr = SymbolData(theEnv)->ExternalAddressTable[i]; eahPtr != NULL; eahPtr = eahPtr->next)
+        { eahPtr->shared = TRUE; }
+     }
   }
 
 /**********************************************************/
@@ -1202,7 +1697,7 @@ globle void EphemerateValue(
       case INSTANCE_NAME:
 #endif
         theSymbol = (SYMBOL_HN *) theValue;
-        if (theSymbol->markedEphemeral) return;
+        if (theSymbol->markedEphemeral || theSymbol->shared) return;
         AddEphemeralHashNode(theEnv,(GENERIC_HN *) theValue,
                              &UtilityData(theEnv)->CurrentGarbageFrame->ephemeralSymbolList,
                              sizeof(SYMBOL_HN),AVERAGE_STRING_SIZE,FALSE);
@@ -1211,7 +1706,8 @@ globle void EphemerateValue(
 
       case FLOAT:
         theFloat = (FLOAT_HN *) theValue;
-        if (theFloat->markedEphemeral) return;
+        if (IsImmediateNumber(theFloat)) return;
+        if (theFloat->markedEphemeral || theFloat->shared) return;
         AddEphemeralHashNode(theEnv,(GENERIC_HN *) theValue,
                              &UtilityData(theEnv)->CurrentGarbageFrame->ephemeralFloatList,
                              sizeof(FLOAT_HN),0,FALSE);
@@ -1220,7 +1716,8 @@ globle void EphemerateValue(
 
       case INTEGER:
         theInteger = (INTEGER_HN *) theValue;
-        if (theInteger->markedEphemeral) return;
+        if (IsImmediateNumber(theInteger)) return;
+        if (theInteger->markedEphemeral || theInteger->shared) return;
         AddEphemeralHashNode(theEnv,(GENERIC_HN *) theValue,
                              &UtilityData(theEnv)->CurrentGarbageFrame->ephemeralIntegerList,
                              sizeof(INTEGER_HN),0,FALSE);
@@ -1229,7 +1726,7 @@ globle void EphemerateValue(
 
       case EXTERNAL_ADDRESS:
         theExternalAddress = (EXTERNAL_ADDRESS_HN *) theValue;
-        if (theExternalAddress->markedEphemeral) return;
+        if (theExternalAddress->markedEphemeral || theExternalAddress->shared) return;
         AddEphemeralHashNode(theEnv,(GENERIC_HN *) theValue,
                              &UtilityData(theEnv)->CurrentGarbageFrame->ephemeralExternalAddressList,
                              sizeof(EXTERNAL_ADDRESS_HN),sizeof(long),FALSE);
@@ -1258,6 +1755,7 @@ static void RemoveEphemeralHashNodes(
   void *theEnv,
   struct ephemeron **theEphemeralList,
   GENERIC_HN **theTable,
+  struct linearHashInfo *theInfo,
   int hashNodeSize,
   int hashNodeType,
   int averageContentsSize)
@@ -1284,7 +1782,7 @@ static void RemoveEphemeralHashNodes(
 
       if (edPtr->associatedValue->count == 0)
         {
-         RemoveHashNode(theEnv,edPtr->associatedValue,theTable,hashNodeSize,hashNodeType);
+         RemoveHashNode(theEnv,edPtr->associatedValue,theTable,theInfo,hashNodeSize,hashNodeType);
          rtn_struct(theEnv,ephemeron,edPtr);
          if (lastPtr == NULL) *theEphemeralList = nextPtr;
          else lastPtr->next = nextPtr;
@@ -1411,6 +1909,152 @@ globle void SetExternalAddressTable(
    SymbolData(theEnv)->ExternalAddressTable = value;
   }
 
+/*************************************************************/
+/* GetSymbolTableSize: Returns the number of buckets in use */
+/*   in the SymbolTable.                                     */
+/*************************************************************/
+globle unsigned long GetSymbolTableSize(
+  void *theEnv)
+  {
+   return(SymbolData(theEnv)->SymbolTableInfo.size);
+  }
+
+/***********************************************************/
+/* GetFloatTableSize: Returns the number of buckets in use */
+/*   in the FloatTable.                                    */
+/***********************************************************/
+globle unsigned long GetFloatTableSize(
+  void *theEnv)
+  {
+   return(SymbolData(theEnv)->FloatTableInfo.size);
+  }
+
+/*************************************************************/
+/* GetIntegerTableSize: Returns the number of buckets in use */
+/*   in the IntegerTable.                                    */
+/*************************************************************/
+globle unsigned long GetIntegerTableSize(
+  void *theEnv)
+  {
+   return(SymbolData(theEnv)->IntegerTableInfo.size);
+  }
+
+/************************************************************/
+/* GetBitMapTableSize: Returns the number of buckets in use */
+/*   in the BitMapTable.                                    */
+/************************************************************/
+globle unsigned long GetBitMapTableSize(
+  void *theEnv)
+  {
+   return(SymbolData(theEnv)->BitMapTableInfo.size);
+  }
+
+/*************************************************************/
+/* SetAtomTableSizes: Redistributes the entries of the       */
+/*   symbol, float, integer, and bitmap tables over the      */
+/*   specified number of buckets. Used by the constructs-to-c */
+/*   command to write the tables in a known layout.           */
+/*************************************************************/
+globle void SetAtomTableSizes(
+  void *theEnv,
+  unsigned long symbolSize,
+  unsigned long floatSize,
+  unsigned long integerSize,
+  unsigned long bitMapSize)
+  {
+   SymbolData(theEnv)->SymbolTable = (SYMBOL_HN **)
+      ResizeAtomTable(theEnv,&SymbolData(theEnv)->SymbolTableInfo,
+                      (GENERIC_HN **) SymbolData(theEnv)->SymbolTable,symbolSize);
+   SymbolData(theEnv)->FloatTable = (FLOAT_HN **)
+      ResizeAtomTable(theEnv,&SymbolData(theEnv)->FloatTableInfo,
+                      (GENERIC_HN **) SymbolData(theEnv)->FloatTable,floatSize);
+   SymbolData(theEnv)->IntegerTable = (INTEGER_HN **)
+      ResizeAtomTable(theEnv,&SymbolData(theEnv)->IntegerTableInfo,
+                      (GENERIC_HN **) SymbolData(theEnv)->IntegerTable,integerSize);
+   SymbolData(theEnv)->BitMapTable = (BITMAP_HN **)
+      ResizeAtomTable(theEnv,&SymbolData(theEnv)->BitMapTableInfo,
+                      (GENERIC_HN **) SymbolData(theEnv)->BitMapTable,bitMapSize);
+  }
+
+/*************************************************************/
+/* ResizeAtomTable: Moves the entries of an atomic value     */
+/*   table into a new table with the specified number of     */
+/*   buckets. The level is the largest power of two not      */
+/*   greater than the new size.                              */
+/*************************************************************/
+static GENERIC_HN **ResizeAtomTable(
+  void *theEnv,
+  struct linearHashInfo *theInfo,
+  GENERIC_HN **theTable,
+  unsigned long newSize)
+  {
+   struct linearHashInfo newInfo;
+   GENERIC_HN **newTable;
+   GENERIC_HN *theNode, *nextNode;
+   unsigned long i, newBucket;
+
+   newInfo.level = 1;
+   while ((newInfo.level << 1) <= newSize)
+     { newInfo.level <<= 1; }
+
+   newTable = (GENERIC_HN **) CreateLinearHashTable(theEnv,&newInfo,newInfo.level);
+   newInfo.size = newSize;
+   newInfo.count = theInfo->count;
+
+   for (i = 0; i < theInfo->size; i++)
+     {
+      for (theNode = theTable[i]; theNode != NULL; theNode = nextNode)
+        {
+         nextNode = theNode->next;
+         newBucket = LinearHashIndex(&newInfo,(unsigned long) theNode->bucket);
+         theNode->next = newTable[newBucket];
+         newTable[newBucket] = theNode;
+        }
+     }
+
+#if ! RUN_TIME
+   ReturnLinearHashTable(theEnv,theInfo,(void **) theTable);
+#endif
+
+   *theInfo = newInfo;
+
+   return(newTable);
+  }
+
+#if RUN_TIME
+
+/*************************************************************/
+/* LoadCompiledAtomTable: Installs an atomic value table     */
+/*   written by the constructs-to-c command with its initial */
+/*   number of buckets, then grows it to fit its entries.    */
+/*************************************************************/
+static GENERIC_HN **LoadCompiledAtomTable(
+  void *theEnv,
+  struct linearHashInfo *theInfo,
+  GENERIC_HN **theTable,
+  unsigned long initialSize)
+  {
+   GENERIC_HN *theNode;
+   unsigned long i;
+
+   theInfo->size = initialSize;
+   theInfo->level = initialSize;
+   theInfo->count = 0;
+
+   for (i = 0; i < initialSize; i++)
+     {
+      for (theNode = theTable[i]; theNode != NULL; theNode = theNode->next)
+        { theInfo->count++; }
+     }
+
+   while (theInfo->count > theInfo->size)
+     { theTable = GrowAtomTable(theEnv,theInfo,theTable); }
+
+   return(theTable);
+  }
+
+#endif /* RUN_TIME */
+
 /******************************************************/
 /* RefreshSpecialSymbols: Resets the values of the    */
 /*   TrueSymbol, FalseSymbol, Zero, PositiveInfinity, */
@@ -1533,7 +2177,7 @@ globle SYMBOL_HN *GetNextSymbolMatch(
 
    else
      {
-      i = prevSymbol->bucket;
+      i = LinearHashIndex(&SymbolData(theEnv)->SymbolTableInfo,(unsigned long) prevSymbol->bucket);
       hashPtr = prevSymbol->next;
      }
 
@@ -1614,7 +2258,7 @@ globle SYMBOL_HN *GetNextSymbolMatch(
       /* Move on to the next bucket in the symbol table. */
       /*=================================================*/
 
-      if (++i >= SYMBOL_HASH_SIZE) flag = FALSE;
+      if (++i >= SymbolData(theEnv)->SymbolTableInfo.size) flag = FALSE;
       else hashPtr = SymbolData(theEnv)->SymbolTable[i];
      }
 
@@ -1679,6 +2323,8 @@ globle void SetAtomicValueIndices(
    INTEGER_HN *integerPtr, **integerArray;
    BITMAP_HN *bitMapPtr, **bitMapArray;
 
+   SymbolData(theEnv)->AtomicValueIndicesSet = TRUE;
+
    /*===================================*/
    /* Set indices for the symbol table. */
    /*===================================*/
@@ -1686,7 +2332,7 @@ globle void SetAtomicValueIndices(
    count = 0;
    symbolArray = GetSymbolTable(theEnv);
 
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->SymbolTableInfo.size; i++)
      {
       for (symbolPtr = symbolArray[i];
            symbolPtr != NULL;
@@ -1708,7 +2354,7 @@ globle void SetAtomicValueIndices(
    count = 0;
    floatArray = GetFloatTable(theEnv);
 
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->FloatTableInfo.size; i++)
      {
       for (floatPtr = floatArray[i];
            floatPtr != NULL;
@@ -1730,7 +2376,7 @@ globle void SetAtomicValueIndices(
    count = 0;
    integerArray = GetIntegerTable(theEnv);
 
-   for (i = 0; i < INTEGER_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->IntegerTableInfo.size; i++)
      {
       for (integerPtr = integerArray[i];
            integerPtr != NULL;
@@ -1752,7 +2398,7 @@ globle void SetAtomicValueIndices(
    count = 0;
    bitMapArray = GetBitMapTable(theEnv);
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->BitMapTableInfo.size; i++)
      {
       for (bitMapPtr = bitMapArray[i];
            bitMapPtr != NULL;
@@ -1770,7 +2416,7 @@ globle void SetAtomicValueIndices(
 
 /***********************************************************************/
 /* RestoreAtomicValueBuckets: Restores the bucket values of hash table */
-/*   entries to the appropriate values. Normally called to undo the    */
+/*   entries to their hash values. Normally called to undo the         */
 /*   effects of a call to the SetAtomicValueIndices function.          */
 /***********************************************************************/
 globle void RestoreAtomicValueBuckets(
@@ -1788,12 +2434,12 @@ globle void RestoreAtomicValueBuckets(
 
    symbolArray = GetSymbolTable(theEnv);
 
-   for (i = 0; i < SYMBOL_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->SymbolTableInfo.size; i++)
      {
       for (symbolPtr = symbolArray[i];
            symbolPtr != NULL;
            symbolPtr = symbolPtr->next)
-        { symbolPtr->bucket = i; }
+        { symbolPtr->bucket = AtomHashValue(HashSymbol(symbolPtr->contents,0)); }
      }
 
    /*===============================================*/
@@ -1802,12 +2448,12 @@ globle void RestoreAtomicValueBuckets(
 
    floatArray = GetFloatTable(theEnv);
 
-   for (i = 0; i < FLOAT_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->FloatTableInfo.size; i++)
      {
       for (floatPtr = floatArray[i];
            floatPtr != NULL;
            floatPtr = floatPtr->next)
-        { floatPtr->bucket = i; }
+        { floatPtr->bucket = AtomHashValue(HashFloat(floatPtr->contents,0)); }
      }
 
    /*=================================================*/
@@ -1816,12 +2462,12 @@ globle void RestoreAtomicValueBuckets(
 
    integerArray = GetIntegerTable(theEnv);
 
-   for (i = 0; i < INTEGER_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->IntegerTableInfo.size; i++)
      {
       for (integerPtr = integerArray[i];
            integerPtr != NULL;
            integerPtr = integerPtr->next)
-        { integerPtr->bucket = i; }
+        { integerPtr->bucket = AtomHashValue(HashInteger(integerPtr->contents,0)); }
      }
 
    /*================================================*/
@@ -1830,13 +2476,15 @@ globle void RestoreAtomicValueBuckets(
 
    bitMapArray = GetBitMapTable(theEnv);
 
-   for (i = 0; i < BITMAP_HASH_SIZE; i++)
+   for (i = 0; i < SymbolData(theEnv)->BitMapTableInfo.size; i++)
      {
       for (bitMapPtr = bitMapArray[i];
            bitMapPtr != NULL;
            bitMapPtr = bitMapPtr->next)
-        { bitMapPtr->bucket = i; }
+        { bitMapPtr->bucket = AtomHashValue(HashBitMap(bitMapPtr->contents,0,bitMapPtr->size)); }
      }
+
+   SymbolData(theEnv)->AtomicValueIndicesSet = FALSE;
   }
 
 #endif /* BLOAD_AND_BSAVE || CONSTRUCT_COMPILER || BSAVE_INSTANCES */
@@ -79,26 +79,57 @@
 #include "multifld.h"
 #endif
 
+/*=================================================*/
+/* Initial number of buckets in the atom tables.   */
+/* The tables grow as values are added, so these   */
+/* must be powers of two.                          */
+/*=================================================*/
+
 #ifndef SYMBOL_HASH_SIZE
-#define SYMBOL_HASH_SIZE       63559L
+#define SYMBOL_HASH_SIZE        256L
 #endif
 
 #ifndef FLOAT_HASH_SIZE
-#define FLOAT_HASH_SIZE         8191
+#define FLOAT_HASH_SIZE          32
 #endif
 
 #ifndef INTEGER_HASH_SIZE
-#define INTEGER_HASH_SIZE       8191
+#define INTEGER_HASH_SIZE        64
 #endif
 
 #ifndef BITMAP_HASH_SIZE
-#define BITMAP_HASH_SIZE        8191
+#define BITMAP_HASH_SIZE         32
 #endif
 
 #ifndef EXTERNAL_ADDRESS_HASH_SIZE
-#define EXTERNAL_ADDRESS_HASH_SIZE        8191
+#define EXTERNAL_ADDRESS_HASH_SIZE         16
 #endif
 
+#define MAX_ATOM_HASH_VALUE     0x0FFFFFFFUL
+
+#define AtomHashValue(tally) (MixHashValue(tally) & MAX_ATOM_HASH_VALUE)
+
+/************************************************************/
+/* linearHashInfo STRUCTURE: Describes a hash table which   */
+/*   grows by linear hashing, one bucket split at a time.   */
+/*   The first size buckets are in use, where level <=      */
+/*   size < 2 * level, and room is allocated for 2 * level  */
+/*   buckets. Buckets below size - level have already been  */
+/*   split and are addressed with one more bit of the hash  */
+/*   value. The table grows when count exceeds size.        */
+/************************************************************/
+struct linearHashInfo
+  {
+   unsigned long size;
+   unsigned long level;
+   unsigned long count;
+  };
+
+#define LinearHashIndex(theInfo,hashValue) \
+   ((((hashValue) & ((theInfo)->level - 1)) < ((theInfo)->size - (theInfo)->level)) ? \
+    ((hashValue) & (((theInfo)->level << 1) - 1)) : \
+    ((hashValue) & ((theInfo)->level - 1)))
+
 /************************************************************/
 /* symbolHashNode STRUCTURE:                                */
 /************************************************************/
@@ -109,7 +140,8 @@ struct symbolHashNode
    unsigned int permanent : 1;
    unsigned int markedEphemeral : 1;
    unsigned int neededSymbol : 1;
-   unsigned int bucket : 29;
+   unsigned int shared : 1;
+   unsigned int bucket : 28;
    const char *contents;
   };
 
@@ -123,7 +155,8 @@ struct floatHashNode
    unsigned int permanent : 1;
    unsigned int markedEphemeral : 1;
    unsigned int neededFloat : 1;
-   unsigned int bucket : 29;
+   unsigned int shared : 1;
+   unsigned int bucket : 28;
    double contents;
   };
 
@@ -137,7 +170,8 @@ struct integerHashNode
    unsigned int permanent : 1;
    unsigned int markedEphemeral : 1;
    unsigned int neededInteger : 1;
-   unsigned int bucket : 29;
+   unsigned int shared : 1;
+   unsigned int bucket : 28;
    long long contents;
   };
 
@@ -151,7 +185,8 @@ struct bitMapHashNode
    unsigned int permanent : 1;
    unsigned int markedEphemeral : 1;
    unsigned int neededBitMap : 1;
-   unsigned int bucket : 29;
+   unsigned int shared : 1;
+   unsigned int bucket : 28;
    const char *contents;
    unsigned short size;
   };
@@ -166,7 +201,8 @@ struct externalAddressHashNode
    unsigned int permanent : 1;
    unsigned int markedEphemeral : 1;
    unsigned int neededPointer : 1;
-   unsigned int bucket : 29;
+   unsigned int shared : 1;
+   unsigned int bucket : 28;
    void *externalAddress;
    unsigned short type;
   };
@@ -181,7 +217,8 @@ struct genericHashNode
    unsigned int permanent : 1;
    unsigned int markedEphemeral : 1;
    unsigned int needed : 1;
-   unsigned int bucket : 29;
+   unsigned int shared : 1;
+   unsigned int bucket : 28;
   };
 
 typedef struct symbolHashNode SYMBOL_HN;
@@ -217,27 +254,104 @@ struct symbolMatch
    struct symbolMatch *next;
   };
 
-#define ValueToString(target) (((struct symbolHashNode *) (target))->contents)
+/*==================================================*/
+/* With IMMEDIATE_NUMBERS, integers and floats are  */
+/* normally carried in the value pointer itself and */
+/* tagged by its low bit, which is never set in the */
+/* address of a hash node. An integer is immediate  */
+/* if it fits in 63 bits and a float if its binary  */
+/* exponent is within -511 to 511. Other numbers    */
+/* (large integers, zero, infinities, NaN and very  */
+/* small or large floats) still live in the atom    */
+/* tables, so every number has exactly one value    */
+/* pointer and numbers still compare by pointer.    */
+/*==================================================*/
+
+#if IMMEDIATE_NUMBERS
+
+union immediateFloat
+  {
+   double value;
+   unsigned long long bits;
+  };
+
+#define IsImmediateNumber(target) ((((size_t) (target)) & 1) != 0)
+
+#define LongFitsImmediate(number) \
+   (((number) >= -(1LL << 62)) && ((number) < (1LL << 62)))
+#define LongToImmediate(number) \
+   ((void *) (size_t) ((((unsigned long long) (number)) << 1) | 1))
+#define ImmediateToLong(target) (((long long) (size_t) (target)) >> 1)
+
+#define FloatBitsFitImmediate(bits) (((((bits) >> 62) ^ ((bits) >> 61)) & 1) != 0)
+#define FloatBitsToImmediate(bits) \
+   ((void *) (size_t) (((bits) & 0xC000000000000000ULL) | \
+                       (((bits) & 0x1FFFFFFFFFFFFFFFULL) << 1) | 1))
+#define ImmediateToFloatBits(target) \
+   ((((unsigned long long) (size_t) (target)) & 0xC000000000000000ULL) | \
+    ((~((unsigned long long) (size_t) (target)) & 0x4000000000000000ULL) >> 1) | \
+    ((((unsigned long long) (size_t) (target)) >> 1) & 0x1FFFFFFFFFFFFFFFULL))
+
+static inline double ImmediateToDouble(
+  void *target)
+  {
+   union immediateFloat theFloat;
+
+   theFloat.bits = ImmediateToFloatBits(target);
+   return(theFloat.value);
+  }
+
+#define ValueToDouble(target) \
+   (IsImmediateNumber(target) ? ImmediateToDouble(target) : \
+                                ((struct floatHashNode *) (target))->contents)
+#define ValueToLong(target) \
+   (IsImmediateNumber(target) ? ImmediateToLong(target) : \
+                                ((struct integerHashNode *) (target))->contents)
+#define NumberHashValue(target) \
+   (IsImmediateNumber(target) ? (unsigned long) (((size_t) (target)) >> 1) : \
+                                (unsigned long) ((GENERIC_HN *) (target))->bucket)
+
+#else
+
+#define IsImmediateNumber(target) 0
 #define ValueToDouble(target) (((struct floatHashNode *) (target))->contents)
 #define ValueToLong(target) (((struct integerHashNode *) (target))->contents)
-#define ValueToInteger(target) ((int) (((struct integerHashNode *) (target))->contents))
+#define NumberHashValue(target) ((unsigned long) ((GENERIC_HN *) (target))->bucket)
+
+#endif
+
+#define ValueToString(target) (((struct symbolHashNode *) (target))->contents)
+#define SymbolHashValue(target) ((unsigned long) ((struct symbolHashNode *) (target))->bucket)
+#define ValueToInteger(target) ((int) ValueToLong(target))
 #define ValueToBitMap(target) ((void *) ((struct bitMapHashNode *) (target))->contents)
 #define ValueToPointer(target) ((void *) target)
 #define ValueToExternalAddress(target) ((void *) ((struct externalAddressHashNode *) (target))->externalAddress)
 
 #define EnvValueToString(theEnv,target) (((struct symbolHashNode *) (target))->contents)
-#define EnvValueToDouble(theEnv,target) (((struct floatHashNode *) (target))->contents)
-#define EnvValueToLong(theEnv,target) (((struct integerHashNode *) (target))->contents)
-#define EnvValueToInteger(theEnv,target) ((int) (((struct integerHashNode *) (target))->contents))
+#define EnvValueToDouble(theEnv,target) ValueToDouble(target)
+#define EnvValueToLong(theEnv,target) ValueToLong(target)
+#define EnvValueToInteger(theEnv,target) ((int) ValueToLong(target))
 #define EnvValueToBitMap(theEnv,target) ((void *) ((struct bitMapHashNode *) (target))->contents)
 #define EnvValueToPointer(theEnv,target) ((void *) target)
 #define EnvValueToExternalAddress(theEnv,target) ((void *) ((struct externalAddressHashNode *) (target))->externalAddress)
 
-#define IncrementSymbolCount(theValue) (((SYMBOL_HN *) theValue)->count++)
-#define IncrementFloatCount(theValue) (((FLOAT_HN *) theValue)->count++)
-#define IncrementIntegerCount(theValue) (((INTEGER_HN *) theValue)->count++)
-#define IncrementBitMapCount(theValue) (((BITMAP_HN *) theValue)->count++)
-#define IncrementExternalAddressCount(theValue) (((EXTERNAL_ADDRESS_HN *) theValue)->count++)
+/*==================================================*/
+/* Atoms owned by a frozen environment are shared   */
+/* with the environments created from it and their  */
+/* counts are left alone (see FreezeAtomTables).    */
+/* Immediate numbers have no count at all.          */
+/*==================================================*/
+
+#define IncrementSymbolCount(theValue) \
+   (((SYMBOL_HN *) theValue)->shared ? 0 : ((SYMBOL_HN *) theValue)->count++)
+#define IncrementFloatCount(theValue) \
+   ((IsImmediateNumber(theValue) || ((FLOAT_HN *) theValue)->shared) ? 0 : ((FLOAT_HN *) theValue)->count++)
+#define IncrementIntegerCount(theValue) \
+   ((IsImmediateNumber(theValue) || ((INTEGER_HN *) theValue)->shared) ? 0 : ((INTEGER_HN *) theValue)->count++)
+#define IncrementBitMapCount(theValue) \
+   (((BITMAP_HN *) theValue)->shared ? 0 : ((BITMAP_HN *) theValue)->count++)
+#define IncrementExternalAddressCount(theValue) \
+   (((EXTERNAL_ADDRESS_HN *) theValue)->shared ? 0 : ((EXTERNAL_ADDRESS_HN *) theValue)->count++)
 
 /*==================*/
 /* ENVIRONMENT DATA */
@@ -257,6 +371,13 @@ struct symbolData
    INTEGER_HN **IntegerTable;
    BITMAP_HN **BitMapTable;
    EXTERNAL_ADDRESS_HN **ExternalAddressTable;
+   struct linearHashInfo SymbolTableInfo;
+   struct linearHashInfo FloatTableInfo;
+   struct linearHashInfo IntegerTableInfo;
+   struct linearHashInfo BitMapTableInfo;
+   struct linearHashInfo ExternalAddressTableInfo;
+   intBool AtomicValueIndicesSet;
+   struct symbolData *SharedAtomTables;
 #if BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE || BLOAD_INSTANCES || BSAVE_INSTANCES
    long NumberOfSymbols;
    long NumberOfFloats;
@@ -275,7 +396,8 @@ struct symbolData
 
    LOCALE void                           InitializeAtomTables(void *,struct symbolHashNode **,struct floatHashNode **,
                                                               struct integerHashNode **,struct bitMapHashNode **,
-                                                              struct externalAddressHashNode **);
+                                                              struct externalAddressHashNode **,void *);
+   LOCALE void                           FreezeAtomTables(void *);
    LOCALE void                          *EnvAddSymbol(void *,const char *);
    LOCALE SYMBOL_HN                     *FindSymbolHN(void *,const char *);
    LOCALE void                          *EnvAddDouble(void *,double);
@@ -283,11 +405,18 @@ struct symbolData
    LOCALE void                          *EnvAddBitMap(void *,void *,unsigned);
    LOCALE void                          *EnvAddExternalAddress(void *,void *,unsigned);
    LOCALE INTEGER_HN                    *FindLongHN(void *,long long);
+   LOCALE FLOAT_HN                      *BoxedFloat(void *,void *);
+   LOCALE INTEGER_HN                    *BoxedInteger(void *,void *);
    LOCALE unsigned long                  HashSymbol(const char *,unsigned long);
+   LOCALE unsigned long                  HashCharacters(const char *,size_t);
    LOCALE unsigned long                  HashFloat(double,unsigned long);
    LOCALE unsigned long                  HashInteger(long long,unsigned long);
    LOCALE unsigned long                  HashBitMap(const char *,unsigned long,unsigned);
    LOCALE unsigned long                  HashExternalAddress(void *,unsigned long);
+   LOCALE unsigned long                  MixHashValue(unsigned long);
+   LOCALE void                         **CreateLinearHashTable(void *,struct linearHashInfo *,unsigned long);
+   LOCALE void                         **ExpandLinearHashTable(void *,struct linearHashInfo *,void **,unsigned long *);
+   LOCALE void                           ReturnLinearHashTable(void *,struct linearHashInfo *,void **);
    LOCALE void                           DecrementSymbolCount(void *,struct symbolHashNode *);
    LOCALE void                           DecrementFloatCount(void *,struct floatHashNode *);
    LOCALE void                           DecrementIntegerCount(void *,struct integerHashNode *);
@@ -305,6 +434,11 @@ struct symbolData
    LOCALE struct externalAddressHashNode        
                                        **GetExternalAddressTable(void *);
    LOCALE void                           SetExternalAddressTable(void *,struct externalAddressHashNode **);
+   LOCALE unsigned long                  GetSymbolTableSize(void *);
+   LOCALE unsigned long                  GetFloatTableSize(void *);
+   LOCALE unsigned long                  GetIntegerTableSize(void *);
+   LOCALE unsigned long                  GetBitMapTableSize(void *);
+   LOCALE void                           SetAtomTableSizes(void *,unsigned long,unsigned long,unsigned long,unsigned long);
    LOCALE void                           RefreshSpecialSymbols(void *);
    LOCALE struct symbolMatch            *FindSymbolMatches(void *,const char *,unsigned *,size_t *);
    LOCALE void                           ReturnSymbolMatches(void *,struct symbolMatch *);
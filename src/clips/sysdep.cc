@@ -241,6 +241,10 @@ struct systemDependentData
 #if (! WIN_MVC)
    FILE *BinaryFP;
 #endif
+   const char *BinaryImage;
+   size_t BinaryImageSize;
+   size_t BinaryImageOffset;
+   int BinaryOverrun;
    int (*BeforeOpenFunction)(void *);
    int (*AfterOpenFunction)(void *);
    jmp_buf *jmpBuffer;
@@ -305,7 +309,8 @@ globle void EnvInitializeEnvironment(
   struct floatHashNode **floatTable,
   struct integerHashNode **integerTable,
   struct bitMapHashNode **bitmapTable,
-  struct externalAddressHashNode **externalAddressTable)
+  struct externalAddressHashNode **externalAddressTable,
+  void *sharedEnv)
   {
    struct environmentData *theEnvironment = (struct environmentData *) vtheEnvironment;
    
@@ -346,7 +351,7 @@ globle void EnvInitializeEnvironment(
    /* Initialize the hash tables for atomic values. */
    /*===============================================*/
 
-   InitializeAtomTables(theEnvironment,symbolTable,floatTable,integerTable,bitmapTable,externalAddressTable);
+   InitializeAtomTables(theEnvironment,symbolTable,floatTable,integerTable,bitmapTable,externalAddressTable,sharedEnv);
 
    /*=========================================*/
    /* Initialize file and string I/O routers. */
@@ -1311,6 +1316,8 @@ globle int GenOpenReadBinary(
   const char *funcName,
   const char *fileName)
   {
+   SystemDependentData(theEnv)->BinaryOverrun = FALSE;
+
    if (SystemDependentData(theEnv)->BeforeOpenFunction != NULL)
      { (*SystemDependentData(theEnv)->BeforeOpenFunction)(theEnv); }
 
@@ -1343,35 +1350,94 @@ globle int GenOpenReadBinary(
    return(TRUE);
   }
 
+/*****************************************************/
+/* GenOpenReadBinaryImage: Makes the binary routines */
+/*   below read from an image in memory instead of a */
+/*   file until GenCloseBinary is called.            */
+/*****************************************************/
+globle void GenOpenReadBinaryImage(
+  void *theEnv,
+  const void *image,
+  size_t size)
+  {
+   SystemDependentData(theEnv)->BinaryImage = (const char *) image;
+   SystemDependentData(theEnv)->BinaryImageSize = size;
+   SystemDependentData(theEnv)->BinaryImageOffset = 0;
+   SystemDependentData(theEnv)->BinaryOverrun = FALSE;
+  }
+
 /***********************************************/
 /* GenReadBinary: Generic and machine specific */
-/*   code for reading from a file.             */
+/*   code for reading from a file. A read past */
+/*   the end of the file or image is recorded  */
+/*   (see GenBinaryOverrun).                   */
 /***********************************************/
 globle void GenReadBinary(
   void *theEnv,
   void *dataPtr,
   size_t size)
   {
+   if (SystemDependentData(theEnv)->BinaryImage != NULL)
+     {
+      size_t offset, available;
+
+      /*=============================================*/
+      /* Reads past the end of the image are zeroed, */
+      /* so that the caller never sees stale data,   */
+      /* and recorded.                               */
+      /*=============================================*/
+
+      offset = SystemDependentData(theEnv)->BinaryImageOffset;
+      available = (offset < SystemDependentData(theEnv)->BinaryImageSize) ?
+                  SystemDependentData(theEnv)->BinaryImageSize - offset : 0;
+      if (size > available)
+        {
+         memset((char *) dataPtr + available,0,size - available);
+         size = available;
+         SystemDependentData(theEnv)->BinaryOverrun = TRUE;
+        }
+      memcpy(dataPtr,SystemDependentData(theEnv)->BinaryImage + offset,size);
+      SystemDependentData(theEnv)->BinaryImageOffset = offset + size;
+      return;
+     }
+
 #if WIN_MVC
    char *tempPtr;
 
    tempPtr = (char *) dataPtr;
    while (size > INT_MAX)
      {
-      _read(SystemDependentData(theEnv)->BinaryFileHandle,tempPtr,INT_MAX);
+      if (_read(SystemDependentData(theEnv)->BinaryFileHandle,tempPtr,INT_MAX) != INT_MAX)
+        { SystemDependentData(theEnv)->BinaryOverrun = TRUE; }
       size -= INT_MAX;
       tempPtr = tempPtr + INT_MAX;
      }
 
    if (size > 0) 
-     { _read(SystemDependentData(theEnv)->BinaryFileHandle,tempPtr,(unsigned int) size); }
+     {
+      if (_read(SystemDependentData(theEnv)->BinaryFileHandle,tempPtr,(unsigned int) size) != (int) size)
+        { SystemDependentData(theEnv)->BinaryOverrun = TRUE; }
+     }
 #endif
 
 #if (! WIN_MVC)
-   fread(dataPtr,size,1,SystemDependentData(theEnv)->BinaryFP); 
+   if ((size > 0) &&
+       (fread(dataPtr,size,1,SystemDependentData(theEnv)->BinaryFP) != 1))
+     { SystemDependentData(theEnv)->BinaryOverrun = TRUE; }
 #endif
   }
 
+/***************************************************/
+/* GenBinaryOverrun: Returns TRUE if a read since  */
+/*   the binary file or image was opened went past */
+/*   its end, as when the image is truncated.      */
+/***************************************************/
+globle intBool GenBinaryOverrun(
+  void *theEnv)
+  {
+   return(SystemDependentData(theEnv)->BinaryOverrun);
+  }
+
 /***************************************************/
 /* GetSeekCurBinary:  Generic and machine specific */
 /*   code for seeking a position in a file.        */
@@ -1380,12 +1446,32 @@ globle void GetSeekCurBinary(
   void *theEnv,
   long offset)
   {
+   if (SystemDependentData(theEnv)->BinaryImage != NULL)
+     {
+      /*============================================*/
+      /* A seek before the start of the image, from */
+      /* a size read past its end, is an overrun.   */
+      /*============================================*/
+
+      if ((offset < 0) &&
+          ((size_t) -offset > SystemDependentData(theEnv)->BinaryImageOffset))
+        {
+         SystemDependentData(theEnv)->BinaryImageOffset = SystemDependentData(theEnv)->BinaryImageSize;
+         SystemDependentData(theEnv)->BinaryOverrun = TRUE;
+         return;
+        }
+      SystemDependentData(theEnv)->BinaryImageOffset += (size_t) offset;
+      return;
+     }
+
 #if WIN_MVC
-   _lseek(SystemDependentData(theEnv)->BinaryFileHandle,offset,SEEK_CUR);
+   if (_lseek(SystemDependentData(theEnv)->BinaryFileHandle,offset,SEEK_CUR) == -1L)
+     { SystemDependentData(theEnv)->BinaryOverrun = TRUE; }
 #endif
 
 #if (! WIN_MVC)
-   fseek(SystemDependentData(theEnv)->BinaryFP,offset,SEEK_CUR);
+   if (fseek(SystemDependentData(theEnv)->BinaryFP,offset,SEEK_CUR) != 0)
+     { SystemDependentData(theEnv)->BinaryOverrun = TRUE; }
 #endif
   }
   
@@ -1397,6 +1483,12 @@ globle void GetSeekSetBinary(
   void *theEnv,
   long offset)
   {
+   if (SystemDependentData(theEnv)->BinaryImage != NULL)
+     {
+      SystemDependentData(theEnv)->BinaryImageOffset = (size_t) offset;
+      return;
+     }
+
 #if WIN_MVC
    _lseek(SystemDependentData(theEnv)->BinaryFileHandle,offset,SEEK_SET);
 #endif
@@ -1414,6 +1506,12 @@ globle void GenTellBinary(
   void *theEnv,
   long *offset)
   {
+   if (SystemDependentData(theEnv)->BinaryImage != NULL)
+     {
+      *offset = (long) SystemDependentData(theEnv)->BinaryImageOffset;
+      return;
+     }
+
 #if WIN_MVC
    *offset = _lseek(SystemDependentData(theEnv)->BinaryFileHandle,0,SEEK_CUR);
 #endif
@@ -1430,6 +1528,12 @@ globle void GenTellBinary(
 globle void GenCloseBinary(
   void *theEnv)
   {
+   if (SystemDependentData(theEnv)->BinaryImage != NULL)
+     {
+      SystemDependentData(theEnv)->BinaryImage = NULL;
+      return;
+     }
+
    if (SystemDependentData(theEnv)->BeforeOpenFunction != NULL)
      { (*SystemDependentData(theEnv)->BeforeOpenFunction)(theEnv); }
 
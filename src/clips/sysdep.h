@@ -109,7 +109,7 @@
 #endif
    LOCALE void                        EnvInitializeEnvironment(void *,struct symbolHashNode **,struct floatHashNode **,
 															   struct integerHashNode **,struct bitMapHashNode **,
-															   struct externalAddressHashNode **);
+															   struct externalAddressHashNode **,void *);
    LOCALE void                        SetRedrawFunction(void *,void (*)(void *));
    LOCALE void                        SetPauseEnvFunction(void *,void (*)(void *));
    LOCALE void                        SetContinueEnvFunction(void *,void (*)(void *,int));
@@ -121,6 +121,8 @@
    LOCALE void                        gensystem(void *theEnv);
    LOCALE void                        VMSSystem(char *);
    LOCALE int                         GenOpenReadBinary(void *,const char *,const char *);
+   LOCALE void                        GenOpenReadBinaryImage(void *,const void *,size_t);
+   LOCALE intBool                     GenBinaryOverrun(void *);
    LOCALE void                        GetSeekCurBinary(void *,long);
    LOCALE void                        GetSeekSetBinary(void *,long);
    LOCALE void                        GenTellBinary(void *,long *);
@@ -46,6 +46,9 @@
 #include "tmpltdef.h"
 #include "tmpltutl.h"
 #include "envrnmnt.h"
+#if FACT_SET_QUERIES
+#include "factqury.h"
+#endif
 
 #include "tmpltbin.h"
 
@@ -65,6 +68,7 @@
    static void                    UpdateDeftemplateSlot(void *,void *,long);
    static void                    ClearBload(void *);
    static void                    DeallocateDeftemplateBloadData(void *);
+   static void                    ShareDeftemplates(void *,void *);
 
 /***********************************************/
 /* DeftemplateBinarySetup: Installs the binary */
@@ -85,6 +89,7 @@ globle void DeftemplateBinarySetup(
                              BloadStorage,BloadBinaryItem,
                              ClearBload);
 #endif
+   AddShareBloadFunction(theEnv,"deftemplate",ShareDeftemplates,0);
   }
   
 /***********************************************************/
@@ -104,6 +109,40 @@ static void DeallocateDeftemplateBloadData(
 
    space =  DeftemplateBinaryData(theEnv)->NumberOfTemplateSlots * sizeof(struct templateSlot);
    if (space != 0) genfree(theEnv,(void *) DeftemplateBinaryData(theEnv)->SlotArray,space);
+
+   space = DeftemplateData(theEnv)->NumberOfSharedDeftemplates * sizeof(struct deftemplateFacts);
+   if (space != 0) genfree(theEnv,(void *) DeftemplateData(theEnv)->FactListArray,space);
+  }
+
+/********************************************************/
+/* ShareDeftemplates: Uses the deftemplates of a frozen */
+/*   binary image. Each environment sharing the image   */
+/*   keeps its own template fact lists.                 */
+/********************************************************/
+static void ShareDeftemplates(
+  void *theEnv,
+  void *frozenEnv)
+  {
+   long i;
+
+#if FACT_SET_QUERIES
+   if (EnvGetDynamicQueryTemplates(frozenEnv))
+     { FactQueryData(theEnv)->DynamicQueryTemplates = TRUE; }
+#endif
+
+   DeftemplateData(theEnv)->SharedDeftemplateArray = DeftemplateBinaryData(frozenEnv)->DeftemplateArray;
+   DeftemplateData(theEnv)->NumberOfSharedDeftemplates = DeftemplateBinaryData(frozenEnv)->NumberOfDeftemplates;
+   if (DeftemplateData(theEnv)->NumberOfSharedDeftemplates == 0) return;
+
+   DeftemplateData(theEnv)->FactListArray = (struct deftemplateFacts *)
+      genalloc(theEnv,sizeof(struct deftemplateFacts) * DeftemplateData(theEnv)->NumberOfSharedDeftemplates);
+
+   for (i = 0; i < DeftemplateData(theEnv)->NumberOfSharedDeftemplates; i++)
+     {
+      DeftemplateData(theEnv)->FactListArray[i].factList = NULL;
+      DeftemplateData(theEnv)->FactListArray[i].lastFact = NULL;
+      DeftemplateData(theEnv)->FactListArray[i].inScope = FALSE;
+     }
   }
 
 #if BLOAD_AND_BSAVE
@@ -197,20 +236,28 @@ static void BsaveStorage(
   FILE *fp)
   {
    size_t space;
+   long dynamicQueries = FALSE;
 
    /*========================================================================*/
    /* Three data structures are saved as part of a deftemplate binary image: */
    /* the deftemplate data structure, the deftemplateModule data structure,  */
    /* and the templateSlot data structure. The data structures associated    */
    /* with default values and constraints are not save with the deftemplate  */
-   /* portion of the binary image.                                           */
+   /* portion of the binary image. Whether a fact query names its templates  */
+   /* with an expression is saved along with their numbers, since the        */
+   /* queried flags of the deftemplates don't cover such queries.            */
    /*========================================================================*/
 
-   space = sizeof(long) * 3;
+#if FACT_SET_QUERIES
+   dynamicQueries = EnvGetDynamicQueryTemplates(theEnv);
+#endif
+
+   space = sizeof(long) * 4;
    GenWrite(&space,sizeof(size_t),fp);
    GenWrite(&DeftemplateBinaryData(theEnv)->NumberOfDeftemplates,sizeof(long int),fp);
    GenWrite(&DeftemplateBinaryData(theEnv)->NumberOfTemplateSlots,sizeof(long int),fp);
    GenWrite(&DeftemplateBinaryData(theEnv)->NumberOfTemplateModules,sizeof(long int),fp);
+   GenWrite(&dynamicQueries,sizeof(long int),fp);
   }
 
 /***********************************************/
@@ -277,6 +324,7 @@ static void BsaveBinaryItem(
          AssignBsaveConstructHeaderVals(&tempDeftemplate.header,
                                           &theDeftemplate->header);
          tempDeftemplate.implied = theDeftemplate->implied;
+         tempDeftemplate.queried = theDeftemplate->queried;
          tempDeftemplate.numberOfSlots = theDeftemplate->numberOfSlots;
          tempDeftemplate.patternNetwork = BsaveFactPatternIndex(theDeftemplate->patternNetwork);
 
@@ -348,16 +396,24 @@ static void BloadStorage(
   void *theEnv)
   {
    size_t space;
+   long dynamicQueries;
 
    /*=========================================================*/
    /* Determine the number of deftemplate, deftemplateModule, */
-   /* and templateSlot data structures to be read.            */
+   /* and templateSlot data structures to be read, and if a   */
+   /* fact query of the image computes its templates.         */
    /*=========================================================*/
 
    GenReadBinary(theEnv,&space,sizeof(size_t));
    GenReadBinary(theEnv,&DeftemplateBinaryData(theEnv)->NumberOfDeftemplates,sizeof(long int));
    GenReadBinary(theEnv,&DeftemplateBinaryData(theEnv)->NumberOfTemplateSlots,sizeof(long int));
    GenReadBinary(theEnv,&DeftemplateBinaryData(theEnv)->NumberOfTemplateModules,sizeof(long int));
+   GenReadBinary(theEnv,&dynamicQueries,sizeof(long int));
+
+#if FACT_SET_QUERIES
+   if (dynamicQueries)
+     { FactQueryData(theEnv)->DynamicQueryTemplates = TRUE; }
+#endif
 
    /*====================================*/
    /* Allocate the space needed for the  */
@@ -494,6 +550,7 @@ static void UpdateDeftemplate(
      { theDeftemplate->patternNetwork = NULL; }
 
    theDeftemplate->implied = bdtPtr->implied;
+   theDeftemplate->queried = bdtPtr->queried;
 #if DEBUGGING_FUNCTIONS
    theDeftemplate->watch = FactData(theEnv)->WatchFacts;
 #endif
@@ -55,6 +55,7 @@ struct bsaveDeftemplate
    struct bsaveConstructHeader header;
    long slotList;
    unsigned int implied : 1;
+   unsigned int queried : 1;
    unsigned int numberOfSlots : 15;
    long patternNetwork;
   };
@@ -296,10 +296,12 @@ static void DeftemplateToCode(
 
    /*==========================================*/
    /* Implied Flag, Watch Flag, In Scope Flag, */
-   /* Number of Slots, and Busy Count.         */
+   /* Queried Flag, Number of Slots, and Busy  */
+   /* Count.                                   */
    /*==========================================*/
 
-   fprintf(theFile,"%d,0,0,%d,%ld,",theTemplate->implied,theTemplate->numberOfSlots,theTemplate->busyCount);
+   fprintf(theFile,"%d,0,0,%d,%d,%ld,",theTemplate->implied,theTemplate->queried,
+           theTemplate->numberOfSlots,theTemplate->busyCount);
 
    /*=================*/
    /* Pattern Network */
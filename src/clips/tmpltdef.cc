@@ -80,6 +80,10 @@
 #include "tmpltcmp.h"
 #endif
 
+#if RUN_TIME
+#include "factsel.h"
+#endif
+
 #include "tmpltdef.h"
 
 /***************************************/
@@ -95,7 +99,6 @@
    static void                    DestroyDeftemplate(void *,void *);
 #if RUN_TIME
    static void                    RuntimeDeftemplateAction(void *,struct constructHeader *,void *);
-   static void                    SearchForHashedPatternNodes(void *,struct factPatternNode *);
 #endif
 
 /******************************************************************/
@@ -339,6 +342,14 @@ static void ReturnDeftemplate(
 
    ReturnSlots(theEnv,theConstruct->slotList);
 
+   /*=====================================*/
+   /* Remove the hit limit set on it, if  */
+   /* any (see EnvSetHitLimit).           */
+   /*=====================================*/
+
+   if (FactData(theEnv)->HitTemplate == theConstruct)
+     { EnvSetHitLimit(theEnv,NULL,0); }
+
    /*==================================*/
    /* Free storage used by the header. */
    /*==================================*/
@@ -420,7 +431,9 @@ globle void DecrementDeftemplateBusyCount(
   {
    struct deftemplate *theTemplate = (struct deftemplate *) vTheTemplate;
 
-   if (! ConstructData(theEnv)->ClearInProgress) theTemplate->busyCount--;
+   if ((! ConstructData(theEnv)->ClearInProgress) &&
+       (! ConstructData(theEnv)->ConstructsFrozen))
+     { theTemplate->busyCount--; }
   }
 
 /*************************************************/
@@ -432,11 +445,9 @@ globle void IncrementDeftemplateBusyCount(
   void *vTheTemplate)
   {
    struct deftemplate *theTemplate = (struct deftemplate *) vTheTemplate;
-#if MAC_XCD
-#pragma unused(theEnv)
-#endif
 
-   theTemplate->busyCount++;
+   if (! ConstructData(theEnv)->ConstructsFrozen)
+     { theTemplate->busyCount++; }
   }
   
 /*******************************************************************/
@@ -449,11 +460,8 @@ globle void *EnvGetNextFactInTemplate(
   void *theTemplate,
   void *factPtr)
   {
-#if MAC_XCD
-#pragma unused(theEnv)
-#endif
    if (factPtr == NULL)
-     { return((void *) ((struct deftemplate *) theTemplate)->factList); }
+     { return((void *) DeftemplateFactList(theEnv,(struct deftemplate *) theTemplate)); }
 
    if (((struct fact *) factPtr)->garbage) return(NULL);
 
@@ -520,27 +528,9 @@ static void RuntimeDeftemplateAction(
 #endif
    struct deftemplate *theDeftemplate = (struct deftemplate *) theConstruct;
    
-   SearchForHashedPatternNodes(theEnv,theDeftemplate->patternNetwork);
+   BuildSelectorTables(theEnv,theDeftemplate->patternNetwork);
   }
 
-/*******************************************************************/
-/* SearchForHashedPatternNodes:    */
-/*******************************************************************/
-static void SearchForHashedPatternNodes(
-   void *theEnv,
-   struct factPatternNode *theNode)
-   {
-    while (theNode != NULL)
-      {
-       if ((theNode->lastLevel != NULL) && (theNode->lastLevel->header.selector))
-        { AddHashedPatternNode(theEnv,theNode->lastLevel,theNode,theNode->networkTest->type,theNode->networkTest->value); }
-
-       SearchForHashedPatternNodes(theEnv,theNode->nextLevel);
-      
-       theNode = theNode->rightNode;
-      }
-   }
-
 /*******************************************************************/
 /* DeftemplateRunTimeInitialize:    */
 /*******************************************************************/
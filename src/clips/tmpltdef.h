@@ -89,6 +89,7 @@ struct deftemplate
    unsigned int implied       : 1;
    unsigned int watch         : 1;
    unsigned int inScope       : 1;
+   unsigned int queried       : 1;
    unsigned short numberOfSlots;
    long busyCount;
    struct factPatternNode *patternNetwork;
@@ -114,6 +115,19 @@ struct deftemplateModule
    struct defmoduleItemHeader header;
   };
 
+/*===================================================*/
+/* The fact lists and scope of the deftemplates in a */
+/* shared binary image belong to the environment     */
+/* using them.                                       */
+/*===================================================*/
+
+struct deftemplateFacts
+  {
+   struct fact *factList;
+   struct fact *lastFact;
+   unsigned int inScope;
+  };
+
 #define DEFTEMPLATE_DATA 5
 
 struct deftemplateData
@@ -129,11 +143,34 @@ struct deftemplateData
 #endif
 #if (! RUN_TIME) && (! BLOAD_ONLY)
    int DeftemplateError;
+#endif
+#if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
+   struct deftemplate *SharedDeftemplateArray;
+   long NumberOfSharedDeftemplates;
+   struct deftemplateFacts *FactListArray;
 #endif
   };
 
 #define DeftemplateData(theEnv) ((struct deftemplateData *) GetEnvironmentData(theEnv,DEFTEMPLATE_DATA))
 
+#if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
+#define SharedDeftemplateFacts(theEnv,theTemplate) \
+   (DeftemplateData(theEnv)->FactListArray[(theTemplate) - DeftemplateData(theEnv)->SharedDeftemplateArray])
+#define DeftemplateFactList(theEnv,theTemplate) \
+   (*((DeftemplateData(theEnv)->SharedDeftemplateArray == NULL) ? &(theTemplate)->factList : \
+      &SharedDeftemplateFacts(theEnv,theTemplate).factList))
+#define DeftemplateLastFact(theEnv,theTemplate) \
+   (*((DeftemplateData(theEnv)->SharedDeftemplateArray == NULL) ? &(theTemplate)->lastFact : \
+      &SharedDeftemplateFacts(theEnv,theTemplate).lastFact))
+#define DeftemplateInScope(theEnv,theTemplate) \
+   ((DeftemplateData(theEnv)->SharedDeftemplateArray == NULL) ? (theTemplate)->inScope : \
+    SharedDeftemplateFacts(theEnv,theTemplate).inScope)
+#else
+#define DeftemplateFactList(theEnv,theTemplate) ((theTemplate)->factList)
+#define DeftemplateLastFact(theEnv,theTemplate) ((theTemplate)->lastFact)
+#define DeftemplateInScope(theEnv,theTemplate) ((theTemplate)->inScope)
+#endif
+
 #ifdef LOCALE
 #undef LOCALE
 #endif
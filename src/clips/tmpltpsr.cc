@@ -167,6 +167,7 @@ globle int ParseDeftemplate(
    newDeftemplate->busyCount = 0;
    newDeftemplate->watch = 0;
    newDeftemplate->inScope = TRUE;
+   newDeftemplate->queried = FALSE;
    newDeftemplate->patternNetwork = NULL;
    newDeftemplate->factList = NULL;
    newDeftemplate->lastFact = NULL;
@@ -415,6 +415,7 @@ globle void UpdateDeftemplateScope(
    int moduleCount;
    struct defmodule *theModule;
    struct defmoduleItemHeader *theItem;
+   unsigned int inScope;
 
    /*==================================*/
    /* Loop through all of the modules. */
@@ -440,12 +441,16 @@ globle void UpdateDeftemplateScope(
          /* current module, then it is in scope.  */
          /*=======================================*/
 
-         if (FindImportedConstruct(theEnv,"deftemplate",theModule,
-                                   ValueToString(theDeftemplate->header.name),
-                                   &moduleCount,TRUE,NULL) != NULL)
-           { theDeftemplate->inScope = TRUE; }
+         inScope = (FindImportedConstruct(theEnv,"deftemplate",theModule,
+                                          ValueToString(theDeftemplate->header.name),
+                                          &moduleCount,TRUE,NULL) != NULL);
+
+#if (BLOAD || BLOAD_ONLY || BLOAD_AND_BSAVE) && (! RUN_TIME)
+         if (DeftemplateData(theEnv)->SharedDeftemplateArray != NULL)
+           { SharedDeftemplateFacts(theEnv,theDeftemplate).inScope = inScope; }
          else
-           { theDeftemplate->inScope = FALSE; }
+#endif
+           { theDeftemplate->inScope = inScope; }
         }
      }
   }
@@ -495,6 +500,7 @@ globle struct deftemplate *CreateImpliedDeftemplate(
    newDeftemplate->implied = setFlag;
    newDeftemplate->numberOfSlots = 0;
    newDeftemplate->inScope = 1;
+   newDeftemplate->queried = FALSE;
    newDeftemplate->patternNetwork = NULL;
    newDeftemplate->factList = NULL;
    newDeftemplate->lastFact = NULL;
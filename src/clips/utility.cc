@@ -1005,7 +1005,9 @@ globle unsigned long ItemHashValue(
 #if OBJECT_SYSTEM
       case INSTANCE_NAME:
 #endif
-        return(HashSymbol(ValueToString(theValue),theRange));
+        if (theRange == 0)
+          { return(SymbolHashValue(theValue)); }
+        return(SymbolHashValue(theValue) % theRange);
 
       case MULTIFIELD:
         return(HashMultifield((struct multifield *) theValue,theRange));
@@ -49,6 +49,7 @@
 #include <string.h>
 
 #include "constant.h"
+#include "constrct.h"
 #include "envrnmnt.h"
 #include "memalloc.h"
 #include "router.h"
@@ -212,12 +213,15 @@ globle int EnvSetWatchItem(
 
          if (argExprs == NULL) *(wPtr->flag) = newState;
 
-         /*=======================================*/
-         /* Set flags for individual watch items. */
-         /*=======================================*/
+         /*===============================================*/
+         /* Set flags for individual watch items. The     */
+         /* constructs of a frozen binary image are       */
+         /* shared, so their flags can't be changed.      */
+         /*===============================================*/
 
          if ((wPtr->accessFunc == NULL) ? FALSE :
-             ((*wPtr->accessFunc)(theEnv,wPtr->code,newState,argExprs) == FALSE))
+             (ConstructData(theEnv)->ConstructsFrozen ? (argExprs != NULL) :
+              ((*wPtr->accessFunc)(theEnv,wPtr->code,newState,argExprs) == FALSE)))
            {
             SetEvaluationError(theEnv,TRUE);
             return(FALSE);
@@ -243,12 +247,15 @@ globle int EnvSetWatchItem(
 
          if (argExprs == NULL) *(wPtr->flag) = newState;
 
-         /*=======================================*/
-         /* Set flags for individual watch items. */
-         /*=======================================*/
+         /*===============================================*/
+         /* Set flags for individual watch items. The     */
+         /* constructs of a frozen binary image are       */
+         /* shared, so their flags can't be changed.      */
+         /*===============================================*/
 
          if ((wPtr->accessFunc == NULL) ? FALSE :
-             ((*wPtr->accessFunc)(theEnv,wPtr->code,newState,argExprs) == FALSE))
+             (ConstructData(theEnv)->ConstructsFrozen ? (argExprs != NULL) :
+              ((*wPtr->accessFunc)(theEnv,wPtr->code,newState,argExprs) == FALSE)))
            {
             SetEvaluationError(theEnv,TRUE);
             return(FALSE);
@@ -0,0 +1,179 @@
+#include "lib/async-clips-executor.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+AsyncClipsExecutor::AsyncClipsExecutor(std::shared_ptr<ClipsPool> pool,
+                                       unsigned int workers,
+                                       unsigned int queue_capacity,
+                                       std::string result_func, int max_iters)
+    : _pool(std::move(pool)),
+      _result_func(std::move(result_func)),
+      _max_iters(max_iters),
+      _queue_capacity(queue_capacity),
+      _stopping(false) {
+    if (!_pool) {
+        throw std::invalid_argument("resource pool is null");
+    }
+    if (workers == 0 || queue_capacity == 0) {
+        throw std::invalid_argument("workers and queue capacity must be > 0");
+    }
+    _workers.reserve(workers);
+    try {
+        for (unsigned int i = 0; i < workers; ++i) {
+            _workers.emplace_back(&AsyncClipsExecutor::WorkerLoop, this);
+        }
+    } catch (...) {
+        // The destructor won't run, the started workers must not outlive
+        // the members they use.
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _stopping = true;
+        }
+        _not_empty.notify_all();
+        for (auto &worker : _workers) {
+            worker.join();
+        }
+        throw;
+    }
+}
+
+AsyncClipsExecutor::~AsyncClipsExecutor() {
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stopping = true;
+    }
+    _not_empty.notify_all();
+    _not_full.notify_all();
+    for (auto &worker : _workers) {
+        worker.join();
+    }
+}
+
+std::future<json> AsyncClipsExecutor::Submit(json features) {
+    auto promise = std::make_shared<std::promise<json>>();
+    auto future = promise->get_future();
+    Submit(std::move(features),
+           [promise](const json &result, int, std::exception_ptr error) {
+               if (error) {
+                   promise->set_exception(error);
+               } else {
+                   promise->set_value(result);
+               }
+           });
+    return future;
+}
+
+void AsyncClipsExecutor::Submit(json features, Callback callback) {
+    Enqueue(Task{std::move(features), std::move(callback), Clock::now()}, true);
+}
+
+bool AsyncClipsExecutor::TrySubmit(json features, Callback callback) {
+    return Enqueue(Task{std::move(features), std::move(callback), Clock::now()},
+                   false);
+}
+
+AsyncClipsMetrics AsyncClipsExecutor::Metrics() {
+    std::lock_guard<std::mutex> guard(_lock);
+    AsyncClipsMetrics metrics = _metrics;
+    metrics.queue_depth = _queue.size();
+    return metrics;
+}
+
+bool AsyncClipsExecutor::Enqueue(Task &&task, bool block) {
+    {
+        std::unique_lock<std::mutex> guard(_lock);
+        if (block) {
+            _not_full.wait(guard, [this]() {
+                return _stopping || _queue.size() < _queue_capacity;
+            });
+        }
+        if (_stopping) {
+            throw std::runtime_error("async clips executor is stopped");
+        }
+        if (_queue.size() >= _queue_capacity) {
+            ++_metrics.rejected;
+            return false;
+        }
+        _queue.push_back(std::move(task));
+        ++_metrics.submitted;
+        _metrics.max_queue_depth = std::max<unsigned int>(
+            _metrics.max_queue_depth, _queue.size());
+    }
+    _not_empty.notify_one();
+    return true;
+}
+
+void AsyncClipsExecutor::WorkerLoop() {
+    void *clips = nullptr;
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> guard(_lock);
+            _not_empty.wait(guard,
+                            [this]() { return _stopping || !_queue.empty(); });
+            // Queued requests are still served once stopping.
+            if (_queue.empty()) break;
+            task = std::move(_queue.front());
+            _queue.pop_front();
+
+            auto wait = std::chrono::duration_cast<std::chrono::microseconds>(
+                            Clock::now() - task.submitted)
+                            .count();
+            _metrics.total_wait_us += wait;
+            _metrics.max_wait_us =
+                std::max<uint64_t>(_metrics.max_wait_us, wait);
+        }
+        _not_full.notify_one();
+        Run(task, clips);
+    }
+    if (clips != nullptr) {
+        _pool->Release(clips);
+    }
+}
+
+void AsyncClipsExecutor::Run(Task &task, void *&clips) {
+    json result;
+    int halt = 0;
+    std::exception_ptr error;
+    auto start = Clock::now();
+    try {
+        if (clips == nullptr) {
+            clips = _pool->Acquire();
+        }
+        result = ClipsModuleExecute(clips, task.features, _max_iters,
+                                    _result_func, halt);
+    } catch (...) {
+        error = std::current_exception();
+        result = nullptr;
+        // The environment may be left half way through the execution.
+        if (clips != nullptr) {
+            _pool->Release(clips, true);
+            clips = nullptr;
+        }
+    }
+    auto run = std::chrono::duration_cast<std::chrono::microseconds>(
+                   Clock::now() - start)
+                   .count();
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _metrics.total_run_us += run;
+        if (error) {
+            ++_metrics.failed;
+        } else {
+            ++_metrics.completed;
+        }
+    }
+
+    if (task.callback) {
+        try {
+            task.callback(result, halt, error);
+        } catch (...) {
+            // A throwing callback must not take the worker down.
+        }
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lib/clips-factory.h"
+#include "lib/json.hpp"
+#include "lib/resource-pool.hpp"
+
+using ClipsPool = ResourcePool<void, ClipsFactory>;
+
+// Snapshot of an AsyncClipsExecutor's counters, times are in microseconds.
+// Wait time is from submission until a worker picks the request up, run time
+// is the ClipsModuleExecute call itself.
+struct AsyncClipsMetrics {
+    unsigned int queue_depth = 0;
+    unsigned int max_queue_depth = 0;
+    uint64_t submitted = 0;
+    uint64_t rejected = 0;  // TrySubmit on a full queue
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+    uint64_t total_wait_us = 0;
+    uint64_t max_wait_us = 0;
+    uint64_t total_run_us = 0;
+};
+
+// Runs ClipsModuleExecute on a fixed set of worker threads. Requests go into
+// a bounded queue shared by all producers and workers; Submit blocks while it
+// is full, TrySubmit refuses instead, so callers feel the backpressure rather
+// than the queue growing without bound. Each worker acquires an environment
+// of @param pool with its first request and keeps it for the following ones,
+// it is only replaced after an execution threw. The pool must therefore be
+// able to hold an environment per worker.
+//
+// The destructor stops accepting requests, finishes the queued ones and joins
+// the workers.
+class AsyncClipsExecutor {
+   public:
+    // Result of one request, @param error is set if the execution threw and
+    // then @param result is null.
+    using Callback = std::function<void(const nlohmann::json &result, int halt,
+                                        std::exception_ptr error)>;
+
+    AsyncClipsExecutor(std::shared_ptr<ClipsPool> pool, unsigned int workers,
+                       unsigned int queue_capacity, std::string result_func,
+                       int max_iters = 10000);
+    ~AsyncClipsExecutor();
+
+    AsyncClipsExecutor(const AsyncClipsExecutor &) = delete;
+    AsyncClipsExecutor &operator=(const AsyncClipsExecutor &) = delete;
+
+    // Blocks while the queue is full. The future throws what the execution
+    // threw.
+    std::future<nlohmann::json> Submit(nlohmann::json features);
+    void Submit(nlohmann::json features, Callback callback);
+
+    // Returns false without queueing if the queue is full.
+    bool TrySubmit(nlohmann::json features, Callback callback);
+
+    AsyncClipsMetrics Metrics();
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Task {
+        nlohmann::json features;
+        Callback callback;
+        Clock::time_point submitted;
+    };
+
+    bool Enqueue(Task &&task, bool block);
+    void WorkerLoop();
+    // @param clips is the worker's environment, acquired if null and
+    // released and reset to null if the execution throws.
+    void Run(Task &task, void *&clips);
+
+    std::shared_ptr<ClipsPool> _pool;
+    std::string _result_func;
+    int _max_iters;
+    unsigned int _queue_capacity;
+
+    std::mutex _lock;  // protects everything below but _workers
+    std::condition_variable _not_empty;
+    std::condition_variable _not_full;
+    std::deque<Task> _queue;
+    bool _stopping;
+    AsyncClipsMetrics _metrics;
+
+    std::vector<std::thread> _workers;
+};
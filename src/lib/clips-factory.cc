@@ -1,8 +1,34 @@
 #include "lib/clips-factory.h"
 
-ClipsFactory::ClipsFactory(std::string rules) : _rules(std::move(rules)) {
+#include <fstream>
+
+ClipsFactory::ClipsFactory(std::string rules, bool prune_features,
+                           bool clone_prototype)
+    : _rules(std::move(rules)),
+      _prune_features(prune_features),
+      _clone_prototype(clone_prototype),
+      _static_facts(false),
+      _shared_network(false),
+      _compiled_expressions(false),
+      _lazy_matching(false) {
+    if (!_clone_prototype) return;
+
+    clips_ptr prototype = CreateClips(_rules);
+    buildSchema(prototype.get());
+    _image = ClipsBsaveImage(prototype.get());
+}
+
+std::unique_ptr<ClipsFactory> ClipsFactory::FromImageFile(
+    const std::string &image_path, bool prune_features) {
+    std::unique_ptr<ClipsFactory> factory(
+        new ClipsFactory("", prune_features, false));
+    factory->_clone_prototype = true;
+    factory->_mapped_image.reset(new ClipsMappedImage(image_path));
+    return factory;
 }
 
+ClipsFactory::~ClipsFactory() = default;
+
 void ClipsFactory::Destroy(void *clips) {
     if (clips) {
         DestroyEnvironment(clips);
@@ -10,10 +36,102 @@ void ClipsFactory::Destroy(void *clips) {
 }
 
 void *ClipsFactory::Create() {
-    return createClipsEnvFromRuleString();
+    void *clips = nullptr;
+    if (_clone_prototype && _shared_network) {
+        clips = shareClipsEnvFromPrototype();
+    }
+    if (clips == nullptr) {
+        clips = _clone_prototype ? cloneClipsEnvFromPrototype()
+                                 : createClipsEnvFromRuleString();
+    }
+    EnvSetStaticFacts(clips, _static_facts);
+    EnvSetLazyMatching(clips, _lazy_matching);
+    // Environments sharing a frozen network use the tests compiled in it.
+    if (_compiled_expressions) {
+        EnvCompileJoinExpressions(clips);
+    }
+    return clips;
+}
+
+void ClipsFactory::SaveImage(const std::string &image_path) {
+    std::string image;
+    if (_mapped_image) {
+        image.assign(static_cast<const char *>(_mapped_image->data()),
+                     _mapped_image->size());
+    } else if (_clone_prototype) {
+        image = _image;
+    } else {
+        image = ClipsBsaveImage(CreateClips(_rules).get());
+    }
+
+    std::ofstream out(image_path, std::ios::binary | std::ios::trunc);
+    out.write(image.data(), image.size());
+    if (!out) {
+        throw std::runtime_error("clips image write failed, " + image_path);
+    }
 }
 
 void *ClipsFactory::createClipsEnvFromRuleString() {
     clips_ptr clips = CreateClips(_rules);
+    buildSchema(clips.get());
+    _schema->AttachTo(clips.get());
+    return clips.release();
+}
+
+void *ClipsFactory::cloneClipsEnvFromPrototype() {
+    clips_ptr clips(CreateEnvironment());
+    if (!clips) {
+        throw std::runtime_error("[FATAL] clips CreateEnvironment() failed");
+    }
+    EnvSetDynamicConstraintChecking(clips.get(), TRUE);
+    loadImage(clips.get());
+    buildSchema(clips.get());
+    _schema->AttachTo(clips.get());
+    return clips.release();
+}
+
+void *ClipsFactory::shareClipsEnvFromPrototype() {
+    std::call_once(_network_once, [&]() {
+        clips_ptr network(CreateEnvironment());
+        if (!network) {
+            throw std::runtime_error("[FATAL] clips CreateEnvironment() failed");
+        }
+        EnvSetDynamicConstraintChecking(network.get(), TRUE);
+        loadImage(network.get());
+        if (_compiled_expressions) {
+            EnvCompileJoinExpressions(network.get());
+        }
+        if (EnvFreezeBload(network.get())) {
+            _network = std::move(network);
+        }
+    });
+    if (!_network) return nullptr;
+
+    clips_ptr clips(CreateSharedEnvironment(_network.get()));
+    if (!clips) {
+        throw std::runtime_error(
+            "[FATAL] clips CreateSharedEnvironment() failed");
+    }
+    EnvSetDynamicConstraintChecking(clips.get(), TRUE);
+    // The schema is built from a shared environment rather than the frozen
+    // one, which must not change module scopes.
+    buildSchema(clips.get());
+    _schema->AttachTo(clips.get());
     return clips.release();
-}
\ No newline at end of file
+}
+
+void ClipsFactory::loadImage(void *clips) {
+    if (_mapped_image) {
+        ClipsBloadImage(clips, _mapped_image->data(), _mapped_image->size());
+    } else {
+        ClipsBloadImage(clips, _image.data(), _image.size());
+    }
+}
+
+void ClipsFactory::buildSchema(void *clips) {
+    // Every environment compiles the same rules, the first one describes the
+    // schema for all of them.
+    std::call_once(_schema_once, [&]() {
+        _schema.reset(new FeatureSchema(clips, _prune_features));
+    });
+}
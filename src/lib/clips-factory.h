@@ -1,18 +1,106 @@
 #pragma once
+#include <memory>
+#include <mutex>
 #include <string>
 #include <stdexcept>
 #include <unordered_map>
 
 #include "lib/clips-utils.h"
+#include "lib/feature-schema.h"
 
 class ClipsFactory {
    public:
-    ClipsFactory(std::string rules);
+    // With @param prune_features, features no rule can match are not
+    // asserted, @see FeatureSchema.
+    //
+    // With @param clone_prototype, the rules are compiled once into a
+    // prototype environment whose binary image (bsave) every created
+    // environment is loaded from (bload) instead of parsing the rules again.
+    // Cloned environments can't load more constructs, and since bload'ed
+    // environments can't create deftemplates, features whose relation is not
+    // known to the rules are not asserted.
+    ClipsFactory(std::string rules, bool prune_features = false,
+                 bool clone_prototype = false);
+
+    // Creates environments from the binary image file at @param image_path,
+    // mapped read only, without any rule text (@see ClipsMappedImage).
+    // Environments are cloned as with clone_prototype.
+    static std::unique_ptr<ClipsFactory> FromImageFile(
+        const std::string &image_path, bool prune_features = false);
+
+    ~ClipsFactory();
+
+    ClipsFactory(const ClipsFactory &) = delete;
+    ClipsFactory &operator=(const ClipsFactory &) = delete;
+
     void *Create();
     void Destroy(void *clips);
 
+    // With @param static_facts, created environments keep the deffacts
+    // facts across resets instead of retracting and asserting them again,
+    // @see EnvSetStaticFacts.
+    void set_static_facts(bool static_facts) {
+        _static_facts = static_facts;
+    }
+
+    // With @param shared_network, environments cloned from the binary image
+    // share one frozen environment holding its rule network and atoms, and
+    // only allocate their own facts, agenda and match memories,
+    // @see CreateSharedEnvironment. Watch items, breakpoints and instances
+    // are not available in them. When the image can't be frozen,
+    // environments load it as without shared_network. Every environment
+    // must be destroyed before the factory.
+    void set_shared_network(bool shared_network) {
+        _shared_network = shared_network;
+    }
+
+    // With @param compiled_expressions, the join network tests of created
+    // environments are compiled into instructions rather than evaluated
+    // function call by function call, @see EnvCompileJoinExpressions. Rule
+    // actions and deffunction bodies are not compiled. With shared_network,
+    // the tests are compiled once in the frozen environment.
+    void set_compiled_expressions(bool compiled_expressions) {
+        _compiled_expressions = compiled_expressions;
+    }
+
+    // With @param lazy_matching, created environments only send asserted
+    // facts through the joins when the agenda needs the activations they
+    // could produce, so a run halted by a rule of high salience skips the
+    // joins of the rules of lower salience, @see EnvSetLazyMatching.
+    // Activations of equal salience may fire in another order than with
+    // eager matching: the facts of a pattern also leading to a rule of
+    // higher salience are joined first. A rule set halting in one of several
+    // rules of equal salience may then stop in another one.
+    void set_lazy_matching(bool lazy_matching) {
+        _lazy_matching = lazy_matching;
+    }
+
+    // Writes the binary image environments are cloned from to
+    // @param image_path, for FromImageFile.
+    void SaveImage(const std::string &image_path);
+
+    // The feature schema of the rule set, nullptr until the first
+    // environment is created.
+    const FeatureSchema *schema() const { return _schema.get(); }
+
    private:
     void *createClipsEnvFromRuleString();
+    void *cloneClipsEnvFromPrototype();
+    void *shareClipsEnvFromPrototype();
+    void loadImage(void *clips);
+    void buildSchema(void *clips);
 
     std::string _rules;
-};
\ No newline at end of file
+    bool _prune_features;
+    bool _clone_prototype;
+    bool _static_facts;
+    bool _shared_network;
+    bool _compiled_expressions;
+    bool _lazy_matching;
+    std::string _image;  // bsave image of the prototype
+    std::unique_ptr<ClipsMappedImage> _mapped_image;
+    std::once_flag _schema_once;
+    std::unique_ptr<FeatureSchema> _schema;
+    std::once_flag _network_once;
+    clips_ptr _network;  // frozen environment shared by the environments
+};
@@ -1,31 +1,30 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <stdexcept>
 #include <sstream>
 
 #include "lib/clips-utils.h"
+#include "lib/feature-schema.h"
 #include "lib/json-utils.h"
 #include "clips/proflfun.h"
+#include "clips/multifld.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using std::runtime_error;
 using std::invalid_argument;
-using std::ostream;
 using std::string;
 using std::stringstream;
+using std::vector;
 using json = nlohmann::json;
 
 namespace {
-bool IsSymbol(const string &text) {
-    for (auto c : text) {
-        if (c >= 'a' && c <= 'z') continue;
-        if (c >= 'A' && c <= 'Z') continue;
-        if (c >= '0' && c <= '9') continue;
-        if (c == '.' || c == '_' || c == '-') continue;
-        return false;
-    }
-
-    return true;
-}
-
 // @see IO Routers in CLIPS.
 int FindGLogRouter(void *env, const char *logical_name) {
     if (logical_name == nullptr) return FALSE;
@@ -196,21 +195,39 @@ json ExtractResult(void *clips, DATA_OBJECT_PTR result_object) {
     return ExtractDataObject(clips, result_object);
 }
 
-inline void ClipsCreatePrimitive(const json &obj, ostream &os) {
+// The load-facts text path printed doubles with 6 significant digits, so
+// integral doubles below 1e6 in magnitude read back as INTEGER atoms and
+// larger ones as FLOAT atoms (1000000.0 -> 1e+06).
+constexpr double kMaxIntegralDouble = 1e6;
+
+// Number of clips atoms a json primitive turns into, null has no atom.
+inline long ClipsAtomCount(const json &obj) {
+    return obj.is_null() ? 0 : 1;
+}
+
+inline void ClipsCreateAtom(void *clips, const json &obj, FIELD_PTR field) {
     if (obj.is_number_integer()) {
-        os << obj.get<int64_t>();
+        field->type = INTEGER;
+        field->value = EnvAddLong(clips, obj.get<int64_t>());
     } else if (obj.is_number_float()) {
-        os << obj.get<double>();
-    } else if (obj.is_string()) {
-        os << obj.dump();
-    } else if (obj.is_boolean()) {
-        if (obj.get<bool>()) {
-            os << "TRUE";
+        // Integral doubles are asserted with the type the load-facts text
+        // path read them back as (11.0 -> 11, 1000000.0 -> 1e+06).
+        double value = obj.get<double>();
+        if (std::trunc(value) == value &&
+            std::fabs(value) < kMaxIntegralDouble) {
+            field->type = INTEGER;
+            field->value = EnvAddLong(clips, static_cast<long long>(value));
         } else {
-            os << "FALSE";
+            field->type = FLOAT;
+            field->value = EnvAddDouble(clips, value);
         }
-    } else {
-        ;  // ignore orthers
+    } else if (obj.is_string()) {
+        field->type = STRING;
+        field->value = EnvAddSymbol(clips, obj.get_ref<const string &>().c_str());
+    } else if (obj.is_boolean()) {
+        field->type = SYMBOL;
+        field->value = obj.get<bool>() ? EnvTrueSymbol(clips)
+                                       : EnvFalseSymbol(clips);
     }
 }
 
@@ -234,6 +251,14 @@ int ClipsEnvLoadFromString(void *clips_env, const string &constructs) {
     return retcode;
 }
 
+ClipsMemoryUsage ClipsGetMemoryUsage(void *clips) {
+    ClipsMemoryUsage usage;
+    usage.used = EnvMemUsed(clips);
+    usage.pooled = PoolSize(clips);
+    usage.requests = EnvMemRequests(clips);
+    return usage;
+}
+
 clips_ptr CreateClips(const string &rules) {
     clips_ptr clips(CreateEnvironment());
     if (!clips) {
@@ -252,42 +277,125 @@ clips_ptr CreateClips(const string &rules) {
     return clips;
 }
 
+string ClipsBsaveImage(void *clips) {
+    char *buffer = nullptr;
+    size_t size = 0;
+    FILE *stream = open_memstream(&buffer, &size);
+    if (stream == nullptr) {
+        throw runtime_error("clips bsave image open_memstream() failed");
+    }
+    int retcode = EnvBsaveToStream(clips, stream);
+    fclose(stream);
+
+    string image;
+    if (retcode) {
+        image.assign(buffer, size);
+    }
+    free(buffer);
+    if (!retcode) {
+        throw runtime_error("clips EnvBsaveToStream() failed");
+    }
+    return image;
+}
+
+void ClipsBloadImage(void *clips, const void *image, size_t size) {
+    if (!EnvBloadFromMemory(clips, image, size)) {
+        throw runtime_error("clips EnvBloadFromMemory() failed");
+    }
+}
+
+ClipsMappedImage::ClipsMappedImage(const string &path)
+    : _data(nullptr), _size(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("clips image open() failed, " + path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        throw runtime_error("clips image is empty or fstat() failed, " + path);
+    }
+    _size = st.st_size;
+    _data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (_data == MAP_FAILED) {
+        throw runtime_error("clips image mmap() failed, " + path);
+    }
+}
+
+ClipsMappedImage::~ClipsMappedImage() {
+    munmap(_data, _size);
+}
+
 void ClipsCreateFacts(void* clips, const json &features) {
     if (!features.is_object()) {
         throw invalid_argument("'features' must be a json object");
     }
+
+    // Asserting from the embedded api triggers a garbage collection after
+    // every fact, defer it until all features are asserted.
+    ClipsGCLock clips_gclock(clips);
     for (auto iter = features.begin(); iter != features.end(); ++iter) {
-        if (!IsSymbol(iter.key())) {
+        auto &values = iter.value();
+        long length = 0;
+        if (values.is_primitive()) {
+            length = ClipsAtomCount(values);
+        } else if (values.is_array()) {
+            for (auto i = 0u; i < values.size() && values[i].is_primitive();
+                 ++i) {
+                length += ClipsAtomCount(values[i]);
+            }
+        } else {
+            continue;  // ignore others
+        }
+
+        auto tmpl = ClipsFindFeatureRelation(clips, iter.key());
+        if (tmpl == nullptr) {
             continue;
         }
 
-        stringstream facts;
-        if (iter.value().is_primitive()) {
-            facts << "(" << iter.key() << " ";
-            ClipsCreatePrimitive(iter.value(), facts);
-            facts << ")\n";
-        } else if (iter.value().is_array()) {
-            facts << "(" << iter.key();
-            auto &values = iter.value();
+        auto segment = static_cast<struct multifield *>(
+            CreateMultifield2(clips, length));
+        if (values.is_primitive()) {
+            if (length) {
+                ClipsCreateAtom(clips, values, &segment->theFields[0]);
+            }
+        } else {
+            long pos = 0;
             for (auto i = 0u; i < values.size() && values[i].is_primitive();
                  ++i) {
-                facts << " ";
-                ClipsCreatePrimitive(values[i], facts);
+                if (ClipsAtomCount(values[i])) {
+                    ClipsCreateAtom(clips, values[i],
+                                    &segment->theFields[pos++]);
+                }
             }
-            facts << ")";
-        } else {
-            continue;  // ignore others
         }
-        EnvLoadFactsFromString(clips, facts.str().c_str(), -1);
+
+        struct fact *fact = EnvCreateFact(clips, tmpl);
+        ReturnMultifield(clips, static_cast<struct multifield *>(
+                                    fact->theProposition.theFields[0].value));
+        fact->theProposition.theFields[0].value = segment;
+        EnvAssert(clips, fact);
+    }
+}
+
+void ClipsResetOrRollback(void *clips) {
+    if (!EnvRollback(clips)) {
+        EnvReset(clips);
+        EnvCheckpoint(clips);
     }
 }
 
 json ClipsExecute(void *clips, const json &features, int max_iters,
-                  const string &result_func, int &halt) {
+                  const string &result_func, int &halt, bool rollback) {
     // Construct facts
 
     // Trigger clips rule engine
-    EnvReset(clips);
+    if (rollback) {
+        ClipsResetOrRollback(clips);
+    } else {
+        EnvReset(clips);
+    }
     ClipsCreateFacts(clips, features);
     EnvRun(clips, max_iters);
 
@@ -306,9 +414,13 @@ json ClipsExecute(void *clips, const json &features, int max_iters,
 
 json ClipsModuleExecute(void *clips, const json &features, int max_iters,
                         const string &result_func,
-                        int &halt) {
+                        int &halt, bool rollback) {
     // Trigger clips rule engine
-    EnvReset(clips);
+    if (rollback) {
+        ClipsResetOrRollback(clips);
+    } else {
+        EnvReset(clips);
+    }
 
     ClipsCreateFacts(clips, features);
     EnvRun(clips, max_iters);
@@ -325,3 +437,104 @@ json ClipsModuleExecute(void *clips, const json &features, int max_iters,
 
     return match_result;
 }
+
+json ClipsExecuteHits(void *clips, const json &features, int max_iters,
+                      const string &result_template, size_t max_hits,
+                      int &halt, bool rollback, bool *stopped) {
+    if (max_hits == 0) {
+        throw invalid_argument("'max_hits' must be positive");
+    }
+
+    if (rollback) {
+        ClipsResetOrRollback(clips);
+    } else {
+        EnvReset(clips);
+    }
+
+    void *tmpl = EnvFindDeftemplate(clips, result_template.c_str());
+    if (tmpl == nullptr) {
+        throw runtime_error("clips failed to find " + result_template);
+    }
+
+    ClipsCreateFacts(clips, features);
+
+    // Only the hits asserted by the rules count, the limit is set once the
+    // features are in.
+    EnvSetHitLimit(clips, tmpl, max_hits);
+    EnvRun(clips, max_iters);
+
+    halt = EvaluationData(clips)->HaltExecution;
+    if (stopped) {
+        *stopped = EnvGetHitCount(clips) >= static_cast<long long>(max_hits);
+    }
+
+    // The limit must not outlive the call, a later run would stop on it.
+    json hits(json::value_t::array);
+    try {
+        ClipsGCLock clips_gclock(clips);
+        for (void *fact = EnvGetNextHitFact(clips, nullptr);
+             fact != nullptr && hits.size() < max_hits;
+             fact = EnvGetNextHitFact(clips, fact)) {
+            hits.push_back(ExtractFactValue(clips, fact));
+        }
+    } catch (...) {
+        EnvSetHitLimit(clips, nullptr, 0);
+        throw;
+    }
+    EnvSetHitLimit(clips, nullptr, 0);
+
+    return hits;
+}
+
+vector<json> ClipsExecuteBatch(void *clips, const vector<json> &features,
+                               int max_iters, const string &result_func,
+                               vector<int> &halts, ClipsBatchTiming *timing,
+                               bool rollback) {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point since;
+    // Adds the time since the previous lap to @param phase, the clock is
+    // only read when timing is asked for.
+    auto lap = [&](uint64_t ClipsBatchTiming::*phase) {
+        if (!timing) return;
+        auto now = Clock::now();
+        timing->*phase += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              now - since).count();
+        since = now;
+    };
+
+    FUNCTION_REFERENCE result_ref;
+    if (!GetFunctionReference(clips, result_func.c_str(), &result_ref)) {
+        throw runtime_error("clips failed to find " + result_func);
+    }
+
+    vector<json> results;
+    results.reserve(features.size());
+    halts.assign(features.size(), 0);
+    for (size_t i = 0; i < features.size(); ++i) {
+        // Reset, assert, the result call and its extraction each clean the
+        // garbage frame once they're done, once per item is enough.
+        ClipsGCLock clips_gclock(clips);
+        if (timing) since = Clock::now();
+        if (rollback) {
+            ClipsResetOrRollback(clips);
+        } else {
+            EnvReset(clips);
+        }
+        lap(&ClipsBatchTiming::reset_ns);
+
+        ClipsCreateFacts(clips, features[i]);
+        lap(&ClipsBatchTiming::assert_ns);
+
+        EnvRun(clips, max_iters);
+        halts[i] = EvaluationData(clips)->HaltExecution;
+        lap(&ClipsBatchTiming::run_ns);
+
+        DATA_OBJECT result;
+        if (FunctionCall2(clips, &result_ref, nullptr, &result)) {
+            throw runtime_error("clips failed to call " + result_func);
+        }
+        results.push_back(ExtractResult(clips, &result));
+        lap(&ClipsBatchTiming::result_ns);
+    }
+    return results;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <ostream>
 #include <vector>
@@ -37,14 +38,94 @@ class ClipsGCLock {
 
 clips_ptr CreateClips(const std::string &rules);
 
+// Binary image (bsave) of the constructs of @param clips.
+std::string ClipsBsaveImage(void *clips);
+
+// Replaces the constructs of @param clips with a binary image (bload), the
+// image is only read during the call.
+void ClipsBloadImage(void *clips, const void *image, size_t size);
+
+// A binary image file mapped read only, processes mapping the same file
+// share its pages.
+class ClipsMappedImage {
+   public:
+    explicit ClipsMappedImage(const std::string &path);
+    ~ClipsMappedImage();
+
+    ClipsMappedImage(const ClipsMappedImage &) = delete;
+    ClipsMappedImage &operator=(const ClipsMappedImage &) = delete;
+
+    const void *data() const { return _data; }
+    size_t size() const { return _size; }
+
+   private:
+    void *_data;
+    size_t _size;
+};
+
 int ClipsEnvLoadFromString(void *clips_env, const std::string &constructs);
 
+// Memory held by an environment, in bytes. @param used is everything it got
+// from the system allocator, @param pooled the part of it that is free and
+// kept for reuse by the environment's memory pools.
+struct ClipsMemoryUsage {
+    int64_t used = 0;
+    int64_t pooled = 0;
+    int64_t requests = 0;
+};
+
+ClipsMemoryUsage ClipsGetMemoryUsage(void *clips);
+
 void ClipsCreateFacts(void* clips, const nlohmann::json &features);
 
+// Brings @param clips to its state right after a reset. The first call
+// resets and takes a checkpoint (EnvCheckpoint), the next ones only roll
+// back what was done since (EnvRollback), and reset again if the checkpoint
+// was invalidated, e.g. by a rule retracting a deffacts fact.
+void ClipsResetOrRollback(void *clips);
+
+// With @param rollback, the environment is prepared with
+// ClipsResetOrRollback instead of EnvReset.
 nlohmann::json ClipsExecute(void *clips, const nlohmann::json &features,
                             int max_iters, const std::string &result_func,
-                            int &halt);
+                            int &halt, bool rollback = false);
 
 nlohmann::json ClipsModuleExecute(void *clips, const nlohmann::json &features,
                                   int max_iters, const std::string &result_func,
-                                  int &halt);
\ No newline at end of file
+                                  int &halt, bool rollback = false);
+
+// Decision mode for rule sets where only the first hits matter: the rules
+// stop firing as soon as @param max_hits facts of the deftemplate
+// @param result_template have been asserted (EnvSetHitLimit), the remaining
+// activations are skipped. Returns those facts, as a json array in the order
+// they were asserted, instead of calling a result function. The rule
+// asserting the last hit still completes its actions, only the first
+// @param max_hits facts still in the fact-list are returned. As for
+// ClipsModuleExecute, @param halt only reports a halted evaluation and is 0
+// when the limit stopped the run; @param stopped, if given, is set to whether
+// it did. Fewer hits than @param max_hits don't tell, a hit may have been
+// retracted by a later rule.
+nlohmann::json ClipsExecuteHits(void *clips, const nlohmann::json &features,
+                                int max_iters,
+                                const std::string &result_template,
+                                size_t max_hits, int &halt,
+                                bool rollback = false,
+                                bool *stopped = nullptr);
+
+// Time spent in each phase of a batch, in nanoseconds, summed over items.
+struct ClipsBatchTiming {
+    uint64_t reset_ns = 0;
+    uint64_t assert_ns = 0;
+    uint64_t run_ns = 0;
+    uint64_t result_ns = 0;
+};
+
+// Runs ClipsModuleExecute for each of @param features on the same
+// environment. The result function is looked up once for the whole batch.
+// @param halts receives the halt flag of each item, and @param timing, if
+// not null, gets the time of each phase added to it. With @param rollback,
+// each item starts with ClipsResetOrRollback instead of EnvReset.
+std::vector<nlohmann::json> ClipsExecuteBatch(
+    void *clips, const std::vector<nlohmann::json> &features, int max_iters,
+    const std::string &result_func, std::vector<int> &halts,
+    ClipsBatchTiming *timing = nullptr, bool rollback = false);
\ No newline at end of file
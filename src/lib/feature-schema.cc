@@ -0,0 +1,211 @@
+#include "lib/feature-schema.h"
+#include "clips/factqury.h"
+#include "clips/modulpsr.h"
+#include "clips/modulutl.h"
+#include "clips/pattern.h"
+#include "clips/tmpltutl.h"
+
+using std::string;
+using json = nlohmann::json;
+using std::unordered_map;
+using std::vector;
+
+namespace {
+// Keys outside the schema are remembered too, up to this many per environment
+// so that payloads with generated keys can't grow the cache without bound.
+const size_t kMaxLearnedKeys = 4096;
+
+bool IsSymbol(const string &text) {
+    for (auto c : text) {
+        if (c >= 'a' && c <= 'z') continue;
+        if (c >= 'A' && c <= 'Z') continue;
+        if (c >= '0' && c <= '9') continue;
+        if (c == '.' || c == '_' || c == '-') continue;
+        return false;
+    }
+
+    return true;
+}
+
+// Checks whether @param text would be read as a number by the clips scanner,
+// such a key can't be used as the relation name of an ordered fact.
+bool IsNumberLiteral(const string &text) {
+    size_t i = 0;
+    if (i < text.size() && (text[i] == '+' || text[i] == '-')) ++i;
+    size_t digits = 0;
+    for (; i < text.size() && isdigit(text[i]); ++i) ++digits;
+    if (i < text.size() && text[i] == '.') {
+        for (++i; i < text.size() && isdigit(text[i]); ++i) ++digits;
+    }
+    if (digits == 0) return false;
+    if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+        ++i;
+        if (i < text.size() && (text[i] == '+' || text[i] == '-')) ++i;
+        size_t exp_digits = 0;
+        for (; i < text.size() && isdigit(text[i]); ++i) ++exp_digits;
+        if (exp_digits == 0) return false;
+    }
+    return i == text.size();
+}
+
+bool IsRelationName(const string &key) {
+    return !key.empty() && IsSymbol(key) && !IsNumberLiteral(key);
+}
+
+// Finds the implied deftemplate of an ordered fact relation, creates it if
+// the relation is new. Returns nullptr if @param relation can't start an
+// ordered fact, the same cases in which the assert parser reports an error.
+// @see GetRHSPattern in factrhs.cc
+struct deftemplate *ClipsFindRelation(void *clips, const string &relation) {
+    if (!IsRelationName(relation)) return nullptr;
+    const char *name = relation.c_str();
+    if (ReservedPatternSymbol(clips, name, nullptr)) return nullptr;
+
+    int count;
+    auto tmpl = static_cast<struct deftemplate *>(FindImportedConstruct(
+        clips, "deftemplate", nullptr, name, &count, TRUE, nullptr));
+    if (count > 1) return nullptr;
+    if (tmpl != nullptr) {
+        return tmpl->implied ? tmpl : nullptr;
+    }
+
+    if (Bloaded(clips)) return nullptr;
+    if (FindImportExportConflict(
+            clips, "deftemplate",
+            static_cast<struct defmodule *>(EnvGetCurrentModule(clips)),
+            name)) {
+        return nullptr;
+    }
+    return CreateImpliedDeftemplate(
+        clips, static_cast<SYMBOL_HN *>(EnvAddSymbol(clips, name)), TRUE);
+}
+
+struct FeatureRelation {
+    bool resolved = false;
+    struct deftemplate *tmpl = nullptr;
+};
+
+struct FeatureBindings {
+    FeatureBindings(const FeatureSchema *schema, size_t keys)
+        : schema(schema), known(keys) {}
+
+    // Forgets every resolved deftemplate, @see ResetFeatureBindings.
+    void Reset() {
+        known.assign(known.size(), FeatureRelation());
+        learned.clear();
+    }
+
+    const FeatureSchema *schema;
+    vector<FeatureRelation> known;
+    unordered_map<string, FeatureRelation> learned;
+};
+
+struct featureSchemaData {
+    FeatureBindings *bindings;
+};
+
+#define FeatureSchemaData(theEnv) \
+    ((struct featureSchemaData *)GetEnvironmentData(theEnv, FEATURE_SCHEMA_DATA))
+
+void DeallocateFeatureSchemaData(void *clips) {
+    delete FeatureSchemaData(clips)->bindings;
+}
+
+// The implied deftemplates are deleted by a clear or by a bload replacing the
+// constructs, they are resolved again afterwards.
+void ResetFeatureBindings(void *clips) {
+    auto bindings = FeatureSchemaData(clips)->bindings;
+    if (bindings != nullptr) bindings->Reset();
+}
+
+void ResolveRelation(void *clips, const string &key,
+                     FeatureRelation *relation) {
+    relation->resolved = true;
+    relation->tmpl = ClipsFindRelation(clips, key);
+}
+}  // anonymous namespace
+
+FeatureSchema::FeatureSchema(void *clips, bool prune)
+    : _pruning(prune && !EnvGetDynamicQueryTemplates(clips)) {
+    void *current_module = EnvGetCurrentModule(clips);
+    for (void *module = EnvGetNextDefmodule(clips, nullptr); module != nullptr;
+         module = EnvGetNextDefmodule(clips, module)) {
+        EnvSetCurrentModule(clips, module);
+        for (void *tmpl = EnvGetNextDeftemplate(clips, nullptr);
+             tmpl != nullptr; tmpl = EnvGetNextDeftemplate(clips, tmpl)) {
+            auto relation = static_cast<struct deftemplate *>(tmpl);
+            if (!relation->implied) continue;
+            string key = EnvGetDeftemplateName(clips, tmpl);
+            if (!IsRelationName(key) || _index.count(key)) continue;
+            _index.emplace(key, static_cast<int>(_keys.size()));
+            _keys.push_back(move(key));
+            _used.push_back(relation->patternNetwork != nullptr ||
+                            relation->queried);
+        }
+    }
+    EnvSetCurrentModule(clips, current_module);
+}
+
+json FeatureSchema::PruneReport(const json &features) const {
+    json report = {{"pruning", _pruning},
+                   {"kept", json::array()},
+                   {"pruned", json::array()}};
+    if (!features.is_object()) return report;
+
+    for (auto iter = features.begin(); iter != features.end(); ++iter) {
+        if (!IsRelationName(iter.key())) continue;
+        if (!iter.value().is_primitive() && !iter.value().is_array()) continue;
+        if (Prunes(Find(iter.key()))) {
+            report["pruned"].push_back(iter.key());
+        } else {
+            report["kept"].push_back(iter.key());
+        }
+    }
+    return report;
+}
+
+void FeatureSchema::AttachTo(void *clips) const {
+    if (GetEnvironmentData(clips, FEATURE_SCHEMA_DATA) == nullptr) {
+        if (!AllocateEnvironmentData(clips, FEATURE_SCHEMA_DATA,
+                                     sizeof(struct featureSchemaData),
+                                     DeallocateFeatureSchemaData)) {
+            throw std::runtime_error("clips AllocateEnvironmentData() failed");
+        }
+        EnvAddClearFunction(clips, "feature-schema", ResetFeatureBindings, 0);
+        AddBeforeBloadFunction(clips, "feature-schema", ResetFeatureBindings,
+                               0);
+    }
+
+    auto data = FeatureSchemaData(clips);
+    delete data->bindings;
+    data->bindings = new FeatureBindings(this, _keys.size());
+}
+
+struct deftemplate *ClipsFindFeatureRelation(void *clips, const string &key) {
+    auto data = FeatureSchemaData(clips);
+    if (data == nullptr || data->bindings == nullptr) {
+        return ClipsFindRelation(clips, key);
+    }
+
+    auto bindings = data->bindings;
+    int index = bindings->schema->Find(key);
+    if (bindings->schema->Prunes(index)) {
+        return nullptr;
+    }
+    if (index >= 0) {
+        auto &relation = bindings->known[index];
+        if (!relation.resolved) ResolveRelation(clips, key, &relation);
+        return relation.tmpl;
+    }
+
+    auto iter = bindings->learned.find(key);
+    if (iter != bindings->learned.end()) {
+        return iter->second.tmpl;
+    }
+    if (bindings->learned.size() >= kMaxLearnedKeys) {
+        return ClipsFindRelation(clips, key);
+    }
+    auto &relation = bindings->learned[key];
+    ResolveRelation(clips, key, &relation);
+    return relation.tmpl;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "lib/clips-utils.h"
+
+// Position of the per environment feature bindings, @see envrnmnt.h
+#define FEATURE_SCHEMA_DATA USER_ENVIRONMENT_DATA
+
+// Compiled view of the feature keys a rule set knows about: the relations of
+// its ordered facts, validated once. It's built once per ClipsFactory and
+// shared read only by all of its environments, every environment attached to
+// it caches the implied deftemplate of each key, so asserting a known key is
+// an index lookup instead of a symbol hash plus a construct search. The cache
+// is dropped when the environment is cleared or bloads other constructs.
+//
+// With pruning, features whose relation no rule pattern and no fact query can
+// see are not asserted at all. A relation is used if it has a pattern network
+// (it appears on the LHS of a defrule) or if a fact query names it. Pruning is
+// turned off if some fact query computes its templates at run time. Rules
+// reaching facts in other ways (get-fact-list, fact indices) must not be
+// combined with pruning.
+class FeatureSchema {
+   public:
+    // Collects the ordered fact relations of the constructs in @param clips.
+    FeatureSchema(void *clips, bool prune = false);
+
+    FeatureSchema(const FeatureSchema &) = delete;
+    FeatureSchema &operator=(const FeatureSchema &) = delete;
+
+    // Index of @param key in keys(), -1 if the rule set never mentions it.
+    inline int Find(const std::string &key) const {
+        auto iter = _index.find(key);
+        return iter == _index.end() ? -1 : iter->second;
+    }
+
+    inline const std::vector<std::string> &keys() const { return _keys; }
+
+    // Whether features no rule or query can match are dropped.
+    inline bool pruning() const { return _pruning; }
+
+    // Whether the key at @param index is dropped, -1 stands for unknown keys.
+    inline bool Prunes(int index) const {
+        return _pruning && (index < 0 || !_used[index]);
+    }
+
+    // Splits the keys of @param features that can be asserted into those kept
+    // and those pruned: {"pruning": bool, "kept": [...], "pruned": [...]}.
+    nlohmann::json PruneReport(const nlohmann::json &features) const;
+
+    // Attaches the schema to @param clips, the bindings are released together
+    // with the environment.
+    void AttachTo(void *clips) const;
+
+   private:
+    bool _pruning;
+    std::vector<std::string> _keys;
+    std::vector<bool> _used;
+    std::unordered_map<std::string, int> _index;
+};
+
+// Resolves the implied deftemplate @param key is asserted as in @param clips,
+// creating it when needed. Returns nullptr if @param key can't be the relation
+// name of an ordered fact. Results are cached when a schema is attached.
+struct deftemplate *ClipsFindFeatureRelation(void *clips,
+                                             const std::string &key);
@@ -0,0 +1,14 @@
+#include "lib/resource-pool.hpp"
+
+namespace {
+
+// Shared by every ResourcePool instantiation, a thread keeps its slot
+// number for all the pools it uses.
+std::atomic<unsigned int> next_thread(0);
+thread_local unsigned int thread_slot = next_thread++;
+
+}  // anonymous namespace
+
+unsigned int ResourcePoolThreadSlot() {
+    return thread_slot;
+}
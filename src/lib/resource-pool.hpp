@@ -1,11 +1,31 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <stdexcept>
 #include <string>
 #include <list>
 #include <limits>
+#include <thread>
+#include <vector>
+
+enum PoolMode {
+    // Idle resources in one list guarded by a mutex.
+    POOL_LOCKED_LIST = 0,
+    // Idle resources in per thread group shards of lock free slots. A thread
+    // returns its resource to its own slot and tends to get it back, empty
+    // shards are stolen from without locking.
+    POOL_SHARDED
+};
+
+// Home slot of the calling thread in a POOL_SHARDED pool. Threads are
+// numbered in order of their first access to any pool, whatever its
+// resource and factory types.
+unsigned int ResourcePoolThreadSlot();
 
 /**
  * FactoryT must have functions:
@@ -16,7 +36,8 @@ template <typename ResourceT, typename FactoryT>
 class ResourcePool {
    public:
     // Acquires owner ship of factory.
-    ResourcePool(unsigned int capacity, FactoryT *factory);
+    ResourcePool(unsigned int capacity, FactoryT *factory,
+                 PoolMode mode = POOL_LOCKED_LIST);
 
     ~ResourcePool();
 
@@ -42,39 +63,83 @@ class ResourcePool {
     template <typename ResultT>
     ResultT RunWithResource(std::function<ResultT(ResourceT *)> func);
 
+    // For callers keeping a resource across many uses, thread safe. Every
+    // acquired resource must be released, one that failed is released with
+    // @param failed and then destroyed like in RunWithResource.
+    ResourceT *Acquire() { return GetResource(); }
+    void Release(ResourceT *resource, bool failed = false);
+
    private:
+    static const unsigned int kCacheLine = 64;
+    static const unsigned int kSlotsPerShard = kCacheLine / sizeof(ResourceT *);
+
+    // One cache line of idle slots, only touched with atomic operations.
+    struct Shard {
+        std::atomic<ResourceT *> slots[kSlotsPerShard];
+    };
+
     ResourceT *GetResource();
     void PutResource(ResourceT *);
     void PutErrorResource(ResourceT *);
     void ClearPool();
 
+    ResourceT *TakeIdle();
+    void PutIdle(ResourceT *resource);
+    ResourceT *CreateResource();
+    void DestroyResource(ResourceT *resource);
+    static unsigned int ThreadSlot() { return ResourcePoolThreadSlot(); }
+
     unsigned int _capacity;
     unsigned int _max_capacity;
     bool _need_clear;
     std::unique_ptr<FactoryT> _factory;
+    PoolMode _mode;
 
-    std::mutex _pool_lock;  // protects the following two
-    unsigned int _size;
+    std::atomic<unsigned int> _size;
+
+    std::mutex _pool_lock;  // protects the list, and the overflow of shards
     std::list<ResourceT *> _idle;
+
+    std::unique_ptr<char[]> _shard_buffer;
+    Shard *_shards;  // cache line aligned inside _shard_buffer
+    unsigned int _shard_count;
 };
 
 template <typename ResourceT, typename FactoryT>
 ResourcePool<ResourceT, FactoryT>::ResourcePool(unsigned int capacity,
-                                                FactoryT *factory)
+                                                FactoryT *factory,
+                                                PoolMode mode)
     : _capacity(capacity),
       _max_capacity(std::numeric_limits<unsigned int>::max()),
+      _need_clear(true),
       _factory(factory),
+      _mode(mode),
       _size(0),
-      _need_clear(true) {
-    std::lock_guard<std::mutex> guard(_pool_lock);
-    for (unsigned int i = 0; i < _capacity; ++i) {
-        try {
-            _idle.push_front(_factory->Create());
-            ++_size;
-        } catch (std::exception &e) {
-            throw;
+      _shards(nullptr),
+      _shard_count(0) {
+    if (_mode == POOL_SHARDED) {
+        // Enough shards for every core and enough slots for every resource,
+        // a thread's home slot is (thread % shards, thread / shards).
+        unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+        unsigned int slots = std::max(cores, _capacity);
+        _shard_count =
+            std::max((slots + kSlotsPerShard - 1) / kSlotsPerShard, cores);
+        _shard_buffer.reset(new char[sizeof(Shard) * _shard_count + kCacheLine]);
+        auto address = reinterpret_cast<uintptr_t>(_shard_buffer.get());
+        _shards = reinterpret_cast<Shard *>((address + kCacheLine - 1) /
+                                            kCacheLine * kCacheLine);
+        for (unsigned int i = 0; i < _shard_count; ++i) {
+            new (&_shards[i]) Shard();
+            for (auto &slot : _shards[i].slots) {
+                slot.store(nullptr, std::memory_order_relaxed);
+            }
         }
     }
+
+    for (unsigned int i = 0; i < _capacity; ++i) {
+        PutIdle(_factory->Create());
+        ++_size;
+    }
 }
 
 template <typename ResourceT, typename FactoryT>
@@ -103,20 +168,24 @@ ResultT ResourcePool<ResourceT, FactoryT>::RunWithResource(
     }
 }
 
+template <typename ResourceT, typename FactoryT>
+void ResourcePool<ResourceT, FactoryT>::Release(ResourceT *resource,
+                                                bool failed) {
+    if (!failed) {
+        PutResource(resource);
+        return;
+    }
+    PutErrorResource(resource);
+    if (_need_clear) {
+        ClearPool();
+    }
+}
+
 template <typename ResourceT, typename FactoryT>
 ResourceT *ResourcePool<ResourceT, FactoryT>::GetResource() {
-    std::lock_guard<std::mutex> guard(_pool_lock);
-    ResourceT *resource;
-    if (!_idle.empty()) {
-        resource = _idle.front();
-        _idle.pop_front();
-    } else {
-        if (_size < _max_capacity) {
-            resource = _factory->Create();
-            ++_size;
-        } else {
-            throw std::runtime_error("resource pool reach max capacity");
-        }
+    ResourceT *resource = TakeIdle();
+    if (resource == nullptr) {
+        resource = CreateResource();
     }
     return resource;
 }
@@ -125,15 +194,10 @@ template <typename ResourceT, typename FactoryT>
 void ResourcePool<ResourceT, FactoryT>::PutResource(ResourceT *resource) {
     if (resource == nullptr) return;
 
-    std::lock_guard<std::mutex> guard(_pool_lock);
     if (_size >= _capacity && _need_clear) {
-        try {
-            _factory->Destroy(resource);
-        } catch (std::exception &e) {
-        }
-        --_size;
+        DestroyResource(resource);
     } else {
-        _idle.push_front(resource);
+        PutIdle(resource);
     }
 }
 
@@ -141,24 +205,93 @@ template <typename ResourceT, typename FactoryT>
 void ResourcePool<ResourceT, FactoryT>::PutErrorResource(ResourceT *resource) {
     if (resource == nullptr) return;
 
-    std::lock_guard<std::mutex> guard(_pool_lock);
-    try {
-        _factory->Destroy(resource);
-    } catch (std::exception &e) {
-    }
-    --_size;
+    DestroyResource(resource);
 }
 
 template <typename ResourceT, typename FactoryT>
 void ResourcePool<ResourceT, FactoryT>::ClearPool() {
+    ResourceT *resource;
+    while ((resource = TakeIdle()) != nullptr) {
+        DestroyResource(resource);
+    }
+}
+
+template <typename ResourceT, typename FactoryT>
+ResourceT *ResourcePool<ResourceT, FactoryT>::TakeIdle() {
+    if (_mode == POOL_SHARDED) {
+        // Own slot first for affinity, then the rest of the own shard, then
+        // steal from the other shards.
+        unsigned int home = ThreadSlot();
+        unsigned int first_shard = home % _shard_count;
+        unsigned int first_slot = home / _shard_count % kSlotsPerShard;
+        for (unsigned int i = 0; i < _shard_count; ++i) {
+            Shard &shard = _shards[(first_shard + i) % _shard_count];
+            for (unsigned int j = 0; j < kSlotsPerShard; ++j) {
+                auto &slot = shard.slots[(first_slot + j) % kSlotsPerShard];
+                if (slot.load(std::memory_order_relaxed) == nullptr) continue;
+                ResourceT *resource =
+                    slot.exchange(nullptr, std::memory_order_acquire);
+                if (resource != nullptr) return resource;
+            }
+        }
+    }
+
     std::lock_guard<std::mutex> guard(_pool_lock);
-    while (!_idle.empty()) {
-        auto resource = _idle.front();
-        _idle.pop_front();
-        try {
-            _factory->Destroy(resource);
-        } catch (std::exception &e) {
+    if (_idle.empty()) return nullptr;
+    ResourceT *resource = _idle.front();
+    _idle.pop_front();
+    return resource;
+}
+
+template <typename ResourceT, typename FactoryT>
+void ResourcePool<ResourceT, FactoryT>::PutIdle(ResourceT *resource) {
+    if (_mode == POOL_SHARDED) {
+        unsigned int home = ThreadSlot();
+        unsigned int first_shard = home % _shard_count;
+        unsigned int first_slot = home / _shard_count % kSlotsPerShard;
+        for (unsigned int i = 0; i < _shard_count; ++i) {
+            Shard &shard = _shards[(first_shard + i) % _shard_count];
+            for (unsigned int j = 0; j < kSlotsPerShard; ++j) {
+                auto &slot = shard.slots[(first_slot + j) % kSlotsPerShard];
+                ResourceT *expected = nullptr;
+                if (slot.load(std::memory_order_relaxed) == nullptr &&
+                    slot.compare_exchange_strong(expected, resource,
+                                                 std::memory_order_release)) {
+                    return;
+                }
+            }
         }
+    }
+
+    // The only place of the locked list mode, and the overflow of the
+    // sharded one when every slot is taken.
+    std::lock_guard<std::mutex> guard(_pool_lock);
+    _idle.push_front(resource);
+}
+
+template <typename ResourceT, typename FactoryT>
+ResourceT *ResourcePool<ResourceT, FactoryT>::CreateResource() {
+    unsigned int size = _size.load();
+    do {
+        if (size >= _max_capacity) {
+            throw std::runtime_error("resource pool reach max capacity");
+        }
+    } while (!_size.compare_exchange_weak(size, size + 1));
+
+    try {
+        return _factory->Create();
+    } catch (...) {
         --_size;
+        throw;
     }
-}
\ No newline at end of file
+}
+
+template <typename ResourceT, typename FactoryT>
+void ResourcePool<ResourceT, FactoryT>::DestroyResource(ResourceT *resource) {
+    try {
+        _factory->Destroy(resource);
+    } catch (std::exception &e) {
+    }
+    --_size;
+}
+
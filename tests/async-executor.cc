@@ -0,0 +1,57 @@
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "check.h"
+#include "lib/async-clips-executor.h"
+
+using nlohmann::json;
+
+namespace {
+
+const char *kRules =
+    "(deftemplate y (slot v))\n"
+    "(defrule double (x ?x) => (assert (y (v (* 2 ?x)))))\n"
+    "(deffunction get-result () (nth 1 (find-fact ((?f y)) TRUE)))";
+
+}  // anonymous namespace
+
+// Every worker keeps one environment for all its requests, and replaces it
+// only after an execution threw.
+int main() {
+    const unsigned int kWorkers = 3;
+    auto pool = std::make_shared<ClipsPool>(0, new ClipsFactory(kRules));
+    pool->set_need_clear(false);
+    {
+        AsyncClipsExecutor executor(pool, kWorkers, 16, "get-result");
+        std::vector<std::future<json>> results;
+        for (int i = 0; i < 200; ++i) {
+            results.push_back(executor.Submit(json{{"x", i}}));
+        }
+        for (int i = 0; i < 200; ++i) {
+            CHECK_EQ(results[i].get(), json({{"v", 2 * i}}));
+        }
+        CHECK(pool->get_size() <= kWorkers);
+
+        // Features that aren't an object make the execution throw.
+        auto failed = executor.Submit(json::array({1}));
+        bool threw = false;
+        try {
+            failed.get();
+        } catch (const std::invalid_argument &) {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK_EQ(executor.Submit(json{{"x", 21}}).get(), json({{"v", 42}}));
+        CHECK(pool->get_size() <= kWorkers);
+
+        auto metrics = executor.Metrics();
+        CHECK_EQ(metrics.completed, 201u);
+        CHECK_EQ(metrics.failed, 1u);
+    }
+    // The workers gave their environments back to the pool.
+    unsigned int idle = pool->get_size();
+    CHECK(idle >= 1 && idle <= kWorkers);
+    return 0;
+}
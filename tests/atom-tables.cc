@@ -0,0 +1,108 @@
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+namespace {
+
+const int kAtoms = 50000;
+
+std::string Name(int i) { return "s" + std::to_string(i); }
+
+// Numbers too large to be immediate, which are kept in the tables.
+double Float(int i) { return std::ldexp(1.0 + i / 65536.0, 600); }
+
+long long Integer(int i) { return (1LL << 62) + i; }
+
+// Rules and facts with many symbols, so that the tables of the environment
+// have grown when the image is saved.
+std::string Rules() {
+    std::string rules = "(deffacts names";
+    for (int i = 0; i < 3000; ++i) {
+        rules += " (name " + Name(i) + " " + std::to_string(i) + " " +
+                 std::to_string(i) + ".5)";
+    }
+    rules += ")\n"
+             "(defrule found (a.x ?x) (name ?n ?x ?f)"
+             " => (assert (hit ?n ?f)))\n"
+             "(deffunction get-result () (bind ?r (create$))"
+             " (do-for-all-facts ((?f hit)) TRUE"
+             " (bind ?r (create$ ?r (fact-slot-value ?f implied)))) ?r)";
+    return rules;
+}
+
+json Execute(void *clips, int x) {
+    int halt = 0;
+    return ClipsModuleExecute(clips, {{"a.x", x}}, -1, "get-result", halt);
+}
+
+}  // anonymous namespace
+
+// The atom tables start small and grow by linear hashing: every atom added
+// is found again as the same node, before and after the tables grew, and in
+// an environment loaded from an image saved with grown tables.
+int main() {
+    auto clips = CreateClips("");
+    unsigned long initial_symbols = GetSymbolTableSize(clips.get());
+    unsigned long initial_floats = GetFloatTableSize(clips.get());
+    unsigned long initial_integers = GetIntegerTableSize(clips.get());
+    CHECK(initial_symbols < 1024);
+
+    std::vector<void *> symbols, floats, integers;
+    for (int i = 0; i < kAtoms; ++i) {
+        symbols.push_back(EnvAddSymbol(clips.get(), Name(i).c_str()));
+        IncrementSymbolCount(symbols.back());
+        floats.push_back(EnvAddDouble(clips.get(), Float(i)));
+        IncrementFloatCount(floats.back());
+        integers.push_back(EnvAddLong(clips.get(), Integer(i)));
+        IncrementIntegerCount(integers.back());
+        // Atoms added before the table grew are found after it.
+        if (i % 997 == 0) {
+            for (int j = 0; j <= i; j += 101) {
+                CHECK(FindSymbolHN(clips.get(), Name(j).c_str()) ==
+                      symbols[j]);
+            }
+        }
+    }
+    CHECK(GetSymbolTableSize(clips.get()) >= kAtoms / 2);
+    CHECK(GetFloatTableSize(clips.get()) > initial_floats);
+    CHECK(GetIntegerTableSize(clips.get()) > initial_integers);
+
+    for (int i = 0; i < kAtoms; ++i) {
+        CHECK(EnvAddSymbol(clips.get(), Name(i).c_str()) == symbols[i]);
+        CHECK_EQ(std::string(ValueToString(symbols[i])), Name(i));
+        CHECK(EnvAddDouble(clips.get(), Float(i)) == floats[i]);
+        CHECK(EnvAddLong(clips.get(), Integer(i)) == integers[i]);
+        CHECK(FindLongHN(clips.get(), Integer(i)) == integers[i]);
+    }
+    CHECK(FindSymbolHN(clips.get(), Name(kAtoms).c_str()) == nullptr);
+
+    // An image saved from grown tables.
+    auto parsed = CreateClips(Rules());
+    std::string image = ClipsBsaveImage(parsed.get());
+    auto loaded = CreateClips("");
+    ClipsBloadImage(loaded.get(), image.data(), image.size());
+    for (int x : {0, 7, 2999, 3000}) {
+        CHECK_EQ(Execute(loaded.get(), x), Execute(parsed.get(), x));
+    }
+    CHECK_EQ(Execute(loaded.get(), 42), json::array({"s42", 42.5}));
+
+    // The symbols of the image are those found by name, and new ones still
+    // grow the tables.
+    void *name = FindSymbolHN(loaded.get(), Name(2999).c_str());
+    CHECK(name != nullptr);
+    CHECK(EnvAddSymbol(loaded.get(), Name(2999).c_str()) == name);
+    unsigned long size = GetSymbolTableSize(loaded.get());
+    for (int i = 0; i < kAtoms; ++i) {
+        std::string other = "t" + Name(i);
+        IncrementSymbolCount(EnvAddSymbol(loaded.get(), other.c_str()));
+    }
+    CHECK(GetSymbolTableSize(loaded.get()) > size);
+    CHECK(FindSymbolHN(loaded.get(), Name(2999).c_str()) == name);
+    CHECK_EQ(Execute(loaded.get(), 42), json::array({"s42", 42.5}));
+    return 0;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdlib>
+#include <iostream>
+
+// Stops the test program with a failure when @param cond doesn't hold.
+#define CHECK(cond)                                                      \
+    do {                                                                 \
+        if (!(cond)) {                                                   \
+            std::cerr << __FILE__ << ":" << __LINE__                     \
+                      << ": CHECK(" #cond ") failed" << std::endl;       \
+            std::exit(1);                                                \
+        }                                                                \
+    } while (0)
+
+// Like CHECK(a == b), printing both values when they differ.
+#define CHECK_EQ(a, b)                                                   \
+    do {                                                                 \
+        const auto &check_a_ = (a);                                      \
+        const auto &check_b_ = (b);                                      \
+        if (!(check_a_ == check_b_)) {                                   \
+            std::cerr << __FILE__ << ":" << __LINE__                     \
+                      << ": CHECK_EQ(" #a ", " #b ") failed\n  "         \
+                      << check_a_ << "\n  " << check_b_ << std::endl;    \
+            std::exit(1);                                                \
+        }                                                                \
+    } while (0)
@@ -0,0 +1,116 @@
+#include <string>
+
+#include "check.h"
+#include "lib/clips-factory.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+const int kAccounts = 50;
+
+// Join tests mixing the inlined comparisons, arithmetic, eq, neq, not, and
+// and or with calls left to the tree walker.
+std::string Rules() {
+    std::string rules =
+        "(deftemplate profile (slot acct) (slot avg) (slot home)"
+        " (slot limit))\n"
+        "(deftemplate txn (slot acct) (slot amount) (slot country)"
+        " (slot hour))\n";
+    const char *tests[] = {
+        "(and (> ?amt (* ?avg K)) (neq ?c ?h))",
+        "(or (> (+ ?amt K) ?l) (and (>= ?hr H) (< ?amt (- ?avg ?l))))",
+        "(and (<> ?hr H) (not (eq ?c ?h)) (> (* ?amt 0.05) (+ ?avg K)))",
+        "(or (= ?amt ?l) (eq ?c c1 c2 ?h) (<= (- 0 ?amt) -1190))",
+        "(and (> (abs (- ?amt ?avg)) (* K 40)) (<= ?hr H 23))",
+    };
+    for (int i = 0; i < 100; ++i) {
+        std::string test = tests[i % 5];
+        std::string::size_type at;
+        while ((at = test.find('K')) != std::string::npos) {
+            test.replace(at, 1, std::to_string(15 + i % 7));
+        }
+        while ((at = test.find('H')) != std::string::npos) {
+            test.replace(at, 1, std::to_string(i % 24));
+        }
+        std::string index = std::to_string(i);
+        rules += "(defrule r" + index +
+                 " (profile (acct ?a) (avg ?avg) (home ?h) (limit ?l))"
+                 " ?t <- (txn (acct ?a) (amount ?amt) (country ?c)"
+                 " (hour ?hr)) (test " + test + ") => (assert (hit " + index +
+                 " (fact-index ?t))))\n";
+    }
+    return rules;
+}
+
+void Assert(void *clips, const std::string &fact) {
+    EnvAssertString(clips, fact.c_str());
+}
+
+// The facts of @param clips in their printed form, one per line.
+std::string FactList(void *clips) {
+    std::string facts;
+    char buffer[256];
+    for (void *fact = EnvGetNextFact(clips, nullptr); fact != nullptr;
+         fact = EnvGetNextFact(clips, fact)) {
+        EnvGetFactPPForm(clips, buffer, sizeof(buffer), fact);
+        facts += buffer;
+        facts += "\n";
+    }
+    return facts;
+}
+
+// Runs transactions through @param clips, the last one with an amount that
+// isn't a number, and returns the facts and error output.
+std::string Workload(void *clips) {
+    EnvReset(clips);
+    for (int a = 0; a < kAccounts; ++a) {
+        std::string acct = std::to_string(a);
+        Assert(clips, "(profile (acct a" + acct + ") (avg " +
+                          std::to_string(50 + a) + ") (home c" +
+                          std::to_string(a % 5) + ") (limit " +
+                          std::to_string(1000 + a * 10) + "))");
+    }
+    for (int i = 0; i < 2000; ++i) {
+        Assert(clips, "(txn (acct a" + std::to_string(i % kAccounts) +
+                          ") (amount " + std::to_string(i * 37 % 1200) +
+                          (i % 2 ? ".5" : "") + ") (country c" +
+                          std::to_string(i % 7) + ") (hour " +
+                          std::to_string(i % 24) + "))");
+    }
+    EnvRun(clips, -1);
+    std::string output = FactList(clips);
+
+    char errors[1024] = "";
+    OpenStringDestination(clips, "werror", errors, sizeof(errors));
+    Assert(clips, "(txn (acct a3) (amount unknown) (country c1) (hour 4))");
+    EnvRun(clips, -1);
+    CloseStringDestination(clips, "werror");
+    CHECK_EQ(GetHaltExecution(clips), TRUE);
+    SetHaltExecution(clips, FALSE);
+    SetEvaluationError(clips, FALSE);
+    return output + errors;
+}
+
+}  // anonymous namespace
+
+// Compiled join tests fire the same rules in the same order, and report the
+// same errors, as the tests walked by EvaluateExpression.
+int main() {
+    auto reference = CreateClips(Rules());
+    std::string expected = Workload(reference.get());
+    CHECK(expected.find("[ARGACCES5]") != std::string::npos);
+
+    auto compiled = CreateClips(Rules());
+    CHECK(EnvCompileJoinExpressions(compiled.get()) > 0);
+    CHECK_EQ(Workload(compiled.get()), expected);
+
+    for (bool shared : {false, true}) {
+        ClipsFactory factory(Rules(), false, true);
+        factory.set_shared_network(shared);
+        factory.set_compiled_expressions(true);
+        void *clips = factory.Create();
+        CHECK_EQ(Workload(clips), expected);
+        factory.Destroy(clips);
+    }
+    return 0;
+}
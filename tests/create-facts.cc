@@ -0,0 +1,61 @@
+#include <string>
+
+#include "lib/clips-utils.h"
+#include "check.h"
+
+using nlohmann::json;
+
+namespace {
+
+// The facts of @param clips in their printed form, one per line.
+std::string FactList(void *clips) {
+    std::string facts;
+    char buffer[512];
+    for (void *fact = EnvGetNextFact(clips, nullptr); fact != nullptr;
+         fact = EnvGetNextFact(clips, fact)) {
+        EnvGetFactPPForm(clips, buffer, sizeof(buffer), fact);
+        facts += buffer;
+        facts += "\n";
+    }
+    return facts;
+}
+
+}  // anonymous namespace
+
+// ClipsCreateFacts asserts atoms of the types the former load-facts text
+// path read back from the printed features, with floats at full precision
+// rather than 6 significant digits.
+int main() {
+    auto clips = CreateClips("(defrule integral (b 11) (c 0) (g 1 3 $?) => )\n"
+                             "(defrule large (h ?h&:(floatp ?h)) => )");
+    EnvReset(clips.get());
+
+    json features = json::object();
+    features["a"] = 11;
+    features["b"] = 11.0;
+    features["c"] = -0.0;
+    features["d"] = 2.5;
+    features["e"] = "text";
+    features["f"] = true;
+    features["g"] = json::array({1, 3.0, "x", false, 0.25});
+    features["h"] = 1000000.0;
+    features["i"] = -9007199254740992.0;
+    ClipsCreateFacts(clips.get(), features);
+
+    CHECK_EQ(FactList(clips.get()),
+             std::string("f-0     (initial-fact)\n"
+                         "f-1     (a 11)\n"
+                         "f-2     (b 11)\n"
+                         "f-3     (c 0)\n"
+                         "f-4     (d 2.5)\n"
+                         "f-5     (e \"text\")\n"
+                         "f-6     (f TRUE)\n"
+                         "f-7     (g 1 3 \"x\" FALSE 0.25)\n"
+                         "f-8     (h 1000000.0)\n"
+                         "f-9     (i -9.00719925474099e+15)\n"));
+
+    // Integral doubles below 1e6 are INTEGER atoms, so they match integer
+    // patterns, larger ones are FLOAT atoms.
+    CHECK_EQ(EnvRun(clips.get(), -1), 2);
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include <stdexcept>
+#include <vector>
+
+#include "check.h"
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+namespace {
+
+// a.x 3 halts the run before bad-div fires, a.x 4 fails a rule action, and
+// a.x 5 fails the result function.
+const char *kRules =
+    "(deftemplate hit (slot v))\n"
+    "(deffacts d (black 1) (black 2))\n"
+    "(defrule match (a.x ?x) (black ?x) => (assert (hit (v ?x))))\n"
+    "(defrule stop (declare (salience 10)) (a.x 3) => (halt))\n"
+    "(defrule bad-div (a.x ?x&3|4) => (assert (hit (v (div ?x 0)))))\n"
+    "(defrule low (declare (salience -10)) (a.x ?x) (not (black ?x))"
+    " => (assert (hit (v low))))\n"
+    "(defrule fail (a.x 5) => (assert (fail)))\n"
+    "(deffunction get-result () (bind ?r (create$))"
+    " (if (any-factp ((?f fail)) TRUE) then (bind ?r (div 1 0)))"
+    " (do-for-all-facts ((?f hit)) TRUE"
+    " (bind ?r (create$ ?r (fact-slot-value ?f v)))) ?r)";
+
+std::vector<json> Items(const std::vector<int> &values) {
+    std::vector<json> items;
+    for (int x : values) items.push_back({{"a.x", x}, {"a.y", x * 2}});
+    return items;
+}
+
+// Runs each item with ClipsModuleExecute and compares with the batch.
+void CheckBatch(void *batch, void *single, const std::vector<json> &items,
+                bool rollback) {
+    std::vector<int> halts;
+    ClipsBatchTiming timing;
+    std::vector<json> results = ClipsExecuteBatch(
+        batch, items, 1000, "get-result", halts, &timing, rollback);
+    CHECK_EQ(results.size(), items.size());
+    CHECK_EQ(halts.size(), items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        int halt = -1;
+        CHECK_EQ(results[i], ClipsModuleExecute(single, items[i], 1000,
+                                                "get-result", halt,
+                                                rollback));
+        CHECK_EQ(halts[i], halt);
+    }
+}
+
+bool Throws(void *clips, const std::vector<json> &items) {
+    std::vector<int> halts;
+    try {
+        ClipsExecuteBatch(clips, items, 1000, "get-result", halts);
+    } catch (std::runtime_error &) {
+        return true;
+    }
+    return false;
+}
+
+}  // anonymous namespace
+
+// Each item of a batch gets the result and halt flag ClipsModuleExecute
+// gives it, including items halted by a rule or by an error, and an item
+// failing the result function throws like it does alone.
+int main() {
+    auto batch = CreateClips(kRules);
+    auto single = CreateClips(kRules);
+    std::vector<json> items = Items({1, 2, 3, 6, 4, 1, 2, 3, 4, 7});
+
+    std::vector<int> halts;
+    ClipsExecuteBatch(batch.get(), items, 1000, "get-result", halts);
+    CHECK_EQ(halts[2], 0);
+    CHECK_EQ(halts[4], 1);
+
+    for (bool rollback : {false, true}) {
+        CheckBatch(batch.get(), single.get(), items, rollback);
+    }
+
+    CHECK(Throws(batch.get(), Items({1, 5, 2})));
+    int halt = 0;
+    bool single_throws = false;
+    try {
+        ClipsModuleExecute(single.get(), Items({5})[0], 1000, "get-result",
+                           halt);
+    } catch (std::runtime_error &) {
+        single_throws = true;
+    }
+    CHECK(single_throws);
+
+    // The environment is still usable after the failed batch.
+    CheckBatch(batch.get(), single.get(), items, false);
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <string>
+
+#include "check.h"
+#include "lib/clips-factory.h"
+#include "lib/clips-utils.h"
+#include "lib/resource-pool.hpp"
+
+using nlohmann::json;
+
+namespace {
+
+using ClipsPool = ResourcePool<void, ClipsFactory>;
+
+// Five rules asserting a hit each in salience order, r2's hit retracted
+// right after it's asserted, and a rule below them all counting the hits.
+const char *kRules =
+    "(deftemplate hit (slot rule) (slot score))\n"
+    "(defrule r1 (declare (salience 50)) (list.score ?s&:(> ?s 1))"
+    " => (assert (hit (rule r1) (score ?s))))\n"
+    "(defrule r2 (declare (salience 40)) (list.score ?s&:(> ?s 2))"
+    " => (assert (hit (rule r2) (score ?s))))\n"
+    "(defrule r3 (declare (salience 30)) (list.score ?s&:(> ?s 3))"
+    " => (assert (hit (rule r3) (score ?s))))\n"
+    "(defrule r4 (declare (salience 20)) (list.score ?s&:(> ?s 4))"
+    " => (assert (hit (rule r4) (score ?s))))\n"
+    "(defrule r5 (declare (salience 10)) (list.score ?s&:(> ?s 5))"
+    " => (assert (hit (rule r5) (score ?s))))\n"
+    "(defrule refund (declare (salience 100)) ?h <- (hit (rule r2))"
+    " => (retract ?h))\n"
+    "(defrule total (declare (salience -100)) (list.score ?)"
+    " => (assert (total done)))\n"
+    "(deffunction get-result ()"
+    " (create$ (length$ (find-all-facts ((?f hit)) TRUE))"
+    " (length$ (find-all-facts ((?f total)) TRUE))))";
+
+json Hit(const std::string &rule) {
+    return {{"rule", rule}, {"score", 9}};
+}
+
+json Hits(void *clips, size_t max_hits, bool rollback, bool &stopped) {
+    int halt = -1;
+    json hits = ClipsExecuteHits(clips, {{"list.score", 9}}, -1, "hit",
+                                 max_hits, halt, rollback, &stopped);
+    CHECK_EQ(halt, 0);
+    return hits;
+}
+
+void CheckHits(void *clips, bool rollback) {
+    bool stopped = false;
+    CHECK_EQ(Hits(clips, 1, rollback, stopped), json::array({Hit("r1")}));
+    CHECK(stopped);
+
+    // r2's hit counts towards the limit but isn't returned.
+    CHECK_EQ(Hits(clips, 3, rollback, stopped),
+             json::array({Hit("r1"), Hit("r3")}));
+    CHECK(stopped);
+
+    CHECK_EQ(Hits(clips, 10, rollback, stopped),
+             json::array({Hit("r1"), Hit("r3"), Hit("r4"), Hit("r5")}));
+    CHECK(!stopped);
+}
+
+// Runs the hits and then the whole rule set on the only environment of a
+// pool, which must not stop on the limit of the previous run.
+void CheckPool(ClipsFactory *factory) {
+    ClipsPool pool(1, factory);
+    for (bool rollback : {false, true}) {
+        json result = pool.RunWithResource<json>([&](void *clips) {
+            CheckHits(clips, rollback);
+            int halt = -1;
+            return ClipsModuleExecute(clips, {{"list.score", 9}}, -1,
+                                      "get-result", halt, rollback);
+        });
+        CHECK_EQ(result, json::array({4, 1}));
+    }
+}
+
+}  // anonymous namespace
+
+// ClipsExecuteHits returns the first hits still asserted, reports whether
+// the limit stopped the run, and leaves no limit behind, with eager and lazy
+// matching.
+int main() {
+    for (bool lazy : {false, true}) {
+        auto clips = CreateClips(kRules);
+        EnvSetLazyMatching(clips.get(), lazy);
+        CheckHits(clips.get(), false);
+        CheckHits(clips.get(), true);
+
+        bool stopped = true;
+        int halt = -1;
+        CHECK_EQ(ClipsExecuteHits(clips.get(), {{"list.score", 0}}, -1,
+                                  "hit", 1, halt, false, &stopped),
+                 json::array());
+        CHECK(!stopped);
+
+        auto *factory = new ClipsFactory(kRules, false, true);
+        factory->set_lazy_matching(lazy);
+        CheckPool(factory);
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <set>
+#include <string>
+
+#include "check.h"
+#include "lib/clips-factory.h"
+
+namespace {
+
+const int kRules = 200;
+const int kFacts = 2000;
+
+std::string Symbol(const char *prefix, int i) {
+    return prefix + std::to_string(i);
+}
+
+// Rule h<i> uses a field form the fact selectors dispatch on (a disjunction,
+// negated constants, a test CE equality or inequality), rule r<i> the same
+// condition as a predicate constraint, which is tested node by node.
+std::string Rules() {
+    std::string rules =
+        "(deftemplate txn (slot mcc) (slot country) (slot channel)"
+        " (slot amount))\n";
+    for (int i = 0; i < kRules; ++i) {
+        std::string m = Symbol("m", i % 50);
+        std::string m2 = Symbol("m", (i * 7 + 3) % 50);
+        std::string m3 = Symbol("m", (i * 13 + 5) % 50);
+        std::string c = Symbol("c", i / 4 % 20);
+        std::string hashed, reference;
+        switch (i % 5) {
+            case 0:
+                hashed = "(mcc " + m + "|" + m2 + "|" + m3 + ") (country " +
+                         c + ")";
+                reference = "(mcc ?m&:(or (eq ?m " + m + ") (eq ?m " + m2 +
+                            ") (eq ?m " + m3 + "))) (country ?c&:(eq ?c " +
+                            c + "))";
+                break;
+            case 1:
+                hashed = "(mcc ?m&~" + m + "&~" + m2 + ") (country " + c +
+                         ") (channel web)";
+                reference = "(mcc ?m&:(neq ?m " + m + " " + m2 +
+                            ")) (country ?c&:(eq ?c " + c +
+                            ")) (channel ?ch&:(eq ?ch web))";
+                break;
+            case 2:
+                hashed = "(mcc ?m) (country ?c) (amount ?a))"
+                         " (test (and (eq ?m " + m + ") (eq " + c +
+                         " ?c) (> ?a 10))";
+                reference = "(mcc ?m&:(eq ?m " + m + ")) (country ?c&:(eq ?c " +
+                            c + ")) (amount ?a&:(> ?a 10))";
+                break;
+            case 3:
+                hashed = "(mcc " + m + ") (channel ?ch))"
+                         " (test (neq ?ch pos atm)";
+                reference = "(mcc ?m&:(eq ?m " + m +
+                            ")) (channel ?ch&:(neq ?ch pos atm))";
+                break;
+            case 4:
+                // The field's variable comparisons still apply under the
+                // selector.
+                hashed = "(mcc ?m&" + m + "|" + m2 + ") (country ?m)";
+                reference = "(mcc ?m&:(or (eq ?m " + m + ") (eq ?m " + m2 +
+                            "))) (country ?c&:(eq ?c ?m))";
+                break;
+        }
+        std::string index = std::to_string(i);
+        rules += "(defrule h" + index + " ?f <- (txn " + hashed +
+                 ") => (assert (hit " + index + " (fact-index ?f))))\n";
+        rules += "(defrule r" + index + " ?f <- (txn " + reference +
+                 ") => (assert (ref " + index + " (fact-index ?f))))\n";
+    }
+    return rules;
+}
+
+// Symbols, along with strings and numbers that print like them.
+std::string Value(const char *prefix, int i) {
+    std::string symbol = Symbol(prefix, i);
+    switch (i % 7) {
+        case 0: return "\"" + symbol + "\"";
+        case 1: return std::to_string(i);
+        default: return symbol;
+    }
+}
+
+// The "hit" or "ref" facts of @param clips, without their relation name.
+std::set<std::string> Matches(void *clips, const std::string &relation) {
+    std::set<std::string> matches;
+    char buffer[256];
+    for (void *fact = EnvGetNextFact(clips, nullptr); fact != nullptr;
+         fact = EnvGetNextFact(clips, fact)) {
+        EnvGetFactPPForm(clips, buffer, sizeof(buffer), fact);
+        std::string form = buffer;
+        std::string::size_type start = form.find('(');
+        if (form.compare(start + 1, relation.size(), relation) == 0) {
+            matches.insert(form.substr(start + 1 + relation.size()));
+        }
+    }
+    return matches;
+}
+
+}  // anonymous namespace
+
+// Rules dispatched through the fact selectors match the same facts as the
+// same conditions tested node by node, whether the rules are parsed, loaded
+// from a binary image or shared.
+int main() {
+    const char *channels[] = {"web", "pos", "atm", "app"};
+    for (int mode = 0; mode < 3; ++mode) {
+        ClipsFactory factory(Rules(), false, mode != 0);
+        factory.set_shared_network(mode == 2);
+        void *clips = factory.Create();
+        EnvReset(clips);
+        for (int i = 0; i < kFacts; ++i) {
+            std::string country = i % 11 == 0 ? Value("m", i % 50)
+                                              : Value("c", i / 50 % 20);
+            std::string fact = "(txn (mcc " + Value("m", i % 50) +
+                               ") (country " + country + ") (channel " +
+                               channels[i % 4] + ") (amount " +
+                               std::to_string(i % 40) + "))";
+            EnvAssertString(clips, fact.c_str());
+        }
+        EnvRun(clips, -1);
+        auto hits = Matches(clips, "hit");
+        CHECK(!hits.empty());
+        CHECK_EQ(hits.size(), Matches(clips, "ref").size());
+        CHECK(hits == Matches(clips, "ref"));
+        factory.Destroy(clips);
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include <memory>
+#include <string>
+
+#include "check.h"
+#include "lib/clips-factory.h"
+
+using nlohmann::json;
+
+namespace {
+
+const char *kRules =
+    "(deftemplate hit (slot v))\n"
+    "(defrule known (a.x ?x) => (assert (hit (v ?x))))\n"
+    "(deffunction get-result () (nth 1 (find-fact ((?f hit)) TRUE)))";
+
+json Execute(void *clips, const json &features) {
+    int halt = 0;
+    return ClipsModuleExecute(clips, features, 100, "get-result", halt);
+}
+
+}  // anonymous namespace
+
+// The deftemplates cached by the attached schema are resolved again once the
+// constructs they belong to are cleared or replaced.
+int main() {
+    for (bool clone : {false, true}) {
+        ClipsFactory factory(kRules, false, clone);
+        clips_ptr clips(factory.Create());
+        // a.y is learned, a.x is a key of the schema.
+        json features = {{"a.x", 1}, {"a.y", 2}};
+        CHECK_EQ(Execute(clips.get(), features), json({{"v", 1}}));
+
+        EnvClear(clips.get());
+        CHECK_EQ(ClipsEnvLoadFromString(clips.get(), kRules), 1);
+        CHECK_EQ(Execute(clips.get(), features), json({{"v", 1}}));
+
+        std::string image = ClipsBsaveImage(clips.get());
+        ClipsBloadImage(clips.get(), image.data(), image.size());
+        features["a.x"] = 3;
+        CHECK_EQ(Execute(clips.get(), features), json({{"v", 3}}));
+    }
+    return 0;
+}
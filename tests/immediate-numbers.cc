@@ -0,0 +1,88 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "check.h"
+#include "lib/clips-factory.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+// Expressions whose results straddle the immediate ranges (integers in
+// [-2^62, 2^62), floats with a binary exponent within -511..511) and their
+// printed value, as printed with numbers kept in the atom tables.
+const std::vector<std::pair<const char *, const char *>> kGolden = {
+    {"(+ 1 2)", "3"},
+    {"(* 4611686018427387903 1)", "4611686018427387903"},
+    {"(- -4611686018427387904 1)", "-4611686018427387905"},
+    {"(* 4611686018427387904 2)", "-9223372036854775808"},
+    {"(- 9223372036854775807 1)", "9223372036854775806"},
+    {"(+ 0.0 0.0)", "0.0"},
+    {"(* -1.0 0.0)", "-0.0"},
+    {"(* 1.0e300 1.0e10)", "inf.0"},
+    {"(/ 1.0e-300 1.0e10)", "9.99999999999997e-311"},
+    {"(/ 1.5 3)", "0.5"},
+    {"(** 2 600)", "4.14951556888099e+180"},
+    {"(** 2 -600)", "2.40991986510288e-181"},
+    {"(eq 3.25 (/ 6.5 2))", "TRUE"},
+    {"(eq 4611686018427387904 (+ 4611686018427387903 1))", "TRUE"},
+    {"(neq 1.0e-200 1.0e-200)", "FALSE"},
+    {"(integer 1.0e18)", "1000000000000000000"},
+    {"(float 7)", "7.0"},
+    {"(create$ 1 2.5 -3 1e200 0.0)", "(1 2.5 -3 1e+200 0.0)"},
+    {"(= 2 2.0)", "TRUE"},
+    {"(abs -9.5)", "9.5"},
+    {"(max 1 2.5 -1e300)", "2.5"},
+    {"(str-cat 0.1 \" \" 123456789012345)", "\"0.1 123456789012345\""},
+};
+
+// Rule patterns and slot values on both sides of the immediate ranges.
+const char *kRules =
+    "(deftemplate a (slot x) (multislot m))\n"
+    "(defrule r1 (a (x ?x&:(> ?x 2.5))) => (assert (hit (+ ?x 1))))\n"
+    "(defrule r2 (a (x 4611686018427387904) (m $? 1.0e-320 $?))"
+    " => (assert (hit 1000)))\n"
+    "(defrule r3 (a (x 7)) (a (x ?y&1.25|0.0)) => (assert (hit (* ?y 3))))\n"
+    "(deffunction hits () (bind ?r (create$))"
+    " (do-for-all-facts ((?f hit)) TRUE (bind ?r (create$ ?r ?f:implied)))"
+    " ?r)";
+
+std::string Print(void *clips, const char *expression) {
+    DATA_OBJECT result;
+    char buffer[256];
+    EnvEval(clips, expression, &result);
+    OpenStringDestination(clips, "value", buffer, sizeof(buffer));
+    PrintDataObject(clips, "value", &result);
+    CloseStringDestination(clips, "value");
+    return buffer;
+}
+
+}  // anonymous namespace
+
+// Numbers print and compare the same whether they are immediate values or
+// atoms, including across the binary image environments are cloned from.
+int main() {
+    auto clips = CreateClips("");
+    for (const auto &golden : kGolden) {
+        CHECK_EQ(Print(clips.get(), golden.first), std::string(golden.second));
+    }
+
+    for (int mode = 0; mode < 3; ++mode) {
+        ClipsFactory factory(kRules, false, mode != 0);
+        factory.set_shared_network(mode == 2);
+        void *env = factory.Create();
+        EnvReset(env);
+        EnvAssertString(env, "(a (x 3.5))");
+        EnvAssertString(env, "(a (x 7))");
+        EnvAssertString(env, "(a (x 1.25))");
+        EnvAssertString(env, "(a (x 0.0))");
+        EnvAssertString(env, "(a (x 4611686018427387904) (m 2 1.0e-320 3))");
+        CHECK_EQ(EnvRun(env, -1), 6);
+        CHECK_EQ(Print(env, "(hits)"),
+                 std::string("(4611686018427387905 1000 0.0 3.75 8 4.5)"));
+        CHECK_EQ(Print(env, "(fact-slot-value 5 m)"),
+                 std::string("(2 9.99988867182683e-321 3)"));
+        factory.Destroy(env);
+    }
+    return 0;
+}
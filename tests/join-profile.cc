@@ -0,0 +1,84 @@
+#include <cstdio>
+#include <string>
+
+#include "check.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+const char *kTemplates =
+    "(deftemplate txn (slot cust))\n"
+    "(deftemplate customer (slot id) (slot segment))\n"
+    "(deftemplate flagged (slot segment))";
+
+// The first rule joins its most selective CE last, the second one already
+// joins it first.
+const char *kRules =
+    "(defrule slow (txn (cust ?c)) (customer (id ?c) (segment ?s))"
+    " (flagged (segment ?s)) =>)\n"
+    "(defrule fast (flagged (segment ?s)) (customer (id ?c) (segment ?s))"
+    " (txn (cust ?c)) =>)";
+
+long Workload(void *clips) {
+    CHECK_EQ(ClipsEnvLoadFromString(clips, kRules), 1);
+    EnvReset(clips);
+    for (int i = 0; i < 3; ++i) {
+        EnvAssertString(clips, ("(flagged (segment " + std::to_string(i * 37) +
+                                "))").c_str());
+    }
+    for (int i = 0; i < 500; ++i) {
+        EnvAssertString(clips, ("(customer (id " + std::to_string(i) +
+                                ") (segment " + std::to_string(i % 100) +
+                                "))").c_str());
+    }
+    for (int i = 0; i < 2000; ++i) {
+        EnvAssertString(clips, ("(txn (cust " + std::to_string(i % 500) +
+                                "))").c_str());
+    }
+    return EnvRun(clips, -1);
+}
+
+std::string Report(void *clips) {
+    char buffer[4096] = "";
+    OpenStringDestination(clips, "report", buffer, sizeof(buffer));
+    EnvJoinProfileReport(clips, "report");
+    CloseStringDestination(clips, "report");
+    return buffer;
+}
+
+bool Contains(const std::string &text, const std::string &part) {
+    return text.find(part) != std::string::npos;
+}
+
+}  // anonymous namespace
+
+// Rules reordered from a join profile fire like the rules in their own order,
+// and runs left in rule order are reported with the reason.
+int main() {
+    const char *profile = "join-profile-test.prof";
+    auto reference = CreateClips(kTemplates);
+    long fired = Workload(reference.get());
+    CHECK(fired > 0);
+    CHECK(EnvSaveJoinProfile(reference.get(), profile));
+
+    auto reordered = CreateClips(kTemplates);
+    CHECK(EnvLoadJoinProfile(reordered.get(), profile));
+    CHECK_EQ(Workload(reordered.get()), fired);
+    std::string report = Report(reordered.get());
+    CHECK(Contains(report, "MAIN::slow, CEs joined in order 3 2 1"));
+    CHECK(Contains(report, "MAIN::fast, CEs joined in rule order\n"
+                           "   CEs 1-3 left in rule order: gain below the "
+                           "reorder threshold"));
+
+    // Nothing beats the rule order by 100%.
+    auto kept = CreateClips(kTemplates);
+    CHECK(EnvLoadJoinProfile(kept.get(), profile));
+    CHECK_EQ(EnvSetJoinReorderThreshold(kept.get(), 100.0), 10.0);
+    CHECK_EQ(Workload(kept.get()), fired);
+    report = Report(kept.get());
+    CHECK(Contains(report, "MAIN::slow, CEs joined in rule order"));
+    CHECK(!Contains(report, "joined in order"));
+
+    std::remove(profile);
+    return 0;
+}
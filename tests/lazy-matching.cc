@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "check.h"
+#include "lib/clips-factory.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+const int kAccounts = 10;
+
+// Rules over many salience levels, above them a rule retracting
+// transactions and a rule halting the run on a blocked account, below them
+// a negated CE.
+std::string Rules() {
+    std::string rules =
+        "(deftemplate txn (slot id) (slot acct) (slot amount))\n"
+        "(deftemplate acct (slot id) (slot limit) (slot status))\n"
+        "(deffacts accounts (acct (id a0) (limit 0) (status ok)))\n"
+        "(defrule blocked (declare (salience 1000))"
+        " (acct (id ?a) (status blocked)) (txn (acct ?a)) => (halt))\n"
+        "(defrule refund (declare (salience 600)) ?t <- (txn (amount 0))"
+        " => (retract ?t))\n"
+        "(defrule orphan (declare (salience -600)) (txn (id ?i) (acct ?a))"
+        " (not (acct (id ?a))) => (assert (orphan ?i)))\n";
+    for (int i = 0; i < 200; ++i) {
+        std::string index = std::to_string(i);
+        rules += "(defrule r" + index + " (declare (salience " +
+                 std::to_string(500 - i % 50) +
+                 ")) (txn (id ?i) (acct ?a) (amount ?m&:(> ?m " +
+                 std::to_string(i % 97) +
+                 "))) (acct (id ?a) (limit ?l&:(< ?l (+ ?m " + index +
+                 ")))) => (assert (score r" + index + " ?i)))\n";
+    }
+    return rules;
+}
+
+void Assert(void *clips, const std::string &fact) {
+    EnvAssertString(clips, fact.c_str());
+}
+
+// The facts of @param clips in their printed form without their index,
+// sorted since activations of equal salience may fire in any order.
+std::string Facts(void *clips) {
+    std::vector<std::string> facts;
+    char buffer[256];
+    for (void *fact = EnvGetNextFact(clips, nullptr); fact != nullptr;
+         fact = EnvGetNextFact(clips, fact)) {
+        EnvGetFactPPForm(clips, buffer, sizeof(buffer), fact);
+        facts.push_back(std::strchr(buffer, '('));
+    }
+    std::sort(facts.begin(), facts.end());
+    std::string list;
+    for (const std::string &fact : facts) list += fact + "\n";
+    return list;
+}
+
+std::string Request(void *clips, int request, bool block) {
+    for (int a = 1; a < kAccounts; ++a) {
+        const char *status = block && a == 3 ? "blocked" : "ok";
+        Assert(clips, "(acct (id a" + std::to_string(a) + ") (limit " +
+                          std::to_string(a * 10) + ") (status " + status +
+                          "))");
+    }
+    for (int i = 0; i < 100; ++i) {
+        int id = request * 100 + i;
+        Assert(clips, "(txn (id " + std::to_string(id) + ") (acct a" +
+                          std::to_string(id % (kAccounts + 2)) +
+                          ") (amount " + std::to_string(id * 37 % 100) +
+                          "))");
+    }
+    long fired = EnvRun(clips, -1);
+    return std::to_string(fired) + " fired\n" + Facts(clips);
+}
+
+// Requests after resets, then requests rolled back to a checkpoint, with
+// the deffacts facts kept static.
+std::string Workload(void *clips) {
+    EnvSetStaticFacts(clips, TRUE);
+    std::string output;
+    for (int request = 0; request < 4; ++request) {
+        EnvReset(clips);
+        output += Request(clips, request, request == 2);
+    }
+    EnvReset(clips);
+    EnvCheckpoint(clips);
+    for (int request = 0; request < 3; ++request) {
+        output += Request(clips, request, request == 1);
+        CHECK(EnvRollback(clips));
+        output += Facts(clips);
+    }
+    return output;
+}
+
+// Two rules of equal salience halting the run. The facts of the pattern
+// also leading to a rule of higher salience are joined first by lazy
+// matching, so their activation is the older one.
+const char *kEqualSalience =
+    "(defrule never (declare (salience 10)) (z ?v) (never) => )\n"
+    "(defrule after-x (x ?v) => (assert (fired x)) (halt))\n"
+    "(defrule after-z (z ?v) => (assert (fired z)) (halt))";
+
+// The rule fired by the run of @param clips before its halt.
+std::string FirstFired(void *clips) {
+    EnvReset(clips);
+    Assert(clips, "(x 1)");
+    Assert(clips, "(z 1)");
+    CHECK_EQ(EnvRun(clips, -1), 1L);
+    std::string facts = Facts(clips);
+    size_t fired = facts.find("(fired");
+    CHECK_EQ(fired, facts.rfind("(fired"));
+    return facts.substr(fired, facts.find('\n', fired) + 1 - fired);
+}
+
+}  // anonymous namespace
+
+// Lazy matching fires the same rules as eager matching, and a run halted by
+// the high salience rule fires nothing else.
+int main() {
+    auto eager = CreateClips(Rules());
+    std::string expected = Workload(eager.get());
+    CHECK(expected.find("\n1 fired\n") != std::string::npos);
+
+    auto lazy = CreateClips(Rules());
+    EnvSetLazyMatching(lazy.get(), TRUE);
+    CHECK_EQ(Workload(lazy.get()), expected);
+
+    for (bool shared : {false, true}) {
+        ClipsFactory factory(Rules(), false, true);
+        factory.set_shared_network(shared);
+        factory.set_lazy_matching(true);
+        void *clips = factory.Create();
+        CHECK_EQ(Workload(clips), expected);
+        factory.Destroy(clips);
+    }
+
+    // The order of activations of equal salience may differ: eager matching
+    // fires the rule of the newer fact, lazy matching the rule of the fact
+    // joined last.
+    auto eager_order = CreateClips(kEqualSalience);
+    CHECK_EQ(FirstFired(eager_order.get()), "(fired z)\n");
+    auto lazy_order = CreateClips(kEqualSalience);
+    EnvSetLazyMatching(lazy_order.get(), TRUE);
+    CHECK_EQ(FirstFired(lazy_order.get()), "(fired x)\n");
+    return 0;
+}
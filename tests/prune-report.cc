@@ -0,0 +1,68 @@
+#include <string>
+
+#include "check.h"
+#include "lib/clips-factory.h"
+
+using nlohmann::json;
+
+namespace {
+
+// a.x is matched by a rule, a.q and a.d are only seen by fact-set queries,
+// a.u is only asserted. Queries need their relations to exist, the
+// deffunction asserting them creates them.
+const char *kRules =
+    "(deftemplate hit (slot v))\n"
+    "(deffunction relations () (assert (a.u 1) (a.q 0) (a.d 0)))\n"
+    "(defrule known (a.x ?x) => (assert (hit (v ?x))))\n"
+    "(deffunction get-result () (bind ?sum 0)"
+    " (do-for-all-facts ((?f a.d)) TRUE"
+    " (bind ?sum (+ ?sum (nth$ 1 ?f:implied))))"
+    " (create$ (fact-slot-value (nth$ 1 (find-fact ((?f hit)) TRUE)) v)"
+    " (nth$ 1 (fact-slot-value (nth$ 1 (find-fact ((?f a.q)) TRUE))"
+    " implied)) ?sum))";
+
+// The same rule set with a query whose template is computed at run time.
+const char *kDynamicRules =
+    "(deffunction count-of (?name)"
+    " (length$ (find-all-facts ((?f ?name)) TRUE)))\n";
+
+const json kFeatures = {{"a.x", 1}, {"a.q", 2}, {"a.d", {3, 4}},
+                        {"a.u", 5}, {"z.unknown", 6}, {"1e5", 7},
+                        {"a.obj", {{"k", 1}}}};
+
+json Execute(ClipsFactory &factory) {
+    void *clips = factory.Create();
+    int halt = 0;
+    json result = ClipsModuleExecute(clips, kFeatures, 100, "get-result",
+                                     halt);
+    factory.Destroy(clips);
+    return result;
+}
+
+}  // anonymous namespace
+
+// Keys seen only by fact-set queries are kept, keys no rule or query can see
+// are pruned, and a query computing its template turns pruning off.
+int main() {
+    for (bool clone : {false, true}) {
+        ClipsFactory factory(kRules, true, clone);
+        CHECK_EQ(Execute(factory), json::array({1, 2, 3}));
+        CHECK_EQ(factory.schema()->PruneReport(kFeatures),
+                 json({{"pruning", true},
+                       {"kept", {"a.d", "a.q", "a.x"}},
+                       {"pruned", {"a.u", "z.unknown"}}}));
+
+        ClipsFactory dynamic(std::string(kRules) + "\n" + kDynamicRules,
+                             true, clone);
+        CHECK_EQ(Execute(dynamic), json::array({1, 2, 3}));
+        CHECK_EQ(dynamic.schema()->PruneReport(kFeatures),
+                 json({{"pruning", false},
+                       {"kept", {"a.d", "a.q", "a.u", "a.x", "z.unknown"}},
+                       {"pruned", json::array()}}));
+
+        ClipsFactory unpruned(kRules, false, clone);
+        CHECK_EQ(Execute(unpruned), json::array({1, 2, 3}));
+        CHECK(!unpruned.schema()->pruning());
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <cstring>
+#include <string>
+
+#include "check.h"
+#include "lib/clips-utils.h"
+
+namespace {
+
+// Inequality joins from pattern predicates and test CEs, one of them the
+// first test of a conjunction. With @param indexed the comparisons come
+// first and the joins are range indexed, otherwise they are negated
+// comparisons which are evaluated for every pair.
+std::string Rules(bool indexed) {
+    auto compare = [indexed](const char *op, const char *negated,
+                             const std::string &args) {
+        return indexed ? "(" + std::string(op) + " " + args + ")"
+                       : "(not (" + std::string(negated) + " " + args + "))";
+    };
+    return "(defrule above (limit ?l) (reading ?r&:" +
+           compare(">", "<=", "?r ?l") +
+           ") => (assert (fired above ?l ?r)))\n"
+           "(defrule within (order ?id ?amount) (cap ?c ?limit)"
+           " (test " + compare(">=", "<", "?limit ?amount") +
+           ") => (assert (fired within ?id ?c)))\n"
+           "(defrule below (limit ?l) (cap ?c ?limit)"
+           " (test (and " + compare("<", ">=", "?l ?limit") +
+           " (neq ?c c3))) => (assert (fired below ?l ?c)))\n"
+           "(defrule most (reading ?r) (order ?id ?amount&:" +
+           compare("<=", ">", "?amount ?r") +
+           ") => (assert (fired most ?r ?id)))\n";
+}
+
+void Assert(void *clips, const std::string &fact) {
+    EnvAssertString(clips, fact.c_str());
+}
+
+// Integer and float values, with ties between the two sides, and some
+// facts of each side retracted.
+void Request(void *clips, int request) {
+    EnvReset(clips);
+    for (int i = 0; i < 150; ++i) {
+        int value = (i * 37 + request * 11) % 100;
+        Assert(clips, "(limit " + std::to_string(value) + ")");
+        Assert(clips, "(reading " + std::to_string(value % 50) +
+                          (i % 3 == 0 ? ".0)" : ")"));
+        Assert(clips, "(order o" + std::to_string(i) + " " +
+                          std::to_string(value) + ".5)");
+        Assert(clips, "(cap c" + std::to_string(i) + " " +
+                          std::to_string((value * 7) % 100) + ")");
+    }
+    DATA_OBJECT result;
+    EnvEval(clips,
+            "(do-for-all-facts ((?f limit reading order cap))"
+            " (= (mod (fact-index ?f) 7) 0) (retract ?f))",
+            &result);
+    EnvRun(clips, -1);
+}
+
+// The facts of @param clips in their printed form without their index, in
+// the order they were asserted, which is the order the rules fired in.
+std::string Facts(void *clips) {
+    std::string facts;
+    char buffer[256];
+    for (void *fact = EnvGetNextFact(clips, nullptr); fact != nullptr;
+         fact = EnvGetNextFact(clips, fact)) {
+        EnvGetFactPPForm(clips, buffer, sizeof(buffer), fact);
+        facts += std::string(std::strchr(buffer, '(')) + "\n";
+    }
+    return facts;
+}
+
+long JoinCompares(void *clips) {
+    long compares = 0;
+    for (const char *rule : {"above", "within", "below", "most"}) {
+        DATA_OBJECT activity;
+        std::string command = "(join-activity " + std::string(rule) +
+                              " terse)";
+        EnvEval(clips, command.c_str(), &activity);
+        compares += ValueToLong(GetMFValue(GetValue(activity), 1));
+    }
+    return compares;
+}
+
+}  // anonymous namespace
+
+// Range indexed joins fire the same rules in the same order as the same
+// comparisons evaluated for every pair, over requests asserting and
+// retracting facts on both sides, with far fewer comparisons.
+int main() {
+    auto indexed = CreateClips(Rules(true));
+    auto reference = CreateClips(Rules(false));
+    for (int request = 0; request < 4; ++request) {
+        Request(indexed.get(), request);
+        Request(reference.get(), request);
+        std::string facts = Facts(indexed.get());
+        CHECK(facts.find("(fired below") != std::string::npos);
+        CHECK_EQ(facts, Facts(reference.get()));
+    }
+    CHECK(JoinCompares(indexed.get()) * 2 < JoinCompares(reference.get()));
+    return 0;
+}
@@ -0,0 +1,42 @@
+#include <vector>
+
+#include "check.h"
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+namespace {
+
+// R2 retracts a deffacts fact, which invalidates the checkpoint, and R4
+// replaces one, so rollbacks and resets alternate.
+const char *kRules =
+    "(deftemplate hit (slot v))\n"
+    "(deffacts d (black 1) (black 2) (cnt 0))\n"
+    "(defrule R1 (a.x ?x) (black ?x) => (assert (hit (v ?x))))\n"
+    "(defrule R2 (a.x 2) ?f <- (black 2) => (retract ?f)"
+    " (assert (hit (v kill))))\n"
+    "(defrule R3 (black 1) (not (a.x 1)) => (assert (hit (v nb))))\n"
+    "(defrule R4 ?f <- (cnt ?c) (a.x 5) => (retract ?f)"
+    " (assert (cnt (+ ?c 1))) (assert (hit (v ?c))))\n"
+    "(deffunction get-result () (bind ?r (create$))"
+    " (do-for-all-facts ((?f hit)) TRUE"
+    " (bind ?r (create$ ?r (fact-slot-value ?f v)))) ?r)";
+
+}  // anonymous namespace
+
+// Requests prepared by ClipsResetOrRollback see the same state as requests
+// prepared by EnvReset.
+int main() {
+    auto reference = CreateClips(kRules);
+    auto rolled_back = CreateClips(kRules);
+    for (int x : {1, 2, 3, 1, 5, 5, 2, 1, 3, 5, 4, 2, 5}) {
+        json features = {{"a.x", x}};
+        int halt = 0;
+        json expected = ClipsModuleExecute(reference.get(), features, 1000,
+                                           "get-result", halt);
+        json result = ClipsModuleExecute(rolled_back.get(), features, 1000,
+                                         "get-result", halt, true);
+        CHECK_EQ(result, expected);
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+#include "lib/resource-pool.hpp"
+
+namespace {
+
+const int kMaxResources = 4096;
+
+// What the factory created and destroyed, and which resources are held.
+struct Ledger {
+    std::atomic<int> created{0};
+    std::atomic<int> destroyed{0};
+    std::atomic<bool> held[kMaxResources];
+
+    Ledger() {
+        for (auto &flag : held) flag.store(false);
+    }
+};
+
+// Resources are numbers, each one created once.
+class CountingFactory {
+   public:
+    explicit CountingFactory(Ledger *ledger) : _ledger(ledger) {}
+
+    int *Create() { return new int(_ledger->created++); }
+
+    void Destroy(int *resource) {
+        CHECK(!_ledger->held[*resource].load());
+        ++_ledger->destroyed;
+        delete resource;
+    }
+
+   private:
+    Ledger *_ledger;
+};
+
+using CountingPool = ResourcePool<int, CountingFactory>;
+
+// Marks @param resource held, it must not have been handed out already.
+void Hold(Ledger *ledger, int *resource) {
+    CHECK(*resource < kMaxResources);
+    CHECK(!ledger->held[*resource].exchange(true));
+}
+
+void Unhold(Ledger *ledger, int *resource) {
+    CHECK(ledger->held[*resource].exchange(false));
+}
+
+// Every thread acquires up to @param depth resources at once and releases
+// them, many times.
+void Stress(CountingPool *pool, Ledger *ledger, int threads, int depth) {
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([=] {
+            std::vector<int *> resources;
+            for (int i = 0; i < 2000; ++i) {
+                int count = 1 + (i + t) % depth;
+                for (int k = 0; k < count; ++k) {
+                    resources.push_back(pool->Acquire());
+                    Hold(ledger, resources.back());
+                }
+                for (int *resource : resources) {
+                    Unhold(ledger, resource);
+                    pool->Release(resource);
+                }
+                resources.clear();
+            }
+        });
+    }
+    for (std::thread &worker : workers) worker.join();
+}
+
+// Acquires every idle resource of @param pool from one thread, each must be
+// handed out once and none may be created.
+void CheckIdle(CountingPool *pool, Ledger *ledger) {
+    int created = ledger->created;
+    unsigned int size = pool->get_size();
+    std::vector<int *> resources;
+    for (unsigned int i = 0; i < size; ++i) {
+        resources.push_back(pool->Acquire());
+        Hold(ledger, resources.back());
+    }
+    CHECK_EQ(ledger->created.load(), created);
+    for (int *resource : resources) {
+        Unhold(ledger, resource);
+        pool->Release(resource);
+    }
+}
+
+}  // anonymous namespace
+
+// A sharded pool used by many threads at once hands each resource to one
+// thread at a time and loses none, also when more resources are idle than
+// the shards have slots and the rest overflow into the locked list.
+int main() {
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    int threads = static_cast<int>(cores) * 4;
+    for (PoolMode mode : {POOL_SHARDED, POOL_LOCKED_LIST}) {
+        Ledger ledger;
+        {
+            CountingPool pool(4, new CountingFactory(&ledger), mode);
+            pool.set_need_clear(false);
+            pool.set_max_capacity(kMaxResources);
+
+            Stress(&pool, &ledger, threads, 3);
+            CHECK_EQ(ledger.destroyed.load(), 0);
+            CHECK_EQ(pool.get_size(),
+                     static_cast<unsigned int>(ledger.created.load()));
+            CheckIdle(&pool, &ledger);
+
+            // One thread holding more resources than there are slots in
+            // the shards, released into the overflow list.
+            std::vector<int *> resources;
+            int overflow = static_cast<int>(cores) * 16 + 64;
+            for (int i = 0; i < overflow; ++i) {
+                resources.push_back(pool.Acquire());
+                Hold(&ledger, resources.back());
+            }
+            for (int *resource : resources) {
+                Unhold(&ledger, resource);
+                pool.Release(resource);
+            }
+            CHECK(pool.get_size() >= static_cast<unsigned int>(overflow));
+
+            // The overflowing pool shared by the threads again.
+            Stress(&pool, &ledger, threads, 8);
+            CHECK_EQ(ledger.destroyed.load(), 0);
+            CHECK_EQ(pool.get_size(),
+                     static_cast<unsigned int>(ledger.created.load()));
+            CheckIdle(&pool, &ledger);
+        }
+        CHECK_EQ(ledger.destroyed.load(), ledger.created.load());
+    }
+    return 0;
+}
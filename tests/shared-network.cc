@@ -0,0 +1,92 @@
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "check.h"
+#include "lib/clips-factory.h"
+#include "lib/resource-pool.hpp"
+
+using nlohmann::json;
+
+namespace {
+
+using ClipsPool = ResourcePool<void, ClipsFactory>;
+
+const int kRequests = 200;
+
+// Join tests for the compiled expressions, salience levels for lazy
+// matching, string atoms interned by every request, and not CEs.
+std::string Rules() {
+    std::ostringstream os;
+    os << "(deftemplate hit (slot model) (slot score))\n";
+    for (int i = 0; i < 100; ++i) {
+        os << "(defrule M" << i << " (declare (salience " << i % 10 << "))"
+           << " (list.score ?s) (list.city ?c) (test (>= (* ?s 2) " << i
+           << ")) (not (list.black ?c)) => (assert (hit (model M" << i
+           << ") (score (+ ?s " << i << ")))))\n";
+    }
+    os << "(defrule city (list.city ?c&:(eq (str-index \"7\" ?c) 2))"
+       << " => (assert (hit (model city) (score 1))))\n";
+    os << "(deffunction get-result () (bind ?sum 0) (bind ?count 0)"
+       << " (do-for-all-facts ((?f hit)) TRUE"
+       << " (bind ?count (+ ?count 1))"
+       << " (bind ?sum (+ ?sum (fact-slot-value ?f score))))"
+       << " (create$ ?count ?sum))";
+    return os.str();
+}
+
+json Request(int i) {
+    json features = {{"list.score", i * 7 % 60},
+                     {"list.city", "c" + std::to_string(i % 13)}};
+    if (i % 5 == 0) features["list.black"] = features["list.city"];
+    return features;
+}
+
+json Execute(void *clips, int i) {
+    int halt = 0;
+    json result =
+        ClipsModuleExecute(clips, Request(i), 100000, "get-result", halt);
+    CHECK_EQ(halt, 0);
+    return result;
+}
+
+}  // anonymous namespace
+
+// Environments sharing one frozen network, with compiled join tests and
+// lazy matching, run requests from several threads at once and return
+// what a parsed environment returns.
+int main() {
+    auto parsed = CreateClips(Rules());
+    std::vector<json> expected;
+    for (int i = 0; i < kRequests; ++i) {
+        expected.push_back(Execute(parsed.get(), i));
+    }
+
+    auto *factory = new ClipsFactory(Rules(), false, true);
+    factory->set_shared_network(true);
+    factory->set_compiled_expressions(true);
+    factory->set_lazy_matching(true);
+    ClipsPool pool(4, factory);
+
+    const int kThreads = 8;
+    std::vector<std::vector<json>> results(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int n = 0; n < kRequests; ++n) {
+                int i = (n + t * 25) % kRequests;
+                results[t].push_back(pool.RunWithResource<json>(
+                    [i](void *clips) { return Execute(clips, i); }));
+            }
+        });
+    }
+    for (auto &thread : threads) thread.join();
+
+    for (int t = 0; t < kThreads; ++t) {
+        for (int n = 0; n < kRequests; ++n) {
+            CHECK_EQ(results[t][n], expected[(n + t * 25) % kRequests]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <cstring>
+#include <set>
+#include <string>
+
+#include "check.h"
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+namespace {
+
+// Strings of every length up to a few words, so that every size of the
+// last partial word is hashed.
+std::string Word(size_t length, char fill) {
+    std::string word;
+    for (size_t i = 0; i < length; ++i) {
+        word += static_cast<char>(fill + i % 23);
+    }
+    return word;
+}
+
+long CountFacts(void *clips) {
+    long count = 0;
+    for (void *fact = EnvGetNextFact(clips, nullptr); fact != nullptr;
+         fact = EnvGetNextFact(clips, fact)) {
+        ++count;
+    }
+    return count;
+}
+
+// Facts made of strings, joined on them, and asserted again as duplicates.
+const char *kRules =
+    "(deffacts names (name \"abc\") (name \"abcdefgh\")"
+    " (name \"abcdefghi\") (name \"a longer string with spaces\"))\n"
+    "(defrule pair (name ?n) (a.n ?n) => (assert (hit ?n)))\n"
+    "(deffunction get-result () (bind ?r (create$))"
+    " (do-for-all-facts ((?f hit)) TRUE"
+    " (bind ?r (create$ ?r (fact-slot-value ?f implied)))) ?r)";
+
+json Execute(void *clips, const std::string &name) {
+    int halt = 0;
+    return ClipsModuleExecute(clips, {{"a.n", name}}, -1, "get-result", halt);
+}
+
+// The deffacts asserted again are duplicates, which are found by the hash
+// of the facts and so by the cached hash of their symbols.
+void CheckDuplicates(void *clips) {
+    EnvReset(clips);
+    long count = CountFacts(clips);
+    EnvAssertString(clips, "(name \"abcdefgh\")");
+    EnvAssertString(clips, "(name \"a longer string with spaces\")");
+    CHECK_EQ(CountFacts(clips), count);
+    EnvAssertString(clips, "(name \"abcdefgi\")");
+    CHECK_EQ(CountFacts(clips), count + 1);
+}
+
+}  // anonymous namespace
+
+// Symbols are hashed a word at a time: the hash of a string depends only on
+// its characters, whatever their alignment and whatever follows them, and
+// the hash cached in the symbol is the one used to find facts and joins,
+// also after a bload.
+int main() {
+    std::set<unsigned long> hashes;
+    char buffer[64];
+    for (size_t length = 0; length <= 40; ++length) {
+        std::string word = Word(length, 'a');
+        unsigned long hash = HashSymbol(word.c_str(), 0);
+        CHECK_EQ(HashCharacters(word.c_str(), length), hash);
+        for (size_t offset = 0; offset < 8; ++offset) {
+            std::memset(buffer, 'x', sizeof(buffer));
+            std::memcpy(buffer + offset, word.c_str(), length);
+            CHECK_EQ(HashCharacters(buffer + offset, length), hash);
+        }
+        CHECK_EQ(HashSymbol(word.c_str(), 1024), hash & 1023);
+        CHECK_EQ(HashSymbol(word.c_str(), 1000), hash % 1000);
+        CHECK(hashes.insert(hash).second);
+
+        // A string one character different anywhere hashes differently.
+        for (size_t i = 0; i < length; ++i) {
+            std::string other = word;
+            other[i] = static_cast<char>(other[i] + 1);
+            CHECK(HashSymbol(other.c_str(), 0) != hash);
+        }
+    }
+
+    auto clips = CreateClips(kRules);
+    for (size_t length = 1; length <= 40; ++length) {
+        std::string word = Word(length, 'b');
+        void *symbol = EnvAddSymbol(clips.get(), word.c_str());
+        std::memset(buffer, 'x', sizeof(buffer));
+        std::memcpy(buffer + 3, word.c_str(), length + 1);
+        CHECK(EnvAddSymbol(clips.get(), buffer + 3) == symbol);
+        CHECK(FindSymbolHN(clips.get(), buffer + 3) == symbol);
+    }
+
+    CheckDuplicates(clips.get());
+    CHECK_EQ(Execute(clips.get(), "abcdefghi"), json::array({"abcdefghi"}));
+    CHECK_EQ(Execute(clips.get(), "abcdefgi"), json::array());
+
+    std::string image = ClipsBsaveImage(clips.get());
+    auto loaded = CreateClips("");
+    ClipsBloadImage(loaded.get(), image.data(), image.size());
+    CheckDuplicates(loaded.get());
+    for (const char *name : {"abc", "abcdefgh", "abcdefghi",
+                             "a longer string with spaces", "abcdefgi"}) {
+        CHECK_EQ(Execute(loaded.get(), name), Execute(clips.get(), name));
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <cstring>
+#include <set>
+#include <string>
+
+#include "check.h"
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+namespace {
+
+// Integer and float bounds of every comparison, including bounds that
+// doubles can't tell apart from their neighbours.
+std::string Rules() {
+    const char *operators[] = {"<", "<=", ">", ">="};
+    const char *bounds[] = {"-5",  "0",   "7",    "7.5",
+                            "1e3", "100", "-2.25", "9007199254740993"};
+    std::string rules = "(deffunction get-result () TRUE)\n";
+    int rule = 0;
+    for (const char *op : operators) {
+        for (const char *bound : bounds) {
+            std::string index = std::to_string(rule++);
+            rules += "(defrule t" + index + " (list.score ?s) (test (" + op +
+                     " ?s " + bound + ")) => (assert (hit " + index +
+                     " ?s)))\n";
+        }
+    }
+    return rules;
+}
+
+// The "hit" facts of @param clips in their printed form, in any order.
+std::set<std::string> Hits(void *clips) {
+    std::set<std::string> hits;
+    char buffer[256];
+    for (void *fact = EnvGetNextFact(clips, nullptr); fact != nullptr;
+         fact = EnvGetNextFact(clips, fact)) {
+        EnvGetFactPPForm(clips, buffer, sizeof(buffer), fact);
+        const char *form = std::strchr(buffer, '(');
+        if (std::strncmp(form, "(hit ", 5) == 0) hits.insert(form);
+    }
+    return hits;
+}
+
+clips_ptr CreateIndexed(const std::string &rules) {
+    auto clips = CreateClips("");
+    EnvSetThresholdIndexing(clips.get(), TRUE);
+    CHECK_EQ(ClipsEnvLoadFromString(clips.get(), rules.c_str()), 1);
+    return clips;
+}
+
+}  // anonymous namespace
+
+// Threshold tests indexed in the fact selectors fire the same rules as the
+// tests evaluated one by one.
+int main() {
+    auto reference = CreateClips(Rules());
+    auto indexed = CreateIndexed(Rules());
+    const json scores[] = {-6,   -5,    -2.25, -2,   0,
+                           0.0,  7,     7.5,   8,    100,
+                           999.9, 1000, 1e3,   1001, 1e17,
+                           9007199254740992LL, 9007199254740993LL,
+                           9007199254740994LL};
+    for (const json &score : scores) {
+        json features = {{"list.score", score}};
+        int halt = 0;
+        ClipsModuleExecute(reference.get(), features, 1000, "get-result",
+                           halt);
+        CHECK_EQ(halt, 0);
+        ClipsModuleExecute(indexed.get(), features, 1000, "get-result", halt);
+        CHECK_EQ(halt, 0);
+        CHECK(!Hits(indexed.get()).empty());
+        CHECK(Hits(indexed.get()) == Hits(reference.get()));
+    }
+
+    // 2^53 equals the bound once converted to a double, but is below it.
+    auto large = CreateIndexed(
+        "(defrule r (list.score ?s) (test (< ?s 9007199254740993)) =>)");
+    EnvReset(large.get());
+    EnvAssertString(large.get(), "(list.score 9007199254740992)");
+    CHECK_EQ(EnvRun(large.get(), -1), 1);
+
+    // A symbol fails the comparison the way the unindexed test does.
+    for (clips_ptr *clips : {&reference, &indexed}) {
+        char errors[512] = "";
+        json features = {{"list.score", "high"}};
+        int halt = 0;
+        OpenStringDestination(clips->get(), "werror", errors, sizeof(errors));
+        ClipsModuleExecute(clips->get(), features, 1000, "get-result",
+                           halt);
+        CloseStringDestination(clips->get(), "werror");
+        CHECK_EQ(halt, 1);
+        CHECK(std::strstr(errors, "[ARGACCES5]") != nullptr);
+    }
+    return 0;
+}
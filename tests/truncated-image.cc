@@ -0,0 +1,82 @@
+#include <cstdio>
+#include <string>
+
+#include "check.h"
+#include "lib/clips-utils.h"
+
+using nlohmann::json;
+
+namespace {
+
+// Constructs of most kinds, so that every section of the image is cut
+// somewhere.
+const char *kRules =
+    "(deftemplate hit (slot v) (slot w (type INTEGER) (range 0 100)))\n"
+    "(deffacts d (black 1) (black 2.5) (black \"two\"))\n"
+    "(defglobal ?*limit* = 10)\n"
+    "(deffunction twice (?x) (* ?x 2))\n"
+    "(defrule match (a.x ?x) (black ?x) => (assert (hit (v ?x) (w 1))))\n"
+    "(defrule over (a.x ?x&:(> (twice ?x) ?*limit*)) (not (black ?x))"
+    " => (assert (hit (v over) (w 2))))\n"
+    "(deffunction get-result () (bind ?r (create$))"
+    " (do-for-all-facts ((?f hit)) TRUE"
+    " (bind ?r (create$ ?r (fact-slot-value ?f v)))) ?r)";
+
+json Execute(void *clips, int x) {
+    int halt = 0;
+    return ClipsModuleExecute(clips, {{"a.x", x}}, 100, "get-result", halt);
+}
+
+// Loads @param size bytes of @param image, the error output is kept in
+// @param errors.
+bool Bload(void *clips, const std::string &image, size_t size,
+           std::string *errors) {
+    char buffer[1024] = "";
+    OpenStringDestination(clips, "werror", buffer, sizeof(buffer));
+    bool loaded = EnvBloadFromMemory(clips, image.data(), size);
+    CloseStringDestination(clips, "werror");
+    *errors = buffer;
+    return loaded;
+}
+
+}  // anonymous namespace
+
+// A binary image cut anywhere fails to load, from memory and from a file,
+// instead of being loaded from zeroes. The environment can load the whole
+// image afterwards and keeps it when a truncated image fails to load.
+int main() {
+    auto parsed = CreateClips(kRules);
+    std::string image = ClipsBsaveImage(parsed.get());
+    CHECK(!image.empty());
+
+    auto clips = CreateClips("");
+    std::string errors;
+    for (size_t size = 0; size < image.size(); ++size) {
+        CHECK(!Bload(clips.get(), image, size, &errors));
+        CHECK(!errors.empty());
+        // Past the prefix and version of the image, the cut is reported.
+        if (size >= 64) {
+            CHECK(errors.find("is truncated") != std::string::npos);
+        }
+    }
+
+    CHECK(Bload(clips.get(), image, image.size(), &errors));
+    CHECK_EQ(errors, "");
+    for (int x : {1, 3, 6}) {
+        CHECK_EQ(Execute(clips.get(), x), Execute(parsed.get(), x));
+    }
+
+    std::string path = "truncated-image.bin";
+    FILE *file = std::fopen(path.c_str(), "wb");
+    CHECK(file != nullptr);
+    std::fwrite(image.data(), 1, image.size() / 2, file);
+    std::fclose(file);
+    char buffer[1024] = "";
+    OpenStringDestination(clips.get(), "werror", buffer, sizeof(buffer));
+    CHECK(!EnvBload(clips.get(), path.c_str()));
+    CloseStringDestination(clips.get(), "werror");
+    CHECK(std::string(buffer).find("is truncated") != std::string::npos);
+    std::remove(path.c_str());
+    CHECK_EQ(Execute(clips.get(), 6), Execute(parsed.get(), 6));
+    return 0;
+}